@@ -0,0 +1,511 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_console.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "app_console.h"
+#include "log_bridge.h"
+#include "lvgl_port.h"
+#include "rgb565_blend.h"
+#include "scan_mon.h"
+#include "touch_sampler.h"
+#include "ui.h"
+#include "ui_bench.h"
+
+static const char *TAG = "app_console";                  // Tag for logging
+
+#define BENCH_DRAIN_MS      (200)                        // Let the last messages reach the screen before stopping
+#define SCAN_STEP_MS        (3000)                       // Default stress time per pixel clock
+#define SCAN_PCLK_STEP_HZ   (2 * 1000 * 1000)
+#define BLEND_BENCH_LINES   (16)                         // Height of the test buffers, full screen width
+#define BLEND_BENCH_PASSES  (20)
+
+static void bench_write(const char *text, void *ctx)
+{
+    fputs(text, stdout);
+}
+
+static int bench_usage(void)
+{
+    printf("usage: bench <workload> [duration_ms] [rate_hz] [csv|json]\nworkloads:");
+    for (int i = 0; i < UI_BENCH_WORKLOAD_COUNT; i++) {
+        printf(" %s", ui_bench_workload_name((ui_bench_workload_t)i));
+    }
+    printf("\n");
+    return 1;
+}
+
+static int cmd_bench(int argc, char **argv)
+{
+    ui_bench_config_t config = {
+        .duration_ms = 5000,
+        .rate_hz = 0,
+    };
+    ui_bench_format_t format = UI_BENCH_CSV;
+    if (argc < 2 || !ui_bench_workload_from_name(argv[1], &config.workload)) {
+        return bench_usage();
+    }
+    if (argc > 2) {
+        config.duration_ms = strtoul(argv[2], NULL, 0);
+    }
+    if (argc > 3) {
+        config.rate_hz = strtoul(argv[3], NULL, 0);
+    }
+    if (argc > 4) {
+        format = strcmp(argv[4], "json") ? UI_BENCH_CSV : UI_BENCH_JSON;
+    }
+
+    if (!ui_bench_start(&config)) {
+        printf("bench is already running\n");
+        return 1;
+    }
+    while (ui_bench_step()) {
+        vTaskDelay(1); // The workload issues every call that is due, so the step rate only adds jitter
+    }
+    vTaskDelay(pdMS_TO_TICKS(BENCH_DRAIN_MS));
+    if (lvgl_port_lock(-1)) {
+        ui_bench_stop(); // Under the lock, so no frame is being recorded
+        lvgl_port_unlock();
+    }
+    ui_bench_report(format, bench_write, NULL);
+    fflush(stdout);
+    return 0;
+}
+
+static int cmd_touch_trace(int argc, char **argv)
+{
+    if (argc != 2 || (strcmp(argv[1], "on") && strcmp(argv[1], "off"))) {
+        printf("usage: touch_trace <on|off>\n");
+        return 1;
+    }
+    touch_sampler_set_trace(!strcmp(argv[1], "on"));
+    return 0;
+}
+
+static int log_usage(void)
+{
+    printf("usage: log find <text> [error|warn|info|debug] | log err | log jump <hh:mm:ss[.mmm]> | log latest | log stats\n");
+    return 1;
+}
+
+static bool parse_level(const char *name, ui_log_level_t *level)
+{
+    static const char *const names[] = { "error", "warn", "info", "debug", "verbose" };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (!strcmp(name, names[i])) {
+            *level = (ui_log_level_t)(UI_LOG_ERROR + i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// "hh:mm:ss[.mmm]" as shown in the log prefix, also "mm:ss" and "ss"
+static bool parse_time(const char *text, uint32_t *tick_ms)
+{
+    uint32_t sec = 0;
+    char *end = (char *)text;
+    for (int field = 0; field < 3; field++) {
+        sec = sec * 60 + strtoul(end, &end, 10);
+        if (*end != ':') {
+            break;
+        }
+        end++;
+    }
+    uint32_t ms = 0;
+    if (*end == '.') {
+        const char *frac = end + 1;
+        ms = strtoul(frac, &end, 10);
+        for (int digits = end - frac; digits < 3; digits++) {
+            ms *= 10;
+        }
+    }
+    *tick_ms = sec * 1000 + ms;
+    return *end == '\0' && end != text;
+}
+
+static int cmd_log(int argc, char **argv)
+{
+    if (argc < 2) {
+        return log_usage();
+    }
+    if (!strcmp(argv[1], "find") && (argc == 3 || argc == 4)) {
+        ui_log_level_t level = UI_LOG_VERBOSE;
+        if (argc == 4 && !parse_level(argv[3], &level)) {
+            return log_usage();
+        }
+        ui_find_log(argv[2], level);
+    } else if (!strcmp(argv[1], "err") && argc == 2) {
+        ui_find_log(NULL, UI_LOG_ERROR);
+    } else if (!strcmp(argv[1], "jump") && argc == 3) {
+        uint32_t tick_ms;
+        if (!parse_time(argv[2], &tick_ms)) {
+            return log_usage();
+        }
+        ui_jump_log(tick_ms);
+    } else if (!strcmp(argv[1], "latest") && argc == 2) {
+        ui_jump_log(UINT32_MAX);
+    } else if (!strcmp(argv[1], "stats") && argc == 2) {
+        ui_log_stats_t stats;
+        if (!lvgl_port_lock(-1)) {
+            return 1;
+        }
+        ui_log_get_stats(&stats);
+        lvgl_port_unlock();
+        printf("lines=%lu stored=%lu/%lu evicted=%lu bytes=%lu/%lu finds=%lu misses=%lu find_us_max=%lu\n",
+               (unsigned long)stats.lines, (unsigned long)stats.stored, (unsigned long)stats.index_size,
+               (unsigned long)stats.evicted, (unsigned long)stats.store_used, (unsigned long)stats.store_size,
+               (unsigned long)stats.finds, (unsigned long)stats.find_misses, (unsigned long)stats.find_us_max);
+        ui_log_bridge_stats_t bridge;
+        log_bridge_get_stats(&bridge);
+        printf("esp_log: calls=%lu shown=%lu filtered=%lu suppressed=%lu summaries=%lu queue_full=%lu tags=%lu\n",
+               (unsigned long)bridge.calls, (unsigned long)bridge.shown, (unsigned long)bridge.filtered,
+               (unsigned long)bridge.suppressed, (unsigned long)bridge.summaries, (unsigned long)bridge.queue_full,
+               (unsigned long)bridge.tags);
+    } else {
+        return log_usage();
+    }
+    return 0;
+}
+
+static int scan_usage(void)
+{
+    printf("usage: scan stats | scan calibrate [min_mhz max_mhz] [step_ms]\n");
+    return 1;
+}
+
+// Redraw the whole screen as often as LVGL can, every pixel is written to PSRAM and, in direct mode, copied once more
+static void scan_stress(void *ctx)
+{
+    if (lvgl_port_lock(-1)) {
+        lv_obj_invalidate(lv_scr_act());
+        lvgl_port_unlock();
+    }
+}
+
+static void scan_print_mhz(const char *prefix, uint32_t hz, const char *suffix)
+{
+    printf("%s%lu.%lu MHz%s", prefix, (unsigned long)(hz / 1000000), (unsigned long)(hz / 100000 % 10), suffix);
+}
+
+static int scan_calibrate(int argc, char **argv)
+{
+    scan_mon_stats_t stats;
+    scan_mon_get_stats(&stats, false);
+    scan_mon_cal_config_t config = {
+        .pclk_min_hz = stats.pclk_hz * 3 / 4 / 1000000 * 1000000,
+        .pclk_max_hz = stats.pclk_hz * 5 / 4,
+        .pclk_step_hz = SCAN_PCLK_STEP_HZ,
+        .step_ms = SCAN_STEP_MS,
+        .stress = scan_stress,
+    };
+    if (argc == 4 || argc == 5) {
+        config.pclk_min_hz = strtoul(argv[2], NULL, 0) * 1000000;
+        config.pclk_max_hz = strtoul(argv[3], NULL, 0) * 1000000;
+    }
+    if (argc == 3 || argc == 5) {
+        config.step_ms = strtoul(argv[argc - 1], NULL, 0);
+    }
+    scan_mon_cal_result_t *result = malloc(sizeof(scan_mon_cal_result_t));
+    if (!result) {
+        return 1;
+    }
+    printf("Sweeping the pixel clock, the screen may flicker\n");
+    esp_err_t ret = scan_mon_calibrate(&config, result);
+    if (ret != ESP_OK) {
+        printf("calibration failed: %s\n", esp_err_to_name(ret));
+        free(result);
+        return 1;
+    }
+    for (int i = 0; i < result->step_count; i++) {
+        const scan_mon_cal_step_t *step = &result->steps[i];
+        scan_print_mhz("", step->pclk_hz, "");
+        printf(": %d-line bounce buffer late=%lu underruns=%lu drifts=%lu, ", CONFIG_EXAMPLE_LCD_RGB_BOUNCE_BUFFER_HEIGHT,
+               (unsigned long)step->late, (unsigned long)step->underruns, (unsigned long)step->drifts);
+        if (step->min_safe_lines) {
+            printf("smallest safe height %u lines\n", step->min_safe_lines);
+        } else {
+            printf("no safe height\n");
+        }
+        printf("  lines  deadline us  refill p99 us  refill max us\n");
+        for (int j = 0; j < SCAN_MON_CAL_HEIGHTS; j++) {
+            const scan_mon_cal_height_t *h = &step->heights[j];
+            printf("  %5u  %11lu  %13lu  %13lu%s\n", h->lines, (unsigned long)h->deadline_us,
+                   (unsigned long)h->refill_us_p99, (unsigned long)h->refill_us_max, h->safe ? "" : "  too slow");
+        }
+    }
+    if (result->best_pclk_hz) {
+        printf("Recommended: CONFIG_EXAMPLE_LCD_RGB_BOUNCE_BUFFER_HEIGHT=%u (%lu KB internal RAM) at ",
+               result->best_lines, (unsigned long)(2 * result->best_lines * LVGL_PORT_H_RES * sizeof(lv_color_t) / 1024));
+        scan_print_mhz("", result->best_pclk_hz, ", EXAMPLE_LCD_PIXEL_CLOCK_HZ\n");
+    } else {
+        printf("No safe configuration in this range\n");
+    }
+    free(result);
+    return 0;
+}
+
+typedef enum {
+    BLEND_FILL,
+    BLEND_COPY,
+    BLEND_FILL_OPA,
+    BLEND_COPY_OPA,
+    BLEND_FILL_MASK,
+    BLEND_KERNEL_COUNT,
+} blend_kernel_t;
+
+static const char *const blend_kernel_names[BLEND_KERNEL_COUNT] = {
+    "fill", "copy", "fill opa", "copy opa", "fill mask",
+};
+
+/* One pass of a kernel over a w x h area of the full-width buffers */
+static void blend_run(blend_kernel_t kernel, uint16_t *dst, const uint16_t *src, const uint8_t *mask, int w, int h,
+                      uint16_t color)
+{
+    const int stride = LVGL_PORT_H_RES;
+    switch (kernel) {
+    case BLEND_FILL:
+        rgb565_fill(dst, stride, w, h, color);
+        break;
+    case BLEND_COPY:
+        rgb565_copy(dst, stride, src, stride, w, h);
+        break;
+    case BLEND_FILL_OPA:
+        rgb565_fill_mix(dst, stride, w, h, color, 128, NULL, 0);
+        break;
+    case BLEND_COPY_OPA:
+        rgb565_copy_mix(dst, stride, src, stride, w, h, 128);
+        break;
+    default:
+        rgb565_fill_mix(dst, stride, w, h, color, 255, mask, stride);
+        break;
+    }
+}
+
+/* MPix/s x100 of one kernel over the whole buffer, with the LVGL lock held by the caller */
+static uint32_t blend_time(blend_kernel_t kernel, uint16_t *dst, const uint16_t *src, const uint8_t *mask)
+{
+    const int w = LVGL_PORT_H_RES;
+    const int h = BLEND_BENCH_LINES;
+    const int64_t start_us = esp_timer_get_time();
+    for (int i = 0; i < BLEND_BENCH_PASSES; i++) {
+        blend_run(kernel, dst, src, mask, w, h, 0x2C5F ^ (i * 0x0821));  // A new color each pass, so no result is cached
+    }
+    const uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+    return (uint32_t)((uint64_t)w * h * BLEND_BENCH_PASSES * 100 / (elapsed_us ? elapsed_us : 1));
+}
+
+/* Test pattern. Glyph-like mask: runs of transparent and opaque pixels with anti-aliased edges */
+static void blend_pattern(uint16_t *dst, uint16_t *src, uint8_t *mask, size_t px)
+{
+    uint32_t rng = 0x2545F491;
+    for (size_t i = 0; i < px; i++) {
+        rng = rng * 1664525 + 1013904223;
+        src[i] = (uint16_t)(rng >> 16);
+        dst[i] = (uint16_t)rng;
+        mask[i] = (i % 16 < 6) ? 0 : (i % 16 < 13) ? 255 : (uint8_t)(rng >> 24);
+    }
+}
+
+/*
+ * Run a kernel once with PIE into `dst` and once with C into `ref`, both starting from the test pattern, and return
+ * the number of pixels that differ. The area starts 3 pixels into each line and is 7 pixels narrower than the buffer,
+ * so the unaligned row ends are covered too. `*first` is the index of the first differing pixel.
+ */
+static uint32_t blend_verify(blend_kernel_t kernel, uint16_t *dst, uint16_t *ref, uint16_t *src, uint8_t *mask,
+                             size_t *first)
+{
+    const size_t px = LVGL_PORT_H_RES * BLEND_BENCH_LINES;
+    const int ofs = 3;
+    blend_pattern(dst, src, mask, px);
+    memcpy(ref, dst, px * sizeof(uint16_t));
+    rgb565_blend_set_simd(true);
+    blend_run(kernel, dst + ofs, src + ofs, mask + ofs, LVGL_PORT_H_RES - 7, BLEND_BENCH_LINES, 0x2C5F);
+    rgb565_blend_set_simd(false);
+    blend_run(kernel, ref + ofs, src + ofs, mask + ofs, LVGL_PORT_H_RES - 7, BLEND_BENCH_LINES, 0x2C5F);
+    if (!memcmp(dst, ref, px * sizeof(uint16_t))) {
+        return 0;
+    }
+    uint32_t diff = 0;
+    for (size_t i = px; i-- > 0;) {
+        if (dst[i] != ref[i]) {
+            diff++;
+            *first = i;
+        }
+    }
+    return diff;
+}
+
+static int blend_usage(void)
+{
+    printf("usage: blend bench [internal|psram]\n");
+    return 1;
+}
+
+static int cmd_blend(int argc, char **argv)
+{
+    if (argc < 2 || argc > 3 || strcmp(argv[1], "bench")) {
+        return blend_usage();
+    }
+    uint32_t caps = MALLOC_CAP_INTERNAL;
+    if (argc == 3 && !strcmp(argv[2], "psram")) {
+        caps = MALLOC_CAP_SPIRAM;
+    } else if (argc == 3 && strcmp(argv[2], "internal")) {
+        return blend_usage();
+    }
+    const size_t px = LVGL_PORT_H_RES * BLEND_BENCH_LINES;
+    uint16_t *dst = heap_caps_aligned_alloc(16, px * sizeof(uint16_t), caps);
+    uint16_t *ref = heap_caps_aligned_alloc(16, px * sizeof(uint16_t), caps);
+    uint16_t *src = heap_caps_aligned_alloc(16, px * sizeof(uint16_t), caps);
+    uint8_t *mask = heap_caps_malloc(px, MALLOC_CAP_INTERNAL);
+    if (!dst || !ref || !src || !mask) {
+        printf("no memory for the test buffers\n");
+        heap_caps_free(dst);
+        heap_caps_free(ref);
+        heap_caps_free(src);
+        heap_caps_free(mask);
+        return 1;
+    }
+    blend_pattern(dst, src, mask, px);
+
+    uint32_t simd[BLEND_KERNEL_COUNT] = { 0 };
+    uint32_t portable[BLEND_KERNEL_COUNT] = { 0 };
+    uint32_t diff[BLEND_KERNEL_COUNT] = { 0 };
+    size_t first[BLEND_KERNEL_COUNT] = { 0 };
+    bool has_simd = false;
+    if (lvgl_port_lock(-1)) {
+        /* The kernels share static staging buffers and the setting with the renderer */
+        const bool prev = rgb565_blend_set_simd(true);
+        has_simd = rgb565_blend_get_simd();
+        for (int k = 0; k < BLEND_KERNEL_COUNT; k++) {
+            if (has_simd) {
+                diff[k] = blend_verify((blend_kernel_t)k, dst, ref, src, mask, &first[k]);
+                rgb565_blend_set_simd(true);
+                simd[k] = blend_time((blend_kernel_t)k, dst, src, mask);
+            }
+            rgb565_blend_set_simd(false);
+            portable[k] = blend_time((blend_kernel_t)k, dst, src, mask);
+            rgb565_blend_set_simd(true);
+        }
+        rgb565_blend_set_simd(prev);
+        lvgl_port_unlock();
+    }
+    heap_caps_free(dst);
+    heap_caps_free(ref);
+    heap_caps_free(src);
+    heap_caps_free(mask);
+
+    printf("%d x %d px in %s RAM, %d passes per kernel\n", LVGL_PORT_H_RES, BLEND_BENCH_LINES,
+           (caps == MALLOC_CAP_SPIRAM) ? "PSRAM" : "internal", BLEND_BENCH_PASSES);
+    if (!has_simd) {
+        printf("PIE kernels not built (CONFIG_EXAMPLE_LVGL_PORT_PIE_BLEND), timing C only\n");
+    }
+    printf("  kernel     PIE MPix/s   C MPix/s  PIE vs C\n");
+    uint32_t mismatches = 0;
+    for (int k = 0; k < BLEND_KERNEL_COUNT; k++) {
+        printf("  %-9s  ", blend_kernel_names[k]);
+        if (has_simd) {
+            printf("%7lu.%02lu", (unsigned long)(simd[k] / 100), (unsigned long)(simd[k] % 100));
+        } else {
+            printf("%10s", "-");
+        }
+        printf("  %6lu.%02lu", (unsigned long)(portable[k] / 100), (unsigned long)(portable[k] % 100));
+        if (!has_simd) {
+            printf("  -\n");
+        } else if (diff[k]) {
+            printf("  MISMATCH %lu px, first at line %u x %u\n", (unsigned long)diff[k],
+                   (unsigned)(first[k] / LVGL_PORT_H_RES), (unsigned)(first[k] % LVGL_PORT_H_RES));
+        } else {
+            printf("  same\n");
+        }
+        mismatches += diff[k];
+    }
+    return mismatches ? 1 : 0;
+}
+
+static int cmd_scan(int argc, char **argv)
+{
+    if (argc >= 2 && !strcmp(argv[1], "calibrate") && argc <= 5) {
+        return scan_calibrate(argc, argv);
+    }
+    if (argc != 2 || strcmp(argv[1], "stats")) {
+        return scan_usage();
+    }
+    scan_mon_stats_t stats;
+    scan_mon_get_stats(&stats, false);
+    scan_print_mhz("pclk=", stats.pclk_hz, "");
+    printf(" frames=%lu bounce_frames=%lu deadline_us=%lu excess_us_max=%lu late=%lu underruns=%lu drifts=%lu\n",
+           (unsigned long)stats.vsyncs, (unsigned long)stats.bounce_frames, (unsigned long)stats.deadline_us,
+           (unsigned long)stats.excess_us_max, (unsigned long)stats.late, (unsigned long)stats.underruns,
+           (unsigned long)stats.drifts);
+    return 0;
+}
+
+esp_err_t app_console_start(void)
+{
+    esp_console_repl_t *repl = NULL;
+    esp_console_repl_config_t repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    repl_config.prompt = "unictl>";
+    repl_config.task_stack_size = 6 * 1024; // The benchmark report formats lines on this stack
+
+    const esp_console_cmd_t bench_cmd = {
+        .command = "bench",
+        .help = "Run a UI benchmark: bench <log_flood|status_rate|button_relabel|mixed|plot_stream> [duration_ms] [rate_hz] [csv|json]",
+        .hint = NULL,
+        .func = cmd_bench,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&bench_cmd));
+    const esp_console_cmd_t touch_trace_cmd = {
+        .command = "touch_trace",
+        .help = "Print touch samples as simulator script lines: touch_trace <on|off>",
+        .hint = NULL,
+        .func = cmd_touch_trace,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&touch_trace_cmd));
+    const esp_console_cmd_t log_cmd = {
+        .command = "log",
+        .help = "Search the on-screen log history: log find <text> [error|warn|info|debug] | log err | "
+                "log jump <hh:mm:ss[.mmm]> | log latest | log stats",
+        .hint = NULL,
+        .func = cmd_log,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&log_cmd));
+    const esp_console_cmd_t scan_cmd = {
+        .command = "scan",
+        .help = "RGB scan-out counters, or sweep the pixel clock and bounce buffer height under a full-screen redraw: "
+                "scan stats | scan calibrate [min_mhz max_mhz] [step_ms]",
+        .hint = NULL,
+        .func = cmd_scan,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&scan_cmd));
+    const esp_console_cmd_t blend_cmd = {
+        .command = "blend",
+        .help = "Time the RGB565 fill, copy and blend kernels of the renderer, PIE against C: blend bench [internal|psram]",
+        .hint = NULL,
+        .func = cmd_blend,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&blend_cmd));
+    ESP_ERROR_CHECK(esp_console_register_help_command());
+
+#if defined(CONFIG_ESP_CONSOLE_UART_DEFAULT) || defined(CONFIG_ESP_CONSOLE_UART_CUSTOM)
+    esp_console_dev_uart_config_t hw_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+    esp_err_t ret = esp_console_new_repl_uart(&hw_config, &repl_config, &repl);
+#elif defined(CONFIG_ESP_CONSOLE_USB_CDC)
+    esp_console_dev_usb_cdc_config_t hw_config = ESP_CONSOLE_DEV_CDC_CONFIG_DEFAULT();
+    esp_err_t ret = esp_console_new_repl_usb_cdc(&hw_config, &repl_config, &repl);
+#elif defined(CONFIG_ESP_CONSOLE_USB_SERIAL_JTAG)
+    esp_console_dev_usb_serial_jtag_config_t hw_config = ESP_CONSOLE_DEV_USB_SERIAL_JTAG_CONFIG_DEFAULT();
+    esp_err_t ret = esp_console_new_repl_usb_serial_jtag(&hw_config, &repl_config, &repl);
+#else
+    esp_err_t ret = ESP_ERR_NOT_SUPPORTED;
+#endif
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create console REPL: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    return esp_console_start_repl(repl);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start the serial console REPL and register the application commands
+ *
+ * Commands:
+ *      - bench <workload> [duration_ms] [rate_hz] [csv|json]: run a UI benchmark, see ui_bench.h
+ *      - touch_trace <on|off>: print touch samples as host simulator script lines, see touch_sampler.h
+ *      - log <find|err|jump|latest|stats> ...: search the on-screen log history or jump to a time, see ui_log.h
+ *      - scan <stats|calibrate> ...: bounce buffer refill counters, pixel clock / bounce height sweep, see scan_mon.h
+ *
+ * @note Call after `lvgl_port_init()`, the commands take the LVGL lock
+ *
+ * @return
+ *      - ESP_OK: Success
+ *      - Others: Fail
+ */
+esp_err_t app_console_start(void);
+
+#ifdef __cplusplus
+}
+#endif
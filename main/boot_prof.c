@@ -0,0 +1,114 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "boot_prof.h"
+
+static const char *TAG = "boot";                         // Tag for logging
+
+typedef struct {
+    const char *name;
+    int64_t start_us;
+    int64_t end_us;                                      // -1 while running
+    int core;
+    bool mark;                                           // A point in time, not a phase
+} boot_prof_phase_t;
+
+static portMUX_TYPE prof_lock = portMUX_INITIALIZER_UNLOCKED;
+static boot_prof_phase_t phases[BOOT_PROF_MAX_PHASES];
+static int phase_count = 0;
+static int64_t origin_us = -1;                           // Start of the first phase, the top of app_main()
+
+static int add_phase(const char *name, bool mark)
+{
+    const int64_t now_us = esp_timer_get_time();
+    int id = -1;
+    portENTER_CRITICAL(&prof_lock);
+    if (origin_us < 0) {
+        origin_us = now_us;
+    }
+    if (phase_count < BOOT_PROF_MAX_PHASES) {
+        id = phase_count++;
+        phases[id] = (boot_prof_phase_t) {
+            .name = name,
+            .start_us = now_us,
+            .end_us = mark ? now_us : -1,
+            .core = esp_cpu_get_core_id(),
+            .mark = mark,
+        };
+    }
+    portEXIT_CRITICAL(&prof_lock);
+    return id;
+}
+
+int boot_prof_begin(const char *name)
+{
+    return add_phase(name, false);
+}
+
+void boot_prof_end(int id)
+{
+    if (id < 0 || id >= BOOT_PROF_MAX_PHASES) {
+        return;
+    }
+    const int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&prof_lock);
+    phases[id].end_us = now_us;
+    portEXIT_CRITICAL(&prof_lock);
+}
+
+void boot_prof_mark(const char *name)
+{
+    add_phase(name, true);
+}
+
+int64_t boot_prof_elapsed_us(void)
+{
+    return origin_us < 0 ? 0 : esp_timer_get_time() - origin_us;
+}
+
+static int compare_start(const void *a, const void *b)
+{
+    const int64_t sa = ((const boot_prof_phase_t *)a)->start_us;
+    const int64_t sb = ((const boot_prof_phase_t *)b)->start_us;
+    return (sa > sb) - (sa < sb);
+}
+
+void boot_prof_report(void)
+{
+    boot_prof_phase_t copy[BOOT_PROF_MAX_PHASES];
+    portENTER_CRITICAL(&prof_lock);
+    const int count = phase_count;
+    const int64_t origin = origin_us;
+    for (int i = 0; i < count; i++) {
+        copy[i] = phases[i];
+    }
+    portEXIT_CRITICAL(&prof_lock);
+    if (count == 0) {
+        return;
+    }
+    qsort(copy, count, sizeof(copy[0]), compare_start);
+
+    /* esp_timer starts counting in the second stage bootloader handoff, before app_main() */
+    ESP_LOGI(TAG, "app_main() at %lu.%lu ms, phases relative to it:", (unsigned long)(origin / 1000),
+             (unsigned long)(origin % 1000 / 100));
+    ESP_LOGI(TAG, "   start ms     dur ms  core  phase");
+    for (int i = 0; i < count; i++) {
+        const boot_prof_phase_t *p = &copy[i];
+        const int64_t start = p->start_us - origin;
+        if (p->mark) {
+            ESP_LOGI(TAG, "%7lu.%lu          -     %d  %s", (unsigned long)(start / 1000),
+                     (unsigned long)(start % 1000 / 100), p->core, p->name);
+        } else if (p->end_us < 0) {
+            ESP_LOGI(TAG, "%7lu.%lu    running     %d  %s", (unsigned long)(start / 1000),
+                     (unsigned long)(start % 1000 / 100), p->core, p->name);
+        } else {
+            const int64_t dur = p->end_us - p->start_us;
+            ESP_LOGI(TAG, "%7lu.%lu  %7lu.%lu     %d  %s", (unsigned long)(start / 1000),
+                     (unsigned long)(start % 1000 / 100), (unsigned long)(dur / 1000),
+                     (unsigned long)(dur % 1000 / 100), p->core, p->name);
+        }
+    }
+}
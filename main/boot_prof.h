@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Boot profiler: start and end time of each init phase, relative to `app_main()`, and the core it ran on.
+ * Phases may run on several tasks at once; begin / end are safe from any task, not from ISR.
+ *
+ */
+#define BOOT_PROF_MAX_PHASES    (24)
+
+/**
+ * @brief Start a phase
+ *
+ * @param[in] name: String constant, printed by `boot_prof_report()`
+ *
+ * @return
+ *      - Phase id for `boot_prof_end()`, -1 once BOOT_PROF_MAX_PHASES phases are recorded
+ */
+int boot_prof_begin(const char *name);
+
+/**
+ * @brief End a phase, ignores -1
+ */
+void boot_prof_end(int id);
+
+/**
+ * @brief Record a point in time, printed as a phase without duration
+ */
+void boot_prof_mark(const char *name);
+
+/**
+ * @brief Time since the start of `app_main()`, in us
+ */
+int64_t boot_prof_elapsed_us(void);
+
+/**
+ * @brief Print every phase in order of start time, phases that have not ended yet are marked as running
+ */
+void boot_prof_report(void);
+
+#ifdef __cplusplus
+}
+#endif
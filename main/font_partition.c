@@ -0,0 +1,74 @@
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "font_partition.h"
+#include "ui_font.h"
+
+static const char *TAG = "font";                         // Tag for logging
+
+#define FONT_CACHE_HOT_BYTES        (CONFIG_EXAMPLE_FONT_CACHE_HOT_KB * 1024)
+#define FONT_CACHE_PSRAM_BYTES      (CONFIG_EXAMPLE_FONT_CACHE_PSRAM_KB * 1024)
+#define FONT_CACHE_SLOT_BYTES       (CONFIG_EXAMPLE_FONT_CACHE_SLOT_BYTES)
+
+static const esp_partition_t *font_part = NULL;
+static const uint8_t *font_map = NULL;                   // Whole partition mapped through the MMU, NULL if not mapped
+static ui_font_t font;
+
+/* A mapped partition is read through the data cache, only on glyph cache misses. Without a mapping the read goes
+ * through the flash driver. */
+static bool font_read(void *ctx, uint32_t offset, void *buf, uint32_t len)
+{
+    if (offset > font_part->size || len > font_part->size - offset) {
+        return false;
+    }
+    if (font_map) {
+        memcpy(buf, font_map + offset, len);
+        return true;
+    }
+    return esp_partition_read(font_part, offset, buf, len) == ESP_OK;
+}
+
+const lv_font_t *font_partition_load(const lv_font_t *fallback, perf_hist_t *fetch_hist)
+{
+    font_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                         CONFIG_EXAMPLE_FONT_PARTITION_LABEL);
+    if (!font_part) {
+        ESP_LOGI(TAG, "No \"%s\" partition, using the built-in fonts", CONFIG_EXAMPLE_FONT_PARTITION_LABEL);
+        return NULL;
+    }
+    esp_partition_mmap_handle_t map_handle;
+    const void *map = NULL;
+    if (esp_partition_mmap(font_part, 0, font_part->size, ESP_PARTITION_MMAP_DATA, &map, &map_handle) == ESP_OK) {
+        font_map = map;
+    } else {
+        ESP_LOGW(TAG, "Cannot map the font partition, reading it through the flash driver");
+    }
+
+    ui_font_cache_config_t cache_cfg = {
+        .hot_mem = heap_caps_malloc(FONT_CACHE_HOT_BYTES, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT),
+        .hot_size = FONT_CACHE_HOT_BYTES,
+        .lru_mem = heap_caps_malloc(FONT_CACHE_PSRAM_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT),
+        .lru_size = FONT_CACHE_PSRAM_BYTES,
+        .slot_bytes = FONT_CACHE_SLOT_BYTES,
+        .fetch_hist = fetch_hist,
+    };
+    if (!cache_cfg.hot_mem && !cache_cfg.lru_mem) {
+        ESP_LOGW(TAG, "No memory for the glyph cache, every glyph will be read from flash");
+    }
+    ui_font_src_t src = {
+        .read = font_read,
+    };
+    if (!ui_font_cache_init(&cache_cfg) || !ui_font_open(&font, &src, fallback)) {
+        ESP_LOGW(TAG, "No usable font in the \"%s\" partition, using the built-in fonts", font_part->label);
+        if (font_map) {
+            esp_partition_munmap(map_handle);
+            font_map = NULL;
+        }
+        ui_font_cache_init(&(ui_font_cache_config_t) { 0 }); // Drop the cache before freeing its memory
+        heap_caps_free(cache_cfg.hot_mem);
+        heap_caps_free(cache_cfg.lru_mem);
+        return NULL;
+    }
+    return &font.font;
+}
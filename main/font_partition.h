@@ -0,0 +1,30 @@
+#pragma once
+
+#include "lvgl.h"
+#include "perf_hist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Font stored in a flash data partition (`CONFIG_EXAMPLE_FONT_PARTITION_LABEL`), written from a file made with
+ * `lv_font_conv --format bin --no-compress`. Only the character map and glyph offsets are loaded; glyphs are
+ * copied on first use into the `ui_font` cache: an LRU in PSRAM and a small hot set in internal RAM.
+ *
+ */
+
+/**
+ * @brief Open the partition font and allocate the glyph cache, call from the LVGL task with the lock held
+ *
+ * @param[in] fallback: Font for the characters the partition font does not have
+ * @param[in] fetch_hist: Optional histogram of the glyph fetch time, in us
+ *
+ * @return
+ *      - The font to use, NULL if the partition is missing or does not hold a usable font
+ */
+const lv_font_t *font_partition_load(const lv_font_t *fallback, perf_hist_t *fetch_hist);
+
+#ifdef __cplusplus
+}
+#endif
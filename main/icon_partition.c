@@ -0,0 +1,69 @@
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "icon_partition.h"
+#include "ui_icon.h"
+
+static const char *TAG = "icons";                        // Tag for logging
+
+#define ICON_CACHE_PSRAM_BYTES      (CONFIG_EXAMPLE_ICON_CACHE_PSRAM_KB * 1024)
+
+static const esp_partition_t *icon_part = NULL;
+static const uint8_t *icon_map = NULL;                   // Whole partition mapped through the MMU, NULL if not mapped
+
+/* Pages are decoded once per cache miss, so a mapped partition is read through the data cache only then */
+static bool icon_read(void *ctx, uint32_t offset, void *buf, uint32_t len)
+{
+    if (offset > icon_part->size || len > icon_part->size - offset) {
+        return false;
+    }
+    if (icon_map) {
+        memcpy(buf, icon_map + offset, len);
+        return true;
+    }
+    return esp_partition_read(icon_part, offset, buf, len) == ESP_OK;
+}
+
+static void *icon_alloc(size_t size)
+{
+    return heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+}
+
+bool icon_partition_load(perf_hist_t *decode_hist)
+{
+    icon_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                         CONFIG_EXAMPLE_ICON_PARTITION_LABEL);
+    if (!icon_part) {
+        ESP_LOGI(TAG, "No \"%s\" partition, buttons and status items show no icons",
+                 CONFIG_EXAMPLE_ICON_PARTITION_LABEL);
+        return false;
+    }
+    esp_partition_mmap_handle_t map_handle;
+    const void *map = NULL;
+    if (esp_partition_mmap(icon_part, 0, icon_part->size, ESP_PARTITION_MMAP_DATA, &map, &map_handle) == ESP_OK) {
+        icon_map = map;
+    } else {
+        ESP_LOGW(TAG, "Cannot map the icon partition, reading it through the flash driver");
+    }
+
+    const ui_icon_cache_config_t cache_cfg = {
+        .alloc = icon_alloc,
+        .free = heap_caps_free,
+        .budget = ICON_CACHE_PSRAM_BYTES,
+        .decode_hist = decode_hist,
+    };
+    const ui_icon_src_t src = {
+        .read = icon_read,
+    };
+    if (!ui_icon_open(&src, &cache_cfg)) {
+        ESP_LOGW(TAG, "No usable atlas in the \"%s\" partition, buttons and status items show no icons",
+                 icon_part->label);
+        if (icon_map) {
+            esp_partition_munmap(map_handle);
+            icon_map = NULL;
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdbool.h>
+#include "perf_hist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Icon atlas stored in a flash data partition (`CONFIG_EXAMPLE_ICON_PARTITION_LABEL`), written from a file made with
+ * `sim/scripts/iconpack.py`. Only the page and icon tables are loaded; a page is decoded on first use into the
+ * `ui_icon` cache, an LRU of decoded pages in PSRAM with a byte budget.
+ *
+ */
+
+/**
+ * @brief Open the partition atlas for `ui_set_button_icon()` and `ui_set_status_icon()`, call from the LVGL task
+ *        with the lock held
+ *
+ * @param[in] decode_hist: Optional histogram of the page decode time, in us
+ *
+ * @return
+ *      - true if the atlas is usable, false if the partition is missing or does not hold an atlas
+ */
+bool icon_partition_load(perf_hist_t *decode_hist);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,128 @@
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_memory_utils.h"
+#include "esp_timer.h"
+#include "log_bridge.h"
+
+static const char *TAG = "log_bridge";                   // Tag for logging
+
+#if CONFIG_EXAMPLE_LOG_BRIDGE_ENABLE
+#define LOG_BRIDGE_LEVEL            (CONFIG_EXAMPLE_LOG_BRIDGE_LEVEL)
+#define LOG_BRIDGE_RATE             (CONFIG_EXAMPLE_LOG_BRIDGE_RATE)
+#define LOG_BRIDGE_BURST            (CONFIG_EXAMPLE_LOG_BRIDGE_BURST)
+#define LOG_BRIDGE_FLUSH_MS         (1000)               // Period of the suppression summaries
+#define LOG_BRIDGE_STATS_PERIOD_MS  (10 * 1000)
+#define LOG_BRIDGE_CPU_MHZ          (CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ)
+
+static vprintf_like_t console_vprintf = NULL;            // The hook that was installed before, prints on the console
+static _Atomic uint32_t hook_calls = 0;                  // Hook cost since the last report, in CPU cycles
+static _Atomic uint32_t hook_cycles = 0;
+static _Atomic uint32_t hook_cycles_max = 0;
+
+/* Format strings and tags in flash rodata stay valid, anything else is formatted on the spot */
+static bool is_static(const void *ptr)
+{
+    return esp_ptr_in_drom(ptr);
+}
+
+static int log_bridge_vprintf(const char *fmt, va_list ap)
+{
+    va_list copy;
+    va_copy(copy, ap);
+    const uint32_t start = esp_cpu_get_cycle_count();
+    ui_log_bridge_write(fmt, copy);
+    const uint32_t cycles = esp_cpu_get_cycle_count() - start;
+    va_end(copy);
+
+    atomic_fetch_add_explicit(&hook_calls, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&hook_cycles, cycles, memory_order_relaxed);
+    uint32_t max = atomic_load_explicit(&hook_cycles_max, memory_order_relaxed);
+    while (cycles > max && !atomic_compare_exchange_weak_explicit(&hook_cycles_max, &max, cycles,
+                                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+    return console_vprintf(fmt, ap);
+}
+
+static void report_stats(void)
+{
+    static ui_log_bridge_stats_t last;
+    ui_log_bridge_stats_t stats;
+    ui_log_bridge_get_stats(&stats);
+    const uint32_t calls = atomic_exchange_explicit(&hook_calls, 0, memory_order_relaxed);
+    const uint32_t cycles = atomic_exchange_explicit(&hook_cycles, 0, memory_order_relaxed);
+    const uint32_t cycles_max = atomic_exchange_explicit(&hook_cycles_max, 0, memory_order_relaxed);
+    if (calls == 0) {
+        return;
+    }
+    /* This line goes through the hook as well, so every report adds one call */
+    ESP_LOGI(TAG, "%lu lines: shown=%lu filtered=%lu suppressed=%lu (%lu summaries) queue_full=%lu formatted=%lu "
+             "tags=%lu, hook avg %lu ns max %lu ns", (unsigned long)calls,
+             (unsigned long)(stats.shown - last.shown), (unsigned long)(stats.filtered - last.filtered),
+             (unsigned long)(stats.suppressed - last.suppressed), (unsigned long)(stats.summaries - last.summaries),
+             (unsigned long)(stats.queue_full - last.queue_full), (unsigned long)(stats.formatted - last.formatted),
+             (unsigned long)stats.tags, (unsigned long)(cycles / calls * 1000 / LOG_BRIDGE_CPU_MHZ),
+             (unsigned long)(cycles_max * 1000ULL / LOG_BRIDGE_CPU_MHZ));
+    last = stats;
+}
+
+static void flush_timer_cb(void *arg)
+{
+    static uint32_t ticks = 0;
+    ui_log_bridge_flush();
+    if (++ticks >= LOG_BRIDGE_STATS_PERIOD_MS / LOG_BRIDGE_FLUSH_MS) {
+        ticks = 0;
+        report_stats();
+    }
+}
+
+esp_err_t log_bridge_start(void)
+{
+    const ui_log_bridge_config_t config = {
+        .level = (ui_log_level_t)LOG_BRIDGE_LEVEL,
+        .rate_per_s = LOG_BRIDGE_RATE,
+        .burst = LOG_BRIDGE_BURST,
+        .is_static = is_static,
+    };
+    ui_log_bridge_init(&config);
+
+    const esp_timer_create_args_t flush_timer_args = {
+        .callback = flush_timer_cb,
+        .name = "log bridge",
+    };
+    esp_timer_handle_t flush_timer = NULL;
+    esp_err_t ret = esp_timer_create(&flush_timer_args, &flush_timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Create flush timer failed");
+        return ret;
+    }
+    ret = esp_timer_start_periodic(flush_timer, LOG_BRIDGE_FLUSH_MS * 1000);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Start flush timer failed");
+        esp_timer_delete(flush_timer);
+        return ret;
+    }
+    console_vprintf = esp_log_set_vprintf(log_bridge_vprintf);
+    ESP_LOGI(TAG, "ESP_LOGx up to level %d on screen, %d lines/s per tag, burst %d", LOG_BRIDGE_LEVEL,
+             LOG_BRIDGE_RATE, LOG_BRIDGE_BURST);
+    return ESP_OK;
+}
+
+void log_bridge_get_stats(ui_log_bridge_stats_t *stats)
+{
+    ui_log_bridge_get_stats(stats);
+}
+#else
+esp_err_t log_bridge_start(void)
+{
+    ESP_LOGI(TAG, "Disabled in menuconfig");
+    return ESP_OK;
+}
+
+void log_bridge_get_stats(ui_log_bridge_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+}
+#endif
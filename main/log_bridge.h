@@ -0,0 +1,35 @@
+#pragma once
+
+#include "esp_err.h"
+#include "ui_log_bridge.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * ESP_LOGx output on the screen: a `esp_log_set_vprintf` hook hands every log line to `ui_log_bridge.h`
+ * (level filter, per-tag token bucket) and then prints it on the console as before. The hook never waits
+ * and never takes the LVGL lock, lines that do not fit the command queue are dropped.
+ *
+ */
+
+/**
+ * @brief Install the log hook and start the timer that writes the "N messages suppressed" summaries
+ *
+ * @note Lines logged before `lvgl_port_init()` are only printed on the console
+ *
+ * @return
+ *      - ESP_OK: Success, or the bridge is disabled in menuconfig
+ *      - Others: Fail
+ */
+esp_err_t log_bridge_start(void);
+
+/**
+ * @brief Copy the bridge counters
+ */
+void log_bridge_get_stats(ui_log_bridge_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
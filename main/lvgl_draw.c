@@ -0,0 +1,83 @@
+#include "lvgl_draw.h"
+#include "rgb565_blend.h"
+#include "src/draw/sw/lv_draw_sw.h"
+
+/* The kernels round like `lv_color_mix()` only in this configuration, otherwise LVGL keeps blending */
+#define LVGL_DRAW_KERNELS   (LV_COLOR_DEPTH == 16 && !LV_COLOR_16_SWAP && \
+                             LV_COLOR_MIX_ROUND_OFS == RGB565_BLEND_ROUND_OFS)
+
+static lvgl_draw_stats_t stats;                          // Only written by the LVGL task
+
+#if LVGL_DRAW_KERNELS
+/**
+ * The same steps as `lv_draw_sw_blend_basic()`: clip to the draw context, offset the buffers to the clipped
+ * area, then pick the kernel. LVGL treats an opacity of LV_OPA_MAX or more as opaque.
+ *
+ */
+static void draw_blend(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc)
+{
+    const lv_opa_t *mask = dsc->mask_buf;
+    if (mask && dsc->mask_res == LV_DRAW_MASK_RES_TRANSP) {
+        return;
+    }
+    if (dsc->mask_res == LV_DRAW_MASK_RES_FULL_COVER) {
+        mask = NULL;
+    }
+
+    lv_area_t blend_area;
+    if (!_lv_area_intersect(&blend_area, dsc->blend_area, draw_ctx->clip_area)) {
+        return;
+    }
+    const lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+    if (disp->driver->set_px_cb || disp->driver->screen_transp || dsc->blend_mode != LV_BLEND_MODE_NORMAL ||
+            (mask && (dsc->src_buf || !disp->driver->antialiasing))) {
+        stats.fallback_px += lv_area_get_size(&blend_area);
+        lv_draw_sw_blend_basic(draw_ctx, dsc);
+        return;
+    }
+
+    const int w = lv_area_get_width(&blend_area);
+    const int h = lv_area_get_height(&blend_area);
+    const int dst_stride = lv_area_get_width(draw_ctx->buf_area);
+    uint16_t *dst = (uint16_t *)draw_ctx->buf + dst_stride * (blend_area.y1 - draw_ctx->buf_area->y1) +
+                    (blend_area.x1 - draw_ctx->buf_area->x1);
+    const uint8_t opa = (dsc->opa >= LV_OPA_MAX) ? 255 : dsc->opa;
+
+    if (dsc->src_buf) {
+        const int src_stride = lv_area_get_width(dsc->blend_area);
+        const uint16_t *src = (const uint16_t *)dsc->src_buf + src_stride * (blend_area.y1 - dsc->blend_area->y1) +
+                              (blend_area.x1 - dsc->blend_area->x1);
+        if (opa == 255) {
+            rgb565_copy(dst, dst_stride, src, src_stride, w, h);
+            stats.copy_px += w * h;
+        } else {
+            rgb565_copy_mix(dst, dst_stride, src, src_stride, w, h, opa);
+            stats.copy_opa_px += w * h;
+        }
+    } else if (mask) {
+        const int mask_stride = lv_area_get_width(dsc->mask_area);
+        mask += mask_stride * (blend_area.y1 - dsc->mask_area->y1) + (blend_area.x1 - dsc->mask_area->x1);
+        rgb565_fill_mix(dst, dst_stride, w, h, dsc->color.full, opa, mask, mask_stride);
+        stats.fill_mask_px += w * h;
+    } else if (opa == 255) {
+        rgb565_fill(dst, dst_stride, w, h, dsc->color.full);
+        stats.fill_px += w * h;
+    } else {
+        rgb565_fill_mix(dst, dst_stride, w, h, dsc->color.full, opa, NULL, 0);
+        stats.fill_opa_px += w * h;
+    }
+}
+#endif /* LVGL_DRAW_KERNELS */
+
+void lvgl_draw_ctx_init(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx)
+{
+    lv_draw_sw_init_ctx(drv, draw_ctx);
+#if LVGL_DRAW_KERNELS
+    ((lv_draw_sw_ctx_t *)draw_ctx)->blend = draw_blend;
+#endif
+}
+
+void lvgl_draw_get_stats(lvgl_draw_stats_t *out)
+{
+    *out = stats;
+}
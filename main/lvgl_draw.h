@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * LVGL software draw context whose blend step runs on the kernels of rgb565_blend.c: fills, opaque copies,
+ * constant-opacity blends and A8 masked fills, in the normal blend mode. Masked image blends, the other blend
+ * modes and `set_px_cb` / `screen_transp` displays fall back to `lv_draw_sw_blend_basic()`.
+ *
+ * Set `drv->draw_ctx_init = lvgl_draw_ctx_init` before `lv_disp_drv_register()`, `draw_ctx_size` keeps the
+ * default `sizeof(lv_draw_sw_ctx_t)`.
+ *
+ */
+typedef struct {
+    uint32_t fill_px;           // Opaque fills
+    uint32_t copy_px;           // Opaque image copies
+    uint32_t fill_opa_px;       // Fills with a constant opacity
+    uint32_t copy_opa_px;       // Image blends with a constant opacity
+    uint32_t fill_mask_px;      // Fills through an A8 mask
+    uint32_t fallback_px;       // Left to LVGL
+} lvgl_draw_stats_t;
+
+/**
+ * @brief `draw_ctx_init` of the display driver
+ */
+void lvgl_draw_ctx_init(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx);
+
+/**
+ * @brief Pixels blended per kernel, the counters only increase and wrap
+ */
+void lvgl_draw_get_stats(lvgl_draw_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,524 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl_mem.h"
+
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#include "esp_heap_caps.h"
+#define LVGL_MEM_POOL_BYTES     (CONFIG_EXAMPLE_LVGL_MEM_POOL_KB * 1024)
+#define LVGL_MEM_TLSF_BYTES     (CONFIG_EXAMPLE_LVGL_MEM_TLSF_KB * 1024)
+#define LVGL_MEM_SPILL_BYTES    (CONFIG_EXAMPLE_LVGL_MEM_SPILL_BYTES)
+#else
+#define LVGL_MEM_POOL_BYTES     (24 * 1024)
+#define LVGL_MEM_TLSF_BYTES     (48 * 1024)
+#define LVGL_MEM_SPILL_BYTES    (4096)
+#endif
+
+#define ALIGN_SIZE              (8)
+#define ALIGN_UP(n)             (((n) + ALIGN_SIZE - 1) & ~(size_t)(ALIGN_SIZE - 1))
+
+static bool mem_inited = false;
+static uint32_t mem_failed = 0;
+
+/* Internal SRAM for the pools and the TLSF region, PSRAM for the spill */
+static void *region_alloc(size_t size, bool internal)
+{
+#ifdef ESP_PLATFORM
+    if (internal) {
+        return heap_caps_aligned_alloc(ALIGN_SIZE, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    void *ptr = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    return ptr ? ptr : heap_caps_malloc(size, MALLOC_CAP_8BIT); // No PSRAM left, or none fitted
+#else
+    (void)internal;
+    return malloc(size);
+#endif
+}
+
+/*
+ * TLSF: free blocks are kept in segregated lists indexed by a two-level bitmap, so allocation and free are O(1)
+ * regardless of the heap state. Every block starts with a header holding the previous physical block (valid when
+ * that one is free) and the payload size with two flags in the low bits. Free blocks also link into their list.
+ */
+#define SL_LOG2                 (4)
+#define SL_COUNT                (1 << SL_LOG2)
+#define FL_SHIFT                (SL_LOG2 + 3)            // 3 = log2(ALIGN_SIZE)
+#define SMALL_BLOCK             (1 << FL_SHIFT)          // Below this, second level lists are linear
+#define FL_MAX                  (24)                     // Blocks up to 16 MB
+#define FL_COUNT                (FL_MAX - FL_SHIFT + 1)
+
+#define BLOCK_FREE              ((size_t)1)
+#define BLOCK_PREV_FREE         ((size_t)2)
+#define BLOCK_FLAGS             (BLOCK_FREE | BLOCK_PREV_FREE)
+
+typedef struct tlsf_block {
+    struct tlsf_block *prev_phys;
+    size_t size;
+    struct tlsf_block *next_free;                        // Free blocks only, overlaps the payload
+    struct tlsf_block *prev_free;
+} tlsf_block_t;
+
+#define BLOCK_HDR               (offsetof(tlsf_block_t, next_free))
+#define BLOCK_MIN               (sizeof(tlsf_block_t) - BLOCK_HDR)
+
+static struct {
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[FL_COUNT];
+    tlsf_block_t *blocks[FL_COUNT][SL_COUNT];
+    uint8_t *start;
+    uint8_t *end;
+    size_t size;
+    size_t used;
+    size_t peak;
+} tlsf;
+
+static inline int fls32(uint32_t v)
+{
+    return 31 - __builtin_clz(v);
+}
+
+static inline size_t block_size(const tlsf_block_t *block)
+{
+    return block->size & ~BLOCK_FLAGS;
+}
+
+static inline tlsf_block_t *block_next(const tlsf_block_t *block)
+{
+    return (tlsf_block_t *)((uint8_t *)block + BLOCK_HDR + block_size(block));
+}
+
+static void mapping(size_t size, int *fl, int *sl)
+{
+    if (size < SMALL_BLOCK) {
+        *fl = 0;
+        *sl = (int)(size / (SMALL_BLOCK / SL_COUNT));
+    } else {
+        int f = fls32((uint32_t)size);
+        *sl = (int)(size >> (f - SL_LOG2)) ^ SL_COUNT;
+        *fl = f - (FL_SHIFT - 1);
+    }
+}
+
+/* Round up to the next list, so any block found there is large enough */
+static void mapping_search(size_t size, int *fl, int *sl)
+{
+    if (size >= SMALL_BLOCK) {
+        size += ((size_t)1 << (fls32((uint32_t)size) - SL_LOG2)) - 1;
+    }
+    mapping(size, fl, sl);
+}
+
+static void tlsf_insert(tlsf_block_t *block)
+{
+    int fl, sl;
+    mapping(block_size(block), &fl, &sl);
+    tlsf_block_t *head = tlsf.blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = NULL;
+    if (head) {
+        head->prev_free = block;
+    }
+    tlsf.blocks[fl][sl] = block;
+    tlsf.fl_bitmap |= 1u << fl;
+    tlsf.sl_bitmap[fl] |= 1u << sl;
+}
+
+static void tlsf_remove(tlsf_block_t *block)
+{
+    int fl, sl;
+    mapping(block_size(block), &fl, &sl);
+    if (block->next_free) {
+        block->next_free->prev_free = block->prev_free;
+    }
+    if (block->prev_free) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        tlsf.blocks[fl][sl] = block->next_free;
+        if (!block->next_free) {
+            tlsf.sl_bitmap[fl] &= ~(1u << sl);
+            if (!tlsf.sl_bitmap[fl]) {
+                tlsf.fl_bitmap &= ~(1u << fl);
+            }
+        }
+    }
+}
+
+static void tlsf_init(void *mem, size_t bytes)
+{
+    uint8_t *start = (uint8_t *)ALIGN_UP((uintptr_t)mem);
+    bytes -= start - (uint8_t *)mem;
+    if (!mem || bytes < 2 * BLOCK_HDR + BLOCK_MIN) {
+        return;
+    }
+    size_t size = (bytes - 2 * BLOCK_HDR) & ~(size_t)(ALIGN_SIZE - 1);
+    tlsf_block_t *first = (tlsf_block_t *)start;
+    first->prev_phys = NULL;
+    first->size = size | BLOCK_FREE;
+    /* Zero sized, never free sentinel, so block_next() of the last block is always valid */
+    tlsf_block_t *sentinel = block_next(first);
+    sentinel->prev_phys = first;
+    sentinel->size = BLOCK_PREV_FREE;
+    tlsf_insert(first);
+    tlsf.start = start;
+    tlsf.end = (uint8_t *)sentinel;
+    tlsf.size = size + BLOCK_HDR;
+}
+
+static void *tlsf_alloc(size_t size)
+{
+    size_t adjust = size < BLOCK_MIN ? BLOCK_MIN : ALIGN_UP(size);
+    int fl, sl;
+    mapping_search(adjust, &fl, &sl);
+    if (fl >= FL_COUNT) {
+        return NULL;
+    }
+    uint32_t sl_map = tlsf.sl_bitmap[fl] & (~0u << sl);
+    if (!sl_map) {
+        uint32_t fl_map = tlsf.fl_bitmap & (~0u << (fl + 1));
+        if (!fl_map) {
+            return NULL;
+        }
+        fl = __builtin_ctz(fl_map);
+        sl_map = tlsf.sl_bitmap[fl];
+    }
+    sl = __builtin_ctz(sl_map);
+    tlsf_block_t *block = tlsf.blocks[fl][sl];
+    tlsf_remove(block);
+
+    size_t bsize = block_size(block);
+    if (bsize >= adjust + sizeof(tlsf_block_t)) {
+        /* Split, the remainder stays free; the next block already has BLOCK_PREV_FREE set */
+        tlsf_block_t *rest = (tlsf_block_t *)((uint8_t *)block + BLOCK_HDR + adjust);
+        rest->prev_phys = block;
+        rest->size = (bsize - adjust - BLOCK_HDR) | BLOCK_FREE;
+        block_next(rest)->prev_phys = rest;
+        block->size = adjust | (block->size & BLOCK_PREV_FREE);
+        tlsf_insert(rest);
+    } else {
+        block->size &= ~BLOCK_FREE;
+        block_next(block)->size &= ~BLOCK_PREV_FREE;
+    }
+    tlsf.used += block_size(block) + BLOCK_HDR;
+    if (tlsf.used > tlsf.peak) {
+        tlsf.peak = tlsf.used;
+    }
+    return (uint8_t *)block + BLOCK_HDR;
+}
+
+static void tlsf_free(void *ptr)
+{
+    tlsf_block_t *block = (tlsf_block_t *)((uint8_t *)ptr - BLOCK_HDR);
+    tlsf.used -= block_size(block) + BLOCK_HDR;
+    block->size |= BLOCK_FREE;
+    if (block->size & BLOCK_PREV_FREE) {
+        tlsf_block_t *prev = block->prev_phys;
+        tlsf_remove(prev);
+        prev->size += BLOCK_HDR + block_size(block);
+        block = prev;
+    }
+    tlsf_block_t *next = block_next(block);
+    if (next->size & BLOCK_FREE) {
+        tlsf_remove(next);
+        block->size += BLOCK_HDR + block_size(next);
+        next = block_next(block);
+    }
+    next->prev_phys = block;
+    next->size |= BLOCK_PREV_FREE;
+    tlsf_insert(block);
+}
+
+static size_t tlsf_largest_free(void)
+{
+    if (!tlsf.fl_bitmap) {
+        return 0;
+    }
+    int fl = fls32(tlsf.fl_bitmap);
+    int sl = fls32(tlsf.sl_bitmap[fl]);
+    size_t largest = 0;
+    for (tlsf_block_t *block = tlsf.blocks[fl][sl]; block; block = block->next_free) {
+        if (block_size(block) > largest) {
+            largest = block_size(block);
+        }
+    }
+    return largest;
+}
+
+/*
+ * Size-class pools: the arena is split into 1 KB pages, a page is assigned to one class when that class runs out
+ * of blocks and carved into a free list. Pages with free blocks are kept in a list per class, and a page that
+ * becomes empty goes back to the arena unless it is the last one of its class.
+ */
+#define POOL_PAGES              (LVGL_MEM_POOL_BYTES / LVGL_MEM_PAGE_SIZE)
+#define POOL_NO_CLASS           (0xFF)
+
+typedef struct {
+    void *free;                                          // Free blocks of the page
+    uint16_t used;
+    uint8_t cls;
+    int16_t prev;                                        // Partial page list of the class, or free page list
+    int16_t next;
+} pool_page_t;
+
+static const uint16_t pool_class_size[LVGL_MEM_CLASS_COUNT] = { 16, 24, 32, 48, 64, 96, 128, 192, 256 };
+static uint8_t pool_class_of[LVGL_MEM_CLASS_MAX / ALIGN_SIZE + 1];  // (size + 7) / 8 -> class
+static uint8_t *pool_arena = NULL;
+static pool_page_t pool_pages[POOL_PAGES];
+static int16_t pool_free_pages = -1;
+static int16_t pool_partial[LVGL_MEM_CLASS_COUNT];
+static lvgl_mem_class_stats_t pool_stats[LVGL_MEM_CLASS_COUNT];
+static uint32_t pool_pages_used = 0;
+
+static void pool_init(void)
+{
+    int cls = 0;
+    for (int i = 0; i <= LVGL_MEM_CLASS_MAX / ALIGN_SIZE; i++) {
+        while (pool_class_size[cls] < i * ALIGN_SIZE) {
+            cls++;
+        }
+        pool_class_of[i] = cls;
+    }
+    for (int i = 0; i < LVGL_MEM_CLASS_COUNT; i++) {
+        pool_partial[i] = -1;
+        pool_stats[i].size = pool_class_size[i];
+    }
+    pool_arena = region_alloc(POOL_PAGES * LVGL_MEM_PAGE_SIZE, true);
+    if (!pool_arena) {
+        return;
+    }
+    for (int i = POOL_PAGES - 1; i >= 0; i--) {
+        pool_pages[i].cls = POOL_NO_CLASS;
+        pool_pages[i].next = pool_free_pages;
+        pool_free_pages = i;
+    }
+}
+
+static void partial_push(int cls, int16_t index)
+{
+    pool_page_t *page = &pool_pages[index];
+    page->prev = -1;
+    page->next = pool_partial[cls];
+    if (page->next >= 0) {
+        pool_pages[page->next].prev = index;
+    }
+    pool_partial[cls] = index;
+}
+
+static void partial_unlink(int cls, int16_t index)
+{
+    pool_page_t *page = &pool_pages[index];
+    if (page->prev >= 0) {
+        pool_pages[page->prev].next = page->next;
+    } else {
+        pool_partial[cls] = page->next;
+    }
+    if (page->next >= 0) {
+        pool_pages[page->next].prev = page->prev;
+    }
+}
+
+static void *pool_alloc(int cls)
+{
+    int16_t index = pool_partial[cls];
+    if (index < 0) {
+        index = pool_free_pages;
+        if (index < 0) {
+            return NULL;
+        }
+        pool_free_pages = pool_pages[index].next;
+        pool_page_t *page = &pool_pages[index];
+        const uint32_t size = pool_class_size[cls];
+        const uint32_t count = LVGL_MEM_PAGE_SIZE / size;
+        uint8_t *base = pool_arena + (size_t)index * LVGL_MEM_PAGE_SIZE;
+        page->free = NULL;
+        for (int i = count - 1; i >= 0; i--) {
+            void **block = (void **)(base + i * size);
+            *block = page->free;
+            page->free = block;
+        }
+        page->used = 0;
+        page->cls = cls;
+        partial_push(cls, index);
+        pool_stats[cls].pages++;
+        pool_stats[cls].capacity += count;
+        pool_pages_used++;
+    }
+    pool_page_t *page = &pool_pages[index];
+    void **block = page->free;
+    page->free = *block;
+    page->used++;
+    if (!page->free) {
+        partial_unlink(cls, index);
+    }
+    lvgl_mem_class_stats_t *stats = &pool_stats[cls];
+    if (++stats->in_use > stats->peak) {
+        stats->peak = stats->in_use;
+    }
+    return block;
+}
+
+static void pool_free(void *ptr)
+{
+    int16_t index = ((uint8_t *)ptr - pool_arena) / LVGL_MEM_PAGE_SIZE;
+    pool_page_t *page = &pool_pages[index];
+    const int cls = page->cls;
+    const bool was_full = (page->free == NULL);
+    *(void **)ptr = page->free;
+    page->free = ptr;
+    page->used--;
+    pool_stats[cls].in_use--;
+    if (was_full) {
+        partial_push(cls, index);
+    }
+    if (page->used == 0 && (pool_partial[cls] != index || page->next >= 0)) {
+        partial_unlink(cls, index);
+        page->cls = POOL_NO_CLASS;
+        page->next = pool_free_pages;
+        pool_free_pages = index;
+        pool_stats[cls].pages--;
+        pool_stats[cls].capacity -= LVGL_MEM_PAGE_SIZE / pool_class_size[cls];
+        pool_pages_used--;
+    }
+}
+
+/* PSRAM spill, the size is kept in front of the block for the statistics and realloc */
+typedef struct {
+    size_t size;
+    size_t reserved;                                     // Keeps the payload 8 byte aligned
+} spill_hdr_t;
+
+static size_t spill_used = 0;
+static size_t spill_peak = 0;
+static uint32_t spill_count = 0;
+
+static void *spill_alloc(size_t size)
+{
+    spill_hdr_t *hdr = region_alloc(sizeof(spill_hdr_t) + size, false);
+    if (!hdr) {
+        return NULL;
+    }
+    hdr->size = size;
+    spill_used += size;
+    spill_count++;
+    if (spill_used > spill_peak) {
+        spill_peak = spill_used;
+    }
+    return hdr + 1;
+}
+
+static void spill_free(void *ptr)
+{
+    spill_hdr_t *hdr = (spill_hdr_t *)ptr - 1;
+    spill_used -= hdr->size;
+    spill_count--;
+#ifdef ESP_PLATFORM
+    heap_caps_free(hdr);
+#else
+    free(hdr);
+#endif
+}
+
+static inline bool in_pool(const void *ptr)
+{
+    return pool_arena && (const uint8_t *)ptr >= pool_arena &&
+           (const uint8_t *)ptr < pool_arena + POOL_PAGES * LVGL_MEM_PAGE_SIZE;
+}
+
+static inline bool in_tlsf(const void *ptr)
+{
+    return (const uint8_t *)ptr >= tlsf.start && (const uint8_t *)ptr < tlsf.end;
+}
+
+void lvgl_mem_init(void)
+{
+    if (mem_inited) {
+        return;
+    }
+    mem_inited = true;
+    pool_init();
+    tlsf_init(region_alloc(LVGL_MEM_TLSF_BYTES, true), LVGL_MEM_TLSF_BYTES);
+}
+
+void *lvgl_mem_alloc(size_t size)
+{
+    if (!mem_inited) {
+        lvgl_mem_init();
+    }
+    void *ptr = NULL;
+    if (size <= LVGL_MEM_CLASS_MAX) {
+        const int cls = pool_class_of[(size + ALIGN_SIZE - 1) / ALIGN_SIZE];
+        ptr = pool_alloc(cls);
+        if (ptr) {
+            return ptr;
+        }
+        pool_stats[cls].fallbacks++;
+    }
+    if (size < LVGL_MEM_SPILL_BYTES) {
+        ptr = tlsf_alloc(size);
+        if (ptr) {
+            return ptr;
+        }
+    }
+    ptr = spill_alloc(size);
+    if (!ptr) {
+        mem_failed++;
+    }
+    return ptr;
+}
+
+void lvgl_mem_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    if (in_pool(ptr)) {
+        pool_free(ptr);
+    } else if (in_tlsf(ptr)) {
+        tlsf_free(ptr);
+    } else {
+        spill_free(ptr);
+    }
+}
+
+void *lvgl_mem_realloc(void *ptr, size_t size)
+{
+    if (!ptr) {
+        return lvgl_mem_alloc(size);
+    }
+    size_t capacity;
+    if (in_pool(ptr)) {
+        capacity = pool_class_size[pool_pages[((uint8_t *)ptr - pool_arena) / LVGL_MEM_PAGE_SIZE].cls];
+    } else if (in_tlsf(ptr)) {
+        capacity = block_size((tlsf_block_t *)((uint8_t *)ptr - BLOCK_HDR));
+    } else {
+        capacity = ((spill_hdr_t *)ptr - 1)->size;
+    }
+    if (size <= capacity && (size >= capacity / 2 || capacity <= LVGL_MEM_CLASS_MAX)) {
+        return ptr; // Label text shrinking or growing within its block stays in place
+    }
+    void *new_ptr = lvgl_mem_alloc(size);
+    if (new_ptr) {
+        memcpy(new_ptr, ptr, size < capacity ? size : capacity);
+        lvgl_mem_free(ptr);
+    }
+    return new_ptr;
+}
+
+void lvgl_mem_get_stats(lvgl_mem_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    memcpy(stats->classes, pool_stats, sizeof(pool_stats));
+    stats->pool_pages = pool_arena ? POOL_PAGES : 0;
+    stats->pool_pages_used = pool_pages_used;
+    stats->tlsf_size = tlsf.size;
+    stats->tlsf_used = tlsf.used;
+    stats->tlsf_peak = tlsf.peak;
+    stats->tlsf_largest_free = tlsf_largest_free();
+    size_t free_bytes = tlsf.size - tlsf.used;
+    size_t largest = stats->tlsf_largest_free ? stats->tlsf_largest_free + BLOCK_HDR : 0;
+    stats->tlsf_frag_pct = free_bytes ? 100 - (uint32_t)((uint64_t)largest * 100 / free_bytes) : 0;
+    stats->spill_used = spill_used;
+    stats->spill_peak = spill_peak;
+    stats->spill_count = spill_count;
+    stats->failed = mem_failed;
+}
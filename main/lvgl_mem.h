@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Dedicated allocator for LVGL (`LV_MEM_CUSTOM_ALLOC/FREE/REALLOC`):
+ *      - Blocks up to 256 bytes come from size-class pools, 1 KB pages carved from an internal SRAM arena
+ *      - Larger blocks, and small ones once the pools are full, come from a TLSF region in internal SRAM
+ *      - Blocks of `LVGL_MEM_SPILL_BYTES` or more, or anything the TLSF region cannot hold, spill to PSRAM
+ * Not thread safe: LVGL only allocates with the LVGL lock held.
+ *
+ */
+#define LVGL_MEM_CLASS_COUNT    (9)                      // 16, 24, 32, 48, 64, 96, 128, 192, 256 bytes
+#define LVGL_MEM_CLASS_MAX      (256)
+#define LVGL_MEM_PAGE_SIZE      (1024)
+
+typedef struct {
+    uint16_t size;          // Block size of the class
+    uint16_t pages;         // Pages currently assigned to the class
+    uint32_t in_use;        // Blocks allocated
+    uint32_t peak;          // Highest `in_use`
+    uint32_t capacity;      // Blocks in the assigned pages
+    uint32_t fallbacks;     // Allocations sent to TLSF because no page was free
+} lvgl_mem_class_stats_t;
+
+typedef struct {
+    lvgl_mem_class_stats_t classes[LVGL_MEM_CLASS_COUNT];
+    uint32_t pool_pages;            // Pages in the pool arena
+    uint32_t pool_pages_used;       // Pages assigned to a class
+    size_t tlsf_size;               // Usable bytes of the TLSF region
+    size_t tlsf_used;               // Bytes allocated from TLSF, headers included
+    size_t tlsf_peak;
+    size_t tlsf_largest_free;       // Largest free TLSF block
+    uint32_t tlsf_frag_pct;         // 100 - largest free block * 100 / free bytes
+    size_t spill_used;              // Bytes allocated in PSRAM
+    size_t spill_peak;
+    uint32_t spill_count;           // PSRAM blocks alive
+    uint32_t failed;                // Allocations that returned NULL
+} lvgl_mem_stats_t;
+
+/**
+ * @brief Reserve the pool arena and the TLSF region, called again it does nothing
+ *
+ * @note Called by the first allocation, call it earlier to reserve internal SRAM before other components
+ */
+void lvgl_mem_init(void);
+
+void *lvgl_mem_alloc(size_t size);
+void lvgl_mem_free(void *ptr);
+void *lvgl_mem_realloc(void *ptr, size_t size);
+
+void lvgl_mem_get_stats(lvgl_mem_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,20 +4,494 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <stdio.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
 #include "esp_lcd_panel_ops.h"
 #include "esp_lcd_panel_rgb.h"
 #include "esp_lcd_touch.h"
 #include "esp_timer.h"
+#include "esp_cache.h"
+#include "esp_async_memcpy.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_pm.h"
 #include "lvgl.h"
 #include "lvgl_port.h"
+#include "lvgl_draw.h"
+#include "lvgl_mem.h"
+#include "lvgl_tick.h"
+#include "boot_prof.h"
+#include "font_partition.h"
+#include "icon_partition.h"
+#include "perf_hist.h"
+#include "rgb565_blend.h"
+#include "rgb565_rotate.h"
+#include "scan_mon.h"
+#include "touch_sampler.h"
+#include "ui.h"
+#include "ui_bench.h"
+#include "ui_font.h"
+#include "ui_icon.h"
 
 static const char *TAG = "lv_port";                      // Tag for logging
 static SemaphoreHandle_t lvgl_mux;                       // LVGL mutex for synchronization
 static TaskHandle_t lvgl_task_handle = NULL;             // Handle for the LVGL task
+static EventGroupHandle_t ready_events = NULL;           // LVGL_PORT_READY_* bits, set once and never cleared
+
+/* Notification bits of the LVGL task, the vsync wait and the main loop share the same notification value */
+#define LVGL_PORT_NOTIFY_VSYNC      (1 << 0)             // The RGB frame buffer has been transmitted
+#define LVGL_PORT_NOTIFY_UI_WORK    (1 << 1)             // New UI messages are pending
+
+#define LVGL_PORT_RGB_TRIPLE_BUFFER (LVGL_PORT_FULL_REFRESH && (LVGL_PORT_LCD_RGB_BUFFER_NUMS == 3) && (EXAMPLE_LVGL_PORT_ROTATION_DEGREE == 0))
+#define LVGL_PORT_SW_ROTATE         (LVGL_PORT_AVOID_TEAR_ENABLE && (EXAMPLE_LVGL_PORT_ROTATION_DEGREE != 0))
+#define LVGL_PORT_FB_SYNC           ((LVGL_PORT_DIRECT_MODE || LVGL_PORT_TILE_MODE) && EXAMPLE_LVGL_PORT_ROTATION_0)
+#define LVGL_PORT_COPY_GDMA         (LVGL_PORT_FB_SYNC && (LVGL_PORT_DIRTY_COPY_DMA || LVGL_PORT_TILE_MODE))
+
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+static perf_hist_t latency_hist;                         // API call to flushed frame latency, in us
+static perf_hist_t frame_hist;                           // Start of the LVGL pass to the return of the last flush, in us
+static perf_hist_t flush_hist;                           // Time the last flush of a frame blocks the LVGL task, in us
+static perf_hist_t touch_hist;                           // Touch INT edge to the LVGL input read, in us
+static touch_sampler_stats_t touch_last_stats;           // Touch counters at the previous report
+static ui_gesture_stats_t gesture_last_stats;            // Gesture counters at the previous report
+static uint32_t gesture_us_max;                          // Longest gesture engine pass for one sample, in us
+static ui_font_cache_stats_t font_last_stats;            // Glyph cache counters at the previous report
+static ui_icon_cache_stats_t icon_last_stats;            // Icon cache counters at the previous report
+static ui_plot_stats_t plot_last_stats;                  // Plot counters at the previous report
+static ui_log_stats_t log_last_stats;                    // Log counters at the previous report
+static scan_mon_stats_t scan_last_stats;                 // Scan-out counters at the previous report
+static lvgl_draw_stats_t draw_last_stats;                // Blend counters at the previous report
+static uint64_t render_px;                               // Pixels LVGL rendered into the PSRAM frame buffers
+static uint64_t psram_copy_bytes;                        // Bytes read and written by the dirty copy and rotation
+
+/* Octal PSRAM moves a byte per clock edge, quad PSRAM half a byte per clock */
+#if CONFIG_SPIRAM_MODE_OCT
+#define LVGL_PORT_PSRAM_PEAK_MBPS   (CONFIG_SPIRAM_SPEED * 2)
+#else
+#define LVGL_PORT_PSRAM_PEAK_MBPS   (CONFIG_SPIRAM_SPEED / 2)
+#endif
+#endif
+static perf_hist_t font_fetch_hist;                      // Glyph cache miss, read from the font partition, in us
+static bool font_loaded = false;                         // The screen uses the font from the font partition
+static perf_hist_t icon_decode_hist;                     // Icon cache miss, page decoded from the icon partition, in us
+static bool icons_loaded = false;                        // The icon partition holds a usable atlas
+static lv_indev_t *touch_indev = NULL;                   // Touchpad input device, fed by the touch sampler task
+static bool lvgl_idle = false;                           // Refresh and touch read timers are paused
+#if LVGL_PORT_IDLE_ENABLE
+static int64_t idle_start_us;                            // Start of the current idle period
+static uint64_t idle_us;                                 // Time spent idle since the last report
+#endif
+static uint32_t wakeups;                                 // LVGL task wakeups since the last report
+#if LVGL_PORT_PM_DFS
+static esp_pm_lock_handle_t pm_cpu_lock = NULL;          // Held while the LVGL task is busy
+#endif
+static lvgl_port_backlight_cb_t backlight_cb = NULL;
+static bool backlight_on = true;
+static bool touch_swallow = false;                       // The press that turned the backlight on is not passed to LVGL
+static int64_t last_touch_us;                            // Last sample with a finger down
+static int64_t frame_start_us;                           // Start of the current LVGL pass
+static uint32_t last_frame_us;                           // Start of the pass to the return of the last flush
+static uint32_t last_flush_us;                           // Time the last flush blocked the LVGL task
+
+static void wait_vsync(void)
+{
+    uint32_t bits = 0;
+    uint32_t pending = 0;
+    do {
+        xTaskNotifyWait(0, LVGL_PORT_NOTIFY_VSYNC, &bits, portMAX_DELAY);
+        pending |= bits;
+    } while (!(bits & LVGL_PORT_NOTIFY_VSYNC));
+    /* Waking up here consumed the pending state, so re-arm any UI work that arrived meanwhile */
+    if (pending & LVGL_PORT_NOTIFY_UI_WORK) {
+        xTaskNotify(xTaskGetCurrentTaskHandle(), LVGL_PORT_NOTIFY_UI_WORK, eSetBits);
+    }
+}
+
+#if LVGL_PORT_RGB_TRIPLE_BUFFER
+/**
+ * Ownership of the three RGB frame buffers, all of it is only changed under `rgb_buf_lock`:
+ *  - `lvgl_port_rgb_last_buf` is scanned out by the panel
+ *  - `lvgl_port_rgb_next_buf` was last handed to the driver, it is scanned out from the next vsync on,
+ *    equal to `lvgl_port_rgb_last_buf` if nothing is queued
+ *  - `lvgl_port_rgb_maybe_buf` is set when a vsync lands while `esp_lcd_panel_draw_bitmap()` runs: the panel
+ *    then scans out either the buffer the driver had before or the new one, so the first becomes
+ *    `lvgl_port_rgb_last_buf` and the second counts as scanned out too until the next vsync
+ *  - `lvgl_port_flush_next_buf` is none of these, LVGL renders the next frame into it
+ *
+ * The buffer is recorded as queued before the driver gets it, and the vsync ISR only moves a queued buffer to
+ * scanned out once `esp_lcd_panel_draw_bitmap()` has returned, so the bookkeeping never lags behind the panel.
+ */
+static portMUX_TYPE rgb_buf_lock = portMUX_INITIALIZER_UNLOCKED;
+static void *lvgl_port_rgb_bufs[3];
+static void *lvgl_port_rgb_last_buf = NULL;
+static void *lvgl_port_rgb_next_buf = NULL;
+static void *lvgl_port_rgb_maybe_buf = NULL;
+static void *lvgl_port_rgb_prev_buf = NULL;              // `lvgl_port_rgb_next_buf` before the running draw_bitmap
+static void *lvgl_port_flush_next_buf = NULL;
+static bool rgb_buf_in_flight = false;                   // `esp_lcd_panel_draw_bitmap()` is running
+static bool rgb_buf_waiting = false;                     // The LVGL task waits for a vsync to free a buffer
+
+/* Record `color_map` as queued, before it is handed to the driver */
+static void rgb_buf_queue(void *color_map)
+{
+    portENTER_CRITICAL(&rgb_buf_lock);
+    lvgl_port_rgb_prev_buf = lvgl_port_rgb_next_buf;
+    lvgl_port_rgb_next_buf = color_map;
+    rgb_buf_in_flight = true;
+    portEXIT_CRITICAL(&rgb_buf_lock);
+}
+
+/**
+ * Return the buffer for the next frame once the driver has `color_map`.
+ *
+ * If a previous frame is still queued it never reaches the screen, it is replaced by `color_map` and becomes
+ * the free buffer. If a vsync landed while the driver was being updated, the buffer it may have switched to
+ * is not free either; then no buffer is free and this waits for the next vsync.
+ */
+static void *rgb_buf_take_free(void *color_map)
+{
+    void *free_buf = NULL;
+    while (1) {
+        portENTER_CRITICAL(&rgb_buf_lock);
+        rgb_buf_in_flight = false;
+        for (int i = 0; i < 3; i++) {
+            void *buf = lvgl_port_rgb_bufs[i];
+            if (buf != color_map && buf != lvgl_port_rgb_last_buf && buf != lvgl_port_rgb_maybe_buf) {
+                lvgl_port_flush_next_buf = buf;
+                free_buf = buf;
+                break;
+            }
+        }
+        rgb_buf_waiting = !free_buf;
+        portEXIT_CRITICAL(&rgb_buf_lock);
+        if (free_buf) {
+            return free_buf;
+        }
+        wait_vsync();
+    }
+}
+#endif
+
+#if LVGL_PORT_DIRECT_MODE || LVGL_PORT_TILE_MODE || LVGL_PORT_SW_ROTATE
+typedef struct {
+    uint16_t count;
+    lv_area_t areas[LV_INV_BUF_SIZE];
+} lvgl_port_dirty_area_t;
+
+static lvgl_port_dirty_area_t dirty_area;
+#endif
+
+#if LVGL_PORT_DIRECT_MODE || LVGL_PORT_TILE_MODE
+static void dirty_area_collect(lvgl_port_dirty_area_t *dirty)
+{
+    lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+    dirty->count = 0;
+    for (int i = 0; i < disp->inv_p; i++) {
+        if (disp->inv_area_joined[i] == 0) {
+            dirty->areas[dirty->count++] = disp->inv_areas[i];
+        }
+    }
+
+    /* Merge rectangles as long as the union does not cover more pixels than the two separately */
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (int i = 0; i < dirty->count; i++) {
+            for (int j = i + 1; j < dirty->count; j++) {
+                lv_area_t joined;
+                _lv_area_join(&joined, &dirty->areas[i], &dirty->areas[j]);
+                if (lv_area_get_size(&joined) <= lv_area_get_size(&dirty->areas[i]) + lv_area_get_size(&dirty->areas[j])) {
+                    dirty->areas[i] = joined;
+                    dirty->areas[j--] = dirty->areas[--dirty->count];
+                    merged = true;
+                }
+            }
+        }
+    }
+}
+#endif
+
+#if LVGL_PORT_FB_SYNC
+/**
+ * In direct mode LVGL only redraws the invalidated areas of the buffer it renders to, so after each
+ * buffer switch the areas of the last frame must be copied into the other buffer, which is
+ * rendered next. Only the merged dirty rectangles are copied, full-width spans by GDMA.
+ * Tile mode writes the same areas into the hidden buffer and needs the same copy.
+ *
+ */
+#define LVGL_PORT_LINE_BYTES        (LVGL_PORT_H_RES * sizeof(lv_color_t))
+#define LVGL_PORT_FRAME_BYTES       (LVGL_PORT_LINE_BYTES * LVGL_PORT_V_RES)
+#define LVGL_PORT_DMA_MIN_BYTES     (8 * 1024)            // Smaller spans are cheaper to copy by CPU
+#define LVGL_PORT_DMA_BACKLOG       (8)
+
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+static uint64_t dirty_copy_bytes;                        // Bytes copied since the last report
+static uint64_t dirty_copy_dma_bytes;                    // Part of them copied by GDMA
+static uint32_t dirty_copy_frames;
+static uint32_t dirty_copy_max;
+#endif
+
+#if LVGL_PORT_COPY_GDMA
+static async_memcpy_handle_t copy_dma = NULL;            // GDMA memcpy engine, NULL falls back to CPU copy
+static SemaphoreHandle_t copy_done = NULL;               // Given once per finished transaction
+
+static void dma_copy_init(void)
+{
+    async_memcpy_config_t config = ASYNC_MEMCPY_DEFAULT_CONFIG();
+    config.backlog = LVGL_PORT_DMA_BACKLOG;
+    copy_done = xSemaphoreCreateCounting(LVGL_PORT_DMA_BACKLOG, 0);
+    if (!copy_done || esp_async_memcpy_install(&config, &copy_dma) != ESP_OK) {
+        ESP_LOGW(TAG, "GDMA memcpy unavailable, dirty areas are copied by CPU");
+        copy_dma = NULL;
+    }
+}
+#endif
+
+#if LVGL_PORT_DIRTY_COPY_DMA
+static int copy_inflight = 0;
+
+static IRAM_ATTR bool dma_copy_done_cb(async_memcpy_handle_t mcp, async_memcpy_event_t *event, void *cb_args)
+{
+    BaseType_t need_yield = pdFALSE;
+    xSemaphoreGiveFromISR(copy_done, &need_yield);
+    return (need_yield == pdTRUE);
+}
+
+static void dma_copy_wait_all(void)
+{
+    while (copy_inflight > 0) {
+        xSemaphoreTake(copy_done, portMAX_DELAY);
+        copy_inflight--;
+    }
+}
+
+static bool dma_copy(uint8_t *dst, uint8_t *src, size_t len)
+{
+    if (copy_dma == NULL) {
+        return false;
+    }
+    if (copy_inflight >= LVGL_PORT_DMA_BACKLOG) {
+        xSemaphoreTake(copy_done, portMAX_DELAY);
+        copy_inflight--;
+    }
+    /* Both spans are whole lines, so they are aligned to the cache line size */
+    esp_cache_msync(src, len, ESP_CACHE_MSYNC_FLAG_DIR_C2M);
+    esp_cache_msync(dst, len, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_INVALIDATE);
+    if (esp_async_memcpy(copy_dma, dst, src, len, dma_copy_done_cb, NULL) != ESP_OK) {
+        return false;
+    }
+    copy_inflight++;
+    return true;
+}
+#endif /* LVGL_PORT_DIRTY_COPY_DMA */
+
+static void dirty_area_copy(void *dst, void *src, const lvgl_port_dirty_area_t *dirty)
+{
+    uint32_t bytes = 0;
+    uint32_t dma_bytes = 0;
+    for (int i = 0; i < dirty->count; i++) {
+        const lv_area_t *area = &dirty->areas[i];
+        const size_t offset = area->y1 * LVGL_PORT_LINE_BYTES + area->x1 * sizeof(lv_color_t);
+        const size_t width_bytes = lv_area_get_width(area) * sizeof(lv_color_t);
+        const int height = lv_area_get_height(area);
+        uint8_t *to = (uint8_t *)dst + offset;
+        uint8_t *from = (uint8_t *)src + offset;
+        bytes += width_bytes * height;
+#if LVGL_PORT_DIRTY_COPY_DMA
+        if (width_bytes == LVGL_PORT_LINE_BYTES && width_bytes * height >= LVGL_PORT_DMA_MIN_BYTES &&
+                dma_copy(to, from, width_bytes * height)) {
+            dma_bytes += width_bytes * height;
+            continue;
+        }
+#endif
+        for (int y = 0; y < height; y++) {
+            memcpy(to, from, width_bytes);
+            to += LVGL_PORT_LINE_BYTES;
+            from += LVGL_PORT_LINE_BYTES;
+        }
+    }
+#if LVGL_PORT_DIRTY_COPY_DMA
+    dma_copy_wait_all();
+#endif
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+    psram_copy_bytes += 2 * bytes;
+    dirty_copy_bytes += bytes;
+    dirty_copy_dma_bytes += dma_bytes;
+    dirty_copy_frames++;
+    if (bytes > dirty_copy_max) {
+        dirty_copy_max = bytes;
+    }
+#else
+    (void)bytes;
+    (void)dma_bytes;
+#endif
+}
+
+#if LVGL_PORT_TILE_MODE
+/**
+ * LVGL renders the invalidated areas into two tiles in internal SRAM. A finished tile is written into
+ * the frame buffer that is not scanned out while LVGL renders the next one into the other tile. Tiles
+ * of whole lines are one GDMA copy, whose callback calls `lv_disp_flush_ready()`; narrower tiles are
+ * copied line by line by the CPU, their lines are not aligned for the GDMA.
+ *
+ */
+static void *tile_fbs[2];                                // Scan-out buffers
+static int tile_back = 1;                                // Index of the buffer the tiles go to, the panel starts with the first one
+static SemaphoreHandle_t tile_done = NULL;               // Given when a tile written by GDMA is complete
+static volatile bool tile_dma_pending = false;
+
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+static uint32_t tile_count;
+static uint64_t tile_dma_bytes;
+static uint64_t tile_cpu_bytes;
+static uint64_t tile_wait_us;                            // Time LVGL waited for a GDMA write-back
+#endif
+
+static IRAM_ATTR bool tile_dma_done_cb(async_memcpy_handle_t mcp, async_memcpy_event_t *event, void *cb_args)
+{
+    BaseType_t need_yield = pdFALSE;
+    tile_dma_pending = false;
+    lv_disp_flush_ready((lv_disp_drv_t *)cb_args); // The tile can be rendered into again
+    xSemaphoreGiveFromISR(tile_done, &need_yield);
+    return (need_yield == pdTRUE);
+}
+
+/* Areas at least half the screen wide become whole lines, so each of their tiles is one contiguous copy */
+static void tile_rounder(lv_disp_drv_t *drv, lv_area_t *area)
+{
+    if (lv_area_get_width(area) * 2 >= drv->hor_res) {
+        area->x1 = 0;
+        area->x2 = drv->hor_res - 1;
+    }
+}
+
+/* LVGL calls this while the other tile is still being written back */
+static void tile_wait(lv_disp_drv_t *drv)
+{
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+    const int64_t start_us = esp_timer_get_time();
+    xSemaphoreTake(tile_done, portMAX_DELAY);
+    tile_wait_us += esp_timer_get_time() - start_us;
+#else
+    xSemaphoreTake(tile_done, portMAX_DELAY);
+#endif
+}
+
+static void tile_wait_idle(void)
+{
+    while (tile_dma_pending) {
+        xSemaphoreTake(tile_done, portMAX_DELAY);
+    }
+}
+
+/* Returns true if the tile is copied by GDMA, its callback then calls `lv_disp_flush_ready()` */
+static bool tile_write_back(lv_disp_drv_t *drv, const lv_area_t *area, const lv_color_t *color_map)
+{
+    const size_t width_bytes = lv_area_get_width(area) * sizeof(lv_color_t);
+    const int height = lv_area_get_height(area);
+    uint8_t *to = (uint8_t *)tile_fbs[tile_back] + area->y1 * LVGL_PORT_LINE_BYTES + area->x1 * sizeof(lv_color_t);
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+    tile_count++;
+#endif
+    if (copy_dma && width_bytes == LVGL_PORT_LINE_BYTES) {
+        /* Whole lines are aligned to the cache line size, write back and drop what the cache holds of them */
+        esp_cache_msync(to, width_bytes * height, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_INVALIDATE);
+        tile_dma_pending = true;
+        if (esp_async_memcpy(copy_dma, to, (void *)color_map, width_bytes * height, tile_dma_done_cb, drv) == ESP_OK) {
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+            tile_dma_bytes += width_bytes * height;
+#endif
+            return true;
+        }
+        tile_dma_pending = false;
+    }
+    const uint8_t *from = (const uint8_t *)color_map;
+    for (int y = 0; y < height; y++) {
+        memcpy(to, from, width_bytes);
+        to += LVGL_PORT_LINE_BYTES;
+        from += width_bytes;
+    }
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+    tile_cpu_bytes += width_bytes * height;
+#endif
+    return false;
+}
+#endif /* LVGL_PORT_TILE_MODE */
+#endif /* LVGL_PORT_FB_SYNC */
+
+#if LVGL_PORT_SW_ROTATE
+/**
+ * With rotation LVGL renders into the third frame buffer in its own orientation, and the dirty areas
+ * are rotated into whichever of the other two is not scanned out before switching to it.
+ * In direct mode the same areas are rotated into the previous buffer once it is released, so both
+ * scan-out buffers stay complete.
+ *
+ */
+static uint16_t *rotate_fbs[2];                          // Scan-out buffers, in the panel orientation
+static int rotate_front = 0;                             // Index of the buffer being scanned out
+
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+static uint64_t rotate_pixels;                           // Pixels rotated since the last report
+static uint64_t rotate_us;                               // Time spent rotating since the last report
+#endif
+
+static void dirty_area_rotate(uint16_t *dst, const uint16_t *src, int src_w, int src_h,
+                              const lvgl_port_dirty_area_t *dirty)
+{
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+    const int64_t start_us = esp_timer_get_time();
+#endif
+    uint32_t pixels = 0;
+    for (int i = 0; i < dirty->count; i++) {
+        const lv_area_t *area = &dirty->areas[i];
+        rgb565_rotate_area(dst, src, src_w, src_h, area->x1, area->y1, area->x2, area->y2,
+                           EXAMPLE_LVGL_PORT_ROTATION_DEGREE);
+        pixels += lv_area_get_size(area);
+    }
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+    rotate_us += esp_timer_get_time() - start_us;
+    rotate_pixels += pixels;
+    psram_copy_bytes += 2 * pixels * sizeof(uint16_t);
+#else
+    (void)pixels;
+#endif
+}
+
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+/**
+ * Rotate a whole frame by each angle into the buffer that is not scanned out, before LVGL starts.
+ * A plain copy of the same frame is timed first: it moves the same PSRAM bytes, so it is the most a faster
+ * transpose (for example on the PIE unit) could reach.
+ *
+ */
+static void rotate_bench(const uint16_t *src)
+{
+    static const int degrees[] = { 90, 180, 270 };
+    const uint32_t px = LVGL_PORT_H_RES * LVGL_PORT_V_RES;
+    int64_t start_us = esp_timer_get_time();
+    memcpy(rotate_fbs[1], src, px * sizeof(uint16_t));
+    const uint32_t copy_us = (uint32_t)(esp_timer_get_time() - start_us);
+    ESP_LOGI(TAG, "Rotate copy: %lu px in %lu us, %lu.%02lu MPix/s", (unsigned long)px, (unsigned long)copy_us,
+             (unsigned long)(px / copy_us), (unsigned long)(px * 100ULL / copy_us % 100));
+    for (int i = 0; i < sizeof(degrees) / sizeof(degrees[0]); i++) {
+        const int src_w = (degrees[i] == 180) ? LVGL_PORT_H_RES : LVGL_PORT_V_RES;
+        const int src_h = (degrees[i] == 180) ? LVGL_PORT_V_RES : LVGL_PORT_H_RES;
+        start_us = esp_timer_get_time();
+        rgb565_rotate_area(rotate_fbs[1], src, src_w, src_h, 0, 0, src_w - 1, src_h - 1, degrees[i]);
+        const uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+        ESP_LOGI(TAG, "Rotate %d: %lu px in %lu us, %lu.%02lu MPix/s, %lu%% of the copy", degrees[i],
+                 (unsigned long)(src_w * src_h), (unsigned long)elapsed_us,
+                 (unsigned long)(src_w * src_h / elapsed_us),
+                 (unsigned long)(src_w * src_h * 100ULL / elapsed_us % 100),
+                 (unsigned long)(copy_us * 100ULL / elapsed_us));
+    }
+}
+#endif
+#endif /* LVGL_PORT_SW_ROTATE */
 
 static void flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
 {
@@ -27,19 +501,103 @@ static void flush_callback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t
     const int offsety1 = area->y1; // Start Y coordinate of the area to flush
     const int offsety2 = area->y2; // End Y coordinate of the area to flush
 
+#if LVGL_PORT_TILE_MODE
+    if (!lv_disp_flush_is_last(drv) && tile_write_back(drv, area, color_map)) {
+        return; // LVGL renders the next tile while the GDMA writes this one
+    }
+#endif
+
     /* Action after last area refresh */
     if (lv_disp_flush_is_last(drv)) {
+        const int64_t flush_start_us = esp_timer_get_time();
+#if LVGL_PORT_RGB_TRIPLE_BUFFER
+        /* Queue `color_map`, the panel switches to it at the next vsync */
+        rgb_buf_queue(color_map);
+        esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, color_map);
+
+        /* Render the next frame into the free buffer right away, LVGL swaps to `buf2` after this flush */
+        drv->draw_buf->buf1 = color_map;
+        drv->draw_buf->buf2 = rgb_buf_take_free(color_map);
+#elif LVGL_PORT_TILE_MODE
+        dirty_area_collect(&dirty_area); // The invalidated areas are cleared once the refresh finishes
+        tile_write_back(drv, area, color_map);
+        tile_wait_idle(); // The hidden buffer holds the whole frame now
+
+        /* Switch to the hidden buffer and wait for the last frame buffer to complete transmission */
+        esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, LVGL_PORT_H_RES, LVGL_PORT_V_RES, tile_fbs[tile_back]);
+        ulTaskNotifyValueClear(NULL, LVGL_PORT_NOTIFY_VSYNC);
+        wait_vsync();
+        tile_back ^= 1;
+
+        /* The released buffer misses this frame, bring it up to date before the next tiles go into it */
+        dirty_area_copy(tile_fbs[tile_back], tile_fbs[tile_back ^ 1], &dirty_area);
+#elif LVGL_PORT_SW_ROTATE
+#if LVGL_PORT_DIRECT_MODE
+        dirty_area_collect(&dirty_area); // The invalidated areas are cleared once the refresh finishes
+#else
+        dirty_area.count = 1; // Full refresh, `area` is the whole screen
+        dirty_area.areas[0] = *area;
+#endif
+        /* Rotate the dirty areas into the buffer that is not scanned out and switch to it */
+        uint16_t *back_buf = rotate_fbs[rotate_front ^ 1];
+        dirty_area_rotate(back_buf, (const uint16_t *)color_map, drv->hor_res, drv->ver_res, &dirty_area);
+        esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, LVGL_PORT_H_RES, LVGL_PORT_V_RES, back_buf);
+
+        /* Wait for the last frame buffer to complete transmission */
+        ulTaskNotifyValueClear(NULL, LVGL_PORT_NOTIFY_VSYNC);
+        wait_vsync();
+        rotate_front ^= 1;
+#if LVGL_PORT_DIRECT_MODE
+        /* The released buffer misses this frame, LVGL's buffer still holds it */
+        dirty_area_rotate(rotate_fbs[rotate_front ^ 1], (const uint16_t *)color_map, drv->hor_res, drv->ver_res,
+                          &dirty_area);
+#endif
+#else
+#if LVGL_PORT_DIRECT_MODE && EXAMPLE_LVGL_PORT_ROTATION_0
+        dirty_area_collect(&dirty_area); // The invalidated areas are cleared once the refresh finishes
+#endif
         /* Switch the current RGB frame buffer to `color_map` */
         esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, color_map);
 
         /* Wait for the last frame buffer to complete transmission */
-        ulTaskNotifyValueClear(NULL, ULONG_MAX);
-        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        ulTaskNotifyValueClear(NULL, LVGL_PORT_NOTIFY_VSYNC);
+        wait_vsync();
+
+#if LVGL_PORT_DIRECT_MODE && EXAMPLE_LVGL_PORT_ROTATION_0
+        /* The other buffer is no longer scanned out, bring it up to date before LVGL renders into it */
+        void *back_buf = (color_map == drv->draw_buf->buf1) ? drv->draw_buf->buf2 : drv->draw_buf->buf1;
+        dirty_area_copy(back_buf, color_map, &dirty_area);
+#endif
+#endif /* LVGL_PORT_RGB_TRIPLE_BUFFER */
+        const int64_t flush_end_us = esp_timer_get_time();
+        last_flush_us = (uint32_t)(flush_end_us - flush_start_us);
+        last_frame_us = (uint32_t)(flush_end_us - frame_start_us);
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+        perf_hist_add(&flush_hist, last_flush_us);
+        perf_hist_add(&frame_hist, last_frame_us);
+#endif
     }
 
     lv_disp_flush_ready(drv); // Mark the display flush as complete
 }
 
+static void monitor_callback(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px)
+{
+    /* Called once per refresh after the last flush, `px` is the number of rendered pixels */
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+    render_px += px;
+#endif
+    if (ui_bench_running()) {
+        const ui_bench_frame_t frame = {
+            .frame_us = last_frame_us,
+            .flush_us = last_flush_us,
+            .inv_px = px,
+            .heap_used = heap_caps_get_total_size(MALLOC_CAP_DEFAULT) - heap_caps_get_free_size(MALLOC_CAP_DEFAULT),
+        };
+        ui_bench_frame_done(&frame);
+    }
+}
+
 
 static lv_disp_t *display_init(esp_lcd_panel_handle_t panel_handle)
 {
@@ -56,7 +614,39 @@ static lv_disp_t *display_init(esp_lcd_panel_handle_t panel_handle)
     ESP_LOGD(TAG, "Malloc memory for LVGL buffer");
     // To avoid tearing effect, at least two frame buffers are needed: one for LVGL rendering and another for RGB output
     buffer_size = LVGL_PORT_H_RES * LVGL_PORT_V_RES;
+#if LVGL_PORT_RGB_TRIPLE_BUFFER
+    // The panel scans out the first frame buffer after init, LVGL renders into the other two
+    void *buf0 = NULL;
+    ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(panel_handle, 3, &buf0, &buf1, &buf2)); // Get three frame buffers
+    lvgl_port_rgb_bufs[0] = buf0;
+    lvgl_port_rgb_bufs[1] = buf1;
+    lvgl_port_rgb_bufs[2] = buf2;
+    lvgl_port_rgb_last_buf = buf0;
+    lvgl_port_rgb_next_buf = buf0;
+    lvgl_port_rgb_prev_buf = buf0;
+    lvgl_port_flush_next_buf = buf2;
+#elif LVGL_PORT_SW_ROTATE
+    // Two frame buffers are scanned out in the panel orientation, LVGL renders into the third one
+    void *fb0 = NULL;
+    void *fb1 = NULL;
+    ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(panel_handle, 3, &fb0, &fb1, &buf1)); // Get three frame buffers
+    rotate_fbs[0] = fb0;
+    rotate_fbs[1] = fb1;
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+    rotate_bench(buf1);
+#endif
+#elif LVGL_PORT_TILE_MODE
+    // The panel scans out two frame buffers in turn, LVGL renders into two tiles in internal SRAM
+    ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(panel_handle, 2, &tile_fbs[0], &tile_fbs[1])); // Get two frame buffers
+    buffer_size = LVGL_PORT_H_RES * LVGL_PORT_TILE_LINES;
+    buf1 = heap_caps_malloc(buffer_size * sizeof(lv_color_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+    buf2 = heap_caps_malloc(buffer_size * sizeof(lv_color_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+    assert(buf1 && buf2 && "no internal SRAM for the render tiles");
+    tile_done = xSemaphoreCreateBinary();
+    assert(tile_done);
+#else
     ESP_ERROR_CHECK(esp_lcd_rgb_panel_get_frame_buffer(panel_handle, 2, &buf1, &buf2)); // Get two frame buffers
+#endif
 
     // Initialize LVGL draw buffers
     lv_disp_draw_buf_init(&disp_buf, buf1, buf2, buffer_size); // Initialize the draw buffer
@@ -71,38 +661,103 @@ static lv_disp_t *display_init(esp_lcd_panel_handle_t panel_handle)
     disp_drv.ver_res = LVGL_PORT_V_RES; // Set vertical resolution
 #endif
     disp_drv.flush_cb = flush_callback; // Set the flush callback
+    disp_drv.monitor_cb = monitor_callback; // Feed the per-frame numbers to the UI benchmark
     disp_drv.draw_buf = &disp_buf; // Set the draw buffer
     disp_drv.user_data = panel_handle; // Set user data to panel handle
+    disp_drv.draw_ctx_init = lvgl_draw_ctx_init; // Blend with the kernels of rgb565_blend.c
 #if LVGL_PORT_FULL_REFRESH
     disp_drv.full_refresh = 1; // Enable full refresh
 #elif LVGL_PORT_DIRECT_MODE
     disp_drv.direct_mode = 1; // Enable direct mode
+#elif LVGL_PORT_TILE_MODE
+    disp_drv.rounder_cb = tile_rounder; // Wide areas become whole lines, written back by one GDMA copy per tile
+    disp_drv.wait_cb = tile_wait; // Block instead of spinning while a tile is written back
+#endif
+#if LVGL_PORT_COPY_GDMA
+    dma_copy_init(); // Install the GDMA memcpy engine used to write the tiles and synchronize the two frame buffers
 #endif
     return lv_disp_drv_register(&disp_drv); // Register the display driver
 }
 
-static void touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
+static void touch_feed_gesture(const touch_sample_t *sample)
 {
-    esp_lcd_touch_handle_t tp = (esp_lcd_touch_handle_t)indev_drv->user_data; // Get touchpad handle from user data
-    assert(tp); // Ensure touchpad handle is valid
+    ui_gesture_input_t in = {
+        .time_ms = (uint32_t)(sample->time_us / 1000),
+        .count = sample->count < UI_GESTURE_MAX_POINTS ? sample->count : UI_GESTURE_MAX_POINTS,
+    };
+    for (int i = 0; i < in.count; i++) {
+        in.points[i].x = sample->points[i].x;
+        in.points[i].y = sample->points[i].y;
+    }
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+    int64_t start_us = esp_timer_get_time();
+    ui_touch_feed(&in);
+    uint32_t cost_us = (uint32_t)(esp_timer_get_time() - start_us);
+    if (cost_us > gesture_us_max) {
+        gesture_us_max = cost_us;
+    }
+#else
+    ui_touch_feed(&in);
+#endif
+}
 
-    uint16_t touchpad_x; // Variable for X coordinate
-    uint16_t touchpad_y; // Variable for Y coordinate
-    uint8_t touchpad_cnt = 0; // Variable for touch count
+static void backlight_set(bool on)
+{
+    backlight_cb(on);
+    backlight_on = on;
+    ESP_LOGI(TAG, "Backlight %s", on ? "on" : "off");
+}
 
-    /* Read data from touch controller into memory */
-    esp_lcd_touch_read_data(tp); // Read data from touch controller
+/* Returns true while the press that turned the backlight on is held */
+static bool backlight_touch(const touch_sample_t *sample)
+{
+    const bool swallow = touch_swallow;
+    if (!sample->count) {
+        touch_swallow = false;
+        return swallow;
+    }
+    last_touch_us = esp_timer_get_time();
+    if (!backlight_on) {
+        backlight_set(true);
+        touch_swallow = true;
+        return true;
+    }
+    return swallow;
+}
 
-    /* Read data from touch controller */
-    bool touchpad_pressed = esp_lcd_touch_get_coordinates(tp, &touchpad_x, &touchpad_y, NULL, &touchpad_cnt, 1); // Get touch coordinates
-    if (touchpad_pressed && touchpad_cnt > 0) {
-        data->point.x = touchpad_x; // Set the X coordinate
-        data->point.y = touchpad_y; // Set the Y coordinate
-        data->state = LV_INDEV_STATE_PRESSED; // Set state to pressed
-        ESP_LOGD(TAG, "Touch position: %d,%d", touchpad_x, touchpad_y); // Log touch position
+static void touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
+{
+    /* The touch sampler task does the I2C reads, here only the queued samples are consumed */
+    touch_sample_t sample;
+    bool queued = touch_sampler_pop(&sample); // Falls back to the latest state when nothing is queued
+    if (backlight_touch(&sample)) {
+        data->state = LV_INDEV_STATE_RELEASED; // This press only turned the backlight on
+        return;
+    }
+    if (queued) {
+        touch_feed_gesture(&sample); // The gesture engine sees every point of every sample
     } else {
-        data->state = LV_INDEV_STATE_RELEASED; // Set state to released
+        ui_touch_tick((uint32_t)(esp_timer_get_time() / 1000)); // Long press while holding still
+    }
+#if !CONFIG_EXAMPLE_TOUCH_BUFFERED
+    /* Merge the samples up to the next press/release transition, so a short tap is never lost */
+    bool next_pressed;
+    while (queued && touch_sampler_peek_pressed(&next_pressed) && next_pressed == (sample.count > 0)) {
+        touch_sampler_pop(&sample);
+        touch_feed_gesture(&sample);
+    }
+#endif
+    data->point.x = sample.points[0].x; // LVGL itself only follows the first point
+    data->point.y = sample.points[0].y;
+    data->state = sample.count ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED; // Set the state
+#if CONFIG_EXAMPLE_TOUCH_BUFFERED
+    data->continue_reading = touch_sampler_pending(); // Let LVGL process every buffered sample in this pass
+#endif
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+    if (queued) {
+        perf_hist_add(&touch_hist, (uint32_t)(esp_timer_get_time() - sample.time_us));
     }
+#endif
 }
 
 static lv_indev_t *indev_init(esp_lcd_touch_handle_t tp)
@@ -117,9 +772,21 @@ static lv_indev_t *indev_init(esp_lcd_touch_handle_t tp)
     indev_drv_tp.read_cb = touchpad_read; // Set the read callback function
     indev_drv_tp.user_data = tp; // Set user data to the touch panel handle
 
-    return lv_indev_drv_register(&indev_drv_tp); // Register the input device driver
+    touch_indev = lv_indev_drv_register(&indev_drv_tp); // Register the input device driver
+    return touch_indev;
+}
+
+uint32_t lvgl_tick_get(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
 }
 
+#if CONFIG_LV_TICK_CUSTOM
+static esp_err_t tick_init(void)
+{
+    return ESP_OK; // lv_tick_get() reads esp_timer through lvgl_tick_get(), no tick interrupt needed
+}
+#else
 static void tick_increment(void *arg)
 {
     /* Tell LVGL how many milliseconds have elapsed */
@@ -137,30 +804,428 @@ static esp_err_t tick_init(void)
     ESP_ERROR_CHECK(esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer)); // Create the timer
     return esp_timer_start_periodic(lvgl_tick_timer, LVGL_PORT_TICK_PERIOD_MS * 1000); // Start the timer
 }
-#include "ui.h"
+#endif
+
+#if LVGL_PORT_IDLE_ENABLE
+/* Nothing to draw, no animation and no finger on the panel */
+static bool idle_possible(const lv_disp_t *disp)
+{
+    if (disp->inv_p || lv_anim_count_running()) {
+        return false;
+    }
+    return !touch_indev || (!touch_sampler_pending() && touch_indev->proc.state == LV_INDEV_STATE_RELEASED);
+}
+
+static void idle_enter(lv_disp_t *disp)
+{
+    lv_timer_pause(disp->refr_timer);
+    if (touch_indev) {
+        lv_timer_pause(touch_indev->driver->read_timer); // The touch sampler wakes the task on the next sample
+    }
+#if LVGL_PORT_PM_DFS
+    esp_pm_lock_release(pm_cpu_lock);
+#endif
+    idle_start_us = esp_timer_get_time();
+    lvgl_idle = true;
+}
+
+static void idle_leave(lv_disp_t *disp)
+{
+#if LVGL_PORT_PM_DFS
+    esp_pm_lock_acquire(pm_cpu_lock);
+#endif
+    lv_timer_resume(disp->refr_timer);
+    if (touch_indev) {
+        lv_timer_resume(touch_indev->driver->read_timer);
+    }
+    idle_us += esp_timer_get_time() - idle_start_us;
+    lvgl_idle = false;
+}
+#endif
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+static void report_hist(const char *name, perf_hist_t *hist)
+{
+    if (hist->count) {
+        ESP_LOGI(TAG, "%s (us): n=%lu p50=%lu p90=%lu p99=%lu max=%lu", name,
+                 (unsigned long)hist->count,
+                 (unsigned long)perf_hist_percentile(hist, 50),
+                 (unsigned long)perf_hist_percentile(hist, 90),
+                 (unsigned long)perf_hist_percentile(hist, 99),
+                 (unsigned long)hist->max);
+    }
+    perf_hist_reset(hist);
+}
+
+static void report_mem(void)
+{
+    lvgl_mem_stats_t mem;
+    if (!lvgl_port_lock(-1)) {
+        return;
+    }
+    lvgl_mem_get_stats(&mem); // LVGL allocates with the lock held
+    lvgl_port_unlock();
+
+    char line[160];
+    int len = 0;
+    for (int i = 0; i < LVGL_MEM_CLASS_COUNT; i++) {
+        const lvgl_mem_class_stats_t *cls = &mem.classes[i];
+        if (!cls->pages && !cls->fallbacks) {
+            continue;
+        }
+        int n = snprintf(line + len, sizeof(line) - len, cls->fallbacks ? " %u:%lu/%lu+%lu" : " %u:%lu/%lu",
+                         cls->size, (unsigned long)cls->in_use, (unsigned long)cls->capacity,
+                         (unsigned long)cls->fallbacks);
+        if (n < 0 || n >= (int)sizeof(line) - len) {
+            break;
+        }
+        len += n;
+    }
+    ESP_LOGI(TAG, "LVGL pools: %lu/%lu pages, class used/capacity(+to TLSF):%s", (unsigned long)mem.pool_pages_used,
+             (unsigned long)mem.pool_pages, len ? line : " none");
+    ESP_LOGI(TAG, "LVGL TLSF: used=%u peak=%u of %u, largest free=%u frag=%lu%%, PSRAM: %lu blocks %u bytes peak=%u, failed=%lu",
+             (unsigned)mem.tlsf_used, (unsigned)mem.tlsf_peak, (unsigned)mem.tlsf_size, (unsigned)mem.tlsf_largest_free,
+             (unsigned long)mem.tlsf_frag_pct, (unsigned long)mem.spill_count, (unsigned)mem.spill_used,
+             (unsigned)mem.spill_peak, (unsigned long)mem.failed);
+}
+
+static void report_blend(void)
+{
+    lvgl_draw_stats_t draw;
+    lvgl_draw_get_stats(&draw);
+    const uint32_t fill = draw.fill_px - draw_last_stats.fill_px;
+    const uint32_t copy = draw.copy_px - draw_last_stats.copy_px;
+    const uint32_t fill_opa = draw.fill_opa_px - draw_last_stats.fill_opa_px;
+    const uint32_t copy_opa = draw.copy_opa_px - draw_last_stats.copy_opa_px;
+    const uint32_t fill_mask = draw.fill_mask_px - draw_last_stats.fill_mask_px;
+    const uint32_t fallback = draw.fallback_px - draw_last_stats.fallback_px;
+    const uint64_t total = (uint64_t)fill + copy + fill_opa + copy_opa + fill_mask + fallback;
+    if (total) {
+        ESP_LOGI(TAG, "Blend (%s): fill=%lu copy=%lu opa fill=%lu copy=%lu, mask=%lu Kpx, %lu%% left to LVGL",
+                 rgb565_blend_get_simd() ? "PIE" : "C", (unsigned long)(fill / 1000),
+                 (unsigned long)(copy / 1000), (unsigned long)(fill_opa / 1000), (unsigned long)(copy_opa / 1000),
+                 (unsigned long)(fill_mask / 1000), (unsigned long)(fallback * 100 / total));
+    }
+    draw_last_stats = draw;
+}
+
+static void report_scan(void)
+{
+    scan_mon_stats_t scan;
+    scan_mon_get_stats(&scan, true);
+    const uint32_t frames = scan.vsyncs - scan_last_stats.vsyncs;
+    const uint32_t bounce_frames = scan.bounce_frames - scan_last_stats.bounce_frames;
+    const uint32_t fps_x10 = (uint32_t)(frames * 10000ULL / LVGL_PORT_STATS_PERIOD_MS);
+    if (bounce_frames) {
+        ESP_LOGI(TAG, "Scan-out: %lu.%lu fps at %lu.%lu MHz, refill deadline %lu us, last refill +%lu us avg "
+                 "+%lu max, late=%lu underruns=%lu drifts=%lu", (unsigned long)(fps_x10 / 10),
+                 (unsigned long)(fps_x10 % 10), (unsigned long)(scan.pclk_hz / 1000000),
+                 (unsigned long)(scan.pclk_hz / 100000 % 10), (unsigned long)scan.deadline_us,
+                 (unsigned long)((scan.excess_us_total - scan_last_stats.excess_us_total) / bounce_frames),
+                 (unsigned long)scan.excess_us_max, (unsigned long)(scan.late - scan_last_stats.late),
+                 (unsigned long)(scan.underruns - scan_last_stats.underruns),
+                 (unsigned long)(scan.drifts - scan_last_stats.drifts));
+    } else {
+        ESP_LOGI(TAG, "Scan-out: %lu.%lu fps at %lu.%lu MHz, no bounce buffer", (unsigned long)(fps_x10 / 10),
+                 (unsigned long)(fps_x10 % 10), (unsigned long)(scan.pclk_hz / 1000000),
+                 (unsigned long)(scan.pclk_hz / 100000 % 10));
+    }
+    scan_last_stats = scan;
+
+    const uint64_t scan_bytes = (uint64_t)frames * scan_mon_frame_bytes();
+#if LVGL_PORT_TILE_MODE
+    /* LVGL renders into the SRAM tiles, PSRAM only sees their write-back */
+    const uint64_t render_bytes = tile_dma_bytes + tile_cpu_bytes;
+    const char *render_label = "tile write-back";
+#else
+    /* LVGL also reads the frame buffer when it blends, only its writes are known here */
+    const uint64_t render_bytes = render_px * sizeof(lv_color_t);
+    const char *render_label = "render writes";
+#endif
+    const uint64_t total_bytes = scan_bytes + render_bytes + psram_copy_bytes;
+    ESP_LOGI(TAG, "PSRAM: scan-out %lu KB/s, %s %lu KB/s, buffer copies %lu KB/s, %lu%% of %d MB/s",
+             (unsigned long)(scan_bytes * 1000 / 1024 / LVGL_PORT_STATS_PERIOD_MS), render_label,
+             (unsigned long)(render_bytes * 1000 / 1024 / LVGL_PORT_STATS_PERIOD_MS),
+             (unsigned long)(psram_copy_bytes * 1000 / 1024 / LVGL_PORT_STATS_PERIOD_MS),
+             (unsigned long)(total_bytes * 1000 / LVGL_PORT_STATS_PERIOD_MS * 100 / (LVGL_PORT_PSRAM_PEAK_MBPS * 1000000ULL)),
+             LVGL_PORT_PSRAM_PEAK_MBPS);
+    render_px = 0;
+    psram_copy_bytes = 0;
+}
+
+static void report_stats(void)
+{
+    report_hist("API->pixel latency", &latency_hist);
+#ifdef LVGL_PORT_AVOID_TEAR_MODE
+    ESP_LOGI(TAG, "Avoid tearing mode %d, rotation %d", LVGL_PORT_AVOID_TEAR_MODE, EXAMPLE_LVGL_PORT_ROTATION_DEGREE);
+#endif
+    report_hist("Frame time", &frame_hist);
+    report_hist("Flush blocked", &flush_hist);
+    report_blend();
+    report_scan();
+    if (touch_indev) {
+        touch_sampler_stats_t touch;
+        touch_sampler_get_stats(&touch);
+        uint32_t touch_reads = touch.reads - touch_last_stats.reads;
+        ESP_LOGI(TAG, "Touch: %lu samples/s, irq=%lu reads=%lu dropped=%lu, I2C read avg=%lu max=%lu us",
+                 (unsigned long)((touch.samples - touch_last_stats.samples) * 1000 / LVGL_PORT_STATS_PERIOD_MS),
+                 (unsigned long)(touch.interrupts - touch_last_stats.interrupts), (unsigned long)touch_reads,
+                 (unsigned long)(touch.dropped - touch_last_stats.dropped),
+                 (unsigned long)(touch_reads ? (touch.read_us_total - touch_last_stats.read_us_total) / touch_reads : 0),
+                 (unsigned long)touch.read_us_max);
+        touch_last_stats = touch;
+        report_hist("Touch INT->read latency", &touch_hist);
+        ui_gesture_stats_t gesture;
+        ui_get_gesture_stats(&gesture);
+        ESP_LOGI(TAG, "Gestures: samples=%lu events=%lu, max %lu us per sample",
+                 (unsigned long)(gesture.samples - gesture_last_stats.samples),
+                 (unsigned long)(gesture.events - gesture_last_stats.events), (unsigned long)gesture_us_max);
+        gesture_last_stats = gesture;
+        gesture_us_max = 0;
+    }
+#if LVGL_PORT_IDLE_ENABLE
+    int64_t now_us = esp_timer_get_time();
+    if (lvgl_idle) {
+        idle_us += now_us - idle_start_us; // Count the running idle period up to now
+        idle_start_us = now_us;
+    }
+    ESP_LOGI(TAG, "Power: %lu wakeups/s, idle %lu%%, backlight %s", (unsigned long)(wakeups * 1000ULL / LVGL_PORT_STATS_PERIOD_MS),
+             (unsigned long)(idle_us / 10 / LVGL_PORT_STATS_PERIOD_MS), backlight_on ? "on" : "off");
+    idle_us = 0;
+#else
+    ESP_LOGI(TAG, "Power: %lu wakeups/s, backlight %s", (unsigned long)(wakeups * 1000ULL / LVGL_PORT_STATS_PERIOD_MS),
+             backlight_on ? "on" : "off");
+#endif
+    wakeups = 0;
+    ui_status_stats_t status;
+    ui_get_status_stats(&status);
+    ESP_LOGI(TAG, "Status updates: applied=%lu skipped=%lu labels=%lu styles=%lu",
+             (unsigned long)status.applied, (unsigned long)status.skipped,
+             (unsigned long)status.labels_set, (unsigned long)status.style_swaps);
+    ui_plot_stats_t plot;
+    if (lvgl_port_lock(-1)) {
+        ui_plot_get_stats(&plot); // The draw counters are updated by the LVGL task
+        lvgl_port_unlock();
+        if (plot.samples != plot_last_stats.samples) {
+            ESP_LOGI(TAG, "Plot: %lu samples/s -> %lu columns/s, dropped=%lu, drawn=%lu spans %lu px",
+                     (unsigned long)((plot.samples - plot_last_stats.samples) * 1000ULL / LVGL_PORT_STATS_PERIOD_MS),
+                     (unsigned long)((plot.columns - plot_last_stats.columns) * 1000ULL / LVGL_PORT_STATS_PERIOD_MS),
+                     (unsigned long)(plot.dropped - plot_last_stats.dropped),
+                     (unsigned long)(plot.columns_drawn - plot_last_stats.columns_drawn),
+                     (unsigned long)(plot.invalidated_px - plot_last_stats.invalidated_px));
+        }
+        plot_last_stats = plot;
+    }
+    ui_log_stats_t log;
+    if (lvgl_port_lock(-1)) {
+        ui_log_get_stats(&log); // The store is only touched by the LVGL task
+        lvgl_port_unlock();
+        ESP_LOGI(TAG, "Log: %lu lines stored of %lu, %lu/%lu bytes, +%lu lines evicted=%lu, finds=%lu max %lu us",
+                 (unsigned long)log.stored, (unsigned long)log.index_size, (unsigned long)log.store_used,
+                 (unsigned long)log.store_size, (unsigned long)(log.lines - log_last_stats.lines),
+                 (unsigned long)(log.evicted - log_last_stats.evicted),
+                 (unsigned long)(log.finds - log_last_stats.finds), (unsigned long)log.find_us_max);
+        log_last_stats = log;
+    }
+    report_mem();
+    if (font_loaded) {
+        ui_font_cache_stats_t font;
+        ui_font_cache_get_stats(&font);
+        uint32_t lookups = font.lookups - font_last_stats.lookups;
+        uint32_t hot_hits = font.hot_hits - font_last_stats.hot_hits;
+        uint32_t lru_hits = font.lru_hits - font_last_stats.lru_hits;
+        ESP_LOGI(TAG, "Glyph cache: lookups=%lu hit=%lu%% (hot %lu%%, PSRAM %lu%%) misses=%lu promoted=%lu evicted=%lu "
+                 "uncached=%lu, hot %u/%u PSRAM %u/%u slots", (unsigned long)lookups,
+                 (unsigned long)(lookups ? (hot_hits + lru_hits) * 100ULL / lookups : 0),
+                 (unsigned long)(lookups ? hot_hits * 100ULL / lookups : 0),
+                 (unsigned long)(lookups ? lru_hits * 100ULL / lookups : 0),
+                 (unsigned long)(font.misses - font_last_stats.misses),
+                 (unsigned long)(font.promotions - font_last_stats.promotions),
+                 (unsigned long)(font.evictions - font_last_stats.evictions),
+                 (unsigned long)(font.uncached - font_last_stats.uncached),
+                 font.hot_used, font.hot_slots, font.lru_used, font.lru_slots);
+        font_last_stats = font;
+        report_hist("Glyph fetch", &font_fetch_hist);
+    }
+    if (icons_loaded) {
+        ui_icon_cache_stats_t icon;
+        ui_icon_get_stats(&icon);
+        uint32_t lookups = icon.lookups - icon_last_stats.lookups;
+        uint32_t hits = icon.hits - icon_last_stats.hits;
+        ESP_LOGI(TAG, "Icon cache: lookups=%lu hit=%lu%% misses=%lu evicted=%lu failed=%lu, %u/%u pages decoded, "
+                 "%lu/%lu KB", (unsigned long)lookups, (unsigned long)(lookups ? hits * 100ULL / lookups : 0),
+                 (unsigned long)(icon.misses - icon_last_stats.misses),
+                 (unsigned long)(icon.evictions - icon_last_stats.evictions),
+                 (unsigned long)(icon.failures - icon_last_stats.failures), icon.pages_decoded, icon.pages,
+                 (unsigned long)(icon.bytes_used / 1024), (unsigned long)(icon.budget / 1024));
+        icon_last_stats = icon;
+        report_hist("Icon decode", &icon_decode_hist);
+    }
+#if LVGL_PORT_SW_ROTATE
+    if (rotate_us) {
+        ESP_LOGI(TAG, "Rotate %d: %llu px, %lu.%02lu MPix/s", EXAMPLE_LVGL_PORT_ROTATION_DEGREE,
+                 (unsigned long long)rotate_pixels, (unsigned long)(rotate_pixels / rotate_us),
+                 (unsigned long)(rotate_pixels * 100 / rotate_us % 100));
+    }
+    rotate_pixels = 0;
+    rotate_us = 0;
+#endif
+#if LVGL_PORT_TILE_MODE
+    if (tile_count) {
+        ESP_LOGI(TAG, "Tiles: %lu, written %lu KB by GDMA and %lu KB by CPU, waited %lu us for GDMA",
+                 (unsigned long)tile_count, (unsigned long)(tile_dma_bytes / 1024),
+                 (unsigned long)(tile_cpu_bytes / 1024), (unsigned long)tile_wait_us);
+    }
+    tile_count = 0;
+    tile_dma_bytes = 0;
+    tile_cpu_bytes = 0;
+    tile_wait_us = 0;
+#endif
+#if LVGL_PORT_FB_SYNC
+    if (dirty_copy_frames) {
+        ESP_LOGI(TAG, "Dirty copy per frame: avg=%lu max=%lu bytes (full frame %lu), %lu%% by GDMA",
+                 (unsigned long)(dirty_copy_bytes / dirty_copy_frames), (unsigned long)dirty_copy_max,
+                 (unsigned long)LVGL_PORT_FRAME_BYTES,
+                 (unsigned long)(dirty_copy_bytes ? dirty_copy_dma_bytes * 100 / dirty_copy_bytes : 0));
+    }
+    dirty_copy_bytes = 0;
+    dirty_copy_dma_bytes = 0;
+    dirty_copy_frames = 0;
+    dirty_copy_max = 0;
+#endif
+}
+#endif
+
+void lvgl_port_wake(void)
+{
+    if (lvgl_task_handle) {
+        xTaskNotify(lvgl_task_handle, LVGL_PORT_NOTIFY_UI_WORK, eSetBits); // Wake the LVGL task
+    }
+}
+
 static void lvgl_port_task(void *arg)
 {
     ESP_LOGD(TAG, "Starting LVGL task"); // Log the task start
-    ui_init();
+    ui_set_wakeup_cb(lvgl_port_wake);
+    /* The log history lives in PSRAM; internal RAM only holds the visible rows */
+    size_t log_store_size = LVGL_PORT_LOG_STORE_BYTES;
+    void *log_store = heap_caps_malloc(log_store_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!log_store) {
+        /* Only now take internal RAM, and only the minimum the log store needs */
+        ESP_LOGW(TAG, "No PSRAM for the %d KB log history, keeping %d KB in internal RAM",
+                 CONFIG_EXAMPLE_LOG_STORE_KB, UI_LOG_STORE_FALLBACK_BYTES / 1024);
+        log_store_size = UI_LOG_STORE_FALLBACK_BYTES;
+        log_store = heap_caps_malloc(log_store_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    ui_log_store_init(log_store, log_store ? log_store_size : 0);
+    if (lvgl_port_lock(-1)) {
+        /* Set before ui_init() so every widget inherits the partition font */
+        int prof = boot_prof_begin("font partition");
+        const lv_font_t *font = font_partition_load(LV_FONT_DEFAULT, &font_fetch_hist);
+        if (font) {
+            lv_obj_set_style_text_font(lv_scr_act(), font, 0);
+            font_loaded = true;
+        }
+        boot_prof_end(prof);
+        prof = boot_prof_begin("icon partition");
+        icons_loaded = icon_partition_load(&icon_decode_hist);
+        boot_prof_end(prof);
+        prof = boot_prof_begin("ui_init");
+        ui_init();
+        boot_prof_end(prof);
+        lvgl_port_unlock();
+    }
+    xEventGroupSetBits(ready_events, LVGL_PORT_READY_UI); // ui.h calls are no longer dropped
+    bool first_frame = false;
     uint32_t task_delay_ms = LVGL_PORT_TASK_MAX_DELAY_MS; // Set initial task delay
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+    perf_hist_reset(&latency_hist);
+    perf_hist_reset(&frame_hist);
+    perf_hist_reset(&flush_hist);
+    perf_hist_reset(&touch_hist);
+    perf_hist_reset(&font_fetch_hist);
+    perf_hist_reset(&icon_decode_hist);
+    int64_t next_report_us = esp_timer_get_time() + LVGL_PORT_STATS_PERIOD_MS * 1000LL;
+#endif
+    lv_disp_t *disp = lv_disp_get_default();
+    assert(disp && disp->refr_timer);
+    last_touch_us = esp_timer_get_time();
     while (1) {
+        uint32_t since = 0;
         if (lvgl_port_lock(-1)) { // Try to lock the LVGL mutex
+            since = ui_process_messages(); // Apply pending UI messages before rendering
+            const bool touch_work = touch_indev && touch_sampler_pending();
+#if LVGL_PORT_IDLE_ENABLE
+            if (lvgl_idle && (since || touch_work)) {
+                idle_leave(disp); // A UI message or a touch sample woke the task
+            }
+#endif
+            if (since) {
+                /* Render the changes in this pass instead of waiting for the next refresh period */
+                lv_timer_ready(disp->refr_timer);
+            }
+            if (touch_work) {
+                lv_timer_ready(touch_indev->driver->read_timer); // Read new touch samples in this pass
+            }
+            frame_start_us = esp_timer_get_time();
             task_delay_ms = lv_timer_handler(); // Handle LVGL timer events
+#if LVGL_PORT_IDLE_ENABLE
+            if (!idle_possible(disp)) {
+                if (lvgl_idle) {
+                    /* An LVGL timer (the plot, a UI timer) invalidated something while idle, draw it now */
+                    idle_leave(disp);
+                    task_delay_ms = lv_timer_handler();
+                }
+            } else if (!lvgl_idle) {
+                idle_enter(disp);
+                task_delay_ms = lv_timer_handler(); // Next deadline without the paused timers
+            }
+#endif
             lvgl_port_unlock(); // Unlock the mutex
         }
-        // Ensure the delay time is within limits
-        if (task_delay_ms > LVGL_PORT_TASK_MAX_DELAY_MS) {
+        if (since && !first_frame) {
+            /* The first pass that applied UI messages rendered the content the application set after READY_UI */
+            first_frame = true;
+            boot_prof_mark("first frame");
+            xEventGroupSetBits(ready_events, LVGL_PORT_READY_FRAME);
+        }
+        int64_t now_us = esp_timer_get_time();
+#if LVGL_PORT_STATS_PERIOD_MS > 0
+        if (since) {
+            perf_hist_add(&latency_hist, (uint32_t)now_us - since);
+        }
+        if (now_us >= next_report_us) {
+            report_stats();
+            next_report_us = now_us + LVGL_PORT_STATS_PERIOD_MS * 1000LL;
+        }
+        if (task_delay_ms > (next_report_us - now_us) / 1000 + 1) {
+            task_delay_ms = (next_report_us - now_us) / 1000 + 1;
+        }
+#endif
+        if (backlight_cb && LVGL_PORT_BACKLIGHT_OFF_MS > 0 && backlight_on) {
+            const int64_t dark_us = last_touch_us + LVGL_PORT_BACKLIGHT_OFF_MS * 1000LL;
+            if (now_us >= dark_us) {
+                backlight_set(false);
+            } else if (task_delay_ms > (dark_us - now_us) / 1000 + 1) {
+                task_delay_ms = (dark_us - now_us) / 1000 + 1;
+            }
+        }
+        // Ensure the delay time is within limits, an idle task sleeps until the next deadline
+        if (task_delay_ms > LVGL_PORT_TASK_MAX_DELAY_MS && !lvgl_idle) {
             task_delay_ms = LVGL_PORT_TASK_MAX_DELAY_MS;
         } else if (task_delay_ms < LVGL_PORT_TASK_MIN_DELAY_MS) {
             task_delay_ms = LVGL_PORT_TASK_MIN_DELAY_MS;
         }
-        ui_process_messages();
-        vTaskDelay(pdMS_TO_TICKS(task_delay_ms)); // Delay the task for the calculated time
+        /* Sleep until the next LVGL timer is due or a UI API call wakes us up */
+        xTaskNotifyWait(0, LVGL_PORT_NOTIFY_UI_WORK, NULL,
+                        (task_delay_ms == LV_NO_TIMER_READY) ? portMAX_DELAY : pdMS_TO_TICKS(task_delay_ms));
+        wakeups++;
     }
 }
 
 esp_err_t lvgl_port_init(esp_lcd_panel_handle_t lcd_handle, esp_lcd_touch_handle_t tp_handle)
 {
+    const int prof = boot_prof_begin("lvgl_port_init");
+    lvgl_mem_init(); // Reserve the LVGL pools and TLSF region in internal SRAM before other components take it
     lv_init(); // Initialize LVGL
     ESP_ERROR_CHECK(tick_init()); // Initialize the tick timer
 
@@ -170,10 +1235,36 @@ esp_err_t lvgl_port_init(esp_lcd_panel_handle_t lcd_handle, esp_lcd_touch_handle
     if (tp_handle) {
         lv_indev_t *indev = indev_init(tp_handle); // Initialize the touchpad input device
         assert(indev); // Ensure the input device initialization was successful
+        ESP_ERROR_CHECK(touch_sampler_start(tp_handle, lvgl_port_wake)); // Read the touch controller on its own task
     }
 
     lvgl_mux = xSemaphoreCreateRecursiveMutex(); // Create a recursive mutex for LVGL
     assert(lvgl_mux); // Ensure mutex creation was successful
+#if LVGL_PORT_PM_DFS
+    const esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = LVGL_PORT_PM_MIN_FREQ_MHZ,
+        .light_sleep_enable = false, // The RGB panel scans out of PSRAM all the time, it cannot sleep
+    };
+    ESP_ERROR_CHECK(esp_pm_configure(&pm_config));
+    ESP_ERROR_CHECK(esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "lvgl", &pm_cpu_lock));
+    esp_pm_lock_acquire(pm_cpu_lock); // Released while the LVGL task is idle
+#if CONFIG_EXAMPLE_LCD_RGB_BOUNCE_BUFFER_HEIGHT > 0
+    /**
+     * With a bounce buffer the IDF RGB panel driver is expected to hold its own ESP_PM_CPU_FREQ_MAX lock for as long
+     * as the panel runs, which would keep the CPU at full clock and make releasing ours a no-op. Print the lock list
+     * so the "rgb_panel" lock can be checked on the board.
+     */
+    ESP_LOGW(TAG, "DFS with a bounce buffer: the RGB panel driver may keep the CPU at %d MHz, see the lock list",
+             CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+    esp_pm_dump_locks(stdout);
+#endif
+#endif
+    ready_events = xEventGroupCreate();
+    assert(ready_events);
+    if (tp_handle) {
+        xEventGroupSetBits(ready_events, LVGL_PORT_READY_TOUCH);
+    }
 
     ESP_LOGI(TAG, "Create LVGL task"); // Log task creation
     BaseType_t core_id = (LVGL_PORT_TASK_CORE < 0) ? tskNO_AFFINITY : LVGL_PORT_TASK_CORE; // Determine core ID for the task
@@ -183,10 +1274,46 @@ esp_err_t lvgl_port_init(esp_lcd_panel_handle_t lcd_handle, esp_lcd_touch_handle
         ESP_LOGE(TAG, "Failed to create LVGL task"); // Log error if task creation fails
         return ESP_FAIL; // Return failure
     }
+    boot_prof_end(prof);
 
     return ESP_OK; // Return success
 }
 
+esp_err_t lvgl_port_attach_touch(esp_lcd_touch_handle_t tp_handle)
+{
+    assert(lvgl_mux && "lvgl_port_init must be called first"); // Ensure the mutex is initialized
+    if (!tp_handle || touch_indev) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = touch_sampler_start(tp_handle, lvgl_port_wake); // Read the touch controller on its own task
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    lvgl_port_lock(-1);
+    lv_indev_t *indev = indev_init(tp_handle); // Initialize the touchpad input device
+    if (indev && lvgl_idle) {
+        lv_timer_pause(indev->driver->read_timer); // Resumed with the refresh timer
+    }
+    lvgl_port_unlock();
+    if (!indev) {
+        return ESP_FAIL;
+    }
+    xEventGroupSetBits(ready_events, LVGL_PORT_READY_TOUCH);
+    return ESP_OK;
+}
+
+void lvgl_port_set_backlight_cb(lvgl_port_backlight_cb_t cb)
+{
+    backlight_cb = cb;
+}
+
+bool lvgl_port_wait_ready(uint32_t bits, int timeout_ms)
+{
+    assert(ready_events && "lvgl_port_init must be called first");
+    const TickType_t timeout_ticks = (timeout_ms < 0) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return (xEventGroupWaitBits(ready_events, bits, pdFALSE, pdTRUE, timeout_ticks) & bits) == bits;
+}
+
 bool lvgl_port_lock(int timeout_ms)
 {
     assert(lvgl_mux && "lvgl_port_init must be called first"); // Ensure the mutex is initialized
@@ -198,20 +1325,39 @@ bool lvgl_port_lock(int timeout_ms)
 void lvgl_port_unlock(void)
 {
     assert(lvgl_mux && "lvgl_port_init must be called first"); // Ensure the mutex is initialized
+#if LVGL_PORT_IDLE_ENABLE
+    /* Another task may have changed widgets under the lock, the idle LVGL task would not notice them */
+    const bool wake = lvgl_idle && xTaskGetCurrentTaskHandle() != lvgl_task_handle;
+#endif
     xSemaphoreGiveRecursive(lvgl_mux); // Release the mutex
+#if LVGL_PORT_IDLE_ENABLE
+    if (wake) {
+        lvgl_port_wake();
+    }
+#endif
 }
 
 bool lvgl_port_notify_rgb_vsync(void)
 {
     BaseType_t need_yield = pdFALSE; // Flag to check if a yield is needed
-#if LVGL_PORT_FULL_REFRESH && (LVGL_PORT_LCD_RGB_BUFFER_NUMS == 3) && (EXAMPLE_LVGL_PORT_ROTATION_DEGREE == 0)
-    if (lvgl_port_rgb_next_buf != lvgl_port_rgb_last_buf) {
-        lvgl_port_flush_next_buf = lvgl_port_rgb_last_buf; // Set next buffer for flushing
-        lvgl_port_rgb_last_buf = lvgl_port_rgb_next_buf; // Update the last buffer
+#if LVGL_PORT_RGB_TRIPLE_BUFFER
+    portENTER_CRITICAL_ISR(&rgb_buf_lock);
+    if (rgb_buf_in_flight) {
+        lvgl_port_rgb_last_buf = lvgl_port_rgb_prev_buf; // Either the buffer the driver had before
+        lvgl_port_rgb_maybe_buf = lvgl_port_rgb_next_buf; // or the one it is being given
+    } else if (lvgl_port_rgb_next_buf != lvgl_port_rgb_last_buf) {
+        lvgl_port_rgb_last_buf = lvgl_port_rgb_next_buf; // The queued buffer is scanned out from now on
+        lvgl_port_rgb_maybe_buf = NULL;
+    }
+    const bool wake = rgb_buf_waiting;
+    rgb_buf_waiting = false;
+    portEXIT_CRITICAL_ISR(&rgb_buf_lock);
+    if (wake) {
+        xTaskNotifyFromISR(lvgl_task_handle, LVGL_PORT_NOTIFY_VSYNC, eSetBits, &need_yield); // A buffer may be free now
     }
 #elif LVGL_PORT_AVOID_TEAR_ENABLE
     // Notify that the current RGB frame buffer has been transmitted
-    xTaskNotifyFromISR(lvgl_task_handle, ULONG_MAX, eNoAction, &need_yield); // Notify the LVGL task
+    xTaskNotifyFromISR(lvgl_task_handle, LVGL_PORT_NOTIFY_VSYNC, eSetBits, &need_yield); // Notify the LVGL task
 #endif
     return (need_yield == pdTRUE); // Return whether a yield is needed
 }
@@ -31,7 +31,9 @@ extern "C" {
     #define LVGL_PORT_H_RES             (800)
     #define LVGL_PORT_V_RES             (480)
 #endif
+#if !CONFIG_LV_TICK_CUSTOM
 #define LVGL_PORT_TICK_PERIOD_MS    (CONFIG_EXAMPLE_LVGL_PORT_TICK)
+#endif
 
 /**
  * LVGL timer handle task related parameters, can be adjusted by users
@@ -43,6 +45,33 @@ extern "C" {
 #define LVGL_PORT_TASK_PRIORITY     (CONFIG_EXAMPLE_LVGL_PORT_TASK_PRIORITY)        // The priority of the LVGL timer task
 #define LVGL_PORT_TASK_CORE         (CONFIG_EXAMPLE_LVGL_PORT_TASK_CORE)            // The core of the LVGL timer task,
 // `-1` means the don't specify the core
+#define LVGL_PORT_STATS_PERIOD_MS   (CONFIG_EXAMPLE_LVGL_PORT_STATS_PERIOD_S * 1000) // Period of the performance report, `0` disables it
+#define LVGL_PORT_LOG_STORE_BYTES   (CONFIG_EXAMPLE_LOG_STORE_KB * 1024)         // Log history store, allocated in PSRAM
+
+/**
+ * Power related parameters, see the "Power" menu
+ *
+ */
+#ifdef CONFIG_EXAMPLE_LVGL_PORT_IDLE_ENABLE
+#define LVGL_PORT_IDLE_ENABLE       (1)             // Pause the refresh and touch read timers while the screen is static
+#else
+#define LVGL_PORT_IDLE_ENABLE       (0)
+#endif
+#ifdef CONFIG_EXAMPLE_PM_DFS_ENABLE
+#define LVGL_PORT_PM_DFS            (1)             // Hold the CPU at full clock only while the LVGL task is busy
+#define LVGL_PORT_PM_MIN_FREQ_MHZ   (CONFIG_EXAMPLE_PM_MIN_FREQ_MHZ)
+#else
+#define LVGL_PORT_PM_DFS            (0)
+#endif
+#define LVGL_PORT_BACKLIGHT_OFF_MS  (CONFIG_EXAMPLE_BACKLIGHT_OFF_S * 1000)       // `0` keeps the backlight on
+
+/**
+ * Bits for `lvgl_port_wait_ready()`
+ *
+ */
+#define LVGL_PORT_READY_UI          (1 << 0)        // ui_init() has run, earlier `ui.h` calls are dropped
+#define LVGL_PORT_READY_FRAME       (1 << 1)        // The first pass that applied UI messages has been flushed
+#define LVGL_PORT_READY_TOUCH       (1 << 2)        // `lvgl_port_attach_touch()` has registered the touch panel
 /**
  *
  * LVGL buffer related parameters, can be adjusted by users:
@@ -73,6 +102,7 @@ extern "C" {
  *      - 1: LCD double-buffer & LVGL full-refresh
  *      - 2: LCD triple-buffer & LVGL full-refresh
  *      - 3: LCD double-buffer & LVGL direct-mode (recommended)
+ *      - 4: LCD double-buffer & LVGL partial tiles in internal SRAM, written back to PSRAM by GDMA (rotation 0 only)
  *
  */
 #define LVGL_PORT_AVOID_TEAR_MODE       (CONFIG_EXAMPLE_LVGL_PORT_AVOID_TEAR_MODE)
@@ -100,8 +130,23 @@ extern "C" {
 #elif LVGL_PORT_AVOID_TEAR_MODE == 3
 #define LVGL_PORT_LCD_RGB_BUFFER_NUMS   (2)
 #define LVGL_PORT_DIRECT_MODE           (1)
+#elif LVGL_PORT_AVOID_TEAR_MODE == 4
+#define LVGL_PORT_LCD_RGB_BUFFER_NUMS   (2)
+#define LVGL_PORT_TILE_MODE             (1)
+#define LVGL_PORT_TILE_LINES            (CONFIG_EXAMPLE_LVGL_PORT_TILE_LINES) // Height of the two internal SRAM tiles
 #endif /* LVGL_PORT_AVOID_TEAR_MODE */
 
+/**
+ * In direct and tile mode, copy the dirty areas between the two frame buffers with the GDMA memcpy engine
+ * instead of the CPU (full-width spans only)
+ *
+ */
+#ifdef CONFIG_EXAMPLE_LVGL_PORT_DIRTY_COPY_DMA
+#define LVGL_PORT_DIRTY_COPY_DMA        (1)
+#else
+#define LVGL_PORT_DIRTY_COPY_DMA        (0)
+#endif
+
 #if EXAMPLE_LVGL_PORT_ROTATION_DEGREE == 0
 #define EXAMPLE_LVGL_PORT_ROTATION_0    (1)
 #else
@@ -121,13 +166,14 @@ extern "C" {
 #define LVGL_PORT_LCD_RGB_BUFFER_NUMS   (1)
 #define LVGL_PORT_FULL_REFRESH          (0)
 #define LVGL_PORT_DIRECT_MODE           (0)
+#define LVGL_PORT_TILE_MODE             (0)
 #endif /* LVGL_PORT_AVOID_TEAR_ENABLE */
 
 /**
  * @brief Initialize LVGL port
  *
  * @param[in] lcd_handle: LCD panel handle
- * @param[in] tp_handle: Touch panel handle
+ * @param[in] tp_handle: Touch panel handle, NULL to attach it later with `lvgl_port_attach_touch()`
  *
  * @return
  *      - ESP_OK: Success
@@ -136,6 +182,45 @@ extern "C" {
  */
 esp_err_t lvgl_port_init(esp_lcd_panel_handle_t lcd_handle, esp_lcd_touch_handle_t tp_handle);
 
+/**
+ * @brief Register the touch panel after `lvgl_port_init()`, so the touch controller can be reset and probed
+ *        on another task while LVGL starts
+ *
+ * @param[in] tp_handle: Touch panel handle
+ *
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: No handle, or a touch panel is already registered
+ *      - Others: Fail
+ */
+esp_err_t lvgl_port_attach_touch(esp_lcd_touch_handle_t tp_handle);
+
+/**
+ * @brief Switch the backlight, called from the LVGL task
+ */
+typedef void (*lvgl_port_backlight_cb_t)(bool on);
+
+/**
+ * @brief Let the LVGL task turn the backlight off after LVGL_PORT_BACKLIGHT_OFF_MS without touch
+ *
+ * @note The press that turns the backlight back on is not passed to LVGL
+ *
+ * @param[in] cb: Backlight switch, NULL keeps the backlight on
+ */
+void lvgl_port_set_backlight_cb(lvgl_port_backlight_cb_t cb);
+
+/**
+ * @brief Wait for LVGL_PORT_READY_* bits, replaces a fixed delay before the first `ui.h` call
+ *
+ * @param[in] bits: LVGL_PORT_READY_* bits, all of them are waited for
+ * @param[in] timeout_ms: Timeout in [ms], -1 blocks indefinitely
+ *
+ * @return
+ *      - true:  All bits are set
+ *      - false: Timeout
+ */
+bool lvgl_port_wait_ready(uint32_t bits, int timeout_ms);
+
 /**
  * @brief Take LVGL mutex
  *
@@ -153,6 +238,14 @@ bool lvgl_port_lock(int timeout_ms);
  */
 void lvgl_port_unlock(void);
 
+/**
+ * @brief Wake the LVGL task to apply pending UI messages
+ *
+ * @note This function is registered as the UI wakeup callback, it must not be called from ISR
+ *
+ */
+void lvgl_port_wake(void);
+
 /**
  * @brief Notifies the LVGL task when the transmission of the RGB frame buffer is completed.
  *
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * LVGL timebase (`LV_TICK_CUSTOM`): `lv_tick_get()` reads esp_timer instead of counting `lv_tick_inc()` calls,
+ * so no periodic tick interrupt is needed and the tick stays exact while the LVGL task sleeps.
+ *
+ */
+
+/**
+ * @brief Milliseconds since boot, wraps after 49 days like the LVGL tick
+ */
+uint32_t lvgl_tick_get(void);
+
+#ifdef __cplusplus
+}
+#endif
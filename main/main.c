@@ -5,8 +5,19 @@
  */
 
 #include "waveshare_rgb_lcd_port.h"
+#include "app_console.h"
+#include "uart_proto.h"
+#include "log_bridge.h"
+#include "boot_prof.h"
 #include "ui.h"
 
+#if CONFIG_EXAMPLE_LCD_TOUCH_CONTROLLER_GT911
+#define BOOT_READY_BITS         (LVGL_PORT_READY_FRAME | LVGL_PORT_READY_TOUCH)
+#else
+#define BOOT_READY_BITS         (LVGL_PORT_READY_FRAME)
+#endif
+#define BOOT_READY_TIMEOUT_MS   (2000)  // The boot profile is printed after this even if a phase hangs
+
 void key1_pressed(void)
 {
     ui_add_log("pressed");
@@ -17,14 +28,17 @@ void key4_pressed(void)
 }
 void app_main()
 {
-    waveshare_esp32_s3_rgb_lcd_init(); // Initialize the Waveshare ESP32-S3 RGB LCD 
+    boot_prof_mark("app_main");
+    waveshare_esp32_s3_rgb_lcd_init(); // Initialize the Waveshare ESP32-S3 RGB LCD, the touch panel comes up on its own task
     // wavesahre_rgb_lcd_bl_on();  //Turn on the screen backlight 
     // wavesahre_rgb_lcd_bl_off(); //Turn off the screen backlight 
 
-    vTaskDelay(pdMS_TO_TICKS(1000));
+    lvgl_port_wait_ready(LVGL_PORT_READY_UI, -1); // ui.h calls before ui_init() are dropped
 
+    // 初始内容作为一批提交，首帧就是完整的界面
+    ui_batch_begin();
     ui_set_top_firmware_info("UniController", "v1.0.0");
-    ui_set_bottom_info("192.168.1.100", 115200, "FW-2025");
+    ui_set_bottom_info("192.168.1.100", uart_proto_baud_rate(), "FW-2025");
 
     // 主状态区三列示例
     ui_set_status_item(0, "Temp", "25°C", lv_color_hex(0x00FF00));
@@ -40,11 +54,37 @@ void app_main()
     ui_set_button(2, "Debug", key1_pressed);
     ui_set_button(3, "Clear", key4_pressed);
 
+    // 图标：状态项一页、按钮一页（sim/scripts/iconpack.py --demo），图标分区里没有图集时不显示
+    ui_set_status_icon(0, "temp");
+    ui_set_status_icon(1, "pressure");
+    ui_set_status_icon(2, "mode");
+    ui_set_status_icon(3, "flow");
+    ui_set_status_icon(4, "error");
+    ui_set_status_icon(5, "uptime");
+    ui_set_button_icon(0, "start");
+    ui_set_button_icon(1, "stop");
+    ui_set_button_icon(2, "debug");
+    ui_set_button_icon(3, "clear");
+
     // 日志
     ui_add_log("System booting...");
     ui_add_log("LVGL initialized.");
     ui_add_log("Network connected.");
     ui_add_log("Device ready.");
+    ui_batch_end();
+
+    // LVGL 任务在另一个核上渲染首帧，其余服务同时启动
+    int prof = boot_prof_begin("services");
+    app_console_start();               // Serial console with the `bench` command
+    uart_proto_start();                // UI commands from an external controller, see ui_proto.h
+    log_bridge_start();                // ESP_LOGx output in the on-screen log, see ui_log_bridge.h
+    boot_prof_end(prof);
+
+    if (!lvgl_port_wait_ready(BOOT_READY_BITS, BOOT_READY_TIMEOUT_MS)) {
+        ESP_LOGW(TAG, "Boot not finished after %d ms", BOOT_READY_TIMEOUT_MS);
+    }
+    boot_prof_report();
+
     while(1)
     {
         ui_add_log("tick.");
@@ -0,0 +1,66 @@
+#include <string.h>
+#include "perf_hist.h"
+
+#define SUB_COUNT   (1 << PERF_HIST_SUB_BITS)
+
+static uint32_t bucket_index(uint32_t value)
+{
+    if (value < SUB_COUNT) {
+        return value;
+    }
+    uint32_t msb = 31 - __builtin_clz(value);
+    uint32_t sub = (value >> (msb - PERF_HIST_SUB_BITS)) & (SUB_COUNT - 1);
+    return (msb - PERF_HIST_SUB_BITS + 1) * SUB_COUNT + sub;
+}
+
+static uint32_t bucket_upper(uint32_t index)
+{
+    if (index < SUB_COUNT) {
+        return index;
+    }
+    uint32_t msb = index / SUB_COUNT + PERF_HIST_SUB_BITS - 1;
+    uint32_t sub = index % SUB_COUNT;
+    uint64_t lower = (uint64_t)(SUB_COUNT + sub) << (msb - PERF_HIST_SUB_BITS);
+    uint64_t width = 1ULL << (msb - PERF_HIST_SUB_BITS);
+    uint64_t upper = lower + width - 1;
+    return (upper > UINT32_MAX) ? UINT32_MAX : (uint32_t)upper;
+}
+
+void perf_hist_reset(perf_hist_t *hist)
+{
+    memset(hist, 0, sizeof(*hist));
+    hist->min = UINT32_MAX;
+}
+
+void perf_hist_add(perf_hist_t *hist, uint32_t value)
+{
+    hist->buckets[bucket_index(value)]++;
+    hist->count++;
+    hist->sum += value;
+    if (value < hist->min) {
+        hist->min = value;
+    }
+    if (value > hist->max) {
+        hist->max = value;
+    }
+}
+
+uint32_t perf_hist_percentile(const perf_hist_t *hist, uint32_t percent)
+{
+    if (hist->count == 0) {
+        return 0;
+    }
+    uint64_t target = ((uint64_t)hist->count * percent + 99) / 100;
+    if (target == 0) {
+        target = 1;
+    }
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < PERF_HIST_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= target) {
+            uint32_t upper = bucket_upper(i);
+            return (upper > hist->max) ? hist->max : upper;
+        }
+    }
+    return hist->max;
+}
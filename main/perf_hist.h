@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Log-linear histogram: four buckets per power of two, so any recorded value is
+ * reported with at most 25% error. Not thread safe, record from a single task.
+ *
+ */
+#define PERF_HIST_SUB_BITS  (2)
+#define PERF_HIST_BUCKETS   (32 << PERF_HIST_SUB_BITS)
+
+typedef struct {
+    uint32_t buckets[PERF_HIST_BUCKETS];
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} perf_hist_t;
+
+/**
+ * @brief Clear all samples
+ */
+void perf_hist_reset(perf_hist_t *hist);
+
+/**
+ * @brief Record one sample
+ */
+void perf_hist_add(perf_hist_t *hist, uint32_t value);
+
+/**
+ * @brief Get the value below which `percent` of the samples fall
+ *
+ * @param[in] percent: 0 - 100
+ *
+ * @return
+ *      - Upper bound of the bucket that holds the percentile, 0 if the histogram is empty
+ */
+uint32_t perf_hist_percentile(const perf_hist_t *hist, uint32_t percent);
+
+#ifdef __cplusplus
+}
+#endif
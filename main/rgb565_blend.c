@@ -0,0 +1,269 @@
+#include <stddef.h>
+#include <string.h>
+#include "rgb565_blend.h"
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+#if CONFIG_IDF_TARGET_ESP32S3 && CONFIG_EXAMPLE_LVGL_PORT_PIE_BLEND
+#define RGB565_BLEND_PIE    (1)
+#else
+#define RGB565_BLEND_PIE    (0)
+#endif
+
+#define MIN(a, b)   (((a) < (b)) ? (a) : (b))
+#define UDIV255(x)  (((x) * 0x8081U) >> 0x17)           // Same as LV_UDIV255()
+
+static bool simd_enabled = RGB565_BLEND_PIE;
+
+static inline uint16_t mix(uint16_t fg, uint16_t bg, uint32_t a)
+{
+    const uint32_t ia = 255 - a;
+    const uint32_t r = UDIV255((fg >> 11) * a + (bg >> 11) * ia + RGB565_BLEND_ROUND_OFS);
+    const uint32_t g = UDIV255(((fg >> 5) & 0x3F) * a + ((bg >> 5) & 0x3F) * ia + RGB565_BLEND_ROUND_OFS);
+    const uint32_t b = UDIV255((fg & 0x1F) * a + (bg & 0x1F) * ia + RGB565_BLEND_ROUND_OFS);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+/* Opacity of a masked pixel, as `fill_normal()` of LVGL computes it */
+static inline uint32_t mask_opa(uint8_t m, uint8_t opa)
+{
+    if (opa == 255) {
+        return m;
+    }
+    return (m == 255) ? opa : ((uint32_t)m * opa) >> 8;
+}
+
+/* a = 0 keeps the background and a = 255 gives the foreground, the shortcuts only save the multiplies */
+static inline void mix_px(uint16_t *d, uint16_t fg, uint32_t a)
+{
+    if (a == 255) {
+        *d = fg;
+    } else if (a) {
+        *d = mix(fg, *d, a);
+    }
+}
+
+static void fill_row_c(uint16_t *d, int w, uint16_t color)
+{
+    if ((w > 0) && ((uintptr_t)d & 2)) {
+        *d++ = color;                                    // Align to 4 bytes
+        w--;
+    }
+    const uint32_t pair = ((uint32_t)color << 16) | color;
+    for (; w >= 2; w -= 2) {
+        memcpy(d, &pair, sizeof(pair));                  // One 32-bit store, without aliasing issues
+        d += 2;
+    }
+    if (w) {
+        *d = color;
+    }
+}
+
+#if RGB565_BLEND_PIE
+/**
+ * Row bodies on the PIE vector unit, see rgb565_blend_pie.S. The 128-bit loads and stores ignore the low four
+ * address bits, so `dst` is advanced to a 16-byte boundary in C first; sources that are not aligned the same way
+ * are staged through an aligned buffer, and A8 masks are widened to one 16-bit opacity per lane.
+ *
+ */
+#define PIE_LANES   (8)                                  // RGB565 pixels per 128-bit register
+#define PIE_CHUNK   (256)                                // Pixels staged per call of `rgb565_pie_mix()`, multiple of PIE_LANES
+#define PIE_VEC(v)  { v, v, v, v, v, v, v, v }
+
+typedef struct {
+    uint16_t mask_r[PIE_LANES];
+    uint16_t mask_g[PIE_LANES];
+    uint16_t mask_b[PIE_LANES];
+    uint16_t round[PIE_LANES];
+    uint16_t udiv[PIE_LANES];
+    uint16_t max[PIE_LANES];
+    uint16_t color[PIE_LANES];                           // Foreground of the fills
+    uint16_t opa[PIE_LANES];                             // Constant opacity
+    int32_t fg_step;                                     // 16 bytes per block, or 0 to repeat `color`
+    int32_t alpha_step;                                  // 16 bytes per block, or 0 to repeat `opa`
+} __attribute__((aligned(16))) pie_ctx_t;
+
+_Static_assert(offsetof(pie_ctx_t, fg_step) == 128, "rgb565_blend_pie.S reads the steps at offset 128");
+
+void rgb565_pie_fill(uint16_t *dst, const uint16_t *color, int blocks);
+void rgb565_pie_copy(uint16_t *dst, const uint16_t *src, int blocks);
+void rgb565_pie_mix(uint16_t *dst, const uint16_t *fg, const uint16_t *alpha, int blocks, const pie_ctx_t *ctx);
+
+static pie_ctx_t pie_ctx = {
+    .mask_r = PIE_VEC(0xF800),
+    .mask_g = PIE_VEC(0x07E0),
+    .mask_b = PIE_VEC(0x001F),
+    .round = PIE_VEC(RGB565_BLEND_ROUND_OFS),
+    .udiv = PIE_VEC(0x8081),
+    .max = PIE_VEC(255),
+};
+static uint16_t pie_fg[PIE_CHUNK] __attribute__((aligned(16)));
+static uint16_t pie_alpha[PIE_CHUNK] __attribute__((aligned(16)));
+
+static void fill_row_pie(uint16_t *d, int w, uint16_t color)
+{
+    for (; (w > 0) && ((uintptr_t)d & 15); w--) {
+        *d++ = color;
+    }
+    const int blocks = w / PIE_LANES;
+    rgb565_pie_fill(d, &color, blocks);
+    d += blocks * PIE_LANES;
+    for (w -= blocks * PIE_LANES; w > 0; w--) {
+        *d++ = color;
+    }
+}
+
+static void copy_row_pie(uint16_t *d, const uint16_t *s, int w)
+{
+    if (((uintptr_t)d ^ (uintptr_t)s) & 15) {
+        memcpy(d, s, w * sizeof(uint16_t));              // Can never be aligned together
+        return;
+    }
+    for (; (w > 0) && ((uintptr_t)d & 15); w--) {
+        *d++ = *s++;
+    }
+    const int blocks = w / PIE_LANES;
+    rgb565_pie_copy(d, s, blocks);
+    memcpy(d + blocks * PIE_LANES, s + blocks * PIE_LANES, (w - blocks * PIE_LANES) * sizeof(uint16_t));
+}
+
+/* `fg` NULL blends `pie_ctx.color`, `mask` NULL uses `opa` for every pixel */
+static void mix_row_pie(uint16_t *d, const uint16_t *fg, const uint8_t *mask, int w, uint8_t opa)
+{
+    for (; (w > 0) && ((uintptr_t)d & 15); w--) {
+        mix_px(d++, fg ? *fg++ : pie_ctx.color[0], mask ? mask_opa(*mask++, opa) : opa);
+    }
+    pie_ctx.fg_step = fg ? 16 : 0;
+    pie_ctx.alpha_step = mask ? 16 : 0;
+    while (w >= PIE_LANES) {
+        const int n = MIN(w, PIE_CHUNK) & ~(PIE_LANES - 1);
+        const uint16_t *fg_vec = pie_ctx.color;
+        const uint16_t *alpha_vec = pie_ctx.opa;
+        bool visible = true;
+        if (fg) {
+            fg_vec = fg;
+            if ((uintptr_t)fg & 15) {
+                memcpy(pie_fg, fg, n * sizeof(uint16_t));
+                fg_vec = pie_fg;
+            }
+            fg += n;
+        }
+        if (mask) {
+            uint32_t any = 0;
+            for (int i = 0; i < n; i++) {
+                any |= pie_alpha[i] = mask_opa(mask[i], opa);
+            }
+            alpha_vec = pie_alpha;
+            visible = (any != 0);                        // Skip the empty spans around glyphs and rounded corners
+            mask += n;
+        }
+        if (visible) {
+            rgb565_pie_mix(d, fg_vec, alpha_vec, n / PIE_LANES, &pie_ctx);
+        }
+        d += n;
+        w -= n;
+    }
+    for (; w > 0; w--) {
+        mix_px(d++, fg ? *fg++ : pie_ctx.color[0], mask ? mask_opa(*mask++, opa) : opa);
+    }
+}
+#endif /* RGB565_BLEND_PIE */
+
+void rgb565_fill(uint16_t *dst, int dst_stride, int w, int h, uint16_t color)
+{
+    for (int y = 0; y < h; y++, dst += dst_stride) {
+#if RGB565_BLEND_PIE
+        if (simd_enabled) {
+            fill_row_pie(dst, w, color);
+            continue;
+        }
+#endif
+        fill_row_c(dst, w, color);
+    }
+}
+
+void rgb565_copy(uint16_t *dst, int dst_stride, const uint16_t *src, int src_stride, int w, int h)
+{
+    for (int y = 0; y < h; y++, dst += dst_stride, src += src_stride) {
+#if RGB565_BLEND_PIE
+        if (simd_enabled) {
+            copy_row_pie(dst, src, w);
+            continue;
+        }
+#endif
+        memcpy(dst, src, w * sizeof(uint16_t));
+    }
+}
+
+void rgb565_fill_mix(uint16_t *dst, int dst_stride, int w, int h, uint16_t color, uint8_t opa,
+                     const uint8_t *mask, int mask_stride)
+{
+#if RGB565_BLEND_PIE
+    if (simd_enabled) {
+        for (int i = 0; i < PIE_LANES; i++) {
+            pie_ctx.color[i] = color;
+            pie_ctx.opa[i] = opa;
+        }
+        for (int y = 0; y < h; y++, dst += dst_stride) {
+            mix_row_pie(dst, NULL, mask, w, opa);
+            if (mask) {
+                mask += mask_stride;
+            }
+        }
+        return;
+    }
+#endif
+    if (mask) {
+        for (int y = 0; y < h; y++, dst += dst_stride, mask += mask_stride) {
+            for (int x = 0; x < w; x++) {
+                mix_px(&dst[x], color, mask_opa(mask[x], opa));
+            }
+        }
+        return;
+    }
+    /* Backgrounds are mostly flat, remember the last result like LVGL does */
+    uint16_t last_bg = dst[0];
+    uint16_t last_res = mix(color, last_bg, opa);
+    for (int y = 0; y < h; y++, dst += dst_stride) {
+        for (int x = 0; x < w; x++) {
+            if (dst[x] != last_bg) {
+                last_bg = dst[x];
+                last_res = mix(color, last_bg, opa);
+            }
+            dst[x] = last_res;
+        }
+    }
+}
+
+void rgb565_copy_mix(uint16_t *dst, int dst_stride, const uint16_t *src, int src_stride, int w, int h, uint8_t opa)
+{
+#if RGB565_BLEND_PIE
+    if (simd_enabled) {
+        for (int i = 0; i < PIE_LANES; i++) {
+            pie_ctx.opa[i] = opa;
+        }
+        for (int y = 0; y < h; y++, dst += dst_stride, src += src_stride) {
+            mix_row_pie(dst, src, NULL, w, opa);
+        }
+        return;
+    }
+#endif
+    for (int y = 0; y < h; y++, dst += dst_stride, src += src_stride) {
+        for (int x = 0; x < w; x++) {
+            dst[x] = mix(src[x], dst[x], opa);
+        }
+    }
+}
+
+bool rgb565_blend_get_simd(void)
+{
+    return simd_enabled;
+}
+
+bool rgb565_blend_set_simd(bool enable)
+{
+    const bool prev = simd_enabled;
+    simd_enabled = enable && RGB565_BLEND_PIE;
+    return prev;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * RGB565 fill, copy and blend kernels for the LVGL software renderer.
+ *
+ * Blending follows `lv_color_mix()` with LV_COLOR_MIX_ROUND_OFS = RGB565_BLEND_ROUND_OFS, per channel:
+ *      out = ((fg * a + bg * (255 - a) + RGB565_BLEND_ROUND_OFS) * 0x8081) >> 23
+ * so the results are bit-exact with LVGL. On the ESP32-S3 the row bodies run on the PIE 128-bit vector unit,
+ * eight pixels per instruction, the unaligned head and tail of each row and every other target use C.
+ *
+ * Strides are in pixels. The kernels share static staging buffers and are not reentrant, only the LVGL task
+ * (or a task holding the LVGL lock) may call them.
+ *
+ */
+#define RGB565_BLEND_ROUND_OFS  (128)       // Must match LV_COLOR_MIX_ROUND_OFS, see `lvgl_draw.c`
+
+/**
+ * @brief Fill an area with `color`
+ */
+void rgb565_fill(uint16_t *dst, int dst_stride, int w, int h, uint16_t color);
+
+/**
+ * @brief Copy an area, `src` and `dst` must not overlap
+ */
+void rgb565_copy(uint16_t *dst, int dst_stride, const uint16_t *src, int src_stride, int w, int h);
+
+/**
+ * @brief Blend `color` over an area with the opacity `opa`, optionally scaled by an A8 mask
+ *
+ * With a mask the opacity of a pixel is `mask` if `opa` is 255, otherwise `opa` where the mask is 255 and
+ * `mask * opa >> 8` elsewhere, as in LVGL.
+ *
+ * @param[in] mask: One byte per pixel, NULL for a constant opacity
+ */
+void rgb565_fill_mix(uint16_t *dst, int dst_stride, int w, int h, uint16_t color, uint8_t opa,
+                     const uint8_t *mask, int mask_stride);
+
+/**
+ * @brief Blend an area of `src` over `dst` with the constant opacity `opa`
+ */
+void rgb565_copy_mix(uint16_t *dst, int dst_stride, const uint16_t *src, int src_stride, int w, int h, uint8_t opa);
+
+/**
+ * @brief Whether the SIMD kernels are in use, always false if the build has none
+ */
+bool rgb565_blend_get_simd(void);
+
+/**
+ * @brief Use the SIMD kernels (default, if the build has them) or the portable C ones, for benchmarks
+ *
+ * @return
+ *      - The previous setting
+ */
+bool rgb565_blend_set_simd(bool enable);
+
+#ifdef __cplusplus
+}
+#endif
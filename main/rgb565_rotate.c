@@ -0,0 +1,127 @@
+#include <string.h>
+#include "rgb565_rotate.h"
+
+#define MIN(a, b)   (((a) < (b)) ? (a) : (b))
+
+/* `dst` must be 4-byte aligned, memcpy keeps the 32-bit store free of aliasing issues */
+static inline void store_pair(uint16_t *dst, uint32_t pair)
+{
+    memcpy(dst, &pair, sizeof(pair));
+}
+
+/**
+ * The kernels are portable C. A PIE 8x8 transpose has not been written: both frame buffers are in PSRAM, so
+ * a rotation cannot run faster than a plain copy of the frame. The startup log of a rotated build prints the
+ * copy and each angle side by side ("Rotate copy" and "Rotate <angle>: ... % of the copy"); a PIE transpose
+ * is only worth adding if the angles stay well below the copy. These numbers have not been taken on the
+ * board yet. `--rotate-check` in the simulator checks the kernels against the mapping in rgb565_rotate.h.
+ *
+ */
+
+/**
+ * 90 and 270 degrees turn source columns into destination rows. Each tile is walked along the destination
+ * rows so the writes stay sequential, and two source rows are packed into one 32-bit store.
+ *
+ */
+static void rotate_90_tile(uint16_t *dst, const uint16_t *src, int src_w, int src_h,
+                           int x1, int y1, int x2, int y2)
+{
+    const int dst_w = src_h;
+    for (int x = x1; x <= x2; x++) {
+        const uint16_t *s = src + y1 * src_w + x;
+        uint16_t *d = dst + x * dst_w + (dst_w - 1 - y1);    // Moves left as y grows
+        int y = y1;
+        if ((y <= y2) && !((uintptr_t)d & 2)) {
+            *d-- = *s;                                       // Align `d - 1` to 4 bytes
+            s += src_w;
+            y++;
+        }
+        for (; y + 1 <= y2; y += 2) {
+            store_pair(d - 1, ((uint32_t)s[0] << 16) | s[src_w]);
+            d -= 2;
+            s += 2 * src_w;
+        }
+        if (y <= y2) {
+            *d = *s;
+        }
+    }
+}
+
+static void rotate_270_tile(uint16_t *dst, const uint16_t *src, int src_w, int src_h,
+                            int x1, int y1, int x2, int y2)
+{
+    const int dst_w = src_h;
+    for (int x = x1; x <= x2; x++) {
+        const uint16_t *s = src + y1 * src_w + x;
+        uint16_t *d = dst + (src_w - 1 - x) * dst_w + y1;    // Moves right as y grows
+        int y = y1;
+        if ((y <= y2) && ((uintptr_t)d & 2)) {
+            *d++ = *s;
+            s += src_w;
+            y++;
+        }
+        for (; y + 1 <= y2; y += 2) {
+            store_pair(d, s[0] | ((uint32_t)s[src_w] << 16));
+            d += 2;
+            s += 2 * src_w;
+        }
+        if (y <= y2) {
+            *d = *s;
+        }
+    }
+}
+
+/**
+ * 180 degrees keeps rows as rows, so every row is a sequential reversed copy and needs no tiling.
+ *
+ */
+static void rotate_180(uint16_t *dst, const uint16_t *src, int src_w, int src_h,
+                       int x1, int y1, int x2, int y2)
+{
+    for (int y = y1; y <= y2; y++) {
+        const uint16_t *s = src + y * src_w + x1;
+        uint16_t *d = dst + (src_h - 1 - y) * src_w + (src_w - 1 - x1);  // Moves left as x grows
+        int x = x1;
+        if ((x <= x2) && !((uintptr_t)d & 2)) {
+            *d-- = *s++;
+            x++;
+        }
+        for (; x + 1 <= x2; x += 2) {
+            store_pair(d - 1, ((uint32_t)s[0] << 16) | s[1]);
+            d -= 2;
+            s += 2;
+        }
+        if (x <= x2) {
+            *d = *s;
+        }
+    }
+}
+
+void rgb565_rotate_area(uint16_t *dst, const uint16_t *src, int src_w, int src_h,
+                        int x1, int y1, int x2, int y2, int degree)
+{
+    switch (degree) {
+    case 90:
+    case 270:
+        for (int ty = y1; ty <= y2; ty += RGB565_ROTATE_TILE) {
+            const int ty2 = MIN(ty + RGB565_ROTATE_TILE - 1, y2);
+            for (int tx = x1; tx <= x2; tx += RGB565_ROTATE_TILE) {
+                const int tx2 = MIN(tx + RGB565_ROTATE_TILE - 1, x2);
+                if (degree == 90) {
+                    rotate_90_tile(dst, src, src_w, src_h, tx, ty, tx2, ty2);
+                } else {
+                    rotate_270_tile(dst, src, src_w, src_h, tx, ty, tx2, ty2);
+                }
+            }
+        }
+        break;
+    case 180:
+        rotate_180(dst, src, src_w, src_h, x1, y1, x2, y2);
+        break;
+    default:
+        for (int y = y1; y <= y2; y++) {
+            memcpy(dst + y * src_w + x1, src + y * src_w + x1, (x2 - x1 + 1) * sizeof(uint16_t));
+        }
+        break;
+    }
+}
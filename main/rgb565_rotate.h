@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Software rotation of RGB565 frame buffers, the panel is always scanned out in its native orientation.
+ *
+ * A source pixel (x, y) of a `src_w` x `src_h` frame is written to:
+ *      - 90:  (src_h - 1 - y, x)            in a `src_h` x `src_w` frame (clockwise)
+ *      - 180: (src_w - 1 - x, src_h - 1 - y) in a `src_w` x `src_h` frame
+ *      - 270: (y, src_w - 1 - x)            in a `src_h` x `src_w` frame
+ *
+ */
+#define RGB565_ROTATE_TILE  (32)    // Tile edge in pixels, a 32x32 tile of source and destination fits in the data cache
+
+/**
+ * @brief Rotate the area [x1, x2] x [y1, y2] (inclusive, source coordinates) of `src` into `dst`
+ *
+ * @param[in] degree: 90, 180 or 270, other values copy the area without rotation
+ *
+ * @note `src` and `dst` must not overlap
+ */
+void rgb565_rotate_area(uint16_t *dst, const uint16_t *src, int src_w, int src_h,
+                        int x1, int y1, int x2, int y2, int degree);
+
+#ifdef __cplusplus
+}
+#endif
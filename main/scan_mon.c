@@ -0,0 +1,283 @@
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_cache.h"
+#include "esp_heap_caps.h"
+#include "esp_lcd_panel_rgb.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "perf_hist.h"
+#include "scan_mon.h"
+
+static const char *TAG = "scan_mon";                     // Tag for logging
+
+#define PROBE_DST_LINES         (8)                      // Internal RAM target of the refills, longer ones wrap around
+#define PROBE_SETTLE_MS         (200)                    // A new pixel clock takes effect at the next vsync
+#define PROBE_TASK_STACK_SIZE   (3 * 1024)
+#define PROBE_TASK_PRIORITY     (configMAX_PRIORITIES - 2)
+
+static const uint16_t cal_heights[SCAN_MON_CAL_HEIGHTS] = { 4, 6, 8, 10, 12, 15, 20, 24, 30, 40 };
+
+static portMUX_TYPE mon_lock = portMUX_INITIALIZER_UNLOCKED;
+static portMUX_TYPE probe_lock = portMUX_INITIALIZER_UNLOCKED;   // Only keeps interrupts off during a refill
+static esp_lcd_panel_handle_t mon_panel = NULL;
+static scan_mon_timing_t mon_timing;
+static int mon_isr_core;                                 // The RGB ISR runs on the core that created the panel
+static uint32_t frame_us;                                // Frame period at the current pixel clock
+static uint32_t deadline_us;                             // Scan-out time of one bounce buffer
+static scan_mon_stats_t mon_stats;
+static int64_t last_vsync_us = 0;
+static int32_t phase_floor_us = INT32_MAX;               // Earliest end of the last refill, relative to vsync
+static uint32_t underrun_run = 0;                        // Consecutive frames with an underrun
+
+static void set_periods(uint32_t pclk_hz)
+{
+    const uint64_t line_clocks = mon_timing.h_total;
+    frame_us = (uint32_t)(line_clocks * mon_timing.v_total * 1000000ULL / pclk_hz);
+    deadline_us = (uint32_t)(line_clocks * mon_timing.bounce_lines * 1000000ULL / pclk_hz);
+    mon_timing.pclk_hz = pclk_hz;
+}
+
+void scan_mon_init(esp_lcd_panel_handle_t panel, const scan_mon_timing_t *timing)
+{
+    portENTER_CRITICAL(&mon_lock);
+    mon_panel = panel;
+    mon_timing = *timing;
+    mon_isr_core = xPortGetCoreID();
+    set_periods(timing->pclk_hz);
+    memset(&mon_stats, 0, sizeof(mon_stats));
+    phase_floor_us = INT32_MAX;
+    underrun_run = 0;
+    portEXIT_CRITICAL(&mon_lock);
+}
+
+IRAM_ATTR void scan_mon_vsync_isr(void)
+{
+    const int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&mon_lock);
+    last_vsync_us = now_us;
+    mon_stats.vsyncs++;
+    portEXIT_CRITICAL_ISR(&mon_lock);
+}
+
+IRAM_ATTR void scan_mon_bounce_frame_isr(void)
+{
+    const int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&mon_lock);
+    mon_stats.bounce_frames++;
+    if (last_vsync_us && frame_us && deadline_us) {
+        /* Distance to the nearest vsync, a late refill may end after the next one */
+        int32_t phase_us = (int32_t)((now_us - last_vsync_us) % frame_us);
+        if (phase_us > (int32_t)(frame_us / 2)) {
+            phase_us -= frame_us;
+        }
+        if (phase_us < phase_floor_us) {
+            phase_floor_us = phase_us;
+        }
+        const uint32_t excess_us = (uint32_t)(phase_us - phase_floor_us);
+        mon_stats.excess_us_total += excess_us;
+        if (excess_us > mon_stats.excess_us_max) {
+            mon_stats.excess_us_max = excess_us;
+        }
+        if (excess_us > deadline_us / 2) {
+            mon_stats.late++;
+        }
+        if (excess_us > deadline_us) {
+            mon_stats.underruns++;
+            if (++underrun_run == SCAN_MON_DRIFT_FRAMES) {
+                mon_stats.drifts++;
+            }
+        } else {
+            underrun_run = 0;
+        }
+    }
+    portEXIT_CRITICAL_ISR(&mon_lock);
+}
+
+void scan_mon_get_stats(scan_mon_stats_t *stats, bool reset_max)
+{
+    portENTER_CRITICAL(&mon_lock);
+    *stats = mon_stats;
+    stats->deadline_us = deadline_us;
+    stats->pclk_hz = mon_timing.pclk_hz;
+    if (reset_max) {
+        mon_stats.excess_us_max = 0;
+    }
+    portEXIT_CRITICAL(&mon_lock);
+}
+
+uint32_t scan_mon_frame_bytes(void)
+{
+    return (uint32_t)mon_timing.h_res * mon_timing.v_res * mon_timing.bytes_per_pixel;
+}
+
+/* Forget the earliest refill, it depends on the pixel clock */
+static void rebase(void)
+{
+    portENTER_CRITICAL(&mon_lock);
+    phase_floor_us = INT32_MAX;
+    underrun_run = 0;
+    portEXIT_CRITICAL(&mon_lock);
+}
+
+static esp_err_t set_pclk(uint32_t pclk_hz)
+{
+    esp_err_t ret = esp_lcd_rgb_panel_set_pclk(mon_panel, pclk_hz);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    portENTER_CRITICAL(&mon_lock);
+    set_periods(pclk_hz);
+    portEXIT_CRITICAL(&mon_lock);
+    vTaskDelay(pdMS_TO_TICKS(PROBE_SETTLE_MS));
+    rebase(); // Frames of the old clock ended at other distances to vsync
+    return ESP_OK;
+}
+
+typedef struct {
+    const uint8_t *src;                                  // Test frame in PSRAM, never written by the CPU after setup
+    uint8_t *dst;                                        // PROBE_DST_LINES lines of internal RAM
+    volatile bool stop;
+    TaskHandle_t caller;
+    perf_hist_t hists[SCAN_MON_CAL_HEIGHTS];             // Refill time per height, in us
+} probe_ctx_t;
+
+static void probe_task(void *arg)
+{
+    probe_ctx_t *ctx = (probe_ctx_t *)arg;
+    const size_t line_bytes = (size_t)mon_timing.h_res * mon_timing.bytes_per_pixel;
+    const size_t dst_bytes = PROBE_DST_LINES * line_bytes;
+    int y = 0;
+    while (!ctx->stop) {
+        for (int i = 0; i < SCAN_MON_CAL_HEIGHTS; i++) {
+            const int lines = cal_heights[i];
+            if (y + lines > mon_timing.v_res) {
+                y = 0;
+            }
+            const uint8_t *src = ctx->src + y * line_bytes;
+            const size_t bytes = lines * line_bytes;
+            y += lines;
+            /* The RGB driver invalidates what it copied, so every refill reads PSRAM, not the cache */
+            esp_cache_msync((void *)src, bytes, ESP_CACHE_MSYNC_FLAG_DIR_M2C);
+            portENTER_CRITICAL(&probe_lock); // Like the RGB ISR, nothing on this core interrupts the copy
+            const int64_t start_us = esp_timer_get_time();
+            for (size_t done = 0; done < bytes; done += dst_bytes) {
+                memcpy(ctx->dst, src + done, (bytes - done < dst_bytes) ? bytes - done : dst_bytes);
+            }
+            const uint32_t refill_us = (uint32_t)(esp_timer_get_time() - start_us);
+            portEXIT_CRITICAL(&probe_lock);
+            perf_hist_add(&ctx->hists[i], refill_us);
+        }
+        vTaskDelay(1); // Leave this core to the other tasks between rounds
+    }
+    xTaskNotifyGive(ctx->caller);
+    vTaskDelete(NULL);
+}
+
+static esp_err_t calibrate_step(const scan_mon_cal_config_t *config, probe_ctx_t *ctx, uint32_t pclk_hz,
+                                scan_mon_cal_step_t *step)
+{
+    esp_err_t ret = set_pclk(pclk_hz);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    for (int i = 0; i < SCAN_MON_CAL_HEIGHTS; i++) {
+        perf_hist_reset(&ctx->hists[i]);
+    }
+    ctx->stop = false;
+    ctx->caller = xTaskGetCurrentTaskHandle();
+    scan_mon_stats_t before;
+    scan_mon_get_stats(&before, false);
+
+    /* The other core, so the real RGB ISR keeps its core while the probe turns interrupts off */
+    BaseType_t core_id = (portNUM_PROCESSORS > 1) ? !mon_isr_core : tskNO_AFFINITY;
+    if (xTaskCreatePinnedToCore(probe_task, "scan probe", PROBE_TASK_STACK_SIZE, ctx, PROBE_TASK_PRIORITY, NULL,
+                                core_id) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    const int64_t end_us = esp_timer_get_time() + config->step_ms * 1000LL;
+    while (esp_timer_get_time() < end_us) {
+        if (config->stress) {
+            config->stress(config->stress_ctx);
+        }
+        vTaskDelay(1);
+    }
+    ctx->stop = true;
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    scan_mon_stats_t after;
+    scan_mon_get_stats(&after, false);
+    step->pclk_hz = pclk_hz;
+    step->late = after.late - before.late;
+    step->underruns = after.underruns - before.underruns;
+    step->drifts = after.drifts - before.drifts;
+    step->min_safe_lines = 0;
+    const uint64_t line_clocks = mon_timing.h_total;
+    for (int i = 0; i < SCAN_MON_CAL_HEIGHTS; i++) {
+        scan_mon_cal_height_t *h = &step->heights[i];
+        h->lines = cal_heights[i];
+        h->deadline_us = (uint32_t)(line_clocks * h->lines * 1000000ULL / pclk_hz);
+        h->refill_us_p99 = perf_hist_percentile(&ctx->hists[i], 99);
+        h->refill_us_max = ctx->hists[i].max;
+        h->safe = ctx->hists[i].count &&
+                  h->refill_us_max * 100ULL <= (uint64_t)h->deadline_us * (100 - SCAN_MON_SAFE_MARGIN_PCT);
+        if (h->safe && !step->min_safe_lines) {
+            step->min_safe_lines = h->lines;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t scan_mon_calibrate(const scan_mon_cal_config_t *config, scan_mon_cal_result_t *result)
+{
+    if (!mon_panel) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!config->pclk_step_hz || config->pclk_min_hz == 0 || config->pclk_max_hz < config->pclk_min_hz ||
+            (config->pclk_max_hz - config->pclk_min_hz) / config->pclk_step_hz >= SCAN_MON_CAL_MAX_PCLKS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const size_t frame_bytes = scan_mon_frame_bytes();
+    probe_ctx_t *ctx = calloc(1, sizeof(probe_ctx_t));
+    uint8_t *src = heap_caps_aligned_alloc(64, frame_bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    uint8_t *dst = heap_caps_malloc(PROBE_DST_LINES * (size_t)mon_timing.h_res * mon_timing.bytes_per_pixel,
+                                    MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!ctx || !src || !dst) {
+        free(ctx);
+        heap_caps_free(src);
+        heap_caps_free(dst);
+        return ESP_ERR_NO_MEM;
+    }
+    memset(src, 0x5A, frame_bytes);
+    esp_cache_msync(src, frame_bytes, ESP_CACHE_MSYNC_FLAG_DIR_C2M); // Nothing of it stays dirty in the cache
+    ctx->src = src;
+    ctx->dst = dst;
+
+    const uint32_t pclk_hz = mon_timing.pclk_hz;
+    esp_err_t ret = ESP_OK;
+    memset(result, 0, sizeof(*result));
+    for (uint32_t hz = config->pclk_min_hz; hz <= config->pclk_max_hz; hz += config->pclk_step_hz) {
+        scan_mon_cal_step_t *step = &result->steps[result->step_count];
+        ESP_LOGI(TAG, "Stress at %lu.%lu MHz for %lu ms", (unsigned long)(hz / 1000000),
+                 (unsigned long)(hz / 100000 % 10), (unsigned long)config->step_ms);
+        ret = calibrate_step(config, ctx, hz, step);
+        if (ret != ESP_OK) {
+            break;
+        }
+        result->step_count++;
+        if (step->min_safe_lines && !step->underruns && !step->drifts) {
+            result->best_pclk_hz = hz;
+            result->best_lines = step->min_safe_lines;
+        }
+    }
+    esp_err_t restore = set_pclk(pclk_hz);
+    if (ret == ESP_OK) {
+        ret = restore;
+    }
+    free(ctx);
+    heap_caps_free(src);
+    heap_caps_free(dst);
+    return ret;
+}
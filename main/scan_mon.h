@@ -0,0 +1,132 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * RGB scan-out monitor. With a bounce buffer the RGB ISR copies the frame from PSRAM into internal RAM one
+ * bounce buffer at a time, and each copy must finish before the GDMA has sent the other half, i.e. within the
+ * scan-out time of one bounce buffer (the refill deadline). The copy competes with LVGL rendering and the buffer
+ * copies for the PSRAM bus.
+ *
+ * The last refill of a frame ends at a fixed point of the scan-out when it is on time, so its distance to the
+ * vsync interrupt, compared with the earliest one seen, tells how much later than the best case it finished:
+ *  - late: more than half of the deadline was used up
+ *  - underrun: the deadline was missed, the panel showed a stale bounce buffer
+ *  - drift: the refills stay a whole bounce buffer behind, the picture is shifted until the panel is restarted
+ *
+ */
+#define SCAN_MON_SAFE_MARGIN_PCT    (25)        // Calibration: the slowest refill must leave this share of the deadline
+#define SCAN_MON_DRIFT_FRAMES       (8)         // Consecutive underrun frames counted as one drift
+#define SCAN_MON_CAL_HEIGHTS        (10)        // Bounce buffer heights tried by `scan_mon_calibrate()`
+#define SCAN_MON_CAL_MAX_PCLKS      (8)
+
+typedef struct {
+    uint32_t pclk_hz;
+    uint16_t h_res;
+    uint16_t v_res;
+    uint16_t h_total;           // Pixel clocks per line, including pulse width and porches
+    uint16_t v_total;           // Lines per frame, including pulse width and porches
+    uint16_t bounce_lines;      // Bounce buffer height, 0 without bounce buffer
+    uint8_t bytes_per_pixel;
+} scan_mon_timing_t;
+
+typedef struct {
+    uint32_t vsyncs;            // Frames scanned out
+    uint32_t bounce_frames;     // Frames refilled through the bounce buffer
+    uint32_t late;
+    uint32_t underruns;
+    uint32_t drifts;
+    uint32_t deadline_us;       // Refill deadline at the current pixel clock
+    uint32_t excess_us_max;     // Largest delay of the last refill against the earliest one, since the last reset
+    uint64_t excess_us_total;
+    uint32_t pclk_hz;
+} scan_mon_stats_t;
+
+typedef struct {
+    uint16_t lines;
+    uint32_t deadline_us;
+    uint32_t refill_us_p99;
+    uint32_t refill_us_max;
+    bool safe;                  // The slowest refill left SCAN_MON_SAFE_MARGIN_PCT of the deadline
+} scan_mon_cal_height_t;
+
+typedef struct {
+    uint32_t pclk_hz;
+    uint32_t late;              // Counters of the real scan-out at the configured bounce height during the step
+    uint32_t underruns;
+    uint32_t drifts;
+    uint16_t min_safe_lines;    // Smallest safe height, 0 if none
+    scan_mon_cal_height_t heights[SCAN_MON_CAL_HEIGHTS];
+} scan_mon_cal_step_t;
+
+typedef struct {
+    uint32_t pclk_min_hz;
+    uint32_t pclk_max_hz;
+    uint32_t pclk_step_hz;
+    uint32_t step_ms;           // Stress time per pixel clock
+    void (*stress)(void *ctx);  // Called about every ms from the calling task, e.g. invalidates the whole screen
+    void *stress_ctx;
+} scan_mon_cal_config_t;
+
+typedef struct {
+    int step_count;
+    scan_mon_cal_step_t steps[SCAN_MON_CAL_MAX_PCLKS];
+    uint32_t best_pclk_hz;      // Highest pixel clock without real underruns that has a safe height, 0 if none
+    uint16_t best_lines;        // Smallest safe height at `best_pclk_hz`
+} scan_mon_cal_result_t;
+
+/**
+ * @brief Start monitoring, call before registering the RGB panel callbacks
+ *
+ * @param[in] panel: RGB panel handle, used to change the pixel clock during calibration
+ * @param[in] timing: Panel timing, copied
+ */
+void scan_mon_init(esp_lcd_panel_handle_t panel, const scan_mon_timing_t *timing);
+
+/**
+ * @brief Call from the `on_vsync` callback of the RGB panel
+ */
+void scan_mon_vsync_isr(void);
+
+/**
+ * @brief Call from the `on_bounce_frame_finish` callback of the RGB panel
+ */
+void scan_mon_bounce_frame_isr(void);
+
+/**
+ * @brief Get the counters, they only increase, `excess_us_max` is cleared if `reset_max` is set
+ */
+void scan_mon_get_stats(scan_mon_stats_t *stats, bool reset_max);
+
+/**
+ * @brief Frame buffer bytes read by the scan-out per frame
+ */
+uint32_t scan_mon_frame_bytes(void);
+
+/**
+ * @brief Sweep the pixel clock and, at each clock, time bounce buffer refills of several heights while `stress`
+ *        loads the PSRAM bus
+ *
+ * The refills are copies from a PSRAM frame into internal RAM with interrupts off, on the core that does not
+ * run the RGB ISR, so the real scan-out keeps going. The panel may flicker while the clock changes, it is
+ * restored at the end. Blocks for about `step_ms` per clock.
+ *
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_STATE: `scan_mon_init()` was not called
+ *      - ESP_ERR_INVALID_ARG: Bad pixel clock range
+ *      - ESP_ERR_NO_MEM: No memory for the test frame
+ */
+esp_err_t scan_mon_calibrate(const scan_mon_cal_config_t *config, scan_mon_cal_result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,188 @@
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "touch_sampler.h"
+
+static const char *TAG = "touch";                        // Tag for logging
+
+#define TOUCH_TASK_STACK_SIZE       (3 * 1024)
+#define TOUCH_TASK_PRIORITY         (CONFIG_EXAMPLE_TOUCH_TASK_PRIORITY)
+#define TOUCH_POLL_MS               (CONFIG_EXAMPLE_TOUCH_POLL_MS)
+
+static esp_lcd_touch_handle_t touch_handle = NULL;
+static TaskHandle_t touch_task_handle = NULL;
+static touch_sampler_wake_cb_t touch_wake_cb = NULL;
+static bool touch_irq_enabled = false;
+
+static touch_sample_t touch_ring[TOUCH_SAMPLER_RING_SIZE];
+static _Atomic uint32_t touch_head = 0;                  // Written by the acquisition task only
+static _Atomic uint32_t touch_tail = 0;                  // Written by the consumer only
+
+static portMUX_TYPE touch_last_lock = portMUX_INITIALIZER_UNLOCKED;
+static touch_sample_t touch_last;                        // Latest state, reported when the ring is empty
+
+static portMUX_TYPE touch_irq_lock = portMUX_INITIALIZER_UNLOCKED;
+static int64_t touch_irq_time_us = 0;                    // First INT edge since the last read, 0 if none
+static touch_sampler_stats_t touch_stats;
+static bool touch_trace = false;
+static int64_t touch_trace_base_us = 0;                  // Trace times are relative to this
+
+static void IRAM_ATTR touch_isr(esp_lcd_touch_handle_t tp)
+{
+    BaseType_t need_yield = pdFALSE;
+    portENTER_CRITICAL_ISR(&touch_irq_lock);
+    if (touch_irq_time_us == 0) {
+        touch_irq_time_us = esp_timer_get_time();
+    }
+    touch_stats.interrupts++;
+    portEXIT_CRITICAL_ISR(&touch_irq_lock);
+    vTaskNotifyGiveFromISR(touch_task_handle, &need_yield);
+    portYIELD_FROM_ISR(need_yield);
+}
+
+static void touch_push(const touch_sample_t *sample)
+{
+    portENTER_CRITICAL(&touch_last_lock);
+    touch_last = *sample;
+    portEXIT_CRITICAL(&touch_last_lock);
+
+    const uint32_t head = atomic_load_explicit(&touch_head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&touch_tail, memory_order_acquire) >= TOUCH_SAMPLER_RING_SIZE) {
+        touch_stats.dropped++; // The consumer still ends up with the latest state through `touch_last`
+        return;
+    }
+    touch_ring[head & (TOUCH_SAMPLER_RING_SIZE - 1)] = *sample;
+    atomic_store_explicit(&touch_head, head + 1, memory_order_release);
+    touch_stats.samples++;
+
+    if (touch_trace) {
+        char line[16 + TOUCH_SAMPLER_MAX_POINTS * 12];
+        int len = snprintf(line, sizeof(line), "%lu touch %u", (unsigned long)((sample->time_us - touch_trace_base_us) / 1000),
+                           sample->count);
+        for (int i = 0; i < sample->count && len < (int)sizeof(line); i++) { // Stop once a line is truncated
+            len += snprintf(line + len, sizeof(line) - len, " %u %u", sample->points[i].x, sample->points[i].y);
+        }
+        puts(line);
+    }
+}
+
+static void touch_task(void *arg)
+{
+    bool pressed = false;
+    touch_sample_t sample = { 0 };
+    touch_point_t points[TOUCH_SAMPLER_MAX_POINTS];
+    while (1) {
+        /* Sleep until the controller reports; while pressed also poll, so a lost release edge cannot stick */
+        const TickType_t timeout = (touch_irq_enabled && !pressed) ? portMAX_DELAY : pdMS_TO_TICKS(TOUCH_POLL_MS);
+        ulTaskNotifyTake(pdTRUE, timeout);
+
+        portENTER_CRITICAL(&touch_irq_lock);
+        int64_t time_us = touch_irq_time_us;
+        touch_irq_time_us = 0;
+        portEXIT_CRITICAL(&touch_irq_lock);
+        const int64_t read_start_us = esp_timer_get_time();
+        if (time_us == 0) {
+            time_us = read_start_us; // Poll
+        }
+        esp_lcd_touch_read_data(touch_handle);
+        uint16_t x[TOUCH_SAMPLER_MAX_POINTS];
+        uint16_t y[TOUCH_SAMPLER_MAX_POINTS];
+        uint8_t count = 0;
+        const bool touched = esp_lcd_touch_get_coordinates(touch_handle, x, y, NULL, &count,
+                                                           TOUCH_SAMPLER_MAX_POINTS) && count > 0;
+        if (!touched) {
+            count = 0;
+        }
+        for (int i = 0; i < count; i++) {
+            points[i].x = x[i];
+            points[i].y = y[i];
+        }
+        const uint32_t read_us = (uint32_t)(esp_timer_get_time() - read_start_us);
+        touch_stats.reads++;
+        touch_stats.read_us_total += read_us;
+        if (read_us > touch_stats.read_us_max) {
+            touch_stats.read_us_max = read_us;
+        }
+
+        if (!touched && !pressed) {
+            continue; // Spurious edge or idle poll
+        }
+        if (touched && pressed && count == sample.count && !memcmp(points, sample.points, count * sizeof(points[0]))) {
+            continue; // Poll while holding still
+        }
+        sample.time_us = time_us;
+        sample.count = count;
+        memcpy(sample.points, points, count * sizeof(points[0]));
+        touch_push(&sample);
+        pressed = touched;
+        if (touch_wake_cb) {
+            touch_wake_cb();
+        }
+    }
+}
+
+esp_err_t touch_sampler_start(esp_lcd_touch_handle_t tp, touch_sampler_wake_cb_t wake_cb)
+{
+    touch_handle = tp;
+    touch_wake_cb = wake_cb;
+    BaseType_t ret = xTaskCreate(touch_task, "touch", TOUCH_TASK_STACK_SIZE, NULL, TOUCH_TASK_PRIORITY,
+                                 &touch_task_handle);
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create touch task");
+        return ESP_FAIL;
+    }
+    /* The task exists now, so the ISR always has someone to notify */
+    touch_irq_enabled = (esp_lcd_touch_register_interrupt_callback(tp, touch_isr) == ESP_OK);
+    if (!touch_irq_enabled) {
+        ESP_LOGW(TAG, "Touch INT not available, polling every %d ms", TOUCH_POLL_MS);
+    }
+    xTaskNotifyGive(touch_task_handle); // Re-evaluate the wait timeout
+    return ESP_OK;
+}
+
+bool touch_sampler_pop(touch_sample_t *sample)
+{
+    const uint32_t tail = atomic_load_explicit(&touch_tail, memory_order_relaxed);
+    if (tail == atomic_load_explicit(&touch_head, memory_order_acquire)) {
+        portENTER_CRITICAL(&touch_last_lock);
+        *sample = touch_last;
+        portEXIT_CRITICAL(&touch_last_lock);
+        return false;
+    }
+    *sample = touch_ring[tail & (TOUCH_SAMPLER_RING_SIZE - 1)];
+    atomic_store_explicit(&touch_tail, tail + 1, memory_order_release);
+    return true;
+}
+
+bool touch_sampler_pending(void)
+{
+    return atomic_load_explicit(&touch_tail, memory_order_relaxed) !=
+           atomic_load_explicit(&touch_head, memory_order_acquire);
+}
+
+bool touch_sampler_peek_pressed(bool *pressed)
+{
+    const uint32_t tail = atomic_load_explicit(&touch_tail, memory_order_relaxed);
+    if (tail == atomic_load_explicit(&touch_head, memory_order_acquire)) {
+        return false;
+    }
+    *pressed = touch_ring[tail & (TOUCH_SAMPLER_RING_SIZE - 1)].count > 0;
+    return true;
+}
+
+void touch_sampler_get_stats(touch_sampler_stats_t *stats)
+{
+    *stats = touch_stats;
+}
+
+void touch_sampler_set_trace(bool enable)
+{
+    /* Start the replay one second in, once the simulator has drawn the first frame */
+    touch_trace_base_us = esp_timer_get_time() - 1000 * 1000;
+    touch_trace = enable;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_lcd_touch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Touch acquisition off the LVGL task: a dedicated task reads the controller when its INT line fires,
+ * timestamps the report and queues it in a lock-free single-producer / single-consumer ring.
+ * The LVGL input read callback only dequeues, so an idle screen costs no I2C traffic.
+ *
+ */
+#define TOUCH_SAMPLER_RING_SIZE     (32)                 // Power of 2, about 300 ms of reports at 100 Hz
+#define TOUCH_SAMPLER_MAX_POINTS    (CONFIG_ESP_LCD_TOUCH_MAX_POINTS) // GT911 reports up to 5 points
+
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+} touch_point_t;
+
+typedef struct {
+    int64_t time_us;        // INT edge (or poll) time of the report, esp_timer clock
+    uint8_t count;          // Number of touch points, 0 means released
+    touch_point_t points[TOUCH_SAMPLER_MAX_POINTS];
+} touch_sample_t;
+
+typedef struct {
+    uint32_t interrupts;    // INT edges
+    uint32_t reads;         // I2C reads of the controller
+    uint32_t samples;       // Samples queued
+    uint32_t dropped;       // Samples lost because the ring was full
+    uint32_t read_us_max;   // Longest I2C read
+    uint64_t read_us_total;
+} touch_sampler_stats_t;
+
+typedef void (*touch_sampler_wake_cb_t)(void);
+
+/**
+ * @brief Start the touch acquisition task
+ *
+ * @param[in] tp: Touch handle, its INT pin is used if configured, otherwise the controller is polled
+ * @param[in] wake_cb: Called after new samples are queued, from the acquisition task
+ *
+ * @return
+ *      - ESP_OK: Success
+ *      - Others: Fail
+ */
+esp_err_t touch_sampler_start(esp_lcd_touch_handle_t tp, touch_sampler_wake_cb_t wake_cb);
+
+/**
+ * @brief Dequeue the oldest sample, single consumer only
+ *
+ * @param[out] sample: The oldest queued sample, or the latest known state if the ring is empty
+ *
+ * @return
+ *      - true:  `sample` was dequeued
+ *      - false: The ring is empty
+ */
+bool touch_sampler_pop(touch_sample_t *sample);
+
+/**
+ * @brief Check whether samples are queued
+ */
+bool touch_sampler_pending(void);
+
+/**
+ * @brief Get the state of the next queued sample without dequeuing it
+ *
+ * @return
+ *      - true:  A sample is queued, `*pressed` is set
+ *      - false: The ring is empty
+ */
+bool touch_sampler_peek_pressed(bool *pressed);
+
+void touch_sampler_get_stats(touch_sampler_stats_t *stats);
+
+/**
+ * @brief Print every queued sample to the console as a simulator script line
+ *
+ * The output `<time_ms> touch <count> <x0> <y0> ...` can be replayed by the host simulator, see README.md.
+ */
+void touch_sampler_set_trace(bool enable);
+
+#ifdef __cplusplus
+}
+#endif
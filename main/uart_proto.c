@@ -0,0 +1,155 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "driver/uart.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "uart_proto.h"
+
+static const char *TAG = "uart_proto";                   // Tag for logging
+
+#if CONFIG_EXAMPLE_UART_PROTO_ENABLE
+#define UART_PROTO_PORT             (CONFIG_EXAMPLE_UART_PROTO_PORT)
+#define UART_PROTO_BAUD_RATE        (CONFIG_EXAMPLE_UART_PROTO_BAUD_RATE)
+#define UART_PROTO_TX_GPIO          (CONFIG_EXAMPLE_UART_PROTO_TX_GPIO)
+#define UART_PROTO_RX_GPIO          (CONFIG_EXAMPLE_UART_PROTO_RX_GPIO)
+#define UART_PROTO_TASK_PRIORITY    (CONFIG_EXAMPLE_UART_PROTO_TASK_PRIORITY)
+#define UART_PROTO_TASK_STACK_SIZE  (3 * 1024)
+#define UART_PROTO_RX_BUF_SIZE      (4 * UI_PROTO_FRAME_MAX) // Driver ring buffer, absorbs a render pass at full rate
+#define UART_PROTO_TX_BUF_SIZE      (256)                // Event frames are queued, the LVGL task never waits on TX
+#define UART_PROTO_RX_TIMEOUT       (4)                  // Idle symbols before the driver reports a short frame
+#define UART_PROTO_STATS_PERIOD_MS  (10 * 1000)
+
+static ui_proto_t proto;
+static QueueHandle_t uart_queue = NULL;
+
+static void uart_proto_write(const uint8_t *data, size_t len, void *ctx)
+{
+    uart_write_bytes(UART_PROTO_PORT, data, len);
+}
+
+static void report_stats(int64_t *last_us, ui_proto_stats_t *last)
+{
+    const int64_t now = esp_timer_get_time();
+    const uint32_t elapsed_ms = (uint32_t)((now - *last_us) / 1000);
+    if (elapsed_ms < UART_PROTO_STATS_PERIOD_MS) {
+        return;
+    }
+    if (proto.stats.bytes != last->bytes) {
+        ESP_LOGI(TAG, "%lu commands/s in %lu frames/s, %lu bytes/s, errors: crc=%lu cobs=%lu overflow=%lu bad=%lu",
+                 (unsigned long)((proto.stats.commands - last->commands) * 1000ULL / elapsed_ms),
+                 (unsigned long)((proto.stats.frames - last->frames) * 1000ULL / elapsed_ms),
+                 (unsigned long)((proto.stats.bytes - last->bytes) * 1000ULL / elapsed_ms),
+                 (unsigned long)(proto.stats.crc_errors - last->crc_errors),
+                 (unsigned long)(proto.stats.cobs_errors - last->cobs_errors),
+                 (unsigned long)(proto.stats.overflows - last->overflows),
+                 (unsigned long)(proto.stats.bad_commands - last->bad_commands));
+    }
+    *last = proto.stats;
+    *last_us = now;
+}
+
+static void uart_proto_task(void *arg)
+{
+    uart_event_t event;
+    ui_proto_stats_t last = { 0 };
+    int64_t last_us = esp_timer_get_time();
+    while (1) {
+        if (xQueueReceive(uart_queue, &event, pdMS_TO_TICKS(UART_PROTO_STATS_PERIOD_MS)) == pdTRUE) {
+            switch (event.type) {
+            case UART_DATA: {
+                /* Read straight into the decoder's frame buffer, frames are decoded in place */
+                size_t buffered = 0;
+                uart_get_buffered_data_len(UART_PROTO_PORT, &buffered);
+                while (buffered > 0) {
+                    size_t avail;
+                    uint8_t *dst = ui_proto_rx_space(&proto, &avail);
+                    int n = uart_read_bytes(UART_PROTO_PORT, dst, buffered < avail ? buffered : avail, 0);
+                    if (n <= 0) {
+                        break;
+                    }
+                    ui_proto_rx_commit(&proto, n);
+                    buffered -= n;
+                }
+                break;
+            }
+            case UART_FIFO_OVF:
+            case UART_BUFFER_FULL:
+                ESP_LOGW(TAG, "RX overflow, dropping the current frame");
+                uart_flush_input(UART_PROTO_PORT);
+                xQueueReset(uart_queue);
+                ui_proto_reset(&proto);
+                break;
+            default:
+                break;
+            }
+        }
+        report_stats(&last_us, &last);
+    }
+}
+
+esp_err_t uart_proto_start(void)
+{
+    const uart_config_t uart_config = {
+        .baud_rate = UART_PROTO_BAUD_RATE,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_DEFAULT,
+    };
+    esp_err_t ret = uart_driver_install(UART_PROTO_PORT, UART_PROTO_RX_BUF_SIZE, UART_PROTO_TX_BUF_SIZE, 16,
+                                        &uart_queue, 0);
+    if (ret == ESP_OK) {
+        ret = uart_param_config(UART_PROTO_PORT, &uart_config);
+    }
+    if (ret == ESP_OK) {
+        ret = uart_set_pin(UART_PROTO_PORT, UART_PROTO_TX_GPIO, UART_PROTO_RX_GPIO, UART_PIN_NO_CHANGE,
+                           UART_PIN_NO_CHANGE);
+    }
+    if (ret == ESP_OK) {
+        ret = uart_set_rx_timeout(UART_PROTO_PORT, UART_PROTO_RX_TIMEOUT); // Report a short frame without waiting for the FIFO threshold
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set up UART%d: %s", UART_PROTO_PORT, esp_err_to_name(ret));
+        return ret;
+    }
+
+    ui_proto_init(&proto, uart_proto_write, NULL);
+    if (xTaskCreate(uart_proto_task, "uart_proto", UART_PROTO_TASK_STACK_SIZE, NULL, UART_PROTO_TASK_PRIORITY,
+                    NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create the receive task");
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "UI commands on UART%d at %d baud (TX GPIO%d, RX GPIO%d)", UART_PROTO_PORT, UART_PROTO_BAUD_RATE,
+             UART_PROTO_TX_GPIO, UART_PROTO_RX_GPIO);
+    return ESP_OK;
+}
+
+uint32_t uart_proto_baud_rate(void)
+{
+    return UART_PROTO_BAUD_RATE;
+}
+
+void uart_proto_get_stats(ui_proto_stats_t *stats)
+{
+    ui_proto_get_stats(&proto, stats);
+}
+#else
+esp_err_t uart_proto_start(void)
+{
+    ESP_LOGI(TAG, "Disabled in menuconfig");
+    return ESP_OK;
+}
+
+uint32_t uart_proto_baud_rate(void)
+{
+    return 0;
+}
+
+void uart_proto_get_stats(ui_proto_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+}
+#endif
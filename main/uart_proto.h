@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "ui_proto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Binary UI command protocol (`ui_proto.h`) on a UART, so an external controller can drive the screen.
+ * A receive task reads the UART straight into the frame buffer of the decoder, complete frames are decoded
+ * in place and applied as one batch; button presses go back to the controller as event frames.
+ *
+ */
+
+/**
+ * @brief Install the UART driver and start the receive task
+ *
+ * @note Call after `lvgl_port_init()`, commands go through the `ui.h` API
+ *
+ * @return
+ *      - ESP_OK: Success, or the protocol is disabled in menuconfig
+ *      - Others: Fail
+ */
+esp_err_t uart_proto_start(void);
+
+/**
+ * @brief Baud rate of the protocol UART, 0 when the protocol is disabled
+ */
+uint32_t uart_proto_baud_rate(void);
+
+/**
+ * @brief Copy the decoder counters
+ */
+void uart_proto_get_stats(ui_proto_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
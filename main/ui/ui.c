@@ -1,12 +1,20 @@
 // ui.c
 #include "ui.h"
+#include "ui_log.h"
+#include "ui_plot.h"
+#include "ui_ring.h"
+#include "ui_gesture.h"
+#include "ui_icon.h"
 #include "lvgl.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdarg.h>
+#include <stdatomic.h>
 
 #include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
+#include "freertos/task.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 static const char *TAG = "ui";   
 
@@ -14,16 +22,21 @@ static const char *TAG = "ui";
 static lv_obj_t *top_bar;
 static lv_obj_t *status_container;
 static lv_obj_t *button_container;
-static lv_obj_t *log_textarea;
+static lv_obj_t *log_view;
+static lv_obj_t *plot_view;
 static lv_obj_t *bottom_bar;
 
 // === 按钮回调存储 ===
 static ui_btn_callback_t g_button_callbacks[UI_BUTTON_COUNT] = {NULL};
+static ui_btn_callback_t g_button_long_callbacks[UI_BUTTON_COUNT] = {NULL};
+static bool g_button_long_fired[UI_BUTTON_COUNT];     // 本次按下已触发长按，松开时不再当作点击
 
-// === 日志缓冲区 ===
-static char g_log_buffer[UI_LOG_MAX_LINES][128];
-static uint8_t g_log_index = 0;
-static uint8_t g_log_count = 0;
+// === 手势 ===
+static ui_gesture_t g_gesture;
+static uint32_t g_gesture_event_code;
+static lv_obj_t *g_gesture_target;                      // 连续手势开始时确定的目标对象
+static ui_gesture_cb_t g_gesture_observer;
+static void *g_gesture_observer_data;
 
 // === 状态项缓存 ===
 typedef struct {
@@ -35,15 +48,117 @@ typedef struct {
 
 static status_item_t g_status_items[UI_STATUS_MAX_ITEMS] = {0};
 
+// === 状态项渲染影子：记录屏幕上实际显示的内容，相同的更新直接跳过 ===
+typedef struct {
+    uint32_t hash;          // key/value/color 的 FNV-1a 哈希，0 表示尚未渲染
+    char key[16];
+    char value[32];
+    int style;              // 数值标签当前使用的颜色样式，-1 表示无
+} status_shadow_t;
+
+static status_shadow_t g_status_shadow[UI_STATUS_MAX_ITEMS];
+static ui_status_stats_t g_status_stats;
+
+// === 共享颜色样式：数值标签切换颜色时换用样式，不再给每个对象添加本地样式 ===
+// 每个数值标签最多引用一个样式，槽位数多于标签数，因此总能找到空闲槽位
+#define UI_COLOR_STYLES (UI_STATUS_MAX_ITEMS + 2)
+
+typedef struct {
+    lv_style_t style;
+    lv_color_t color;
+    uint8_t refs;
+    bool inited;
+} color_style_t;
+
+static color_style_t g_color_styles[UI_COLOR_STYLES];
+
+// === 图标：按钮和状态项当前显示的图集图标 id，-1 表示无 ===
+static int16_t g_button_icons[UI_BUTTON_COUNT];
+static int16_t g_status_icons[UI_STATUS_MAX_ITEMS];
+
 // === 按钮点击事件回调 ===
 static void button_event_handler(lv_event_t *e) {
     lv_obj_t *btn = lv_event_get_target(e);
     uintptr_t id = (uintptr_t)lv_obj_get_user_data(btn);
-    if (id < UI_BUTTON_COUNT && g_button_callbacks[id]) {
+    if (id >= UI_BUTTON_COUNT) return;
+    if (lv_event_get_code(e) == LV_EVENT_PRESSED) {
+        g_button_long_fired[id] = false;
+        return;
+    }
+    if (!g_button_long_fired[id] && g_button_callbacks[id]) {
         g_button_callbacks[id]();
     }
 }
 
+// === 按钮长按（手势事件）===
+static void button_gesture_handler(lv_event_t *e) {
+    const ui_gesture_event_t *ev = lv_event_get_param(e);
+    uintptr_t id = (uintptr_t)lv_obj_get_user_data(lv_event_get_target(e));
+    if (ev->type != UI_GESTURE_LONG_PRESS || id >= UI_BUTTON_COUNT || !g_button_long_callbacks[id]) return;
+    g_button_long_fired[id] = true;
+    g_button_long_callbacks[id]();
+}
+
+static void _ui_show_plot(bool show);
+
+// === 日志区双指平移：上下翻看历史日志；长按跳到上一条警告 / 错误，点击回到最新日志；
+// 向左滑动切换到实时曲线 ===
+static void log_gesture_handler(lv_event_t *e) {
+    const ui_gesture_event_t *ev = lv_event_get_param(e);
+    if (ev->type == UI_GESTURE_PAN && ev->phase != UI_GESTURE_END) {
+        ui_log_scroll(ev->dy);
+    } else if (ev->type == UI_GESTURE_LONG_PRESS) {
+        ui_log_find(NULL, UI_LOG_WARN);
+    } else if (ev->type == UI_GESTURE_TAP) {
+        ui_log_jump(UINT32_MAX);
+    } else if (ev->type == UI_GESTURE_SWIPE && ev->dir == UI_GESTURE_DIR_LEFT) {
+        _ui_show_plot(true);
+    }
+}
+
+// === 曲线向右滑动回到日志 ===
+static void plot_gesture_handler(lv_event_t *e) {
+    const ui_gesture_event_t *ev = lv_event_get_param(e);
+    if (ev->type == UI_GESTURE_SWIPE && ev->dir == UI_GESTURE_DIR_RIGHT) {
+        _ui_show_plot(false);
+    }
+}
+
+static int _ui_color_style_acquire(lv_color_t color) {
+    int free_slot = -1;
+    for (int i = 0; i < UI_COLOR_STYLES; i++) {
+        color_style_t *cs = &g_color_styles[i];
+        if (cs->inited && cs->color.full == color.full) {
+            cs->refs++;
+            return i;
+        }
+        if (cs->refs == 0 && (free_slot < 0 || !g_color_styles[free_slot].inited)) free_slot = i;
+    }
+    // 空闲槽位没有对象引用，直接改色不会触发任何重绘
+    color_style_t *cs = &g_color_styles[free_slot];
+    if (!cs->inited) {
+        lv_style_init(&cs->style);
+        cs->inited = true;
+    }
+    lv_style_set_text_color(&cs->style, color);
+    cs->color = color;
+    cs->refs = 1;
+    return free_slot;
+}
+
+static void _ui_color_style_release(int index) {
+    if (index >= 0 && g_color_styles[index].refs > 0) g_color_styles[index].refs--;
+}
+
+static uint32_t _ui_status_hash(const char *key, const char *value, lv_color_t color) {
+    uint32_t h = 2166136261u;
+    for (const char *p = key; *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+    h = (h ^ 0xFF) * 16777619u;     // 分隔 key 与 value，避免 "ab"+"c" 与 "a"+"bc" 相同
+    for (const char *p = value; *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+    h = (h ^ lv_color_to16(color)) * 16777619u;
+    return h ? h : 1;
+}
+
 // === 初始化顶部状态栏 ===
 static void init_top_bar(void) {
     top_bar = lv_obj_create(lv_scr_act());
@@ -86,9 +201,16 @@ static void init_status_area(void) {
 
         lv_obj_t *value_label = lv_label_create(item);
         lv_label_set_text(value_label, "Value");
-        lv_obj_set_style_text_color(value_label, lv_color_hex(0x00FF00), 0);
+        g_status_shadow[i].style = _ui_color_style_acquire(lv_color_hex(0x00FF00));
+        lv_obj_add_style(value_label, &g_color_styles[g_status_shadow[i].style].style, 0);
         lv_obj_align(value_label, LV_ALIGN_BOTTOM_LEFT, 0, 0);
 
+        // 图标在右上角，ui_set_status_icon 设置前隐藏
+        lv_obj_t *icon = lv_img_create(item);
+        lv_obj_add_flag(icon, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_align(icon, LV_ALIGN_TOP_RIGHT, 0, 0);
+        g_status_icons[i] = -1;
+
         lv_obj_set_user_data(item, (void*)(uintptr_t)i);
     }
 }
@@ -115,7 +237,14 @@ static void init_button_area(void) {
         lv_label_set_text(label, "N/A");
         lv_obj_center(label);
 
+        lv_obj_t *icon = lv_img_create(btn);
+        lv_obj_add_flag(icon, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_align(icon, LV_ALIGN_LEFT_MID, 0, 0);
+        g_button_icons[i] = -1;
+
         lv_obj_add_event_cb(btn, button_event_handler, LV_EVENT_CLICKED, NULL);
+        lv_obj_add_event_cb(btn, button_event_handler, LV_EVENT_PRESSED, NULL);
+        lv_obj_add_event_cb(btn, button_gesture_handler, (lv_event_code_t)g_gesture_event_code, NULL);
     }
 }
 
@@ -127,13 +256,15 @@ static void init_log_area(void) {
     lv_obj_set_style_bg_color(log_container, lv_color_hex(0x0d0d0d), 0);
     lv_obj_align_to(log_container, button_container, LV_ALIGN_OUT_BOTTOM_MID, 0, 10);
 
-    log_textarea = lv_textarea_create(log_container);
-    lv_textarea_set_text(log_textarea, "");
-    lv_obj_set_size(log_textarea, LV_PCT(100), LV_PCT(100));
-    lv_obj_set_style_bg_color(log_textarea, lv_color_black(), 0);
-    lv_obj_set_style_text_color(log_textarea, lv_color_hex(0x00FF00), 0);
-    lv_obj_set_scrollbar_mode(log_textarea, LV_SCROLLBAR_MODE_AUTO); // 自动滚动条
-    lv_textarea_set_one_line(log_textarea, false); // 多行
+    lv_obj_set_style_pad_all(log_container, 0, 0);
+
+    log_view = ui_log_create(log_container);
+    lv_obj_add_event_cb(log_view, log_gesture_handler, (lv_event_code_t)g_gesture_event_code, NULL);
+
+    // 曲线与日志共用日志区，默认隐藏；隐藏时仍按周期取走新列，切换过来即是最新一屏（没有新列时取列暂停）
+    plot_view = ui_plot_create(log_container);
+    lv_obj_add_flag(plot_view, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_add_event_cb(plot_view, plot_gesture_handler, (lv_event_code_t)g_gesture_event_code, NULL);
 }
 
 // === 初始化底部状态栏 ===
@@ -151,21 +282,48 @@ static void init_bottom_bar(void) {
 }
 
 // === 线程内绘制 ===
+// 与影子比较，只对内容变化的标签调用 set_text，颜色变化只切换共享样式
+static void _ui_refresh_status_item(int i) {
+    const status_item_t *item_data = &g_status_items[i];
+    status_shadow_t *shadow = &g_status_shadow[i];
+    const char *key = item_data->valid ? item_data->key : "";
+    const char *value = item_data->valid ? item_data->value : "";
+    lv_color_t color = item_data->valid ? item_data->color : g_color_styles[shadow->style].color;
+
+    uint32_t hash = _ui_status_hash(key, value, color);
+    if (hash == shadow->hash && !strcmp(key, shadow->key) && !strcmp(value, shadow->value) &&
+        g_color_styles[shadow->style].color.full == color.full) {
+        g_status_stats.skipped++;
+        return;
+    }
+    g_status_stats.applied++;
+
+    lv_obj_t *item = lv_obj_get_child(status_container, i);
+    if (strcmp(key, shadow->key) || shadow->hash == 0) {
+        lv_label_set_text(lv_obj_get_child(item, 0), key);
+        strncpy(shadow->key, key, sizeof(shadow->key) - 1);
+        g_status_stats.labels_set++;
+    }
+    lv_obj_t *value_label = lv_obj_get_child(item, 1);
+    if (strcmp(value, shadow->value) || shadow->hash == 0) {
+        lv_label_set_text(value_label, value);
+        strncpy(shadow->value, value, sizeof(shadow->value) - 1);
+        g_status_stats.labels_set++;
+    }
+    if (g_color_styles[shadow->style].color.full != color.full) {
+        int style = _ui_color_style_acquire(color);
+        lv_obj_remove_style(value_label, &g_color_styles[shadow->style].style, 0);
+        _ui_color_style_release(shadow->style);
+        lv_obj_add_style(value_label, &g_color_styles[style].style, 0);
+        shadow->style = style;
+        g_status_stats.style_swaps++;
+    }
+    shadow->hash = hash;
+}
+
 void _ui_refresh_status(void) {
     for (int i = 0; i < UI_STATUS_MAX_ITEMS; i++) {
-        lv_obj_t *item = lv_obj_get_child(status_container, i);
-        if (g_status_items[i].valid) {
-            lv_obj_t *key_label = lv_obj_get_child(item, 0);
-            lv_obj_t *value_label = lv_obj_get_child(item, 1);
-            lv_label_set_text(key_label, g_status_items[i].key);
-            lv_label_set_text(value_label, g_status_items[i].value);
-            lv_obj_set_style_text_color(value_label, g_status_items[i].color, 0);
-        } else {
-            lv_obj_t *key_label = lv_obj_get_child(item, 0);
-            lv_obj_t *value_label = lv_obj_get_child(item, 1);
-            lv_label_set_text(key_label, "");
-            lv_label_set_text(value_label, "");
-        }
+        _ui_refresh_status_item(i);
     }
 }
 
@@ -182,47 +340,63 @@ void _ui_set_status_item(int index, const char* key, const char* value, lv_color
     strncpy(g_status_items[index].value, value ? value : "", sizeof(g_status_items[index].value) - 1);
     g_status_items[index].color = color;
     g_status_items[index].valid = true;
-    ui_refresh_status();
+    // 只重绘本项，不再整体刷新六项
+    _ui_refresh_status_item(index);
 }
 
-void _ui_set_button(int index, const char* text, ui_btn_callback_t callback) {
+static void _ui_set_button_text(int index, const char* text) {
     if (index < 0 || index >= UI_BUTTON_COUNT) return;
-    g_button_callbacks[index] = callback;
     lv_obj_t *btn = lv_obj_get_child(button_container, index);
     lv_obj_t *label = lv_obj_get_child(btn, 0);
     lv_label_set_text(label, text ? text : "N/A");
 }
 
-// === 真正执行日志写入和显示刷新（仅在 LVGL 任务中调用！）===
-static char g_log_display_buf[UI_LOG_MAX_LINES * 128];
-void _ui_add_log_from_lvgl(const char* formatted_msg) {
-    if (!formatted_msg) return;
-
-    // 写入环形缓冲区
-    strncpy(g_log_buffer[g_log_index], formatted_msg, sizeof(g_log_buffer[0]) - 1);
-    g_log_buffer[g_log_index][sizeof(g_log_buffer[0]) - 1] = '\0'; // 确保终止
-
-    g_log_index = (g_log_index + 1) % UI_LOG_MAX_LINES;
-    if (g_log_count < UI_LOG_MAX_LINES) g_log_count++;
+void _ui_set_button(int index, const char* text, ui_btn_callback_t callback) {
+    if (index < 0 || index >= UI_BUTTON_COUNT) return;
+    g_button_callbacks[index] = callback;
+    _ui_set_button_text(index, text);
+}
 
-    // 安全地更新 UI
-    
-    g_log_display_buf[0] = '\0';
-    size_t pos = 0;
+// 在 img 上显示图集中的图标：src 为整页，对象大小取图标大小，偏移把页内子矩形移到对象原点，
+// 同一页上的图标共用一块已解码的缓冲。name 为空或图集里没有时隐藏；隐藏的对象不绘制，可以继续指向已释放的页
+static void _ui_set_icon(lv_obj_t *img, int16_t *current, const char *name) {
+    int id = name[0] ? ui_icon_find(name) : -1;
+    if (id == *current) return;
+    ui_icon_ref_t ref;
+    if (id >= 0 && ui_icon_acquire(id, &ref)) {
+        lv_img_set_src(img, ref.sheet);
+        lv_obj_set_size(img, ref.w, ref.h);
+        lv_img_set_offset_x(img, -(lv_coord_t)ref.x);
+        lv_img_set_offset_y(img, -(lv_coord_t)ref.y);
+        lv_obj_clear_flag(img, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        if (name[0] && ui_icon_is_open()) ESP_LOGW(TAG, "icon \"%s\" not available", name);
+        id = -1;
+        lv_obj_add_flag(img, LV_OBJ_FLAG_HIDDEN);
+    }
+    // 新图标先占住所在页再释放旧的，两者同页时不会被挤出再解码
+    if (*current >= 0) ui_icon_release(*current);
+    *current = (int16_t)id;
+}
 
-    for (int i = 0; i < g_log_count; i++) {
-        int idx = (g_log_index - g_log_count + i + UI_LOG_MAX_LINES) % UI_LOG_MAX_LINES;
-        size_t line_len = strlen(g_log_buffer[idx]);
-        if (pos + line_len + 1 >= sizeof(g_log_display_buf)) break;
+static void _ui_set_button_icon(int index, const char* name) {
+    if (index < 0 || index >= UI_BUTTON_COUNT) return;
+    lv_obj_t *btn = lv_obj_get_child(button_container, index);
+    _ui_set_icon(lv_obj_get_child(btn, 1), &g_button_icons[index], name);
+}
 
-        memcpy(g_log_display_buf + pos, g_log_buffer[idx], line_len);
-        pos += line_len;
-        g_log_display_buf[pos++] = '\n';
-    }
-    g_log_display_buf[pos] = '\0';
+static void _ui_set_status_icon(int index, const char* name) {
+    if (index < 0 || index >= UI_STATUS_MAX_ITEMS) return;
+    lv_obj_t *item = lv_obj_get_child(status_container, index);
+    _ui_set_icon(lv_obj_get_child(item, 2), &g_status_icons[index], name);
+}
 
-    lv_textarea_set_text(log_textarea, g_log_display_buf);
-    lv_textarea_set_cursor_pos(log_textarea, LV_TEXTAREA_CURSOR_LAST);
+// === 真正执行日志写入（仅在 LVGL 任务中调用！）===
+// 只写入行缓冲，实际上屏在 ui_process_messages 末尾统一提交
+void _ui_add_log_from_lvgl(const char* formatted_msg) {
+    if (!formatted_msg) return;
+    ui_log_rec_hdr_t hdr = { .tick_ms = lv_tick_get(), .level = UI_LOG_INFO };
+    ui_log_append(&hdr, formatted_msg, strlen(formatted_msg));
 }
 
 void _ui_set_bottom_info(const char* ip, uint32_t baudrate, const char* firmware_id) {
@@ -233,14 +407,22 @@ void _ui_set_bottom_info(const char* ip, uint32_t baudrate, const char* firmware
     lv_label_set_text(label, buf);
 }
 static void _ui_clear_log(void) {
-    // 清空环形缓冲区状态
-    g_log_index = 0;
-    g_log_count = 0;
-    // 可选：显式清零内存（非必需，但更干净）
-    memset(g_log_buffer, 0, sizeof(g_log_buffer));
+    ui_log_clear();
+}
+
+static void _ui_show_plot(bool show) {
+    if (show) {
+        lv_obj_clear_flag(plot_view, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(log_view, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_clear_flag(log_view, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(plot_view, LV_OBJ_FLAG_HIDDEN);
+    }
+}
 
-    // 清空文本框
-    lv_textarea_set_text(log_textarea, "");
+static void _ui_set_button_long_press(int index, ui_btn_callback_t callback) {
+    if (index < 0 || index >= UI_BUTTON_COUNT) return;
+    g_button_long_callbacks[index] = callback;
 }
 // 声明内部刷新函数（仅在 LVGL 任务中调用）
 static void _ui_apply_msg(const ui_msg_t* msg) {
@@ -272,107 +454,409 @@ static void _ui_apply_msg(const ui_msg_t* msg) {
         case UI_MSG_CLEAR_LOG:
             _ui_clear_log();
             break;
+        default:
+            break;
+    }
+}
+
+// === 命令队列：按钮 / 日志 / 清屏走变长条目的无锁环形队列 ===
+// 条目类型即 ui_msg_type_t，负载按类型紧凑编码，不再按 ui_msg_t 的最大成员定长拷贝。
+typedef struct {
+    int32_t index;
+    ui_btn_callback_t callback;
+} ui_btn_payload_t;     // 后接按钮文字（不含结尾 '\0'）
+
+typedef struct {
+    int32_t index;
+} ui_index_payload_t;   // 后接图标名或按钮文字（不含结尾 '\0'）
+
+static bool g_ui_ready = false;
+static ui_wakeup_cb_t g_wakeup_cb = NULL;
+static _Atomic uint32_t g_pending_since = 0;   // 最早一条未处理命令的时间（us，0 表示无）
+static _Atomic uint32_t g_batch_depth = 0;
+static _Atomic uint32_t g_batch_since = 0;     // 最外层批打开的时间（us）
+static ui_ring_t g_msg_ring;
+static uint8_t g_msg_ring_buf[UI_RING_MEM_SIZE(UI_MSG_RING_SIZE)] __attribute__((aligned(8)));
+static uint8_t g_msg_buf[UI_MSG_PAYLOAD_MAX + 1] __attribute__((aligned(8)));
+
+static void _ui_apply_entry(uint8_t type, const uint8_t *payload, int len) {
+    switch (type) {
+        case UI_MSG_SET_BUTTON: {
+            ui_btn_payload_t btn;
+            if (len < (int)sizeof(btn)) break;
+            memcpy(&btn, payload, sizeof(btn));
+            _ui_set_button(btn.index, (const char *)payload + sizeof(btn), btn.callback);
+            break;
+        }
+        case UI_MSG_ADD_LOG: {
+            ui_log_rec_hdr_t hdr;
+            if (len < (int)sizeof(hdr)) break;
+            memcpy(&hdr, payload, sizeof(hdr));
+            ui_log_append(&hdr, payload + sizeof(hdr), len - sizeof(hdr));
+            break;
+        }
+        case UI_MSG_CLEAR_LOG:
+            _ui_clear_log();
+            break;
+        case UI_MSG_SET_BUTTON_LONG_PRESS: {
+            ui_btn_payload_t btn;
+            if (len < (int)sizeof(btn)) break;
+            memcpy(&btn, payload, sizeof(btn));
+            _ui_set_button_long_press(btn.index, btn.callback);
+            break;
+        }
+        case UI_MSG_SHOW_PLOT:
+            if (len >= 1) _ui_show_plot(payload[0] != 0);
+            break;
+        case UI_MSG_FIND_LOG:
+            // 负载为级别 + 文本（不含结尾 '\0'，出队后已补上）
+            if (len >= 1) {
+                _ui_show_plot(false);
+                ui_log_find((const char *)payload + 1, (ui_log_level_t)payload[0]);
+            }
+            break;
+        case UI_MSG_JUMP_LOG: {
+            uint32_t tick_ms;
+            if (len < (int)sizeof(tick_ms)) break;
+            memcpy(&tick_ms, payload, sizeof(tick_ms));
+            _ui_show_plot(false);
+            ui_log_jump(tick_ms);
+            break;
+        }
+        case UI_MSG_SET_BUTTON_TEXT: {
+            ui_index_payload_t btn;
+            if (len < (int)sizeof(btn)) break;
+            memcpy(&btn, payload, sizeof(btn));
+            _ui_set_button_text(btn.index, (const char *)payload + sizeof(btn));
+            break;
+        }
+        case UI_MSG_SET_BUTTON_ICON:
+        case UI_MSG_SET_STATUS_ICON: {
+            ui_index_payload_t icon;
+            if (len < (int)sizeof(icon)) break;
+            memcpy(&icon, payload, sizeof(icon));
+            if (type == UI_MSG_SET_BUTTON_ICON) _ui_set_button_icon(icon.index, (const char *)payload + sizeof(icon));
+            else _ui_set_status_icon(icon.index, (const char *)payload + sizeof(icon));
+            break;
+        }
+        default:
+            break;
     }
 }
 
-#define UI_MSG_QUEUE_SIZE 20
-static QueueHandle_t ui_msg_queue = NULL;
+// === 合并邮箱：状态项 / 顶栏 / 底栏只保留每个槽位的最新值 ===
+// 生产者覆盖槽位并置脏位，从不阻塞也不会丢失最终值；
+// LVGL 任务每帧对每个脏槽位只应用一次。
+#define UI_SLOT_TOP             (UI_STATUS_MAX_ITEMS)
+#define UI_SLOT_BOTTOM          (UI_STATUS_MAX_ITEMS + 1)
+#define UI_SLOT_REFRESH_STATUS  (UI_STATUS_MAX_ITEMS + 2)
+#define UI_MAILBOX_SLOTS        (UI_STATUS_MAX_ITEMS + 3)
+
+static portMUX_TYPE g_mailbox_lock = portMUX_INITIALIZER_UNLOCKED;
+static ui_msg_t g_mailbox[UI_MAILBOX_SLOTS];
+static uint32_t g_mailbox_dirty = 0;
+
+// === 唤醒 LVGL 任务，并记录最早的待处理时间用于统计延迟 ===
+static void ui_signal_work(void) {
+    uint32_t expected = 0;
+    uint32_t now = (uint32_t)esp_timer_get_time() | 1;
+    atomic_compare_exchange_strong(&g_pending_since, &expected, now);
+    // 批内不唤醒，ui_batch_end 统一唤醒一次
+    if (g_wakeup_cb && atomic_load(&g_batch_depth) == 0) g_wakeup_cb();
+}
+
+void ui_batch_begin(void) {
+    if (atomic_fetch_add(&g_batch_depth, 1) == 0) {
+        atomic_store(&g_batch_since, (uint32_t)esp_timer_get_time());
+    }
+}
 
-// === 新增：在 lvgl_port_task 主循环中定期调用 ===
-void ui_process_messages(void) {
-    if (!ui_msg_queue) return;
-    ui_msg_t msg;
-    while (xQueueReceive(ui_msg_queue, &msg, 0) == pdTRUE) {
+void ui_batch_end(void) {
+    if (atomic_fetch_sub(&g_batch_depth, 1) == 1 && atomic_load(&g_pending_since) && g_wakeup_cb) {
+        g_wakeup_cb();
+    }
+}
+
+static void ui_mailbox_post(int slot, const ui_msg_t *msg) {
+    taskENTER_CRITICAL(&g_mailbox_lock);
+    g_mailbox[slot] = *msg;
+    g_mailbox_dirty |= 1u << slot;
+    taskEXIT_CRITICAL(&g_mailbox_lock);
+    ui_signal_work();
+}
+
+static void _ui_apply_mailbox(void) {
+    static ui_msg_t msg;
+    uint32_t dirty;
+
+    taskENTER_CRITICAL(&g_mailbox_lock);
+    dirty = g_mailbox_dirty;
+    g_mailbox_dirty = 0;
+    taskEXIT_CRITICAL(&g_mailbox_lock);
+
+    while (dirty) {
+        int slot = __builtin_ctz(dirty);
+        dirty &= dirty - 1;
+        // 取槽位时可能已被再次覆盖并置脏：拿到的是更新的值，下一帧重复应用一次，无害
+        taskENTER_CRITICAL(&g_mailbox_lock);
+        msg = g_mailbox[slot];
+        taskEXIT_CRITICAL(&g_mailbox_lock);
         _ui_apply_msg(&msg);
     }
 }
 
+// === 在 lvgl_port_task 主循环中调用（持有 LVGL 锁）===
+uint32_t ui_process_messages(void) {
+    if (!g_ui_ready) return 0;
+    ui_plot_poll();
+    // 有批正在写入时留到批结束再处理，避免只渲染其中一部分
+    if (atomic_load(&g_batch_depth) &&
+        (uint32_t)esp_timer_get_time() - atomic_load(&g_batch_since) < UI_BATCH_HOLD_US) {
+        return 0;
+    }
+    uint32_t since = atomic_exchange(&g_pending_since, 0);
+    uint8_t type;
+    int len;
+    // 每次最多处理一整圈，避免生产者持续灌入时饿死渲染
+    for (int n = 0; n < UI_MSG_RING_SIZE / 8; n++) {
+        len = ui_ring_pop(&g_msg_ring, &type, g_msg_buf, UI_MSG_PAYLOAD_MAX);
+        if (len < 0) break;
+        g_msg_buf[len] = '\0';
+        _ui_apply_entry(type, g_msg_buf, len);
+    }
+    _ui_apply_mailbox();
+    // 本帧内到达的日志一次性上屏
+    ui_log_commit();
+    return since;
+}
+
+// === 手势分发：在 read_cb 中同步执行，与 LVGL 自身的 LV_EVENT_GESTURE 发送时机相同 ===
+static void _ui_gesture_dispatch(const ui_gesture_event_t *ev, void *user_data) {
+    bool continuous = ev->type == UI_GESTURE_PINCH || ev->type == UI_GESTURE_PAN;
+    if (g_gesture_observer) g_gesture_observer(ev, g_gesture_observer_data);
+    if (!continuous || ev->phase == UI_GESTURE_BEGIN) {
+        lv_point_t p = { ev->start_x, ev->start_y };
+        g_gesture_target = lv_indev_search_obj(lv_scr_act(), &p);
+    }
+    if (!continuous || ev->phase != UI_GESTURE_UPDATE) {
+        ESP_LOGD(TAG, "gesture %s phase %d at (%d,%d) v=(%ld,%ld) scale=%u", ui_gesture_type_name(ev->type),
+                 ev->phase, ev->x, ev->y, (long)ev->vx, (long)ev->vy, ev->scale);
+    }
+    lv_obj_t *target = g_gesture_target;
+    if (continuous && ev->phase == UI_GESTURE_END) g_gesture_target = NULL;
+    if (target) lv_event_send(target, (lv_event_code_t)g_gesture_event_code, (void *)ev);
+}
+
+void ui_touch_feed(const ui_gesture_input_t *in) {
+    if (g_ui_ready) ui_gesture_feed(&g_gesture, in);
+}
+
+void ui_touch_tick(uint32_t now_ms) {
+    if (g_ui_ready) ui_gesture_tick(&g_gesture, now_ms);
+}
+
+uint32_t ui_get_gesture_event_code(void) {
+    return g_gesture_event_code;
+}
+
+void ui_get_gesture_stats(ui_gesture_stats_t *stats) {
+    ui_gesture_get_stats(&g_gesture, stats);
+}
+
+void ui_set_gesture_observer(ui_gesture_cb_t cb, void *user_data) {
+    g_gesture_observer_data = user_data;
+    g_gesture_observer = cb;
+}
+
 // === 主初始化函数（加入预制数据）===
 void ui_init(void) {
     ESP_LOGD(TAG, "ui_init");
     lv_obj_t *scr = lv_scr_act();
     lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
 
+    if (!g_gesture_event_code) g_gesture_event_code = lv_event_register_id();
+    ui_gesture_init(&g_gesture, NULL, _ui_gesture_dispatch, NULL);
+
     init_top_bar();
     init_status_area();
     init_button_area();
     init_log_area();
     init_bottom_bar();
 
-    if (ui_msg_queue == NULL) {
-        ui_msg_queue = xQueueCreate(UI_MSG_QUEUE_SIZE, sizeof(ui_msg_t));
-        configASSERT(ui_msg_queue);
+    if (!g_ui_ready) {
+        ui_ring_init(&g_msg_ring, g_msg_ring_buf, UI_MSG_RING_SIZE, UI_RING_DROP_NEWEST, 0);
+        g_ui_ready = true;
     }
 }
 
+void ui_set_wakeup_cb(ui_wakeup_cb_t cb) {
+    g_wakeup_cb = cb;
+    ui_plot_set_wakeup_cb(cb);
+}
+
+void ui_set_queue_policy(ui_ring_policy_t policy, uint32_t timeout_ms) {
+    ui_ring_set_policy(&g_msg_ring, policy, timeout_ms);
+}
+
+void ui_get_queue_stats(ui_ring_stats_t *stats) {
+    ui_ring_get_stats(&g_msg_ring, stats);
+}
+
+void ui_get_status_stats(ui_status_stats_t *stats) {
+    if (stats) *stats = g_status_stats;
+}
+
 // api
 void ui_set_top_firmware_info(const char* name, const char* version) {
-    if (!ui_msg_queue) return;
+    if (!g_ui_ready) return;
     ui_msg_t msg = {0};
     msg.type = UI_MSG_SET_TOP;
     if (name) strncpy(msg.data.top.name, name, sizeof(msg.data.top.name) - 1);
     if (version) strncpy(msg.data.top.version, version, sizeof(msg.data.top.version) - 1);
-    xQueueSend(ui_msg_queue, &msg, 0);
+    ui_mailbox_post(UI_SLOT_TOP, &msg);
 }
 
 void ui_set_status_item(int index, const char* key, const char* value, lv_color_t color) {
-    if (!ui_msg_queue || index < 0) return;
+    if (!g_ui_ready || index < 0 || index >= UI_STATUS_MAX_ITEMS) return;
     ui_msg_t msg = {0};
     msg.type = UI_MSG_SET_STATUS_ITEM;
     msg.data.status_item.index = index;
     if (key) strncpy(msg.data.status_item.key, key, sizeof(msg.data.status_item.key) - 1);
     if (value) strncpy(msg.data.status_item.value, value, sizeof(msg.data.status_item.value) - 1);
     msg.data.status_item.color = color;
-    xQueueSend(ui_msg_queue, &msg, 0);
+    ui_mailbox_post(index, &msg);
 }
 
 void ui_set_button(int index, const char* text, ui_btn_callback_t callback) {
-    if (!ui_msg_queue || index < 0) return;
-    ui_msg_t msg = {0};
-    msg.type = UI_MSG_SET_BUTTON;
-    msg.data.button.index = index;
-    if (text) strncpy(msg.data.button.text, text, sizeof(msg.data.button.text) - 1);
-    msg.data.button.callback = callback;
-    xQueueSend(ui_msg_queue, &msg, 0);
+    if (!g_ui_ready || index < 0) return;
+    ui_btn_payload_t btn = { .index = index, .callback = callback };
+    ui_ring_seg_t segs[2] = {
+        { &btn, sizeof(btn) },
+        { text, text ? strlen(text) : 0 },
+    };
+    if (ui_ring_pushv(&g_msg_ring, UI_MSG_SET_BUTTON, segs, 2)) ui_signal_work();
+}
+
+void ui_set_button_text(int index, const char* text) {
+    if (!g_ui_ready || index < 0) return;
+    ui_index_payload_t btn = { .index = index };
+    ui_ring_seg_t segs[2] = {
+        { &btn, sizeof(btn) },
+        { text, text ? strlen(text) : 0 },
+    };
+    if (ui_ring_pushv(&g_msg_ring, UI_MSG_SET_BUTTON_TEXT, segs, 2)) ui_signal_work();
+}
+
+void ui_set_button_long_press(int index, ui_btn_callback_t callback) {
+    if (!g_ui_ready || index < 0) return;
+    ui_btn_payload_t btn = { .index = index, .callback = callback };
+    if (ui_ring_push(&g_msg_ring, UI_MSG_SET_BUTTON_LONG_PRESS, &btn, sizeof(btn))) ui_signal_work();
+}
+
+static void ui_push_icon(uint8_t type, int index, const char* icon) {
+    ui_index_payload_t payload = { .index = index };
+    ui_ring_seg_t segs[2] = {
+        { &payload, sizeof(payload) },
+        { icon, icon ? strnlen(icon, UI_ICON_NAME_MAX - 1) : 0 },
+    };
+    if (ui_ring_pushv(&g_msg_ring, type, segs, 2)) ui_signal_work();
+}
+
+void ui_set_button_icon(int index, const char* icon) {
+    if (!g_ui_ready || index < 0 || index >= UI_BUTTON_COUNT) return;
+    ui_push_icon(UI_MSG_SET_BUTTON_ICON, index, icon);
+}
+
+void ui_set_status_icon(int index, const char* icon) {
+    if (!g_ui_ready || index < 0 || index >= UI_STATUS_MAX_ITEMS) return;
+    ui_push_icon(UI_MSG_SET_STATUS_ICON, index, icon);
 }
 
+// 日志只记录时间和原文（或格式串和打包参数），时间前缀和格式化推迟到 LVGL 任务，只为显示的行做
 void ui_add_log(const char* msg) {
-    if (!ui_msg_queue || !msg) return;
-    ui_msg_t m = {0};
-    m.type = UI_MSG_ADD_LOG;
-    // 获取当前 LVGL tick（单位：毫秒）
-    uint32_t tick_ms = lv_tick_get();
-    uint32_t total_sec = tick_ms / 1000;
-    uint32_t hr = total_sec / 3600;
-    uint32_t min = (total_sec % 3600) / 60;
-    uint32_t sec = total_sec % 60;
-
-    // 格式化带时间戳的日志消息，确保不越界
-    snprintf(m.data.log.msg, sizeof(m.data.log.msg),
-             "[%02d:%02d:%02d.%03d] %s", (int)hr, (int)min, (int)sec,(int)tick_ms%1000, msg);
-    xQueueSend(ui_msg_queue, &m, 0);
+    if (!g_ui_ready || !msg) return;
+    ui_log_rec_hdr_t hdr = { .tick_ms = lv_tick_get(), .level = UI_LOG_INFO };
+    ui_ring_seg_t segs[2] = {
+        { &hdr, sizeof(hdr) },
+        { msg, strlen(msg) },
+    };
+    if (ui_ring_pushv(&g_msg_ring, UI_MSG_ADD_LOG, segs, 2)) ui_signal_work();
+}
+
+static bool ui_log_vpush(ui_log_level_t level, const char* tag, const char* fmt, va_list ap, bool may_wait) {
+    ui_log_rec_hdr_t hdr = { .tick_ms = lv_tick_get(), .level = (uint8_t)level, .fmt = fmt, .tag = tag };
+    uint8_t args[UI_LOG_ARGS_MAX];
+    size_t len = ui_log_pack_args(args, sizeof(args), fmt, ap);
+    ui_ring_seg_t segs[2] = {
+        { &hdr, sizeof(hdr) },
+        { args, len },
+    };
+    bool ok = may_wait ? ui_ring_pushv(&g_msg_ring, UI_MSG_ADD_LOG, segs, 2)
+                       : ui_ring_try_pushv(&g_msg_ring, UI_MSG_ADD_LOG, segs, 2);
+    if (ok) ui_signal_work();
+    return ok;
+}
+
+void ui_logf(const char* fmt, ...) {
+    if (!g_ui_ready || !fmt) return;
+    va_list ap;
+    va_start(ap, fmt);
+    ui_log_vpush(UI_LOG_INFO, NULL, fmt, ap, true);
+    va_end(ap);
+}
+
+void ui_logt(ui_log_level_t level, const char* tag, const char* fmt, ...) {
+    if (!g_ui_ready || !fmt) return;
+    va_list ap;
+    va_start(ap, fmt);
+    ui_log_vpush(level, tag, fmt, ap, true);
+    va_end(ap);
+}
+
+bool ui_vlogt_nowait(ui_log_level_t level, const char* tag, const char* fmt, va_list ap) {
+    if (!g_ui_ready || !fmt) return false;
+    return ui_log_vpush(level, tag, fmt, ap, false);
+}
+
+void ui_find_log(const char* text, ui_log_level_t level) {
+    if (!g_ui_ready) return;
+    uint8_t lvl = (uint8_t)level;
+    ui_ring_seg_t segs[2] = {
+        { &lvl, sizeof(lvl) },
+        { text, text ? strlen(text) : 0 },
+    };
+    if (ui_ring_pushv(&g_msg_ring, UI_MSG_FIND_LOG, segs, 2)) ui_signal_work();
+}
+
+void ui_jump_log(uint32_t tick_ms) {
+    if (!g_ui_ready) return;
+    if (ui_ring_push(&g_msg_ring, UI_MSG_JUMP_LOG, &tick_ms, sizeof(tick_ms))) ui_signal_work();
 }
 
 void ui_set_bottom_info(const char* ip, uint32_t baudrate, const char* firmware_id) {
-    if (!ui_msg_queue) return;
+    if (!g_ui_ready) return;
     ui_msg_t msg = {0};
     msg.type = UI_MSG_SET_BOTTOM;
     if (ip) strncpy(msg.data.bottom.ip, ip, sizeof(msg.data.bottom.ip) - 1);
     msg.data.bottom.baudrate = baudrate;
     if (firmware_id) strncpy(msg.data.bottom.firmware_id, firmware_id, sizeof(msg.data.bottom.firmware_id) - 1);
-    xQueueSend(ui_msg_queue, &msg, 0);
+    ui_mailbox_post(UI_SLOT_BOTTOM, &msg);
 }
 
 void ui_refresh_status(void) {
-    if (!ui_msg_queue) return;
+    if (!g_ui_ready) return;
     ui_msg_t msg = {0};
     msg.type = UI_MSG_REFRESH_STATUS;
-    xQueueSend(ui_msg_queue, &msg, 0);
+    ui_mailbox_post(UI_SLOT_REFRESH_STATUS, &msg);
 }
 
 void ui_clear_log(void) {
-    if (!ui_msg_queue) return;
-    ui_msg_t msg = {0};
-    msg.type = UI_MSG_CLEAR_LOG;
-    xQueueSend(ui_msg_queue, &msg, 0);
-}
\ No newline at end of file
+    if (!g_ui_ready) return;
+    if (ui_ring_push(&g_msg_ring, UI_MSG_CLEAR_LOG, NULL, 0)) ui_signal_work();
+}
+
+void ui_show_plot(bool show) {
+    if (!g_ui_ready) return;
+    uint8_t on = show ? 1 : 0;
+    if (ui_ring_push(&g_msg_ring, UI_MSG_SHOW_PLOT, &on, sizeof(on))) ui_signal_work();
+}
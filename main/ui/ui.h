@@ -4,14 +4,20 @@
 
 #include <stdint.h>
 #include "lvgl.h"
+#include "ui_ring.h"
+#include "ui_gesture.h"
+#include "ui_plot.h"
+#include "ui_log.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#define UI_LOG_MAX_LINES 40
+#define UI_LOG_MAX_LINES 40      // 日志区最多的行对象数（可见行），历史行数由 ui_log_store_init 的存储区决定
 #define UI_STATUS_MAX_ITEMS 6
 #define UI_BUTTON_COUNT 4
+#define UI_MSG_RING_SIZE 4096    // 命令队列字节数（2 的幂）
+#define UI_MSG_PAYLOAD_MAX 512   // 单条命令最大负载（含日志正文）
 
 typedef enum {
     UI_MSG_SET_TOP,
@@ -21,6 +27,13 @@ typedef enum {
     UI_MSG_SET_BOTTOM,
     UI_MSG_REFRESH_STATUS,
     UI_MSG_CLEAR_LOG,
+    UI_MSG_SET_BUTTON_LONG_PRESS,
+    UI_MSG_SHOW_PLOT,
+    UI_MSG_FIND_LOG,
+    UI_MSG_JUMP_LOG,
+    UI_MSG_SET_BUTTON_ICON,
+    UI_MSG_SET_STATUS_ICON,
+    UI_MSG_SET_BUTTON_TEXT,
 } ui_msg_type_t;
 
 typedef struct {
@@ -52,17 +65,76 @@ typedef struct {
     } data;
 } ui_msg_t;
 
+typedef struct {
+    uint32_t applied;       // 内容有变化、实际重绘的状态项更新次数
+    uint32_t skipped;       // 与屏幕内容相同而跳过的次数
+    uint32_t labels_set;    // 调用 lv_label_set_text 的标签数
+    uint32_t style_swaps;   // 数值颜色切换（换用共享样式）次数
+} ui_status_stats_t;
+
 typedef void (*ui_btn_callback_t)(void);
+typedef void (*ui_wakeup_cb_t)(void);
 
 void ui_init(void);
 void ui_set_top_firmware_info(const char* name, const char* version);
 void ui_set_status_item(int index, const char* key, const char* value, lv_color_t color);
 void ui_set_button(int index, const char* text, ui_btn_callback_t callback);
+// 只改按钮文字，点击回调保持不变
+void ui_set_button_text(int index, const char* text);
 void ui_add_log(const char* msg);
+// 格式化日志：只记录时间、fmt 指针和按 fmt 打包的参数，文本在 LVGL 任务中只为显示出来的行生成。
+// fmt 必须是字符串常量（记录里只存指针）；%s 参数按值拷贝。
+void ui_logf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+// 带级别和标签的格式化日志（如 ESP_LOGx 的 TAG），tag 也必须是字符串常量；错误 / 警告行以不同颜色显示
+void ui_logt(ui_log_level_t level, const char* tag, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+// 同 ui_logt，但队列满时即使是 UI_RING_BLOCK 策略也不等待，直接丢弃并返回 false（供 esp_log 钩子使用）
+bool ui_vlogt_nowait(ui_log_level_t level, const char* tag, const char* fmt, va_list ap);
+// 在日志历史中往前找级别不低于 level、正文包含 text 的下一行，滚到日志区最上方并高亮（见 ui_log_find）
+// text 为 NULL 或空串时只按级别找，如 ui_find_log(NULL, UI_LOG_ERROR) 跳到上一条错误
+void ui_find_log(const char* text, ui_log_level_t level);
+// 跳到第一条时间（lv_tick_get 的毫秒数，与行首时间相同）不早于 tick_ms 的行；UINT32_MAX 回到最新日志
+void ui_jump_log(uint32_t tick_ms);
 void ui_clear_log(void);
 void ui_set_bottom_info(const char* ip, uint32_t baudrate, const char* firmware_id);
 void ui_refresh_status(void);
-void ui_process_messages(void);
+// 长按按钮时调用 callback（由手势引擎识别，长按后松开不再触发点击回调）
+void ui_set_button_long_press(int index, ui_btn_callback_t callback);
+// 日志区切换为实时曲线（true）或日志（false），也可在日志区左右滑动切换
+// 曲线数据由 ui_plot_config_channel / ui_plot_push 送入（见 ui_plot.h），隐藏时照常接收
+void ui_show_plot(bool show);
+// 在按钮左侧 / 状态项右上角显示图集中名为 icon 的图标（见 ui_icon.h），NULL 或空串去掉图标；
+// 图集未加载或没有该图标时不显示。一行里的图标放在同一页上时，绘制整行只读一块已解码的缓冲
+void ui_set_button_icon(int index, const char* icon);
+void ui_set_status_icon(int index, const char* icon);
+
+// 以下两个函数由显示移植层调用
+// 生产者写入命令后调用 cb 唤醒 LVGL 任务
+void ui_set_wakeup_cb(ui_wakeup_cb_t cb);
+// 应用所有待处理命令，返回其中最早一条的提交时间（esp_timer 低 32 位，us），无命令时返回 0
+uint32_t ui_process_messages(void);
+
+// 批量提交：begin 与 end 之间的调用在同一次 ui_process_messages 中生效（由同一任务调用，可嵌套）。
+// 批内只做入队，不要阻塞；批打开超过 UI_BATCH_HOLD_US 后 LVGL 任务不再等待，照常处理。
+#define UI_BATCH_HOLD_US 5000
+void ui_batch_begin(void);
+void ui_batch_end(void);
+
+// 命令队列溢出策略与统计（状态项 / 顶栏 / 底栏走合并邮箱，不受队列影响）
+void ui_set_queue_policy(ui_ring_policy_t policy, uint32_t timeout_ms);
+void ui_get_queue_stats(ui_ring_stats_t *stats);
+// 状态区重绘统计（状态项更新按内容去重）
+void ui_get_status_stats(ui_status_stats_t *stats);
+
+// === 手势 ===
+// 以下两个函数由输入移植层在 LVGL 任务的 read_cb 中调用：有新触摸样本时 feed，否则 tick
+// 识别出的手势以 ui_get_gesture_event_code() 事件发给手势起点下方最内层的可点击对象，
+// 事件参数为 const ui_gesture_event_t *；连续手势（捏合 / 双指平移）的后续事件发给同一对象。
+void ui_touch_feed(const ui_gesture_input_t *in);
+void ui_touch_tick(uint32_t now_ms);
+uint32_t ui_get_gesture_event_code(void);
+void ui_get_gesture_stats(ui_gesture_stats_t *stats);
+// 每个识别出的手势在分发前先交给 cb（模拟器用它核对回放结果），NULL 取消
+void ui_set_gesture_observer(ui_gesture_cb_t cb, void *user_data);
 
 #ifdef __cplusplus
 }
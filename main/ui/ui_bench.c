@@ -0,0 +1,262 @@
+// ui_bench.c
+// 负载只依赖 LVGL tick，固定步长时钟下每次运行发出的 API 调用完全相同。
+#include "ui_bench.h"
+#include "ui.h"
+#include "perf_hist.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    uint32_t t_ms;
+    uint32_t frame_us;
+    uint32_t flush_us;
+    uint32_t inv_px;
+    uint32_t queue_bytes;
+    uint32_t heap_used;
+} bench_record_t;
+
+static const char *const g_workload_names[UI_BENCH_WORKLOAD_COUNT] = {
+    "log_flood", "status_rate", "button_relabel", "mixed", "plot_stream",
+};
+static const uint32_t g_default_rate_hz[UI_BENCH_WORKLOAD_COUNT] = { 1000, 50, 10, 200, 10000 };
+
+static ui_bench_config_t g_config;
+static _Atomic bool g_running = false;
+static uint32_t g_start_ms;
+static uint32_t g_issued_log, g_issued_status, g_issued_button, g_issued_plot;
+
+static bench_record_t *g_records;
+static uint32_t g_frames;
+static perf_hist_t g_frame_hist, g_flush_hist;
+static uint64_t g_inv_px_total;
+static uint32_t g_heap_peak;
+static uint32_t g_queue_peak;
+static ui_ring_stats_t g_queue_start;
+
+// === 负载 ===
+static const char g_filler[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                               "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+static void issue_log(uint32_t n) {
+    ui_logf("bench %lu %.*s", (unsigned long)n, (int)(n * 37 % 113), g_filler);
+}
+
+static void issue_status(uint32_t n) {
+    static const uint32_t colors[] = { 0x00FF00, 0xFFFF00, 0x00FFFF, 0xFF00FF, 0xFFFFFF };
+    static const char *const keys[UI_STATUS_MAX_ITEMS] = { "Temp", "Pressure", "Mode", "Flow", "Error", "Uptime" };
+    lv_color_t color = lv_color_hex(colors[n / 10 % (sizeof(colors) / sizeof(colors[0]))]);
+    for (int i = 0; i < UI_STATUS_MAX_ITEMS; i++) {
+        char value[16];
+        snprintf(value, sizeof(value), "%lu.%d", (unsigned long)(n % 1000), i);
+        ui_set_status_item(i, keys[i], value, color);
+    }
+}
+
+static void issue_buttons(uint32_t n) {
+    for (int i = 0; i < UI_BUTTON_COUNT; i++) {
+        char text[16];
+        snprintf(text, sizeof(text), "B%d #%lu", i, (unsigned long)n);
+        ui_set_button_text(i, text);
+    }
+}
+
+// 以 rate_hz 计算截至 elapsed_ms 应发出的次数，补齐尚未发出的部分
+static void issue_due(uint32_t elapsed_ms, uint32_t rate_hz, uint32_t *issued, void (*issue)(uint32_t)) {
+    if (rate_hz == 0) return;
+    uint32_t due = (uint32_t)((uint64_t)elapsed_ms * rate_hz / 1000) + 1;
+    while (*issued < due) {
+        issue((*issued)++);
+    }
+}
+
+// 曲线：通道 0 为三角波叠加每 997 个样本一次的单样本尖峰（抽取后必须仍可见），通道 1 为锯齿波
+// 样本值只取决于序号，按到期数量成批送入
+#define BENCH_PLOT_BATCH 64
+
+static void plot_config(uint32_t rate_hz) {
+    uint32_t spp = rate_hz / UI_BENCH_PLOT_COLS_PER_S;
+    ui_plot_channel_config_t cfg = { .min = -1.5f, .max = 1.5f, .samples_per_px = spp ? spp : 1 };
+    cfg.color = lv_color_hex(0x00FF00);
+    ui_plot_config_channel(0, &cfg);
+    cfg.color = lv_color_hex(0xFFFF00);
+    ui_plot_config_channel(1, &cfg);
+}
+
+static void issue_plot_due(uint32_t elapsed_ms, uint32_t rate_hz) {
+    float tri[BENCH_PLOT_BATCH], saw[BENCH_PLOT_BATCH];
+    uint32_t due = (uint32_t)((uint64_t)elapsed_ms * rate_hz / 1000);
+    while (g_issued_plot < due) {
+        uint32_t n = due - g_issued_plot;
+        if (n > BENCH_PLOT_BATCH) n = BENCH_PLOT_BATCH;
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t s = g_issued_plot + i;
+            int32_t phase = (int32_t)(s % 2000);
+            tri[i] = (float)(phase < 1000 ? phase : 2000 - phase) / 1000.0f - 0.5f;
+            if (s % 997 == 0) tri[i] += 0.9f;
+            saw[i] = (float)(s % 1500) / 1500.0f - 0.5f;
+        }
+        ui_plot_push(0, tri, n);
+        ui_plot_push(1, saw, n);
+        g_issued_plot += n;
+    }
+}
+
+const char *ui_bench_workload_name(ui_bench_workload_t workload) {
+    return (workload < UI_BENCH_WORKLOAD_COUNT) ? g_workload_names[workload] : "?";
+}
+
+bool ui_bench_workload_from_name(const char *name, ui_bench_workload_t *workload) {
+    for (int i = 0; i < UI_BENCH_WORKLOAD_COUNT; i++) {
+        if (!strcmp(name, g_workload_names[i])) {
+            *workload = (ui_bench_workload_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ui_bench_start(const ui_bench_config_t *config) {
+    if (atomic_load(&g_running) || config->workload >= UI_BENCH_WORKLOAD_COUNT) return false;
+    if (!g_records) {
+        g_records = malloc(UI_BENCH_MAX_FRAMES * sizeof(*g_records));
+        if (!g_records) return false;
+    }
+    g_config = *config;
+    if (g_config.rate_hz == 0) g_config.rate_hz = g_default_rate_hz[g_config.workload];
+    g_start_ms = lv_tick_get();
+    g_issued_log = g_issued_status = g_issued_button = g_issued_plot = 0;
+    g_frames = 0;
+    g_inv_px_total = 0;
+    g_heap_peak = 0;
+    g_queue_peak = 0;
+    perf_hist_reset(&g_frame_hist);
+    perf_hist_reset(&g_flush_hist);
+    ui_get_queue_stats(&g_queue_start);
+    ui_show_plot(g_config.workload == UI_BENCH_PLOT_STREAM);
+    if (g_config.workload == UI_BENCH_PLOT_STREAM) plot_config(g_config.rate_hz);
+    atomic_store(&g_running, true);
+    return true;
+}
+
+bool ui_bench_step(void) {
+    if (!atomic_load(&g_running)) return false;
+    uint32_t elapsed = lv_tick_elaps(g_start_ms);
+    if (elapsed >= g_config.duration_ms) return false;
+    uint32_t rate = g_config.rate_hz;
+    switch (g_config.workload) {
+        case UI_BENCH_LOG_FLOOD:
+            issue_due(elapsed, rate, &g_issued_log, issue_log);
+            break;
+        case UI_BENCH_STATUS_RATE:
+            issue_due(elapsed, rate, &g_issued_status, issue_status);
+            break;
+        case UI_BENCH_BUTTON_RELABEL:
+            issue_due(elapsed, rate, &g_issued_button, issue_buttons);
+            break;
+        case UI_BENCH_MIXED:
+            issue_due(elapsed, rate, &g_issued_log, issue_log);
+            issue_due(elapsed, rate / 5, &g_issued_status, issue_status);
+            issue_due(elapsed, rate / 50 ? rate / 50 : 1, &g_issued_button, issue_buttons);
+            break;
+        case UI_BENCH_PLOT_STREAM:
+            issue_plot_due(elapsed, rate);
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+void ui_bench_stop(void) {
+    atomic_store(&g_running, false);
+}
+
+bool ui_bench_running(void) {
+    return atomic_load(&g_running);
+}
+
+void ui_bench_frame_done(const ui_bench_frame_t *frame) {
+    if (!atomic_load(&g_running)) return;
+    ui_ring_stats_t queue;
+    ui_get_queue_stats(&queue);
+    if (g_frames < UI_BENCH_MAX_FRAMES) {
+        bench_record_t *r = &g_records[g_frames];
+        r->t_ms = lv_tick_elaps(g_start_ms);
+        r->frame_us = frame->frame_us;
+        r->flush_us = frame->flush_us;
+        r->inv_px = frame->inv_px;
+        r->queue_bytes = queue.used;
+        r->heap_used = frame->heap_used;
+    }
+    g_frames++;
+    perf_hist_add(&g_frame_hist, frame->frame_us);
+    perf_hist_add(&g_flush_hist, frame->flush_us);
+    g_inv_px_total += frame->inv_px;
+    if (frame->heap_used > g_heap_peak) g_heap_peak = frame->heap_used;
+    if (queue.used > g_queue_peak) g_queue_peak = queue.used;
+}
+
+// === 输出 ===
+static void report_summary(ui_bench_format_t format, ui_bench_write_cb_t write, void *ctx) {
+    ui_ring_stats_t queue;
+    ui_get_queue_stats(&queue);
+    char buf[512];
+    const char *fmt = (format == UI_BENCH_JSON)
+        ? "\"summary\":{\"frames\":%lu,\"fps\":%lu.%02lu,\"frame_us_p50\":%lu,\"frame_us_p99\":%lu,"
+          "\"frame_us_max\":%lu,\"flush_us_p50\":%lu,\"flush_us_p99\":%lu,\"inv_px_avg\":%lu,"
+          "\"queue_peak\":%lu,\"queue_dropped\":%lu,\"heap_peak\":%lu}"
+        : "# summary frames=%lu fps=%lu.%02lu frame_us_p50=%lu frame_us_p99=%lu frame_us_max=%lu "
+          "flush_us_p50=%lu flush_us_p99=%lu inv_px_avg=%lu queue_peak=%lu queue_dropped=%lu heap_peak=%lu\n";
+    uint32_t centi_fps = g_config.duration_ms ? (uint32_t)((uint64_t)g_frames * 100000 / g_config.duration_ms) : 0;
+    snprintf(buf, sizeof(buf), fmt,
+             (unsigned long)g_frames, (unsigned long)(centi_fps / 100), (unsigned long)(centi_fps % 100),
+             (unsigned long)perf_hist_percentile(&g_frame_hist, 50),
+             (unsigned long)perf_hist_percentile(&g_frame_hist, 99),
+             (unsigned long)g_frame_hist.max,
+             (unsigned long)perf_hist_percentile(&g_flush_hist, 50),
+             (unsigned long)perf_hist_percentile(&g_flush_hist, 99),
+             (unsigned long)(g_frames ? g_inv_px_total / g_frames : 0),
+             (unsigned long)g_queue_peak,
+             (unsigned long)(queue.dropped - g_queue_start.dropped),
+             (unsigned long)g_heap_peak);
+    write(buf, ctx);
+}
+
+void ui_bench_report(ui_bench_format_t format, ui_bench_write_cb_t write, void *ctx) {
+    char buf[160];
+    const uint32_t kept = g_frames < UI_BENCH_MAX_FRAMES ? g_frames : UI_BENCH_MAX_FRAMES;
+    if (format == UI_BENCH_JSON) {
+        snprintf(buf, sizeof(buf),
+                 "{\"workload\":\"%s\",\"rate_hz\":%lu,\"duration_ms\":%lu,"
+                 "\"columns\":[\"t_ms\",\"frame_us\",\"flush_us\",\"inv_px\",\"queue_bytes\",\"heap_used\"],\"frames\":[",
+                 ui_bench_workload_name(g_config.workload), (unsigned long)g_config.rate_hz,
+                 (unsigned long)g_config.duration_ms);
+        write(buf, ctx);
+        for (uint32_t i = 0; i < kept; i++) {
+            const bench_record_t *r = &g_records[i];
+            snprintf(buf, sizeof(buf), "%s[%lu,%lu,%lu,%lu,%lu,%lu]", i ? "," : "",
+                     (unsigned long)r->t_ms, (unsigned long)r->frame_us, (unsigned long)r->flush_us,
+                     (unsigned long)r->inv_px, (unsigned long)r->queue_bytes, (unsigned long)r->heap_used);
+            write(buf, ctx);
+        }
+        write("],", ctx);
+        report_summary(format, write, ctx);
+        write("}\n", ctx);
+    } else {
+        snprintf(buf, sizeof(buf), "# workload=%s rate_hz=%lu duration_ms=%lu\n"
+                 "frame,t_ms,frame_us,flush_us,inv_px,queue_bytes,heap_used\n",
+                 ui_bench_workload_name(g_config.workload), (unsigned long)g_config.rate_hz,
+                 (unsigned long)g_config.duration_ms);
+        write(buf, ctx);
+        for (uint32_t i = 0; i < kept; i++) {
+            const bench_record_t *r = &g_records[i];
+            snprintf(buf, sizeof(buf), "%lu,%lu,%lu,%lu,%lu,%lu,%lu\n", (unsigned long)i,
+                     (unsigned long)r->t_ms, (unsigned long)r->frame_us, (unsigned long)r->flush_us,
+                     (unsigned long)r->inv_px, (unsigned long)r->queue_bytes, (unsigned long)r->heap_used);
+            write(buf, ctx);
+        }
+        report_summary(format, write, ctx);
+    }
+}
@@ -0,0 +1,68 @@
+// ui_bench.h
+// UI 渲染基准：用固定的负载驱动公开的 ui.h 接口，逐帧记录耗时、失效面积、队列深度与堆占用。
+// 同一套代码在板上（控制台 bench 命令）与主机模拟器（--bench）中运行，结果可直接对比。
+#ifndef UI_BENCH_H
+#define UI_BENCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UI_BENCH_MAX_FRAMES 2048    // 超出部分只计入汇总，不保留逐帧记录
+#define UI_BENCH_PLOT_COLS_PER_S 200    // plot_stream 的扫描速度，采样率变化时每帧绘制的列数不变
+
+typedef enum {
+    UI_BENCH_LOG_FLOOD,         // 以 rate_hz 条/秒写日志，长度在 8~120 字节间循环
+    UI_BENCH_STATUS_RATE,       // 以 rate_hz 更新全部 6 个状态项，每 10 次换一次颜色
+    UI_BENCH_BUTTON_RELABEL,    // 以 rate_hz 重命名全部按钮（只改文字，回调不变）
+    UI_BENCH_MIXED,             // 日志 rate_hz，状态 rate_hz/5，按钮 rate_hz/50
+    UI_BENCH_PLOT_STREAM,       // 两个曲线通道各 rate_hz 个样本/秒，每 ~1 ms 一批，曲线固定 UI_BENCH_PLOT_COLS_PER_S 列/秒
+    UI_BENCH_WORKLOAD_COUNT,
+} ui_bench_workload_t;
+
+typedef enum {
+    UI_BENCH_CSV,
+    UI_BENCH_JSON,
+} ui_bench_format_t;
+
+typedef struct {
+    ui_bench_workload_t workload;
+    uint32_t duration_ms;
+    uint32_t rate_hz;           // 0 使用负载的默认速率
+} ui_bench_config_t;
+
+// 由显示移植层在每帧刷新完成后填写
+typedef struct {
+    uint32_t frame_us;          // 本次 LVGL 处理到最后一块刷出的耗时
+    uint32_t flush_us;          // 最后一次 flush 阻塞的时间
+    uint32_t inv_px;            // 本帧重绘的像素数
+    uint32_t heap_used;         // 当前堆占用（字节）
+} ui_bench_frame_t;
+
+typedef void (*ui_bench_write_cb_t)(const char *text, void *ctx);
+
+const char *ui_bench_workload_name(ui_bench_workload_t workload);
+// 按名称查找负载（log_flood / status_rate / button_relabel / mixed / plot_stream），找不到返回 false
+bool ui_bench_workload_from_name(const char *name, ui_bench_workload_t *workload);
+
+// 生产者侧：start 后周期调用 step 发出到期的 API 调用（按 lv_tick 计时），负载结束时返回 false
+bool ui_bench_start(const ui_bench_config_t *config);
+bool ui_bench_step(void);
+// 停止记录（持有 LVGL 锁调用，保证不会与 ui_bench_frame_done 并发）
+void ui_bench_stop(void);
+bool ui_bench_running(void);
+
+// LVGL 任务侧：每帧调用一次，未运行时直接返回
+void ui_bench_frame_done(const ui_bench_frame_t *frame);
+
+// 输出结果：逐帧明细 + 汇总，按块多次调用 write
+void ui_bench_report(ui_bench_format_t format, ui_bench_write_cb_t write, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_BENCH_H
@@ -0,0 +1,598 @@
+// ui_font.c
+// 二进制字体格式（与 LVGL 的 lv_font_load 相同）：依次为 head、cmap、loca、glyf（以及不使用的 kern）表，
+// 每个表以 uint32 长度（含表头）和 4 字节标签开头，多字节字段均为小端。
+// glyf 表中每个字形是一串高位在前的位流：步进宽度、ofs_x、ofs_y、box_w、box_h，之后紧跟位图。
+#include "ui_font.h"
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "ui_font";
+
+#define FONT_HEAD_SIZE      40          // head 表去掉表头后的长度
+#define FONT_CMAP_MAX       1024        // 子表数量上限，防止读到损坏的数据
+#define FONT_GLYPH_MAX      (64 * 1024) // 单个字形记录的长度上限
+
+// === 缓存 ===
+typedef struct {
+    uint32_t key;               // 字体 id << 24 | 码点，0 表示空闲
+    int16_t hnext;              // 哈希链
+    int16_t prev;               // 所在层的使用顺序链表，表头为最近使用
+    int16_t next;               // 空闲时串起空闲槽
+    uint16_t adv_w;             // 1/16 像素
+    uint16_t box_w;
+    uint16_t box_h;
+    int16_t ofs_x;
+    int16_t ofs_y;
+    uint16_t size;              // 位图字节数
+    uint8_t hits;               // 在 LRU 层被命中的次数
+    uint8_t *bitmap;            // 指向所在层的位图槽
+} glyph_entry_t;
+
+typedef struct {
+    glyph_entry_t *entries;
+    int16_t first;              // 第一个槽的全局下标：热点层在前，LRU 层在后
+    int16_t count;
+    int16_t head;
+    int16_t tail;
+    int16_t free;
+    uint16_t used;
+} cache_tier_t;
+
+static cache_tier_t g_hot;
+static cache_tier_t g_lru;
+static uint16_t g_slot_bytes;
+static int16_t *g_buckets;
+static uint32_t g_bucket_bits;
+static perf_hist_t *g_fetch_hist;
+static ui_font_cache_stats_t g_stats;
+
+static uint8_t *g_stage;                // 读取字形记录、交换两层位图用的暂存区
+static uint32_t g_stage_size;
+static glyph_entry_t g_big;             // 超过槽大小的字形：只保留最近一个，供紧接着的取位图调用使用
+static uint32_t g_big_size;
+
+static uint8_t g_next_font_id = 1;
+
+static uint32_t rd16(const uint8_t *p) {
+    return p[0] | (uint32_t)p[1] << 8;
+}
+
+static uint32_t rd32(const uint8_t *p) {
+    return rd16(p) | rd16(p + 2) << 16;
+}
+
+static glyph_entry_t *entry_at(int16_t i) {
+    return i < g_hot.count ? &g_hot.entries[i] : &g_lru.entries[i - g_lru.first];
+}
+
+static cache_tier_t *tier_of(int16_t i) {
+    return i < g_hot.count ? &g_hot : &g_lru;
+}
+
+static uint32_t bucket_of(uint32_t key) {
+    return (key * 2654435761u) >> (32 - g_bucket_bits);
+}
+
+static int16_t hash_find(uint32_t key) {
+    if (!g_buckets) return -1;
+    int16_t i = g_buckets[bucket_of(key)];
+    while (i >= 0 && entry_at(i)->key != key) i = entry_at(i)->hnext;
+    return i;
+}
+
+static void hash_insert(int16_t i) {
+    glyph_entry_t *e = entry_at(i);
+    int16_t *head = &g_buckets[bucket_of(e->key)];
+    e->hnext = *head;
+    *head = i;
+}
+
+static void hash_remove(int16_t i) {
+    int16_t *link = &g_buckets[bucket_of(entry_at(i)->key)];
+    while (*link >= 0 && *link != i) link = &entry_at(*link)->hnext;
+    if (*link == i) *link = entry_at(i)->hnext;
+}
+
+static void list_unlink(cache_tier_t *t, int16_t i) {
+    glyph_entry_t *e = entry_at(i);
+    if (e->prev >= 0) entry_at(e->prev)->next = e->next;
+    else t->head = e->next;
+    if (e->next >= 0) entry_at(e->next)->prev = e->prev;
+    else t->tail = e->prev;
+}
+
+static void list_push_head(cache_tier_t *t, int16_t i) {
+    glyph_entry_t *e = entry_at(i);
+    e->prev = -1;
+    e->next = t->head;
+    if (t->head >= 0) entry_at(t->head)->prev = i;
+    else t->tail = i;
+    t->head = i;
+}
+
+static void list_touch(cache_tier_t *t, int16_t i) {
+    if (t->head == i) return;
+    list_unlink(t, i);
+    list_push_head(t, i);
+}
+
+// 取一个槽：优先用空闲槽，否则挤掉该层最久未用的字形；返回的槽不在任何链表中
+static int16_t take_slot(cache_tier_t *t) {
+    int16_t i = t->free;
+    if (i >= 0) {
+        t->free = entry_at(i)->next;
+        t->used++;
+        return i;
+    }
+    i = t->tail;
+    if (i < 0) return -1;
+    list_unlink(t, i);
+    hash_remove(i);
+    if (t == &g_lru) g_stats.evictions++;
+    return i;
+}
+
+static void release_slot(cache_tier_t *t, int16_t i) {
+    glyph_entry_t *e = entry_at(i);
+    list_unlink(t, i);
+    hash_remove(i);
+    e->key = 0;
+    e->next = t->free;
+    t->free = i;
+    t->used--;
+}
+
+// 复制字形描述和位图，保留目标自己的位图槽和链表位置
+static void copy_glyph(glyph_entry_t *dst, const glyph_entry_t *src, const uint8_t *bitmap) {
+    dst->key = src->key;
+    dst->adv_w = src->adv_w;
+    dst->box_w = src->box_w;
+    dst->box_h = src->box_h;
+    dst->ofs_x = src->ofs_x;
+    dst->ofs_y = src->ofs_y;
+    dst->size = src->size;
+    memcpy(dst->bitmap, bitmap, src->size);
+}
+
+static bool stage_reserve(uint32_t size) {
+    if (size <= g_stage_size) return true;
+    uint8_t *p = lv_mem_realloc(g_stage, size);
+    if (!p) return false;
+    g_stage = p;
+    g_stage_size = size;
+    return true;
+}
+
+// LRU 层的字形提升到热点层，返回它的新下标；热点层已满时与热点层最久未用的字形交换位置
+static int16_t promote(int16_t i) {
+    if (g_hot.count == 0) return i;
+    glyph_entry_t *e = entry_at(i);
+    int16_t h = g_hot.free;
+    if (h >= 0) {
+        h = take_slot(&g_hot);
+        copy_glyph(entry_at(h), e, e->bitmap);
+        release_slot(&g_lru, i);
+        hash_insert(h);
+        list_push_head(&g_hot, h);
+    } else {
+        if (!stage_reserve(g_slot_bytes)) return i;
+        h = g_hot.tail;
+        glyph_entry_t *victim = entry_at(h);
+        glyph_entry_t saved = *victim;
+        memcpy(g_stage, victim->bitmap, victim->size);
+        hash_remove(h);
+        hash_remove(i);
+        copy_glyph(victim, e, e->bitmap);
+        copy_glyph(e, &saved, g_stage);
+        e->hits = 0;
+        hash_insert(h);
+        hash_insert(i);
+        list_touch(&g_hot, h);
+        list_touch(&g_lru, i);      // 换下来的字形放在 LRU 层最近使用的位置，不会马上被挤掉
+    }
+    g_stats.promotions++;
+    return h;
+}
+
+static void tier_init(cache_tier_t *t, void *mem, size_t size, int16_t first) {
+    uint32_t count = size / (sizeof(glyph_entry_t) + g_slot_bytes);
+    if (!mem || !g_slot_bytes) count = 0;
+    if (count > INT16_MAX / 2) count = INT16_MAX / 2;
+    *t = (cache_tier_t){
+        .entries = mem,
+        .first = first,
+        .count = (int16_t)count,
+        .head = -1,
+        .tail = -1,
+        .free = -1,
+    };
+    uint8_t *bitmaps = (uint8_t *)mem + count * sizeof(glyph_entry_t);
+    for (int16_t k = (int16_t)count - 1; k >= 0; k--) {
+        glyph_entry_t *e = &t->entries[k];
+        *e = (glyph_entry_t){ .hnext = -1, .prev = -1, .next = t->free };
+        e->bitmap = bitmaps + (size_t)k * g_slot_bytes;
+        t->free = first + k;
+    }
+}
+
+bool ui_font_cache_init(const ui_font_cache_config_t *cfg) {
+    lv_mem_free(g_buckets);
+    g_buckets = NULL;
+    g_big.key = 0;
+    g_slot_bytes = (cfg->slot_bytes + 3) & ~3u;
+    g_fetch_hist = cfg->fetch_hist;
+    tier_init(&g_hot, cfg->hot_mem, cfg->hot_size, 0);
+    tier_init(&g_lru, cfg->lru_mem, cfg->lru_size, g_hot.count);
+
+    const uint32_t total = g_hot.count + g_lru.count;
+    g_bucket_bits = 4;
+    while ((1u << g_bucket_bits) < total) g_bucket_bits++;
+    g_buckets = lv_mem_alloc(sizeof(int16_t) << g_bucket_bits);
+    if (!g_buckets) {
+        g_hot.count = g_lru.count = 0;
+        return false;
+    }
+    memset(g_buckets, 0xFF, sizeof(int16_t) << g_bucket_bits);     // 全部为 -1
+    ESP_LOGI(TAG, "glyph cache: %d hot + %d LRU slots of %u bytes", g_hot.count, g_lru.count,
+             (unsigned)g_slot_bytes);
+    return true;
+}
+
+void ui_font_cache_get_stats(ui_font_cache_stats_t *stats) {
+    *stats = g_stats;
+    stats->hot_slots = g_hot.count;
+    stats->hot_used = g_hot.used;
+    stats->lru_slots = g_lru.count;
+    stats->lru_used = g_lru.used;
+}
+
+// === 字形读取 ===
+typedef struct {
+    const uint8_t *data;
+    uint32_t len;
+    uint32_t bit;
+} bit_reader_t;
+
+static uint32_t read_bits(bit_reader_t *r, uint8_t n) {
+    uint32_t v = 0;
+    while (n--) {
+        const uint32_t byte = r->bit >> 3;
+        const uint32_t b = byte < r->len ? (r->data[byte] >> (7 - (r->bit & 7))) & 1 : 0;
+        v = (v << 1) | b;
+        r->bit++;
+    }
+    return v;
+}
+
+static int32_t read_bits_signed(bit_reader_t *r, uint8_t n) {
+    uint32_t v = read_bits(r, n);
+    if (n && (v & (1u << (n - 1)))) v |= ~0u << n;
+    return (int32_t)v;
+}
+
+// 位图紧跟在描述之后，起点一般不在字节边界上，逐字节移位拼出来
+static void read_bitmap(const bit_reader_t *r, uint8_t *out, uint32_t size) {
+    const uint32_t byte = r->bit >> 3;
+    const uint32_t shift = r->bit & 7;
+    for (uint32_t k = 0; k < size; k++) {
+        const uint32_t b0 = byte + k < r->len ? r->data[byte + k] : 0;
+        if (shift == 0) {
+            out[k] = (uint8_t)b0;
+        } else {
+            const uint32_t b1 = byte + k + 1 < r->len ? r->data[byte + k + 1] : 0;
+            out[k] = (uint8_t)((b0 << shift) | (b1 >> (8 - shift)));
+        }
+    }
+}
+
+static uint32_t glyph_offset(const ui_font_t *f, uint32_t gid) {
+    const uint8_t *loca = f->loca;
+    return f->loca32 ? rd32(loca + gid * 4) : rd16(loca + gid * 2);
+}
+
+static glyph_entry_t *fetch(ui_font_t *f, uint32_t gid, uint32_t key) {
+    const int64_t start_us = esp_timer_get_time();
+    const uint32_t start = glyph_offset(f, gid);
+    const uint32_t end = gid + 1 < f->glyph_count ? glyph_offset(f, gid + 1) : f->glyf_size;
+    if (end < start || end - start > FONT_GLYPH_MAX || !stage_reserve(end - start) ||
+        !f->src.read(f->src.ctx, f->glyf_start + start, g_stage, end - start)) {
+        g_stats.read_errors++;
+        return NULL;
+    }
+
+    bit_reader_t r = { .data = g_stage, .len = end - start };
+    glyph_entry_t desc = {0};
+    uint32_t adv = f->adv_bits ? read_bits(&r, f->adv_bits) : f->default_adv;
+    desc.adv_w = (uint16_t)(f->adv_frac ? adv : adv * 16);
+    desc.ofs_x = (int16_t)read_bits_signed(&r, f->xy_bits);
+    desc.ofs_y = (int16_t)read_bits_signed(&r, f->xy_bits);
+    desc.box_w = (uint16_t)read_bits(&r, f->wh_bits);
+    desc.box_h = (uint16_t)read_bits(&r, f->wh_bits);
+    const uint32_t size = ((uint32_t)desc.box_w * desc.box_h * f->bpp + 7) / 8;
+    desc.size = (uint16_t)size;
+    desc.key = key;
+
+    // 放进 LRU 层；没有 LRU 层时直接放进热点层
+    cache_tier_t *t = g_lru.count ? &g_lru : &g_hot;
+    int16_t i = size <= g_slot_bytes ? take_slot(t) : -1;
+    glyph_entry_t *e;
+    if (i >= 0) {
+        e = entry_at(i);
+        e->hits = 0;
+    } else {
+        if (size > g_big_size) {
+            uint8_t *p = lv_mem_realloc(g_big.bitmap, size);
+            if (!p) {
+                g_stats.read_errors++;
+                return NULL;
+            }
+            g_big.bitmap = p;
+            g_big_size = size;
+        }
+        e = &g_big;
+        g_stats.uncached++;
+    }
+    e->key = key;
+    e->adv_w = desc.adv_w;
+    e->box_w = desc.box_w;
+    e->box_h = desc.box_h;
+    e->ofs_x = desc.ofs_x;
+    e->ofs_y = desc.ofs_y;
+    e->size = desc.size;
+    read_bitmap(&r, e->bitmap, size);
+    if (i >= 0) {
+        hash_insert(i);
+        list_push_head(t, i);
+    }
+
+    const uint32_t us = (uint32_t)(esp_timer_get_time() - start_us);
+    g_stats.lookups++;
+    g_stats.misses++;
+    g_stats.fetch_us_total += us;
+    if (us > g_stats.fetch_us_max) g_stats.fetch_us_max = us;
+    if (g_fetch_hist) perf_hist_add(g_fetch_hist, us);
+    return e;
+}
+
+static int32_t find_u16(const uint16_t *list, uint32_t count, uint32_t value) {
+    uint32_t lo = 0, hi = count;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (list[mid] < value) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < count && list[lo] == value ? (int32_t)lo : -1;
+}
+
+// 与 lv_font_fmt_txt.c 的 get_glyph_dsc_id 相同，0 表示字体中没有该字符
+static uint32_t glyph_id(const ui_font_t *f, uint32_t letter) {
+    for (uint32_t k = 0; k < f->cmap_count; k++) {
+        const ui_font_cmap_t *c = &f->cmaps[k];
+        const uint32_t rcp = letter - c->range_start;
+        if (rcp >= c->range_length) continue;
+        switch (c->type) {
+        case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY:
+            return c->glyph_id_start + rcp;
+        case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL:
+            if (rcp >= c->count) continue;
+            return c->glyph_id_start + ((const uint8_t *)c->data)[rcp];
+        case LV_FONT_FMT_TXT_CMAP_SPARSE_TINY:
+        case LV_FONT_FMT_TXT_CMAP_SPARSE_FULL: {
+            const uint16_t *list = c->data;
+            int32_t idx = find_u16(list, c->count, rcp);
+            if (idx < 0) continue;
+            if (c->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY) return c->glyph_id_start + idx;
+            return c->glyph_id_start + list[c->count + idx];
+        }
+        default:
+            break;
+        }
+    }
+    return 0;
+}
+
+// count 为 false 时是取位图的调用，描述刚查过，不重复计数也不提升
+static const glyph_entry_t *glyph_get(ui_font_t *f, uint32_t letter, bool count) {
+    const uint32_t key = (uint32_t)f->id << 24 | (letter & 0xFFFFFF);
+    if (!count && g_big.key == key) return &g_big;
+    int16_t i = hash_find(key);
+    if (i >= 0) {
+        cache_tier_t *t = tier_of(i);
+        list_touch(t, i);
+        if (count) {
+            g_stats.lookups++;
+            if (t == &g_hot) {
+                g_stats.hot_hits++;
+            } else {
+                g_stats.lru_hits++;
+                if (++entry_at(i)->hits >= UI_FONT_PROMOTE_HITS) i = promote(i);
+            }
+        }
+        return entry_at(i);
+    }
+    const uint32_t gid = glyph_id(f, letter);
+    if (gid == 0 || gid >= f->glyph_count) return NULL;
+    return fetch(f, gid, key);
+}
+
+// === LVGL 字体接口 ===
+static bool font_get_glyph_dsc(const lv_font_t *font, lv_font_glyph_dsc_t *dsc_out, uint32_t letter,
+                               uint32_t letter_next) {
+    (void)letter_next;      // 不读取 kern 表，没有字距调整
+    ui_font_t *f = (ui_font_t *)font->dsc;
+    const bool is_tab = letter == '\t';
+    if (is_tab) letter = ' ';
+    const glyph_entry_t *e = glyph_get(f, letter, true);
+    if (!e) return false;
+    uint32_t adv_w = is_tab ? e->adv_w * 2u : e->adv_w;
+    dsc_out->adv_w = (uint16_t)((adv_w + 8) >> 4);
+    dsc_out->box_w = is_tab ? e->box_w * 2 : e->box_w;
+    dsc_out->box_h = e->box_h;
+    dsc_out->ofs_x = e->ofs_x;
+    dsc_out->ofs_y = e->ofs_y;
+    dsc_out->bpp = f->bpp;
+    dsc_out->is_placeholder = false;
+    return true;
+}
+
+static const uint8_t *font_get_glyph_bitmap(const lv_font_t *font, uint32_t letter) {
+    ui_font_t *f = (ui_font_t *)font->dsc;
+    if (letter == '\t') letter = ' ';
+    const glyph_entry_t *e = glyph_get(f, letter, false);
+    return e ? e->bitmap : NULL;
+}
+
+// === 打开字体 ===
+static bool read_table(const ui_font_src_t *src, uint32_t offset, const char *label, uint32_t *len) {
+    uint8_t hdr[8];
+    if (!src->read(src->ctx, offset, hdr, sizeof(hdr))) return false;
+    *len = rd32(hdr);
+    return memcmp(hdr + 4, label, 4) == 0 && *len >= sizeof(hdr);
+}
+
+// 子表数据的字节数，格式未知时返回 UINT32_MAX
+static uint32_t cmap_data_size(const ui_font_cmap_t *c) {
+    switch (c->type) {
+    case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL: return c->count;
+    case LV_FONT_FMT_TXT_CMAP_SPARSE_FULL: return c->count * 4u;
+    case LV_FONT_FMT_TXT_CMAP_SPARSE_TINY: return c->count * 2u;
+    case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY: return 0;
+    default: return UINT32_MAX;
+    }
+}
+
+static bool load_cmaps(ui_font_t *f, uint32_t cmap_start) {
+    const ui_font_src_t *src = &f->src;
+    uint8_t buf[16];
+    if (!src->read(src->ctx, cmap_start + 8, buf, 4)) return false;
+    f->cmap_count = rd32(buf);
+    if (f->cmap_count == 0 || f->cmap_count > FONT_CMAP_MAX) return false;
+    f->cmaps = lv_mem_alloc(f->cmap_count * sizeof(ui_font_cmap_t));
+    if (!f->cmaps) return false;
+
+    uint32_t total = 0;
+    for (uint32_t k = 0; k < f->cmap_count; k++) {
+        if (!src->read(src->ctx, cmap_start + 12 + k * 16, buf, 16)) return false;
+        ui_font_cmap_t *c = &f->cmaps[k];
+        c->range_start = rd32(buf + 4);
+        c->range_length = (uint16_t)rd16(buf + 8);
+        c->glyph_id_start = (uint16_t)rd16(buf + 10);
+        c->count = (uint16_t)rd16(buf + 12);
+        c->type = buf[14];
+        const uint32_t size = cmap_data_size(c);
+        if (size == UINT32_MAX) return false;
+        total += (size + 1u) & ~1u;
+    }
+    f->cmap_data = total ? lv_mem_alloc(total) : NULL;
+    if (total && !f->cmap_data) return false;
+
+    // 第二遍读入各子表的码点 / 偏移列表，子表描述再读一次取数据位置，不占用额外内存
+    uint8_t *data = f->cmap_data;
+    for (uint32_t k = 0; k < f->cmap_count; k++) {
+        ui_font_cmap_t *c = &f->cmaps[k];
+        const uint32_t size = cmap_data_size(c);
+        c->data = data;
+        if (!size) continue;
+        if (!src->read(src->ctx, cmap_start + 12 + k * 16, buf, 4) ||
+            !src->read(src->ctx, cmap_start + rd32(buf), data, size)) {
+            return false;
+        }
+        data += (size + 1u) & ~1u;
+    }
+    return true;
+}
+
+void ui_font_close(ui_font_t *font) {
+    for (int16_t i = 0; i < g_hot.count + g_lru.count; i++) {
+        glyph_entry_t *e = entry_at(i);
+        if (e->key && (e->key >> 24) == font->id) release_slot(tier_of(i), i);
+    }
+    if (g_big.key >> 24 == font->id) g_big.key = 0;
+    lv_mem_free(font->loca);
+    lv_mem_free(font->cmaps);
+    lv_mem_free(font->cmap_data);
+    font->loca = NULL;
+    font->cmaps = NULL;
+    font->cmap_data = NULL;
+    font->glyph_count = 0;
+    font->cmap_count = 0;
+}
+
+bool ui_font_open(ui_font_t *font, const ui_font_src_t *src, const lv_font_t *fallback) {
+    memset(font, 0, sizeof(*font));
+    font->src = *src;
+    if (g_next_font_id == 0) {
+        ESP_LOGE(TAG, "too many fonts opened");
+        return false;
+    }
+
+    uint32_t head_len;
+    uint8_t head[FONT_HEAD_SIZE];
+    if (!read_table(src, 0, "head", &head_len) || head_len < 8 + FONT_HEAD_SIZE ||
+        !src->read(src->ctx, 8, head, sizeof(head))) {
+        ESP_LOGW(TAG, "no font found");
+        return false;
+    }
+    const uint8_t loca_format = head[26];
+    const uint8_t bpp = head[29];
+    const uint8_t compression = head[33];
+    const uint8_t subpx = head[34];
+    if (compression != 0 || subpx != 0 || loca_format > 1 || (bpp != 1 && bpp != 2 && bpp != 4 && bpp != 8)) {
+        ESP_LOGE(TAG, "unsupported font: bpp %u, compression %u, subpixel %u (use lv_font_conv --no-compress)",
+                 bpp, compression, subpx);
+        return false;
+    }
+    font->adv_frac = head[28] != 0;
+    font->bpp = bpp;
+    font->xy_bits = head[30];
+    font->wh_bits = head[31];
+    font->adv_bits = head[32];
+    font->default_adv = (uint16_t)rd16(head + 22);
+    font->loca32 = loca_format == 1;
+
+    uint32_t cmap_len, loca_len;
+    const uint32_t cmap_start = head_len;
+    if (!read_table(src, cmap_start, "cmap", &cmap_len) || !load_cmaps(font, cmap_start)) {
+        ESP_LOGE(TAG, "bad cmap table");
+        ui_font_close(font);
+        return false;
+    }
+    const uint32_t loca_start = cmap_start + cmap_len;
+    uint8_t buf[4];
+    if (!read_table(src, loca_start, "loca", &loca_len) || !src->read(src->ctx, loca_start + 8, buf, 4)) {
+        ESP_LOGE(TAG, "bad loca table");
+        ui_font_close(font);
+        return false;
+    }
+    font->glyph_count = rd32(buf);
+    const uint32_t loca_size = font->glyph_count * (font->loca32 ? 4 : 2);
+    font->loca = loca_size && font->glyph_count <= 0x10000 ? lv_mem_alloc(loca_size) : NULL;
+    if (!font->loca || !src->read(src->ctx, loca_start + 12, font->loca, loca_size)) {
+        ESP_LOGE(TAG, "cannot load %u glyph offsets", (unsigned)font->glyph_count);
+        ui_font_close(font);
+        return false;
+    }
+    font->glyf_start = loca_start + loca_len;
+    if (!read_table(src, font->glyf_start, "glyf", &font->glyf_size)) {
+        ESP_LOGE(TAG, "bad glyf table");
+        ui_font_close(font);
+        return false;
+    }
+
+    font->id = g_next_font_id++;
+    lv_font_t *lf = &font->font;
+    lf->get_glyph_dsc = font_get_glyph_dsc;
+    lf->get_glyph_bitmap = font_get_glyph_bitmap;
+    lf->line_height = (lv_coord_t)((int16_t)rd16(head + 8) - (int16_t)rd16(head + 10));
+    lf->base_line = (lv_coord_t)-(int16_t)rd16(head + 10);
+    lf->subpx = LV_FONT_SUBPX_NONE;
+    lf->underline_position = (int8_t)(int16_t)rd16(head + 36);
+    lf->underline_thickness = (int8_t)rd16(head + 38);
+    lf->dsc = font;
+    lf->fallback = fallback;
+    ESP_LOGI(TAG, "font %u: %u px, %u bpp, %u glyphs, %u cmap ranges", font->id, (unsigned)rd16(head + 6), bpp,
+             (unsigned)font->glyph_count, (unsigned)font->cmap_count);
+    return true;
+}
@@ -0,0 +1,97 @@
+// ui_font.h
+// 按需加载的字体：读取 lv_font_conv 生成的二进制字体（--format bin --no-compress）。
+// 只有字符映射（cmap）和字形偏移表（loca）常驻内存，字形在第一次用到时从字体分区或文件读入两级缓存：
+//   未命中 -> LRU 层（PSRAM，容量大）--命中 UI_FONT_PROMOTE_HITS 次--> 热点层（内部 RAM，容量小）
+// 热点层满时把最久未用的字形换回 LRU 层。数据来源由调用方的 read 回调提供，与硬件无关。
+// 以下函数仅在 LVGL 任务中调用。
+#ifndef UI_FONT_H
+#define UI_FONT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl.h"
+#include "perf_hist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UI_FONT_PROMOTE_HITS 3      // 在 LRU 层命中的次数达到该值后提升到热点层
+
+typedef struct {
+    // 从字体数据的 offset 处读取 len 字节，成功返回 true
+    bool (*read)(void *ctx, uint32_t offset, void *buf, uint32_t len);
+    void *ctx;
+} ui_font_src_t;
+
+typedef struct {
+    void *hot_mem;                  // 热点层（字形描述和位图），放在内部 RAM
+    size_t hot_size;
+    void *lru_mem;                  // LRU 层，放在 PSRAM
+    size_t lru_size;
+    uint16_t slot_bytes;            // 每个字形位图槽的字节数，位图更大的字形每次直接读取、不缓存
+    perf_hist_t *fetch_hist;        // 可选，记录每次读取字形的耗时（us）
+} ui_font_cache_config_t;
+
+typedef struct {
+    uint32_t lookups;               // 查询字形描述的次数（排版和绘制）
+    uint32_t hot_hits;
+    uint32_t lru_hits;
+    uint32_t misses;                // 从来源读取的次数，含不缓存的大字形
+    uint32_t promotions;            // LRU 层 -> 热点层
+    uint32_t evictions;             // 被挤出 LRU 层的字形
+    uint32_t uncached;              // 位图超过 slot_bytes 的读取
+    uint32_t read_errors;
+    uint32_t fetch_us_max;
+    uint64_t fetch_us_total;
+    uint16_t hot_slots;
+    uint16_t hot_used;
+    uint16_t lru_slots;
+    uint16_t lru_used;
+} ui_font_cache_stats_t;
+
+typedef struct {
+    uint32_t range_start;
+    uint16_t range_length;
+    uint16_t glyph_id_start;
+    uint16_t count;
+    uint8_t type;                   // lv_font_fmt_txt_cmap_type_t
+    const void *data;               // FORMAT0_FULL：uint8 偏移；SPARSE：uint16 码点列表，FULL 时后接 uint16 偏移
+} ui_font_cmap_t;
+
+typedef struct {
+    lv_font_t font;                 // 交给 LVGL 使用，font.dsc 指回本结构
+    ui_font_src_t src;
+    uint8_t id;                     // 缓存键的高 8 位
+    uint8_t bpp;
+    uint8_t xy_bits;
+    uint8_t wh_bits;
+    uint8_t adv_bits;
+    bool adv_frac;                  // 字形里的步进宽度已是 1/16 像素
+    uint16_t default_adv;
+    bool loca32;
+    uint32_t glyph_count;
+    uint32_t glyf_start;
+    uint32_t glyf_size;
+    void *loca;                     // uint16 或 uint32 偏移，相对 glyf 表
+    ui_font_cmap_t *cmaps;
+    uint32_t cmap_count;
+    void *cmap_data;
+} ui_font_t;
+
+// 划分两层缓存；可重复调用以更换内存，已缓存的字形全部丢弃
+bool ui_font_cache_init(const ui_font_cache_config_t *cfg);
+void ui_font_cache_get_stats(ui_font_cache_stats_t *stats);
+
+// 读入字体头、字符映射和偏移表，成功后 &font->font 可直接用作 LVGL 字体；
+// fallback 用于本字体没有的字符（例如拉丁字母继续使用内置字体），可为 NULL
+bool ui_font_open(ui_font_t *font, const ui_font_src_t *src, const lv_font_t *fallback);
+// 释放索引并丢弃该字体的缓存字形，调用前确保没有对象还在使用它
+void ui_font_close(ui_font_t *font);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_FONT_H
@@ -0,0 +1,256 @@
+// ui_gesture.c
+// 状态机：
+//   IDLE --按下--> ONE --移动超过 slop--> DRAG --松开且够快够远--> SWIPE
+//                  ONE --按住超过 long_press_ms--> LONG（等待松开）
+//                  ONE --松开且不超过 tap_max_ms--> TAP
+//   任意单指状态 --第二指按下--> TWO --间距变化--> PINCH / --中点移动--> PAN
+//   双指手势中抬起一指即结束（END），之后直到全部松开都不再识别新手势。
+#include "ui_gesture.h"
+#include <stddef.h>
+
+enum {
+    GESTURE_IDLE,
+    GESTURE_ONE,        // 单指按下，尚未移动
+    GESTURE_DRAG,       // 单指移动中，松开时判定是否为滑动
+    GESTURE_LONG,       // 已触发长按，等待松开
+    GESTURE_TWO,        // 双指按下，尚未判定
+    GESTURE_PINCH,
+    GESTURE_PAN,
+    GESTURE_DONE,       // 本次触摸已消费，等待全部松开
+};
+
+#define GESTURE_VELOCITY_WINDOW_MS 80   // 松手前超过该时间没有移动则速度视为 0
+
+void ui_gesture_config_default(ui_gesture_config_t *cfg) {
+    cfg->tap_max_ms = 300;
+    cfg->long_press_ms = 600;
+    cfg->slop_px = 12;
+    cfg->swipe_min_px = 60;
+    cfg->swipe_min_speed = 400;
+    cfg->pinch_min_px = 24;
+}
+
+void ui_gesture_init(ui_gesture_t *g, const ui_gesture_config_t *cfg, ui_gesture_cb_t cb, void *user_data) {
+    *g = (ui_gesture_t){0};
+    if (cfg) {
+        g->cfg = *cfg;
+    } else {
+        ui_gesture_config_default(&g->cfg);
+    }
+    g->cb = cb;
+    g->user_data = user_data;
+    g->state = GESTURE_IDLE;
+}
+
+// 32 位整数平方根，固定 16 次迭代
+static uint32_t isqrt32(uint32_t v) {
+    uint32_t res = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+
+static uint32_t dist2(ui_gesture_point_t a, ui_gesture_point_t b) {
+    int32_t dx = a.x - b.x;
+    int32_t dy = a.y - b.y;
+    return (uint32_t)(dx * dx + dy * dy);
+}
+
+static bool moved_beyond(ui_gesture_point_t a, ui_gesture_point_t b, uint32_t px) {
+    return dist2(a, b) > px * px;
+}
+
+static void emit(ui_gesture_t *g, ui_gesture_type_t type, ui_gesture_phase_t phase, uint32_t time_ms) {
+    ui_gesture_event_t ev = {
+        .type = type,
+        .phase = phase,
+        .time_ms = time_ms,
+        .x = g->last.x,
+        .y = g->last.y,
+        .start_x = g->start.x,
+        .start_y = g->start.y,
+        .vx = g->vx,
+        .vy = g->vy,
+        .scale = 256,
+        .dir = UI_GESTURE_DIR_NONE,
+    };
+    if (type == UI_GESTURE_PAN) {
+        ev.dx = g->last.x - g->reported.x;
+        ev.dy = g->last.y - g->reported.y;
+        g->reported = g->last;
+    } else if (type == UI_GESTURE_SWIPE) {
+        ev.dx = g->last.x - g->start.x;
+        ev.dy = g->last.y - g->start.y;
+        int32_t ax = ev.dx < 0 ? -ev.dx : ev.dx;
+        int32_t ay = ev.dy < 0 ? -ev.dy : ev.dy;
+        if (ax >= ay) {
+            ev.dir = ev.dx < 0 ? UI_GESTURE_DIR_LEFT : UI_GESTURE_DIR_RIGHT;
+        } else {
+            ev.dir = ev.dy < 0 ? UI_GESTURE_DIR_UP : UI_GESTURE_DIR_DOWN;
+        }
+    } else if (type == UI_GESTURE_PINCH && g->start_dist) {
+        uint32_t scale = (g->dist << 8) / g->start_dist;
+        ev.scale = scale > UINT16_MAX ? UINT16_MAX : (uint16_t)scale;
+    }
+    g->stats.events++;
+    if (g->cb) g->cb(&ev, g->user_data);
+}
+
+// 速度取相邻样本瞬时速度的指数平均（权重 1/2），dt 为 0 的样本不参与
+static void track_velocity(ui_gesture_t *g, ui_gesture_point_t pos, uint32_t time_ms) {
+    uint32_t dt = time_ms - g->last_ms;
+    if (dt == 0) return;
+    int32_t vx = (int32_t)(pos.x - g->last.x) * 1000 / (int32_t)dt;
+    int32_t vy = (int32_t)(pos.y - g->last.y) * 1000 / (int32_t)dt;
+    g->vx = (g->vx + vx) / 2;
+    g->vy = (g->vy + vy) / 2;
+}
+
+static void begin_touch(ui_gesture_t *g, uint8_t state, ui_gesture_point_t pos, uint32_t time_ms) {
+    g->state = state;
+    g->start = pos;
+    g->last = pos;
+    g->reported = pos;
+    g->start_ms = time_ms;
+    g->last_ms = time_ms;
+    g->vx = 0;
+    g->vy = 0;
+}
+
+static void release(ui_gesture_t *g, uint32_t time_ms) {
+    if (time_ms - g->last_ms > GESTURE_VELOCITY_WINDOW_MS) {
+        g->vx = 0;
+        g->vy = 0;
+    }
+    switch (g->state) {
+    case GESTURE_ONE:
+        if (time_ms - g->start_ms <= g->cfg.tap_max_ms) emit(g, UI_GESTURE_TAP, UI_GESTURE_END, time_ms);
+        break;
+    case GESTURE_DRAG: {
+        uint32_t speed2 = (uint32_t)(g->vx * g->vx + g->vy * g->vy);
+        uint32_t min_speed = g->cfg.swipe_min_speed;
+        if (moved_beyond(g->start, g->last, g->cfg.swipe_min_px) && speed2 >= min_speed * min_speed) {
+            emit(g, UI_GESTURE_SWIPE, UI_GESTURE_END, time_ms);
+        }
+        break;
+    }
+    case GESTURE_PINCH:
+        emit(g, UI_GESTURE_PINCH, UI_GESTURE_END, time_ms);
+        break;
+    case GESTURE_PAN:
+        emit(g, UI_GESTURE_PAN, UI_GESTURE_END, time_ms);
+        break;
+    default:
+        break;
+    }
+    g->state = GESTURE_IDLE;
+    g->fingers = 0;
+}
+
+static void check_long_press(ui_gesture_t *g, uint32_t now_ms) {
+    if (g->state == GESTURE_ONE && now_ms - g->start_ms >= g->cfg.long_press_ms) {
+        g->state = GESTURE_LONG;
+        emit(g, UI_GESTURE_LONG_PRESS, UI_GESTURE_END, now_ms);
+    }
+}
+
+void ui_gesture_feed(ui_gesture_t *g, const ui_gesture_input_t *in) {
+    g->stats.samples++;
+    const uint8_t n = in->count > UI_GESTURE_MAX_POINTS ? UI_GESTURE_MAX_POINTS : in->count;
+    const uint32_t t = in->time_ms;
+    if (n == 0) {
+        if (g->state != GESTURE_IDLE) release(g, t);
+        return;
+    }
+
+    // 单指取触点，双指及以上取前两指的中点
+    ui_gesture_point_t pos = in->points[0];
+    uint32_t dist = 0;
+    if (n >= 2) {
+        pos.x = (int16_t)((in->points[0].x + in->points[1].x) / 2);
+        pos.y = (int16_t)((in->points[0].y + in->points[1].y) / 2);
+        dist = isqrt32(dist2(in->points[0], in->points[1]));
+    }
+
+    if (g->state == GESTURE_IDLE) {
+        begin_touch(g, n >= 2 ? GESTURE_TWO : GESTURE_ONE, pos, t);
+        g->start_dist = g->dist = dist;
+    } else if (n >= 2 && g->fingers < 2) {
+        // 第二指落下：单指阶段的点击 / 滑动作废，改为识别双指手势
+        if (g->state == GESTURE_DONE) {
+            g->fingers = n;
+            return;
+        }
+        begin_touch(g, GESTURE_TWO, pos, t);
+        g->start_dist = g->dist = dist;
+    } else if (n < 2 && g->fingers >= 2) {
+        // 抬起一指：结束双指手势，剩下的一指不再产生手势
+        if (g->state == GESTURE_PINCH || g->state == GESTURE_PAN) {
+            emit(g, g->state == GESTURE_PINCH ? UI_GESTURE_PINCH : UI_GESTURE_PAN, UI_GESTURE_END, t);
+        }
+        g->state = GESTURE_DONE;
+    } else {
+        track_velocity(g, pos, t);
+        g->last = pos;
+        g->last_ms = t;
+        g->dist = dist;
+        switch (g->state) {
+        case GESTURE_ONE:
+            if (moved_beyond(g->start, pos, g->cfg.slop_px)) {
+                g->state = GESTURE_DRAG;
+            } else {
+                check_long_press(g, t);
+            }
+            break;
+        case GESTURE_TWO: {
+            int32_t change = (int32_t)dist - (int32_t)g->start_dist;
+            if (change > g->cfg.pinch_min_px || -change > g->cfg.pinch_min_px) {
+                g->state = GESTURE_PINCH;
+                emit(g, UI_GESTURE_PINCH, UI_GESTURE_BEGIN, t);
+            } else if (moved_beyond(g->start, pos, g->cfg.slop_px)) {
+                g->state = GESTURE_PAN;
+                g->reported = g->start;
+                emit(g, UI_GESTURE_PAN, UI_GESTURE_BEGIN, t);
+            }
+            break;
+        }
+        case GESTURE_PINCH:
+            emit(g, UI_GESTURE_PINCH, UI_GESTURE_UPDATE, t);
+            break;
+        case GESTURE_PAN:
+            if (pos.x != g->reported.x || pos.y != g->reported.y) emit(g, UI_GESTURE_PAN, UI_GESTURE_UPDATE, t);
+            break;
+        default:
+            break;
+        }
+    }
+    g->fingers = n;
+}
+
+void ui_gesture_tick(ui_gesture_t *g, uint32_t now_ms) {
+    check_long_press(g, now_ms);
+}
+
+void ui_gesture_get_stats(const ui_gesture_t *g, ui_gesture_stats_t *stats) {
+    if (stats) *stats = g->stats;
+}
+
+const char *ui_gesture_type_name(ui_gesture_type_t type) {
+    switch (type) {
+    case UI_GESTURE_TAP: return "tap";
+    case UI_GESTURE_LONG_PRESS: return "long_press";
+    case UI_GESTURE_SWIPE: return "swipe";
+    case UI_GESTURE_PINCH: return "pinch";
+    case UI_GESTURE_PAN: return "pan";
+    }
+    return "?";
+}
@@ -0,0 +1,109 @@
+// ui_gesture.h
+// 手势识别：点击、长按、滑动、双指捏合、双指平移。
+// 与 LVGL 和硬件无关，输入是带时间戳的多点触摸样本，便于在主机上回放触摸轨迹。
+#ifndef UI_GESTURE_H
+#define UI_GESTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UI_GESTURE_MAX_POINTS 5     // GT911 最多上报 5 个触点
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+} ui_gesture_point_t;
+
+typedef struct {
+    uint32_t time_ms;
+    uint8_t count;                  // 触点数，0 表示全部松开
+    ui_gesture_point_t points[UI_GESTURE_MAX_POINTS];
+} ui_gesture_input_t;
+
+typedef enum {
+    UI_GESTURE_TAP,
+    UI_GESTURE_LONG_PRESS,
+    UI_GESTURE_SWIPE,
+    UI_GESTURE_PINCH,
+    UI_GESTURE_PAN,                 // 双指平移
+} ui_gesture_type_t;
+
+typedef enum {
+    UI_GESTURE_BEGIN,
+    UI_GESTURE_UPDATE,
+    UI_GESTURE_END,                 // 点击 / 长按 / 滑动只有 END
+} ui_gesture_phase_t;
+
+typedef enum {
+    UI_GESTURE_DIR_NONE,
+    UI_GESTURE_DIR_LEFT,
+    UI_GESTURE_DIR_RIGHT,
+    UI_GESTURE_DIR_UP,
+    UI_GESTURE_DIR_DOWN,
+} ui_gesture_dir_t;
+
+typedef struct {
+    ui_gesture_type_t type;
+    ui_gesture_phase_t phase;
+    uint32_t time_ms;
+    int16_t x, y;                   // 当前位置，双指手势为两指中点
+    int16_t start_x, start_y;       // 手势起点
+    int16_t dx, dy;                 // PAN：与上一事件的位移；SWIPE：总位移
+    int32_t vx, vy;                 // 速度（px/s）
+    uint16_t scale;                 // PINCH：两指间距相对开始时的比例，256 = 1.0
+    ui_gesture_dir_t dir;           // SWIPE 的主方向
+} ui_gesture_event_t;
+
+typedef struct {
+    uint16_t tap_max_ms;            // 按下到松开不超过该时间才算点击
+    uint16_t long_press_ms;         // 按住不动超过该时间触发长按
+    uint16_t slop_px;               // 移动超过该距离不再算点击 / 长按，双指超过则开始平移
+    uint16_t swipe_min_px;          // 滑动的最小距离
+    uint16_t swipe_min_speed;       // 滑动松手时的最小速度（px/s）
+    uint16_t pinch_min_px;          // 两指间距变化超过该值判定为捏合
+} ui_gesture_config_t;
+
+typedef struct {
+    uint32_t samples;               // 送入的样本数
+    uint32_t events;                // 产生的手势事件数
+} ui_gesture_stats_t;
+
+typedef void (*ui_gesture_cb_t)(const ui_gesture_event_t *event, void *user_data);
+
+// 引擎状态，调用方静态分配；每个样本的处理量与触点数无关（只用前两个触点），不分配内存
+typedef struct {
+    ui_gesture_config_t cfg;
+    ui_gesture_cb_t cb;
+    void *user_data;
+    uint8_t state;
+    uint8_t fingers;                // 上一个样本的触点数
+    uint32_t start_ms;
+    uint32_t last_ms;
+    ui_gesture_point_t start;       // 单指为触点，双指为两指中点
+    ui_gesture_point_t last;
+    ui_gesture_point_t reported;    // PAN 上一次上报的位置
+    int32_t vx, vy;                 // 平滑后的速度（px/s）
+    uint32_t start_dist;            // 双指开始时的间距
+    uint32_t dist;                  // 当前双指间距
+    ui_gesture_stats_t stats;
+} ui_gesture_t;
+
+void ui_gesture_config_default(ui_gesture_config_t *cfg);
+// cfg 为 NULL 时使用默认参数
+void ui_gesture_init(ui_gesture_t *g, const ui_gesture_config_t *cfg, ui_gesture_cb_t cb, void *user_data);
+// 送入一个样本，识别出的手势通过回调同步发出
+void ui_gesture_feed(ui_gesture_t *g, const ui_gesture_input_t *in);
+// 没有新样本时周期调用，用于按住不动时触发长按
+void ui_gesture_tick(ui_gesture_t *g, uint32_t now_ms);
+void ui_gesture_get_stats(const ui_gesture_t *g, ui_gesture_stats_t *stats);
+const char *ui_gesture_type_name(ui_gesture_type_t type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_GESTURE_H
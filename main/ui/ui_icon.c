@@ -0,0 +1,287 @@
+// ui_icon.c
+// 图集格式（sim/scripts/iconpack.py 生成），多字节字段均为小端：
+//   头（16 字节）：'U' 'I' 'C' 'N'、版本 u16（1）、页数 u16、图标数 u16、保留 6 字节
+//   页表：每页 8 字节：像素数据偏移 u32（相对图集开头）、宽 u16、高 u16
+//   图标表：每个 28 字节：名字 char[16]（不足补 '\0'）、页 u16、x u16、y u16、宽 u16、高 u16、保留 u16
+//   像素数据：每页 RGB565 平面（宽 x 高 x 2 字节）后接 A8 平面（宽 x 高 字节）
+#include "ui_icon.h"
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "ui_icon";
+
+#define ICON_HEAD_SIZE      16
+#define ICON_PAGE_SIZE      8
+#define ICON_ENTRY_SIZE     28
+#define ICON_VERSION        1
+#define ICON_PAGE_MAX       256     // 页数上限，防止读到损坏的数据
+#define ICON_COUNT_MAX      4096
+#define ICON_PAGE_DIM_MAX   2048
+#define ICON_STAGE_PX       256     // 解码时每次读入的像素数
+
+_Static_assert(LV_IMG_PX_SIZE_ALPHA_BYTE == 3, "ui_icon 只支持 16 位颜色");
+
+typedef struct {
+    lv_img_dsc_t dsc;           // data 为 NULL 表示未解码；结构本身在图集关闭前一直有效，隐藏的 lv_img 可以继续指向它
+    uint32_t offset;
+    uint16_t refs;              // 正在显示的图标数
+    int16_t prev;               // 已解码页的使用顺序链表，表头为最近使用
+    int16_t next;
+} icon_page_t;
+
+typedef struct {
+    char name[UI_ICON_NAME_MAX];
+    uint16_t page;
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+} icon_entry_t;
+
+static ui_icon_src_t g_src;
+static ui_icon_cache_config_t g_cfg;
+static icon_page_t *g_pages;
+static icon_entry_t *g_icons;
+static uint16_t g_page_count;
+static uint16_t g_icon_count;
+static int16_t g_head = -1;
+static int16_t g_tail = -1;
+static ui_icon_cache_stats_t g_stats;
+static uint8_t g_stage[ICON_STAGE_PX * 3];
+
+static uint32_t rd16(const uint8_t *p) {
+    return p[0] | (uint32_t)p[1] << 8;
+}
+
+static uint32_t rd32(const uint8_t *p) {
+    return rd16(p) | rd16(p + 2) << 16;
+}
+
+static uint32_t page_bytes(const icon_page_t *pg) {
+    return (uint32_t)pg->dsc.header.w * pg->dsc.header.h * LV_IMG_PX_SIZE_ALPHA_BYTE;
+}
+
+// === 使用顺序链表 ===
+static void list_unlink(int16_t i) {
+    icon_page_t *pg = &g_pages[i];
+    if (pg->prev >= 0) g_pages[pg->prev].next = pg->next;
+    else g_head = pg->next;
+    if (pg->next >= 0) g_pages[pg->next].prev = pg->prev;
+    else g_tail = pg->prev;
+}
+
+static void list_push_head(int16_t i) {
+    icon_page_t *pg = &g_pages[i];
+    pg->prev = -1;
+    pg->next = g_head;
+    if (g_head >= 0) g_pages[g_head].prev = i;
+    else g_tail = i;
+    g_head = i;
+}
+
+static void page_drop(int16_t i) {
+    icon_page_t *pg = &g_pages[i];
+    list_unlink(i);
+    g_cfg.free((void *)pg->dsc.data);
+    pg->dsc.data = NULL;
+    g_stats.bytes_used -= page_bytes(pg);
+    g_stats.pages_decoded--;
+}
+
+// 从表尾往前丢弃第一个没有图标在用的页，没有可丢的页时返回 false
+static bool evict_one(void) {
+    for (int16_t i = g_tail; i >= 0; i = g_pages[i].prev) {
+        if (g_pages[i].refs == 0) {
+            page_drop(i);
+            g_stats.evictions++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// === 解码 ===
+// RGB565 平面和 A8 平面分块读入暂存区，交错成 LV_IMG_CF_TRUE_COLOR_ALPHA（颜色按 lv_color_t 的字节序，后接 alpha）
+static bool page_decode(icon_page_t *pg) {
+    const uint32_t px = (uint32_t)pg->dsc.header.w * pg->dsc.header.h;
+    const uint32_t size = page_bytes(pg);
+    while (g_stats.bytes_used + size > g_cfg.budget && evict_one()) {}
+    if (g_stats.bytes_used + size > g_cfg.budget) return false;
+    uint8_t *data = g_cfg.alloc ? g_cfg.alloc(size) : NULL;
+    if (!data) return false;
+
+    const int64_t start_us = esp_timer_get_time();
+    uint8_t *out = data;
+    for (uint32_t i = 0; i < px; i += ICON_STAGE_PX) {
+        const uint32_t n = px - i < ICON_STAGE_PX ? px - i : ICON_STAGE_PX;
+        uint8_t *rgb = g_stage;
+        uint8_t *alpha = g_stage + n * 2;
+        if (!g_src.read(g_src.ctx, pg->offset + i * 2, rgb, n * 2) ||
+            !g_src.read(g_src.ctx, pg->offset + px * 2 + i, alpha, n)) {
+            g_cfg.free(data);
+            return false;
+        }
+        for (uint32_t k = 0; k < n; k++) {
+#if LV_COLOR_16_SWAP
+            *out++ = rgb[k * 2 + 1];
+            *out++ = rgb[k * 2];
+#else
+            *out++ = rgb[k * 2];
+            *out++ = rgb[k * 2 + 1];
+#endif
+            *out++ = alpha[k];
+        }
+    }
+    const uint32_t us = (uint32_t)(esp_timer_get_time() - start_us);
+    g_stats.decode_us_total += us;
+    if (us > g_stats.decode_us_max) g_stats.decode_us_max = us;
+    if (g_cfg.decode_hist) perf_hist_add(g_cfg.decode_hist, us);
+
+    pg->dsc.data = data;
+    pg->dsc.data_size = size;
+    g_stats.bytes_used += size;
+    g_stats.pages_decoded++;
+    list_push_head((int16_t)(pg - g_pages));
+    return true;
+}
+
+// === 查找与引用 ===
+int ui_icon_find(const char *name) {
+    if (!name) return -1;
+    for (int i = 0; i < g_icon_count; i++) {
+        if (!strncmp(g_icons[i].name, name, UI_ICON_NAME_MAX)) return i;
+    }
+    return -1;
+}
+
+bool ui_icon_acquire(int id, ui_icon_ref_t *ref) {
+    if (id < 0 || id >= g_icon_count) return false;
+    const icon_entry_t *icon = &g_icons[id];
+    icon_page_t *pg = &g_pages[icon->page];
+    const int16_t page = (int16_t)icon->page;
+    g_stats.lookups++;
+    if (pg->dsc.data) {
+        g_stats.hits++;
+        list_unlink(page);
+        list_push_head(page);
+    } else {
+        g_stats.misses++;
+        if (!page_decode(pg)) {
+            g_stats.failures++;
+            ESP_LOGW(TAG, "cannot decode page %d (%u bytes, %u/%u used) for icon \"%s\"", page,
+                     (unsigned)page_bytes(pg), (unsigned)g_stats.bytes_used, (unsigned)g_cfg.budget, icon->name);
+            return false;
+        }
+    }
+    pg->refs++;
+    *ref = (ui_icon_ref_t){
+        .sheet = &pg->dsc,
+        .x = icon->x,
+        .y = icon->y,
+        .w = icon->w,
+        .h = icon->h,
+    };
+    return true;
+}
+
+void ui_icon_release(int id) {
+    if (id < 0 || id >= g_icon_count) return;
+    icon_page_t *pg = &g_pages[g_icons[id].page];
+    if (pg->refs > 0) pg->refs--;
+}
+
+void ui_icon_get_stats(ui_icon_cache_stats_t *stats) {
+    *stats = g_stats;
+    stats->budget = (uint32_t)g_cfg.budget;
+    stats->icons = g_icon_count;
+    stats->pages = g_page_count;
+}
+
+// === 打开图集 ===
+void ui_icon_close(void) {
+    while (g_head >= 0) page_drop(g_head);
+    lv_mem_free(g_pages);
+    lv_mem_free(g_icons);
+    g_pages = NULL;
+    g_icons = NULL;
+    g_page_count = 0;
+    g_icon_count = 0;
+}
+
+bool ui_icon_is_open(void) {
+    return g_icon_count > 0;
+}
+
+static bool load_pages(void) {
+    uint8_t buf[ICON_PAGE_SIZE];
+    for (uint16_t i = 0; i < g_page_count; i++) {
+        if (!g_src.read(g_src.ctx, ICON_HEAD_SIZE + i * ICON_PAGE_SIZE, buf, sizeof(buf))) return false;
+        const uint32_t w = rd16(buf + 4);
+        const uint32_t h = rd16(buf + 6);
+        if (w == 0 || h == 0 || w > ICON_PAGE_DIM_MAX || h > ICON_PAGE_DIM_MAX) return false;
+        icon_page_t *pg = &g_pages[i];
+        *pg = (icon_page_t){ .offset = rd32(buf), .prev = -1, .next = -1 };
+        pg->dsc.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+        pg->dsc.header.w = w;
+        pg->dsc.header.h = h;
+    }
+    return true;
+}
+
+static bool load_icons(void) {
+    const uint32_t table = ICON_HEAD_SIZE + g_page_count * ICON_PAGE_SIZE;
+    uint8_t buf[ICON_ENTRY_SIZE];
+    for (uint16_t i = 0; i < g_icon_count; i++) {
+        if (!g_src.read(g_src.ctx, table + i * ICON_ENTRY_SIZE, buf, sizeof(buf))) return false;
+        icon_entry_t *icon = &g_icons[i];
+        memcpy(icon->name, buf, UI_ICON_NAME_MAX);
+        icon->name[UI_ICON_NAME_MAX - 1] = '\0';
+        icon->page = (uint16_t)rd16(buf + 16);
+        icon->x = (uint16_t)rd16(buf + 18);
+        icon->y = (uint16_t)rd16(buf + 20);
+        icon->w = (uint16_t)rd16(buf + 22);
+        icon->h = (uint16_t)rd16(buf + 24);
+        // 子矩形必须落在所在页内，lv_img 的偏移不会越界读
+        if (icon->page >= g_page_count || icon->w == 0 || icon->h == 0 ||
+            icon->x + icon->w > g_pages[icon->page].dsc.header.w ||
+            icon->y + icon->h > g_pages[icon->page].dsc.header.h) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ui_icon_open(const ui_icon_src_t *src, const ui_icon_cache_config_t *cfg) {
+    ui_icon_close();
+    g_src = *src;
+    g_cfg = *cfg;
+    if (!g_cfg.alloc || !g_cfg.free) g_cfg.budget = 0;
+
+    uint8_t head[ICON_HEAD_SIZE];
+    if (!src->read(src->ctx, 0, head, sizeof(head)) || memcmp(head, "UICN", 4) != 0) {
+        ESP_LOGW(TAG, "no icon atlas found");
+        return false;
+    }
+    const uint32_t version = rd16(head + 4);
+    const uint32_t pages = rd16(head + 6);
+    const uint32_t icons = rd16(head + 8);
+    if (version != ICON_VERSION || pages == 0 || pages > ICON_PAGE_MAX || icons == 0 || icons > ICON_COUNT_MAX) {
+        ESP_LOGE(TAG, "unsupported icon atlas: version %u, %u pages, %u icons", (unsigned)version, (unsigned)pages,
+                 (unsigned)icons);
+        return false;
+    }
+    g_pages = lv_mem_alloc(pages * sizeof(icon_page_t));
+    g_icons = lv_mem_alloc(icons * sizeof(icon_entry_t));
+    g_page_count = (uint16_t)pages;
+    g_icon_count = (uint16_t)icons;
+    if (!g_pages || !g_icons || !load_pages() || !load_icons()) {
+        ESP_LOGE(TAG, "bad icon atlas tables");
+        ui_icon_close();
+        return false;
+    }
+    ESP_LOGI(TAG, "icon atlas: %u icons on %u pages, decode budget %u KB", (unsigned)icons, (unsigned)pages,
+             (unsigned)(g_cfg.budget / 1024));
+    return true;
+}
@@ -0,0 +1,75 @@
+// ui_icon.h
+// 图标图集：sim/scripts/iconpack.py 把一组图标打包成若干页，每页是一张 RGB565A8 图（RGB565 平面后接 A8 平面），
+// 每个图标是某页内的一个子矩形。页在第一次用到时整页解码成 LVGL 可直接绘制的 LV_IMG_CF_TRUE_COLOR_ALPHA，
+// 放进按字节预算的 LRU 缓存（板上在 PSRAM）；图标以 lv_img 的偏移显示页内子矩形，同一页上的图标共用一块源缓冲。
+// 正在显示的页不会被挤出，预算不够时新页解码失败、图标不显示。数据来源由调用方的 read 回调提供，与硬件无关。
+// 以下函数仅在 LVGL 任务中调用。
+#ifndef UI_ICON_H
+#define UI_ICON_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl.h"
+#include "perf_hist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UI_ICON_NAME_MAX 16         // 图标名长度上限（含结尾 '\0'）
+
+typedef struct {
+    // 从图集数据的 offset 处读取 len 字节，成功返回 true
+    bool (*read)(void *ctx, uint32_t offset, void *buf, uint32_t len);
+    void *ctx;
+} ui_icon_src_t;
+
+typedef struct {
+    void *(*alloc)(size_t size);    // 解码后的页，板上分配在 PSRAM
+    void (*free)(void *ptr);
+    size_t budget;                  // 已解码页的总字节数上限（每像素 3 字节）
+    perf_hist_t *decode_hist;       // 可选，记录每次解码一页的耗时（us）
+} ui_icon_cache_config_t;
+
+typedef struct {
+    uint32_t lookups;               // ui_icon_acquire 次数
+    uint32_t hits;                  // 所在页已解码
+    uint32_t misses;                // 需要解码整页
+    uint32_t evictions;             // 为腾出预算被丢弃的页
+    uint32_t failures;              // 预算不足、分配或读取失败
+    uint32_t decode_us_max;
+    uint64_t decode_us_total;
+    uint32_t bytes_used;
+    uint32_t budget;
+    uint16_t icons;
+    uint16_t pages;
+    uint16_t pages_decoded;
+} ui_icon_cache_stats_t;
+
+typedef struct {
+    const lv_img_dsc_t *sheet;      // 已解码的整页，ui_icon_release 之前一直有效
+    uint16_t x;                     // 图标在页内的子矩形
+    uint16_t y;
+    uint16_t w;
+    uint16_t h;
+} ui_icon_ref_t;
+
+// 读入图集头、页表和图标表，已打开的图集先关闭；页在第一次 acquire 时才解码
+bool ui_icon_open(const ui_icon_src_t *src, const ui_icon_cache_config_t *cfg);
+// 释放全部已解码的页和索引，调用前确保没有对象还在显示图标
+void ui_icon_close(void);
+bool ui_icon_is_open(void);
+// 按名字查找图标，返回 id，没有时返回 -1
+int ui_icon_find(const char *name);
+// 取得图标并增加所在页的引用，页未解码时先解码；失败返回 false
+bool ui_icon_acquire(int id, ui_icon_ref_t *ref);
+// 与 ui_icon_acquire 成对调用；引用归零的页留在缓存中，预算不够时按最久未用的顺序丢弃
+void ui_icon_release(int id);
+void ui_icon_get_stats(ui_icon_cache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_ICON_H
@@ -0,0 +1,613 @@
+// ui_log.c
+// 日志视图：固定数量的行标签 + 日志历史存储区。
+// 追加一行只排版这一行，其余行对象只移动位置，不再重建整段文本。
+// 视图填满后每次上屏所有行都上移，整个日志区仍要重绘（与原 textarea 相同），省下的只是文本拼接和排版；
+// 两者的对比见 sim --log-view-bench。
+// 存储区里是未格式化的记录（时间 + 格式串 + 打包参数），只有要显示的行才格式化成文本，
+// 同一帧内被挤出屏幕的行从不格式化。
+#include "ui_log.h"
+#include "ui.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdalign.h>
+
+#include "esp_timer.h"
+
+// === 存储区：变长记录首尾相接写入数据区，写到末尾放不下时回到开头；索引按序号取模记录每行的偏移 ===
+typedef struct {
+    ui_log_rec_hdr_t hdr;
+    uint16_t len;                   // 参数字节数，参数紧跟在记录头后
+} store_rec_t;
+
+#define STORE_ALIGN alignof(store_rec_t)
+
+static void *g_store_fallback;     // 调用方没有提供存储区时才从堆上分配，之后一直复用
+static uint8_t *g_data;
+static uint32_t g_data_size;
+static uint32_t *g_index;
+static uint32_t g_index_mask;       // 索引条目数 - 1（2 的幂）
+static uint32_t g_data_head;        // 下一条记录的写入偏移
+static uint32_t g_data_used;
+static uint32_t g_log_first = 0;    // 最旧一行的序号
+static uint32_t g_log_head = 0;     // 下一行的序号
+static uint32_t g_log_pending = 0;  // 已写入存储区但尚未上屏的行数，最多排版 UI_LOG_MAX_LINES 行
+static uint32_t g_log_added = 0;    // 上次提交以来写入的行数，不封顶，翻看历史时用来保持画面
+
+// === 行对象池 ===
+static lv_obj_t *g_view;
+static lv_obj_t *g_rows[UI_LOG_MAX_LINES];
+static char g_row_text[UI_LOG_MAX_LINES][UI_LOG_LINE_MAX];  // 每个行对象自己的文本，标签直接引用
+static uint8_t g_row_style[UI_LOG_MAX_LINES];               // 行对象当前的级别样式和高亮，避免重复换样式
+static uint16_t g_row_count = 0;    // 可见行数
+static uint16_t g_row_top = 0;      // 位于最上方的行对象下标
+static uint16_t g_rows_used = 0;    // 已有内容的行数
+static lv_coord_t g_line_h = 1;
+static uint32_t g_scroll = 0;       // 向上翻看的行数，0 表示跟随最新日志
+static lv_coord_t g_scroll_px = 0;  // 不足一行的平移累计
+static uint32_t g_mark = 0;         // 搜索 / 跳转到的行的序号 + 1，0 表示无
+static lv_style_t g_style_error, g_style_warn, g_style_debug, g_style_mark;
+
+static void render_rows(void);
+static uint32_t max_scroll(void);
+
+static ui_log_stats_t g_stats;
+
+// === 参数打包 / 格式化 ===
+// 生产者和 LVGL 任务用同一个解析器走格式串，两边取参数的顺序和宽度一致
+typedef enum {
+    ARG_NONE,       // %%
+    ARG_SKIP,       // %n：生产者取走指针但不写入
+    ARG_INT,
+    ARG_LONG,
+    ARG_LLONG,
+    ARG_INTMAX,
+    ARG_SIZE,
+    ARG_PTRDIFF,
+    ARG_DOUBLE,
+    ARG_LDOUBLE,
+    ARG_PTR,
+    ARG_STR,
+} arg_kind_t;
+
+typedef struct {
+    const char *end;        // 转换字符之后
+    bool width_star;
+    bool prec_star;
+    int prec;               // 数字精度，-1 表示没有
+    arg_kind_t kind;
+} fmt_spec_t;
+
+// 解析从 '%' 开始的一个转换说明，不支持的（如 %ls）返回 false
+static bool parse_spec(const char *p, fmt_spec_t *spec) {
+    enum { LEN_NONE, LEN_L, LEN_LL, LEN_J, LEN_Z, LEN_T, LEN_LD } mod = LEN_NONE;
+    spec->width_star = spec->prec_star = false;
+    spec->prec = -1;
+    p++;
+    while (*p && strchr("-+ #0", *p)) p++;
+    if (*p == '*') {
+        spec->width_star = true;
+        p++;
+    } else {
+        while (*p >= '0' && *p <= '9') p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->prec_star = true;
+            p++;
+        } else {
+            spec->prec = 0;
+            while (*p >= '0' && *p <= '9') spec->prec = spec->prec * 10 + (*p++ - '0');
+        }
+    }
+    switch (*p) {
+        case 'h': p += p[1] == 'h' ? 2 : 1; break;      // 提升为 int
+        case 'l': if (p[1] == 'l') { mod = LEN_LL; p += 2; } else { mod = LEN_L; p++; } break;
+        case 'q': mod = LEN_LL; p++; break;
+        case 'j': mod = LEN_J; p++; break;
+        case 'z': mod = LEN_Z; p++; break;
+        case 't': mod = LEN_T; p++; break;
+        case 'L': mod = LEN_LD; p++; break;
+        default: break;
+    }
+    switch (*p) {
+        case '%':
+            spec->kind = ARG_NONE;
+            break;
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            spec->kind = mod == LEN_L ? ARG_LONG : mod == LEN_LL ? ARG_LLONG : mod == LEN_J ? ARG_INTMAX :
+                         mod == LEN_Z ? ARG_SIZE : mod == LEN_T ? ARG_PTRDIFF : ARG_INT;
+            break;
+        case 'c':
+            spec->kind = ARG_INT;       // wint_t 同样按 int 传递
+            break;
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+            spec->kind = mod == LEN_LD ? ARG_LDOUBLE : ARG_DOUBLE;
+            break;
+        case 's':
+            if (mod != LEN_NONE) return false;
+            spec->kind = ARG_STR;
+            break;
+        case 'p':
+            spec->kind = ARG_PTR;
+            break;
+        case 'n':
+            spec->kind = ARG_SKIP;
+            break;
+        default:
+            return false;
+    }
+    spec->end = p + 1;
+    return true;
+}
+
+// 放不下时丢弃这个及之后的全部参数
+#define PACK(type, value) do { \
+        type v_ = (value); \
+        if (pos + sizeof(v_) > cap) return pos; \
+        memcpy(out + pos, &v_, sizeof(v_)); \
+        pos += sizeof(v_); \
+    } while (0)
+
+size_t ui_log_pack_args(uint8_t *out, size_t cap, const char *fmt, va_list ap) {
+    size_t pos = 0;
+    fmt_spec_t spec;
+    for (const char *p = fmt; (p = strchr(p, '%')) != NULL; p = spec.end) {
+        if (!parse_spec(p, &spec)) break;
+        int prec = spec.prec;
+        if (spec.width_star) PACK(int, va_arg(ap, int));
+        if (spec.prec_star) {
+            prec = va_arg(ap, int);
+            PACK(int, prec);
+        }
+        switch (spec.kind) {
+            case ARG_NONE: break;
+            case ARG_SKIP: (void)va_arg(ap, void *); break;
+            case ARG_INT: PACK(int, va_arg(ap, int)); break;
+            case ARG_LONG: PACK(long, va_arg(ap, long)); break;
+            case ARG_LLONG: PACK(long long, va_arg(ap, long long)); break;
+            case ARG_INTMAX: PACK(intmax_t, va_arg(ap, intmax_t)); break;
+            case ARG_SIZE: PACK(size_t, va_arg(ap, size_t)); break;
+            case ARG_PTRDIFF: PACK(ptrdiff_t, va_arg(ap, ptrdiff_t)); break;
+            case ARG_DOUBLE: PACK(double, va_arg(ap, double)); break;
+            case ARG_LDOUBLE: PACK(long double, va_arg(ap, long double)); break;
+            case ARG_PTR: PACK(void *, va_arg(ap, void *)); break;
+            case ARG_STR: {
+                // 字符串在格式化时早已失效，按值拷贝；有精度时只拷贝会显示的部分
+                const char *s = va_arg(ap, const char *);
+                if (!s) s = "(null)";
+                if (pos >= cap) return pos;
+                size_t room = cap - pos - 1;
+                size_t n = strnlen(s, prec >= 0 && (size_t)prec < room ? (size_t)prec : room);
+                memcpy(out + pos, s, n);
+                out[pos + n] = '\0';
+                pos += n + 1;
+                break;
+            }
+        }
+    }
+    return pos;
+}
+
+#define UNPACK(type, var) \
+    type var; \
+    if (a + sizeof(var) > len) goto done; \
+    memcpy(&var, args + a, sizeof(var)); \
+    a += sizeof(var)
+
+size_t ui_log_format(char *out, size_t cap, const char *fmt, const uint8_t *args, size_t len) {
+    size_t o = 0, a = 0;
+    if (cap == 0) return 0;
+    const char *p = fmt;
+    while (*p && o + 1 < cap) {
+        size_t lit = strcspn(p, "%");
+        if (lit > 0) {
+            if (lit > cap - 1 - o) lit = cap - 1 - o;
+            memcpy(out + o, p, lit);
+            o += lit;
+            p += lit;
+            continue;
+        }
+        fmt_spec_t spec;
+        if (!parse_spec(p, &spec)) break;
+        // 转换说明里的 '*' 换成打包时取到的数字，每次 snprintf 只带一个参数
+        char sub[32];
+        size_t s = 0;
+        for (const char *q = p; q < spec.end; q++) {
+            if (s + 12 > sizeof(sub)) goto done;
+            if (*q != '*') {
+                sub[s++] = *q;
+                continue;
+            }
+            UNPACK(int, n);
+            s += (size_t)snprintf(sub + s, sizeof(sub) - s, "%d", n);
+        }
+        sub[s] = '\0';
+        p = spec.end;
+
+        char *dst = out + o;
+        size_t room = cap - o;
+        int n = 0;
+        switch (spec.kind) {
+            case ARG_NONE: n = snprintf(dst, room, "%%"); break;
+            case ARG_SKIP: break;
+            case ARG_INT: { UNPACK(int, v); n = snprintf(dst, room, sub, v); break; }
+            case ARG_LONG: { UNPACK(long, v); n = snprintf(dst, room, sub, v); break; }
+            case ARG_LLONG: { UNPACK(long long, v); n = snprintf(dst, room, sub, v); break; }
+            case ARG_INTMAX: { UNPACK(intmax_t, v); n = snprintf(dst, room, sub, v); break; }
+            case ARG_SIZE: { UNPACK(size_t, v); n = snprintf(dst, room, sub, v); break; }
+            case ARG_PTRDIFF: { UNPACK(ptrdiff_t, v); n = snprintf(dst, room, sub, v); break; }
+            case ARG_DOUBLE: { UNPACK(double, v); n = snprintf(dst, room, sub, v); break; }
+            case ARG_LDOUBLE: { UNPACK(long double, v); n = snprintf(dst, room, sub, v); break; }
+            case ARG_PTR: { UNPACK(void *, v); n = snprintf(dst, room, sub, v); break; }
+            case ARG_STR: {
+                const char *str = (const char *)args + a;
+                size_t slen = strnlen(str, len - a);
+                if (slen == len - a) goto done;     // 截断的记录没有结尾 '\0'
+                a += slen + 1;
+                n = snprintf(dst, room, sub, str);
+                break;
+            }
+        }
+        if (n < 0) break;
+        o += (size_t)n < room ? (size_t)n : room - 1;
+    }
+done:
+    out[o] = '\0';
+    return o;
+}
+
+// === 存储区 ===
+void ui_log_store_init(void *mem, size_t size) {
+    uint32_t lines = 1;
+    if (!mem || size < UI_LOG_STORE_FALLBACK_BYTES) {
+        if (!g_store_fallback) g_store_fallback = malloc(UI_LOG_STORE_FALLBACK_BYTES);
+        if (!g_store_fallback) {
+            // 没有存储区：日志不显示，ui_log_create 时再试一次
+            g_data = NULL;
+            g_index_mask = 0;
+            g_data_size = 0;
+            return;
+        }
+        mem = g_store_fallback;
+        size = UI_LOG_STORE_FALLBACK_BYTES;
+    }
+    while (lines * 2 <= size / UI_LOG_STORE_BYTES_PER_LINE) lines *= 2;
+    g_index = mem;
+    g_index_mask = lines - 1;
+    g_data = (uint8_t *)mem + lines * sizeof(uint32_t);
+    g_data_size = (uint32_t)((size - lines * sizeof(uint32_t)) & ~(STORE_ALIGN - 1));
+    g_data_head = 0;
+    g_data_used = 0;
+    g_log_first = g_log_head = 0;
+}
+
+static const store_rec_t *rec_at(uint32_t seq) {
+    return (const store_rec_t *)(g_data + g_index[seq & g_index_mask]);
+}
+
+static uint32_t rec_size(uint32_t len) {
+    return (uint32_t)(sizeof(store_rec_t) + len + STORE_ALIGN - 1) & ~(uint32_t)(STORE_ALIGN - 1);
+}
+
+static void evict_oldest(void) {
+    g_data_used -= rec_size(rec_at(g_log_first)->len);
+    g_log_first++;
+    g_stats.evicted++;
+}
+
+// 行文本 = 时间前缀 + 级别 / 标签 + 格式化后的正文，超出一行的部分截断。
+// esp_log 的格式串以颜色复位和换行结尾，这两部分不显示。
+static size_t format_body(char *out, size_t cap, const store_rec_t *rec) {
+    const uint8_t *args = (const uint8_t *)(rec + 1);
+    size_t len;
+    if (rec->hdr.fmt) {
+        len = ui_log_format(out, cap, rec->hdr.fmt, args, rec->len);
+    } else {
+        len = rec->len < cap - 1 ? rec->len : cap - 1;
+        memcpy(out, args, len);
+    }
+    while (len > 0 && (out[len - 1] == '\n' || out[len - 1] == '\r')) len--;
+    if (len >= 4 && memcmp(out + len - 4, "\033[0m", 4) == 0) len -= 4;
+    out[len] = '\0';
+    return len;
+}
+
+static void format_line(char *out, const store_rec_t *rec) {
+    static const char level_chars[] = "-EWIDV";
+    uint32_t tick_ms = rec->hdr.tick_ms;
+    uint32_t total_sec = tick_ms / 1000;
+    int n = snprintf(out, UI_LOG_LINE_MAX, "[%02d:%02d:%02d.%03d] ", (int)(total_sec / 3600),
+                     (int)(total_sec % 3600 / 60), (int)(total_sec % 60), (int)(tick_ms % 1000));
+    if (n < 0 || n >= UI_LOG_LINE_MAX) n = 0;
+    if (rec->hdr.tag) {
+        int m = snprintf(out + n, UI_LOG_LINE_MAX - n, "%c %s: ",
+                         level_chars[rec->hdr.level < UI_LOG_VERBOSE ? rec->hdr.level : UI_LOG_VERBOSE], rec->hdr.tag);
+        if (m > 0) n += m < UI_LOG_LINE_MAX - n ? m : UI_LOG_LINE_MAX - 1 - n;
+    }
+    format_body(out + n, UI_LOG_LINE_MAX - n, rec);
+}
+
+// 行样式：低 4 位为级别，bit 4 为高亮
+#define ROW_STYLE_MARK 0x10
+
+static lv_style_t *level_style(uint8_t level) {
+    switch (level) {
+        case UI_LOG_ERROR: return &g_style_error;
+        case UI_LOG_WARN: return &g_style_warn;
+        case UI_LOG_DEBUG:
+        case UI_LOG_VERBOSE: return &g_style_debug;
+        default: return NULL;
+    }
+}
+
+static void set_row_style(uint16_t row, uint8_t style) {
+    uint8_t old = g_row_style[row];
+    if (old == style) return;
+    lv_style_t *old_level = level_style(old & 0x0F);
+    lv_style_t *new_level = level_style(style & 0x0F);
+    if (old_level != new_level) {
+        if (old_level) lv_obj_remove_style(g_rows[row], old_level, 0);
+        if (new_level) lv_obj_add_style(g_rows[row], new_level, 0);
+    }
+    if ((old ^ style) & ROW_STYLE_MARK) {
+        if (style & ROW_STYLE_MARK) lv_obj_add_style(g_rows[row], &g_style_mark, 0);
+        else lv_obj_remove_style(g_rows[row], &g_style_mark, 0);
+    }
+    g_row_style[row] = style;
+}
+
+// 行对象改为显示第 seq 条记录：格式化只发生在这里
+static void set_row(uint16_t row, uint32_t seq) {
+    const store_rec_t *rec = rec_at(seq);
+    format_line(g_row_text[row], rec);
+    lv_label_set_text_static(g_rows[row], g_row_text[row]);
+    set_row_style(row, (uint8_t)((rec->hdr.level & 0x0F) | (g_mark == seq + 1 ? ROW_STYLE_MARK : 0)));
+    g_stats.rows_set++;
+}
+
+static void place_rows(void) {
+    for (uint16_t p = 0; p < g_row_count; p++) {
+        lv_obj_set_y(g_rows[(g_row_top + p) % g_row_count], p * g_line_h);
+    }
+}
+
+static void init_style(lv_style_t *style, uint32_t text_color) {
+    lv_style_init(style);
+    lv_style_set_text_color(style, lv_color_hex(text_color));
+}
+
+lv_obj_t *ui_log_create(lv_obj_t *parent) {
+    if (!g_data) ui_log_store_init(NULL, 0);
+    init_style(&g_style_error, 0xFF5050);
+    init_style(&g_style_warn, 0xFFD040);
+    init_style(&g_style_debug, 0x909090);
+    lv_style_init(&g_style_mark);
+    lv_style_set_bg_color(&g_style_mark, lv_color_hex(0x203870));
+    lv_style_set_bg_opa(&g_style_mark, LV_OPA_COVER);
+
+    g_view = lv_obj_create(parent);
+    lv_obj_set_size(g_view, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_border_width(g_view, 0, 0);
+    lv_obj_set_style_radius(g_view, 0, 0);
+    lv_obj_set_style_pad_all(g_view, 4, 0);
+    lv_obj_set_style_bg_color(g_view, lv_color_black(), 0);
+    lv_obj_set_style_text_color(g_view, lv_color_hex(0x00FF00), 0);
+    lv_obj_clear_flag(g_view, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_update_layout(g_view);
+
+    // 行高和可见行数在创建时确定，之后行对象只移动不重建
+    const lv_font_t *font = lv_obj_get_style_text_font(g_view, LV_PART_MAIN);
+    g_line_h = lv_font_get_line_height(font) + lv_obj_get_style_text_line_space(g_view, LV_PART_MAIN);
+    if (g_line_h < 1) g_line_h = 1;
+    lv_coord_t content_h = lv_obj_get_content_height(g_view);
+    g_row_count = content_h / g_line_h;
+    if (g_row_count < 1) g_row_count = 1;
+    if (g_row_count > UI_LOG_MAX_LINES) g_row_count = UI_LOG_MAX_LINES;
+
+    for (uint16_t i = 0; i < g_row_count; i++) {
+        lv_obj_t *row = lv_label_create(g_view);
+        lv_label_set_long_mode(row, LV_LABEL_LONG_CLIP);
+        lv_obj_set_size(row, LV_PCT(100), g_line_h);
+        lv_label_set_text_static(row, "");
+        g_rows[i] = row;
+        g_row_style[i] = UI_LOG_INFO;
+    }
+    g_row_top = 0;
+    g_rows_used = 0;
+    place_rows();
+    return g_view;
+}
+
+void ui_log_append(const ui_log_rec_hdr_t *hdr, const void *args, size_t len) {
+    if (!hdr || !g_data) return;
+    if (len > UI_LOG_ARGS_MAX) len = UI_LOG_ARGS_MAX;
+    const uint32_t size = rec_size((uint32_t)len);
+
+    if (g_log_head - g_log_first > g_index_mask) evict_oldest();
+    if (g_data_head + size > g_data_size) {
+        // 末尾放不下：淘汰位于写入位置之后的最旧记录，再从头写
+        while (g_log_first != g_log_head && g_index[g_log_first & g_index_mask] >= g_data_head) evict_oldest();
+        g_data_head = 0;
+    }
+    // 淘汰与新记录重叠的最旧记录；最旧记录在写入位置之前时，写入位置之后没有记录
+    while (g_log_first != g_log_head) {
+        uint32_t off = g_index[g_log_first & g_index_mask];
+        if (off < g_data_head || off >= g_data_head + size) break;
+        evict_oldest();
+    }
+
+    store_rec_t *rec = (store_rec_t *)(g_data + g_data_head);
+    rec->hdr = *hdr;
+    rec->len = (uint16_t)len;
+    memcpy(rec + 1, args, len);
+    g_index[g_log_head & g_index_mask] = g_data_head;
+    g_data_head += size;
+    g_data_used += size;
+    g_log_head++;
+    if (g_log_pending < UI_LOG_MAX_LINES) g_log_pending++;
+    g_log_added++;
+    g_stats.lines++;
+}
+
+// 把本帧积累的新行上屏：同一帧内到达的多行只移动一次行对象，
+// 超出可见行数的行直接跳过，永远不会被格式化和排版。
+// 行标签用 set_text_static 引用行对象自己的文本，记录之后被淘汰也不影响已显示的行。
+void ui_log_commit(void) {
+    if (!g_view || g_log_pending == 0) return;
+
+    uint32_t n = g_log_pending;
+    const uint32_t added = g_log_added;
+    g_log_pending = 0;
+    g_log_added = 0;
+    if (g_scroll > 0) {
+        // 翻看历史时保持画面停在同一批行上，行文本不变；只有这批行已被淘汰出存储区时才重排
+        g_scroll += added;
+        if (g_scroll > max_scroll()) render_rows();
+        g_stats.commits++;
+        return;
+    }
+    if (n > g_row_count) n = g_row_count;
+    uint32_t seq = g_log_head - n;
+    lv_coord_t w = lv_obj_get_content_width(g_view);
+
+    // 未填满时写入空行，只失效新行
+    while (n > 0 && g_rows_used < g_row_count) {
+        set_row((g_row_top + g_rows_used) % g_row_count, seq++);
+        g_rows_used++;
+        n--;
+        g_stats.invalidated_px += (uint32_t)w * g_line_h;
+    }
+
+    // 已填满：复用最上方的行对象作为新的底行，其余行整体上移。
+    // 每行都换了位置，失效区域是整个日志区；LVGL 没有按帧缓冲平移的接口，这部分重绘省不掉
+    if (n > 0) {
+        for (uint32_t i = 0; i < n; i++) {
+            set_row(g_row_top, seq++);
+            g_row_top = (g_row_top + 1) % g_row_count;
+        }
+        place_rows();
+        g_stats.invalidated_px += (uint32_t)w * g_line_h * g_row_count;
+    }
+    g_stats.commits++;
+}
+
+// 按 g_scroll 重排全部已用的行：第 p 个可见行显示序号 head - scroll - rows_used + p 的日志
+static uint32_t max_scroll(void) {
+    uint32_t history = g_log_head - g_log_first;
+    return history > g_row_count ? history - g_row_count : 0;
+}
+
+static void render_rows(void) {
+    if (g_scroll > max_scroll()) g_scroll = max_scroll();
+    uint32_t seq = g_log_head - g_scroll - g_rows_used;
+    for (uint16_t p = 0; p < g_rows_used; p++) {
+        set_row((g_row_top + p) % g_row_count, seq + p);
+    }
+    g_stats.invalidated_px += (uint32_t)lv_obj_get_content_width(g_view) * g_line_h * g_rows_used;
+}
+
+// dy_px > 0 表示手指向下移动，内容跟随手指，显示更早的日志
+void ui_log_scroll(lv_coord_t dy_px) {
+    if (!g_view) return;
+    g_scroll_px += dy_px;
+    int32_t lines = g_scroll_px / g_line_h;
+    if (lines == 0) return;
+    g_scroll_px -= lines * g_line_h;
+    uint32_t scroll = (lines < 0 && (uint32_t)-lines > g_scroll) ? 0 : g_scroll + lines;
+    if (scroll > max_scroll()) scroll = max_scroll();
+    if (scroll == g_scroll) return;
+    g_scroll = scroll;
+    if (g_scroll == 0) g_mark = 0;      // 回到底部即结束这次查看
+    render_rows();
+}
+
+// 把 seq 滚到最上方（历史不足一屏时尽量靠上）并高亮
+static void show_at_top(uint32_t seq) {
+    uint32_t bottom = seq + g_rows_used - 1;
+    g_scroll = bottom < g_log_head ? g_log_head - 1 - bottom : 0;
+    g_scroll_px = 0;
+    g_mark = seq + 1;
+    render_rows();
+}
+
+static void find_done(int64_t start_us, bool found) {
+    uint32_t us = (uint32_t)(esp_timer_get_time() - start_us);
+    g_stats.finds++;
+    if (!found) g_stats.find_misses++;
+    if (us > g_stats.find_us_max) g_stats.find_us_max = us;
+}
+
+bool ui_log_find(const char *text, ui_log_level_t level) {
+    if (!g_view || g_rows_used == 0) return false;
+    const int64_t start_us = esp_timer_get_time();
+    // 接着上次的结果往前找，没有标记时从最下方的可见行找起；标记行已被淘汰时结果为找不到
+    uint32_t seq = g_mark ? g_mark - 1 : g_log_head - g_scroll;
+    char body[UI_LOG_LINE_MAX];
+    while (seq != g_log_first && seq - g_log_first <= g_log_head - g_log_first) {
+        seq--;
+        const store_rec_t *rec = rec_at(seq);
+        if (rec->hdr.level > level) continue;
+        // 只比较正文，时间和标签不参与匹配
+        if (text && text[0]) {
+            format_body(body, sizeof(body), rec);
+            if (!strstr(body, text)) continue;
+        }
+        show_at_top(seq);
+        find_done(start_us, true);
+        return true;
+    }
+    find_done(start_us, false);
+    return false;
+}
+
+void ui_log_jump(uint32_t tick_ms) {
+    if (!g_view || g_rows_used == 0) return;
+    const int64_t start_us = esp_timer_get_time();
+    // 各任务写入的时间戳基本递增，二分查找第一条不早于 tick_ms 的行
+    uint32_t lo = g_log_first, hi = g_log_head;
+    while (lo != hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (rec_at(mid)->hdr.tick_ms < tick_ms) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == g_log_head) {
+        g_scroll = 0;
+        g_scroll_px = 0;
+        g_mark = 0;
+        render_rows();
+    } else {
+        show_at_top(lo);
+    }
+    find_done(start_us, true);
+}
+
+void ui_log_clear(void) {
+    g_log_first = g_log_head = 0;
+    g_log_pending = 0;
+    g_log_added = 0;
+    g_data_head = 0;
+    g_data_used = 0;
+    g_scroll = 0;
+    g_scroll_px = 0;
+    g_mark = 0;
+    if (!g_view) return;
+    for (uint16_t i = 0; i < g_row_count; i++) {
+        lv_label_set_text_static(g_rows[i], "");
+        set_row_style(i, UI_LOG_INFO);
+    }
+    g_row_top = 0;
+    g_rows_used = 0;
+    place_rows();
+}
+
+void ui_log_get_stats(ui_log_stats_t *stats) {
+    if (!stats) return;
+    *stats = g_stats;
+    stats->stored = g_log_head - g_log_first;
+    stats->store_used = g_data_used;
+    stats->store_size = g_data_size;
+    stats->index_size = g_index_mask + 1;
+}
@@ -0,0 +1,85 @@
+// ui_log.h
+#ifndef UI_LOG_H
+#define UI_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UI_LOG_LINE_MAX 128
+#define UI_LOG_ARGS_MAX 128      // 单条记录的参数（或纯文本）最大字节数
+#define UI_LOG_STORE_BYTES_PER_LINE 48      // 按平均行长给索引分配条目：每 48 字节存储区一条
+#define UI_LOG_STORE_FALLBACK_BYTES 8192    // 存储区的最小字节数，也是没有提供存储区时从堆上分配的大小
+
+// 与 esp_log_level_t 的数值相同
+typedef enum {
+    UI_LOG_NONE,
+    UI_LOG_ERROR,
+    UI_LOG_WARN,
+    UI_LOG_INFO,
+    UI_LOG_DEBUG,
+    UI_LOG_VERBOSE,
+} ui_log_level_t;
+
+// 日志记录：生产者只写时间、级别和格式串 / 标签指针，参数按格式串紧凑打包在其后，
+// 文本在 LVGL 任务中、只为真正显示的行格式化。fmt 为 NULL 时参数区就是纯文本。
+typedef struct {
+    uint32_t tick_ms;
+    uint8_t level;           // ui_log_level_t
+    const char *fmt;         // 必须在进程生命期内有效（字符串常量）
+    const char *tag;         // 同上，NULL 表示无标签
+} ui_log_rec_hdr_t;
+
+typedef struct {
+    uint32_t lines;          // 累计追加的日志行数
+    uint32_t rows_set;       // 实际格式化并排版（set_text）的行数
+    uint32_t commits;        // 上屏次数（每帧最多一次）
+    uint32_t invalidated_px; // 累计失效像素数
+    uint32_t stored;         // 存储区当前保存的行数
+    uint32_t evicted;        // 为新行腾出空间而淘汰的最旧行数
+    uint32_t store_used;     // 存储区已用字节数（不含索引）
+    uint32_t store_size;
+    uint32_t index_size;     // 存储区最多保存的行数
+    uint32_t finds;          // 搜索 / 跳转次数
+    uint32_t find_misses;    // 没有找到的次数
+    uint32_t find_us_max;    // 单次搜索最长耗时
+} ui_log_stats_t;
+
+// 按 fmt 依次取出 ap 中的参数写入 out，返回写入字节数；放不下的参数及其后的参数被丢弃。
+// 字符串参数按值拷贝（受精度限制），%n 被忽略。任意任务可调用，不依赖 LVGL。
+size_t ui_log_pack_args(uint8_t *out, size_t cap, const char *fmt, va_list ap);
+// 用 ui_log_pack_args 打包的参数格式化 fmt，返回写入的字符数（不含 '\0'，out 总以 '\0' 结尾）
+size_t ui_log_format(char *out, size_t cap, const char *fmt, const uint8_t *args, size_t len);
+
+// 日志历史存储区：变长记录区 + 行偏移索引，放在 PSRAM，容量约为 size / UI_LOG_STORE_BYTES_PER_LINE 行，
+// 满时淘汰最旧的行。内部 RAM 只有可见行的文本，与历史长度无关。
+// 在 ui_init() 之前调用；mem 由调用方分配且不再释放，为 NULL 或太小时用 malloc 分配
+// UI_LOG_STORE_FALLBACK_BYTES 字节（板上 PSRAM 分配失败时由调用方改从内部 RAM 分配这个大小传入）。
+void ui_log_store_init(void *mem, size_t size);
+
+// 以下函数仅在 LVGL 任务中调用
+lv_obj_t *ui_log_create(lv_obj_t *parent);
+// 追加一条记录，args 为打包的参数（fmt 为 NULL 时为不含 '\0' 的文本），超过 UI_LOG_ARGS_MAX 截断
+void ui_log_append(const ui_log_rec_hdr_t *hdr, const void *args, size_t len);
+void ui_log_clear(void);
+void ui_log_commit(void);
+// 按像素平移翻看历史日志，翻回底部后恢复跟随最新日志
+void ui_log_scroll(lv_coord_t dy_px);
+// 从当前标记行（没有时从最下方的可见行）往更早的方向找级别不低于 level、正文包含 text 的行，
+// 找到后把它滚到最上方并高亮；text 为空时只按级别找（如上一条错误）。找不到时返回 false，画面不变。
+bool ui_log_find(const char *text, ui_log_level_t level);
+// 跳到第一条时间不早于 tick_ms 的行（滚到最上方并高亮）；晚于最新一行时恢复跟随最新日志
+void ui_log_jump(uint32_t tick_ms);
+void ui_log_get_stats(ui_log_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_LOG_H
@@ -0,0 +1,230 @@
+// ui_log_bridge.c
+// esp_log 的格式串形如 [颜色] "I (%lu) %s: " 正文 [颜色复位] "\n"，参数依次为时间、标签和正文参数。
+// 这里解析出级别和标签，跳过时间参数，正文格式串（常量的后缀，同样常驻）和其余参数交给 ui_vlogt_nowait 打包，
+// 生产者一侧不格式化文本。令牌桶状态压缩在一个 32 位原子量里，多个任务并发写同一标签也不需要锁。
+#include "ui_log_bridge.h"
+#include "ui.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+// 令牌桶：高 16 位为令牌数（千分之一个为单位，每 ms 恰好补充 rate_per_s 个单位，没有舍入误差），
+// 低 16 位为上次补充的时间（ms）。时间只保留 16 位（约 65 s），而空桶补满最多 63 s，
+// 标签安静超过 65 s 后再出现时可能少补一些令牌，不会多补。
+#define BUCKET_TIME_BITS 16
+#define BUCKET_TIME_MASK ((1u << BUCKET_TIME_BITS) - 1)
+#define BUCKET_ONE 1000u
+
+_Static_assert(UI_LOG_BRIDGE_BURST_MAX * BUCKET_ONE <= BUCKET_TIME_MASK, "burst fits the token bits");
+
+enum {
+    TAG_FREE,
+    TAG_CLAIMED,        // 名字正在写入
+    TAG_READY,
+};
+
+typedef struct {
+    _Atomic uint32_t state;
+    const char *key;                    // 第一次见到的标签指针，查找时先比指针
+    char name[UI_LOG_BRIDGE_TAG_LEN];   // 标签名拷贝，记录引用它，调用方的标签不必常驻
+    _Atomic uint32_t bucket;
+    _Atomic uint32_t suppressed;        // 尚未汇总的被丢行数
+} bridge_tag_t;
+
+typedef struct {
+    _Atomic uint32_t calls;
+    _Atomic uint32_t shown;
+    _Atomic uint32_t filtered;
+    _Atomic uint32_t suppressed;
+    _Atomic uint32_t summaries;
+    _Atomic uint32_t queue_full;
+    _Atomic uint32_t formatted;
+} bridge_counters_t;
+
+static ui_log_bridge_config_t g_cfg = { .level = UI_LOG_INFO, .rate_per_s = 10, .burst = 20 };
+static uint32_t g_burst_q;          // 令牌桶容量（千分之一单位）
+static uint32_t g_refill_ms;        // 空桶补满所需时间，限制单次补充的计算范围
+static bridge_tag_t g_tags[UI_LOG_BRIDGE_TAGS];
+static bridge_tag_t g_other;        // 没有标签、或标签表已满的行
+static _Atomic uint32_t g_tag_next;
+static bridge_counters_t g_count;
+
+#define COUNT(field) atomic_fetch_add_explicit(&g_count.field, 1, memory_order_relaxed)
+
+void ui_log_bridge_init(const ui_log_bridge_config_t *cfg) {
+    if (cfg) g_cfg = *cfg;
+    if (g_cfg.rate_per_s == 0) g_cfg.rate_per_s = 1;
+    if (g_cfg.burst == 0) g_cfg.burst = 1;
+    if (g_cfg.burst > UI_LOG_BRIDGE_BURST_MAX) g_cfg.burst = UI_LOG_BRIDGE_BURST_MAX;
+    g_burst_q = g_cfg.burst * BUCKET_ONE;
+    g_refill_ms = g_burst_q / g_cfg.rate_per_s + 1;
+    memset(g_tags, 0, sizeof(g_tags));
+    memset(&g_other, 0, sizeof(g_other));
+    atomic_store(&g_other.bucket, g_burst_q << BUCKET_TIME_BITS | (lv_tick_get() & BUCKET_TIME_MASK));
+    atomic_store(&g_other.state, TAG_READY);
+    atomic_store(&g_tag_next, 0);
+    memset(&g_count, 0, sizeof(g_count));
+}
+
+// === 令牌桶 ===
+static bool take_token(bridge_tag_t *t, uint32_t now_ms) {
+    uint32_t old = atomic_load_explicit(&t->bucket, memory_order_relaxed);
+    for (;;) {
+        uint32_t tokens = old >> BUCKET_TIME_BITS;
+        uint32_t elapsed = (now_ms - old) & BUCKET_TIME_MASK;
+        if (elapsed > g_refill_ms) elapsed = g_refill_ms;
+        tokens += elapsed * g_cfg.rate_per_s;
+        if (tokens > g_burst_q) tokens = g_burst_q;
+        bool ok = tokens >= BUCKET_ONE;
+        if (ok) tokens -= BUCKET_ONE;
+        uint32_t next = tokens << BUCKET_TIME_BITS | (now_ms & BUCKET_TIME_MASK);
+        if (next == old || atomic_compare_exchange_weak_explicit(&t->bucket, &old, next,
+                                                                 memory_order_relaxed, memory_order_relaxed)) {
+            return ok;
+        }
+    }
+}
+
+// === 标签表 ===
+static bridge_tag_t *find_tag(const char *tag) {
+    if (!tag) return &g_other;
+    uint32_t count = atomic_load_explicit(&g_tag_next, memory_order_acquire);
+    if (count > UI_LOG_BRIDGE_TAGS) count = UI_LOG_BRIDGE_TAGS;
+    for (uint32_t i = 0; i < count; i++) {
+        if (g_tags[i].key == tag && atomic_load_explicit(&g_tags[i].state, memory_order_acquire) == TAG_READY) {
+            return &g_tags[i];
+        }
+    }
+    // 不同文件各自定义的同名 TAG 指针不同，按名字共用一个桶
+    for (uint32_t i = 0; i < count; i++) {
+        if (atomic_load_explicit(&g_tags[i].state, memory_order_acquire) == TAG_READY &&
+            strncmp(g_tags[i].name, tag, UI_LOG_BRIDGE_TAG_LEN - 1) == 0) {
+            return &g_tags[i];
+        }
+    }
+    // 新标签：占一个槽，写好名字和满桶后再发布。两个任务同时遇到同一新标签时可能各占一个槽，只是多一个桶。
+    uint32_t i = atomic_fetch_add_explicit(&g_tag_next, 1, memory_order_relaxed);
+    if (i >= UI_LOG_BRIDGE_TAGS) return &g_other;
+    bridge_tag_t *t = &g_tags[i];
+    atomic_store_explicit(&t->state, TAG_CLAIMED, memory_order_relaxed);
+    t->key = tag;
+    strncpy(t->name, tag, sizeof(t->name) - 1);
+    t->name[sizeof(t->name) - 1] = '\0';
+    atomic_store_explicit(&t->bucket, g_burst_q << BUCKET_TIME_BITS | (lv_tick_get() & BUCKET_TIME_MASK),
+                          memory_order_relaxed);
+    atomic_store_explicit(&t->suppressed, 0, memory_order_relaxed);
+    atomic_store_explicit(&t->state, TAG_READY, memory_order_release);
+    return t;
+}
+
+// === 写入 ===
+static bool push(ui_log_level_t level, const char *tag, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    bool ok = ui_vlogt_nowait(level, tag, fmt, ap);
+    va_end(ap);
+    return ok;
+}
+
+// 记录里的标签：槽里的拷贝；共用桶的行只在标签常驻时保留
+static const char *record_tag(const bridge_tag_t *t, const char *tag) {
+    if (t != &g_other) return t->name;
+    return tag && (!g_cfg.is_static || g_cfg.is_static(tag)) ? tag : NULL;
+}
+
+// 刷屏期间每个标签每次 flush 只有一行汇总，不与放行的行交替出现
+static void emit_summary(bridge_tag_t *t) {
+    uint32_t n = atomic_exchange_explicit(&t->suppressed, 0, memory_order_relaxed);
+    if (n == 0) return;
+    if (push(UI_LOG_WARN, record_tag(t, NULL), "%lu messages suppressed", (unsigned long)n)) {
+        COUNT(summaries);
+    } else {
+        atomic_fetch_add_explicit(&t->suppressed, n, memory_order_relaxed);     // 下次再试
+    }
+}
+
+// 解析 esp_log 的行前缀，返回正文格式串；不是该格式时返回 NULL
+static const char *parse_prefix(const char *fmt, ui_log_level_t *level, char *time_conv, bool *time_long) {
+    static const char letters[] = "EWIDV";
+    if (fmt[0] == '\033') {
+        const char *m = strchr(fmt, 'm');
+        if (!m) return NULL;
+        fmt = m + 1;
+    }
+    const char *letter = fmt[0] ? strchr(letters, fmt[0]) : NULL;
+    if (!letter || strncmp(fmt + 1, " (%", 3) != 0) return NULL;
+    const char *p = fmt + 4;
+    while (*p && *p != ')') p++;
+    if (*p != ')' || p - fmt < 5) return NULL;
+    *time_conv = p[-1];
+    *time_long = p[-2] == 'l';
+    if (strncmp(p, ") %s: ", 6) != 0) return NULL;
+    *level = (ui_log_level_t)(UI_LOG_ERROR + (letter - letters));
+    return p + 6;
+}
+
+void ui_log_bridge_write(const char *fmt, va_list ap) {
+    COUNT(calls);
+    if (!fmt) return;
+    ui_log_level_t level = UI_LOG_INFO;
+    const char *tag = NULL;
+    char time_conv;
+    bool time_long;
+    const char *body = parse_prefix(fmt, &level, &time_conv, &time_long);
+    if (body) {
+        // 时间由界面日志自己记录，这里只取走参数
+        if (time_conv == 's') (void)va_arg(ap, const char *);
+        else if (time_long) (void)va_arg(ap, unsigned long);
+        else (void)va_arg(ap, unsigned int);
+        tag = va_arg(ap, const char *);
+    } else {
+        body = fmt;
+    }
+    if (level > g_cfg.level) {
+        COUNT(filtered);
+        return;
+    }
+    if (body[0] == '\0' || (body[0] == '\n' && body[1] == '\0')) return;
+
+    bridge_tag_t *t = find_tag(tag);
+    if (!take_token(t, lv_tick_get())) {
+        atomic_fetch_add_explicit(&t->suppressed, 1, memory_order_relaxed);
+        COUNT(suppressed);
+        return;
+    }
+
+    bool ok;
+    if (!g_cfg.is_static || g_cfg.is_static(body)) {
+        ok = ui_vlogt_nowait(level, record_tag(t, tag), body, ap);
+    } else {
+        // 运行时拼出的格式串在显示前可能已失效，只能当场格式化
+        char line[UI_LOG_LINE_MAX];
+        vsnprintf(line, sizeof(line), body, ap);
+        ok = push(level, record_tag(t, tag), "%s", line);
+        COUNT(formatted);
+    }
+    if (ok) COUNT(shown);
+    else COUNT(queue_full);
+}
+
+void ui_log_bridge_flush(void) {
+    uint32_t count = atomic_load_explicit(&g_tag_next, memory_order_acquire);
+    if (count > UI_LOG_BRIDGE_TAGS) count = UI_LOG_BRIDGE_TAGS;
+    for (uint32_t i = 0; i < count; i++) {
+        if (atomic_load_explicit(&g_tags[i].state, memory_order_acquire) == TAG_READY) emit_summary(&g_tags[i]);
+    }
+    emit_summary(&g_other);
+}
+
+void ui_log_bridge_get_stats(ui_log_bridge_stats_t *stats) {
+    if (!stats) return;
+    uint32_t tags = atomic_load_explicit(&g_tag_next, memory_order_relaxed);
+    stats->calls = atomic_load_explicit(&g_count.calls, memory_order_relaxed);
+    stats->shown = atomic_load_explicit(&g_count.shown, memory_order_relaxed);
+    stats->filtered = atomic_load_explicit(&g_count.filtered, memory_order_relaxed);
+    stats->suppressed = atomic_load_explicit(&g_count.suppressed, memory_order_relaxed);
+    stats->summaries = atomic_load_explicit(&g_count.summaries, memory_order_relaxed);
+    stats->queue_full = atomic_load_explicit(&g_count.queue_full, memory_order_relaxed);
+    stats->formatted = atomic_load_explicit(&g_count.formatted, memory_order_relaxed);
+    stats->tags = tags < UI_LOG_BRIDGE_TAGS ? tags : UI_LOG_BRIDGE_TAGS;
+}
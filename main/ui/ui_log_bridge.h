@@ -0,0 +1,53 @@
+// ui_log_bridge.h
+// 把 esp_log 的输出转入界面日志：按级别过滤、每个标签一个令牌桶限速，被限速丢掉的条数以
+// "N messages suppressed" 汇总补上。任意任务可调用，从不等待、不取 LVGL 锁。
+// 与硬件无关，板上由 log_bridge.c 接 esp_log_set_vprintf，主机模拟器直接调用。
+#ifndef UI_LOG_BRIDGE_H
+#define UI_LOG_BRIDGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include "ui_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UI_LOG_BRIDGE_TAGS 32       // 各有令牌桶的标签数，其余标签共用一个桶
+#define UI_LOG_BRIDGE_TAG_LEN 16    // 标签名保存长度（含 '\0'），前 15 个字符相同的标签共用一个桶
+#define UI_LOG_BRIDGE_BURST_MAX 63
+
+typedef struct {
+    ui_log_level_t level;           // 显示不高于该级别的日志，例如 UI_LOG_INFO 时不显示 DEBUG / VERBOSE
+    uint16_t rate_per_s;            // 每个标签每秒补充的令牌数（行数）
+    uint8_t burst;                  // 令牌桶容量：标签安静一段时间后可连续显示的行数
+    // 指针是否常驻（字符串常量）：是则记录里只存格式串指针，否则当场格式化成文本。NULL 视为都常驻。
+    bool (*is_static)(const void *ptr);
+} ui_log_bridge_config_t;
+
+typedef struct {
+    uint32_t calls;                 // 收到的 esp_log 行数
+    uint32_t shown;                 // 写入界面日志的行数
+    uint32_t filtered;              // 级别被过滤的行数
+    uint32_t suppressed;            // 被限速丢掉的行数
+    uint32_t summaries;             // 写入的 "N messages suppressed" 行数
+    uint32_t queue_full;            // 命令队列满而丢掉的行数
+    uint32_t formatted;             // 格式串不常驻、只能当场格式化的行数
+    uint32_t tags;                  // 已分配令牌桶的标签数
+} ui_log_bridge_stats_t;
+
+// 设置过滤和限速参数并清空标签表，在第一次 ui_log_bridge_write 之前调用
+void ui_log_bridge_init(const ui_log_bridge_config_t *cfg);
+// esp_log 的一行：fmt / ap 即 esp_log 传给 vprintf 的参数（"I (123) tag: ..." 的行格式），
+// 也接受其他格式串，整行按 INFO、无标签显示。ap 会被取用，还要输出到控制台时传入 va_copy 的副本。
+void ui_log_bridge_write(const char *fmt, va_list ap);
+// 为每个有行被丢掉的标签写一行 "N messages suppressed"，周期调用（约每秒一次）
+void ui_log_bridge_flush(void);
+void ui_log_bridge_get_stats(ui_log_bridge_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_LOG_BRIDGE_H
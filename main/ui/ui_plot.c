@@ -0,0 +1,313 @@
+// ui_plot.c
+// 抽取用 min/max 而不是 LTTB：每列保留区间内的极值，窄尖峰不会被抽掉；
+// 合并一列只需要本列的样本，不用等下一桶数据，生产者每个样本只做两次比较。
+#include "ui_plot.h"
+#include <string.h>
+#include <stdatomic.h>
+
+#include "esp_log.h"
+
+static const char *TAG = "ui_plot";
+
+#define PLOT_LEVEL_MAX 65535        // 生产者按通道量程把样本归一化到 0..65535，LVGL 侧只按高度缩放
+
+typedef struct {
+    uint16_t lo;
+    uint16_t hi;
+    uint16_t last;                  // 本列最后一个样本，下一列从这里连线
+} plot_col_t;
+
+// === 生产者状态 + 列队列（每通道一个）===
+typedef struct {
+    float min;
+    float scale;                    // PLOT_LEVEL_MAX / (max - min)
+    uint32_t samples_per_px;        // 0 表示未配置
+    uint32_t acc_n;                 // 当前列已合并的样本数
+    uint16_t acc_lo, acc_hi;
+    lv_color_t color;
+    _Atomic uint32_t gen;           // 每次配置加一，LVGL 侧据此清空曲线
+    plot_col_t ring[UI_PLOT_COL_RING];
+    _Atomic uint32_t head;          // 生产者写
+    _Atomic uint32_t tail;          // LVGL 任务写
+    _Atomic uint32_t samples, columns, dropped;
+} plot_channel_t;
+
+static plot_channel_t g_channels[UI_PLOT_CHANNELS];
+
+// === LVGL 侧：每通道一行像素列，扫描光标处覆盖 ===
+typedef struct {
+    int16_t top;                    // 相对内容区的行，top < 0 表示该列为空
+    int16_t bottom;
+} plot_span_t;
+
+typedef struct {
+    plot_span_t *spans;             // 宽度个列
+    uint16_t x;                     // 下一列写入的位置
+    int16_t last_y;                 // 上一列最后一个样本所在的行，< 0 表示无
+    uint32_t gen;
+    lv_color_t color;
+} plot_trace_t;
+
+static lv_obj_t *g_obj;
+static lv_timer_t *g_timer;
+static plot_span_t *g_spans;
+static plot_trace_t g_traces[UI_PLOT_CHANNELS];
+static lv_coord_t g_w, g_h;
+static ui_plot_stats_t g_stats;     // 只记录 LVGL 侧的计数，生产者计数在通道里
+
+// 定时器暂停时置位。与生产者发布的 head / gen 构成 Dekker 式握手（都用 seq_cst）：
+// 暂停前先置位再复查队列，生产者先发布再查看标志，两边至少有一边看到对方，唤醒不会丢。
+static _Atomic bool g_parked;
+static bool g_timer_paused;
+static uint32_t g_empty_periods;
+static void (*g_wakeup_cb)(void);
+
+static uint16_t to_level(const plot_channel_t *ch, float v) {
+    float t = (v - ch->min) * ch->scale;
+    if (!(t > 0.0f)) return 0;      // 含 NaN
+    if (t >= (float)PLOT_LEVEL_MAX) return PLOT_LEVEL_MAX;
+    return (uint16_t)t;
+}
+
+// === 生产者侧 ===
+// 定时器已暂停时只有第一个发现的生产者去唤醒，之后的 push 只多一次原子读
+static void wake_consumer(void) {
+    if (atomic_load(&g_parked) && atomic_exchange(&g_parked, false) && g_wakeup_cb) g_wakeup_cb();
+}
+
+void ui_plot_config_channel(int channel, const ui_plot_channel_config_t *cfg) {
+    if (channel < 0 || channel >= UI_PLOT_CHANNELS || !cfg) return;
+    plot_channel_t *ch = &g_channels[channel];
+    ch->min = cfg->min;
+    ch->scale = cfg->max > cfg->min ? (float)PLOT_LEVEL_MAX / (cfg->max - cfg->min) : 0.0f;
+    ch->samples_per_px = cfg->samples_per_px ? cfg->samples_per_px : 1;
+    ch->acc_n = 0;
+    ch->color = cfg->color;
+    atomic_fetch_add_explicit(&ch->gen, 1, memory_order_seq_cst);
+    wake_consumer();
+}
+
+void ui_plot_push(int channel, const float *samples, size_t n) {
+    if (channel < 0 || channel >= UI_PLOT_CHANNELS || !samples) return;
+    plot_channel_t *ch = &g_channels[channel];
+    const uint32_t spp = ch->samples_per_px;
+    if (spp == 0) return;
+
+    uint32_t head = atomic_load_explicit(&ch->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ch->tail, memory_order_acquire);
+    uint32_t lo = ch->acc_lo, hi = ch->acc_hi, acc_n = ch->acc_n;
+    uint32_t columns = 0, dropped = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint16_t v = to_level(ch, samples[i]);
+        if (acc_n == 0) {
+            lo = hi = v;
+        } else if (v < lo) {
+            lo = v;
+        } else if (v > hi) {
+            hi = v;
+        }
+        if (++acc_n < spp) continue;
+        acc_n = 0;
+        columns++;
+        if (head - tail >= UI_PLOT_COL_RING) {
+            tail = atomic_load_explicit(&ch->tail, memory_order_acquire);
+            if (head - tail >= UI_PLOT_COL_RING) {
+                dropped++;
+                continue;
+            }
+        }
+        plot_col_t *col = &ch->ring[head & (UI_PLOT_COL_RING - 1)];
+        col->lo = (uint16_t)lo;
+        col->hi = (uint16_t)hi;
+        col->last = v;
+        head++;
+    }
+    ch->acc_lo = (uint16_t)lo;
+    ch->acc_hi = (uint16_t)hi;
+    ch->acc_n = acc_n;
+    // 整批只发布一次，LVGL 任务按自己的周期来取，不为每列唤醒
+    atomic_store_explicit(&ch->head, head, memory_order_seq_cst);
+    atomic_fetch_add_explicit(&ch->samples, (uint32_t)n, memory_order_relaxed);
+    if (columns) atomic_fetch_add_explicit(&ch->columns, columns, memory_order_relaxed);
+    if (dropped) atomic_fetch_add_explicit(&ch->dropped, dropped, memory_order_relaxed);
+    if (columns) wake_consumer();
+}
+
+// === LVGL 侧 ===
+static int16_t level_to_row(uint16_t level) {
+    return (int16_t)((g_h - 1) - (int32_t)level * (g_h - 1) / PLOT_LEVEL_MAX);
+}
+
+static void clear_trace(plot_trace_t *trace) {
+    for (lv_coord_t x = 0; x < g_w; x++) trace->spans[x].top = -1;
+    trace->x = 0;
+    trace->last_y = -1;
+}
+
+// 失效从 x 开始的 count 列（可绕回开头），只覆盖内容区的这几列
+static void invalidate_cols(uint32_t x, uint32_t count) {
+    lv_area_t content;
+    lv_obj_get_content_coords(g_obj, &content);
+    if (count > (uint32_t)g_w) count = g_w;
+    while (count > 0) {
+        uint32_t run = (uint32_t)g_w - x;
+        if (run > count) run = count;
+        lv_area_t area = { content.x1 + (lv_coord_t)x, content.y1, content.x1 + (lv_coord_t)(x + run - 1), content.y2 };
+        lv_obj_invalidate_area(g_obj, &area);
+        g_stats.invalidated_px += run * (uint32_t)g_h;
+        count -= run;
+        x = 0;
+    }
+}
+
+static void write_col(plot_trace_t *trace, const plot_col_t *col) {
+    int16_t top = level_to_row(col->hi);
+    int16_t bottom = level_to_row(col->lo);
+    // 与上一列的最后一个样本连成竖线，陡峭的边沿不会断开
+    if (trace->last_y >= 0) {
+        if (trace->last_y < top) top = trace->last_y;
+        if (trace->last_y > bottom) bottom = trace->last_y;
+    }
+    trace->spans[trace->x] = (plot_span_t){ top, bottom };
+    trace->last_y = level_to_row(col->last);
+    trace->x = (uint16_t)((trace->x + 1) % g_w);
+}
+
+static bool has_pending(void) {
+    for (int c = 0; c < UI_PLOT_CHANNELS; c++) {
+        plot_channel_t *ch = &g_channels[c];
+        if (atomic_load(&ch->gen) != g_traces[c].gen ||
+            atomic_load(&ch->head) != atomic_load_explicit(&ch->tail, memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void park_timer(void) {
+    atomic_store(&g_parked, true);
+    if (has_pending()) {
+        atomic_store(&g_parked, false);     // 置位前刚好有数据到达
+        return;
+    }
+    lv_timer_pause(g_timer);
+    g_timer_paused = true;
+}
+
+static void plot_timer_cb(lv_timer_t *timer) {
+    bool updated = false;
+    for (int c = 0; c < UI_PLOT_CHANNELS; c++) {
+        plot_channel_t *ch = &g_channels[c];
+        plot_trace_t *trace = &g_traces[c];
+        uint32_t gen = atomic_load_explicit(&ch->gen, memory_order_acquire);
+        if (gen != trace->gen) {
+            trace->gen = gen;
+            trace->color = ch->color;
+            clear_trace(trace);
+            lv_obj_invalidate(g_obj);
+        }
+
+        uint32_t head = atomic_load_explicit(&ch->head, memory_order_acquire);
+        uint32_t tail = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+        uint32_t n = head - tail;
+        if (n == 0) continue;
+        // 一个周期内到达超过一屏的列时，只有最后一屏可见
+        if (n > (uint32_t)g_w) {
+            tail = head - g_w;
+            n = g_w;
+        }
+        uint32_t x0 = trace->x;
+        for (; tail != head; tail++) {
+            write_col(trace, &ch->ring[tail & (UI_PLOT_COL_RING - 1)]);
+        }
+        atomic_store_explicit(&ch->tail, tail, memory_order_release);
+
+        for (uint32_t k = 0; k < UI_PLOT_GAP_PX && k < (uint32_t)g_w; k++) {
+            trace->spans[(trace->x + k) % g_w].top = -1;
+        }
+        invalidate_cols(x0, n + UI_PLOT_GAP_PX);
+        updated = true;
+    }
+    if (updated) {
+        g_stats.updates++;
+        g_empty_periods = 0;
+    } else if (++g_empty_periods >= UI_PLOT_PARK_PERIODS) {
+        park_timer();
+    }
+}
+
+// 只绘制裁剪区内的列：正常推进时裁剪区就是新列条带
+static void plot_draw_cb(lv_event_t *e) {
+    lv_draw_ctx_t *draw_ctx = lv_event_get_draw_ctx(e);
+    lv_area_t content, clip;
+    lv_obj_get_content_coords(g_obj, &content);
+    if (!_lv_area_intersect(&clip, draw_ctx->clip_area, &content)) return;
+
+    lv_draw_rect_dsc_t dsc;
+    lv_draw_rect_dsc_init(&dsc);
+    dsc.bg_opa = LV_OPA_COVER;
+    const lv_coord_t x_end = clip.x2 - content.x1;
+    for (int c = 0; c < UI_PLOT_CHANNELS; c++) {
+        const plot_trace_t *trace = &g_traces[c];
+        if (trace->gen == 0) continue;
+        dsc.bg_color = trace->color;
+        for (lv_coord_t x = clip.x1 - content.x1; x <= x_end; x++) {
+            const plot_span_t *span = &trace->spans[x];
+            if (span->top < 0) continue;
+            lv_area_t area = { content.x1 + x, content.y1 + span->top, content.x1 + x, content.y1 + span->bottom };
+            lv_draw_rect(draw_ctx, &dsc, &area);
+            g_stats.columns_drawn++;
+        }
+    }
+}
+
+lv_obj_t *ui_plot_create(lv_obj_t *parent) {
+    g_obj = lv_obj_create(parent);
+    lv_obj_set_size(g_obj, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_border_width(g_obj, 0, 0);
+    lv_obj_set_style_radius(g_obj, 0, 0);
+    lv_obj_set_style_pad_all(g_obj, 4, 0);
+    lv_obj_set_style_bg_color(g_obj, lv_color_black(), 0);
+    lv_obj_clear_flag(g_obj, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_update_layout(g_obj);
+
+    // 列缓冲按创建时的内容区分配，之后只覆盖不重建
+    g_w = lv_obj_get_content_width(g_obj);
+    g_h = lv_obj_get_content_height(g_obj);
+    if (g_w < 1 || g_h < 2) return g_obj;
+    g_spans = lv_mem_alloc(sizeof(plot_span_t) * UI_PLOT_CHANNELS * g_w);
+    if (!g_spans) {
+        ESP_LOGE(TAG, "no memory for %d x %d plot", (int)g_w, (int)g_h);
+        return g_obj;
+    }
+    for (int c = 0; c < UI_PLOT_CHANNELS; c++) {
+        g_traces[c].spans = g_spans + c * g_w;
+        g_traces[c].gen = 0;
+        clear_trace(&g_traces[c]);
+    }
+    lv_obj_add_event_cb(g_obj, plot_draw_cb, LV_EVENT_DRAW_MAIN, NULL);
+    g_timer = lv_timer_create(plot_timer_cb, UI_PLOT_PERIOD_MS, NULL);
+    return g_obj;
+}
+
+void ui_plot_set_wakeup_cb(void (*cb)(void)) {
+    g_wakeup_cb = cb;
+}
+
+void ui_plot_poll(void) {
+    if (!g_timer_paused || atomic_load(&g_parked)) return;
+    g_timer_paused = false;
+    g_empty_periods = 0;
+    lv_timer_resume(g_timer);
+    lv_timer_ready(g_timer);
+}
+
+void ui_plot_get_stats(ui_plot_stats_t *stats) {
+    if (!stats) return;
+    *stats = g_stats;
+    for (int c = 0; c < UI_PLOT_CHANNELS; c++) {
+        stats->samples += atomic_load_explicit(&g_channels[c].samples, memory_order_relaxed);
+        stats->columns += atomic_load_explicit(&g_channels[c].columns, memory_order_relaxed);
+        stats->dropped += atomic_load_explicit(&g_channels[c].dropped, memory_order_relaxed);
+    }
+}
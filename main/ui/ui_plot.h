@@ -0,0 +1,61 @@
+// ui_plot.h
+// 实时曲线：高采样率信号（1~10 kHz）按像素列做 min/max 抽取后扫描绘制。
+// 生产者在自己的任务里把每 samples_per_px 个样本合并成一列（最小值、最大值、最后一个值），
+// 经每通道一个的无锁单生产者队列交给 LVGL 任务；LVGL 任务每 UI_PLOT_PERIOD_MS 取走新列，
+// 在扫描光标处覆盖旧列，只失效新写入的列条带。每帧的绘制量只取决于时间窗（列/秒），与采样率无关。
+// 连续 UI_PLOT_PARK_PERIODS 个周期没有新列时取列定时器暂停，LVGL 任务可以一直睡眠；
+// 生产者再次发布列或配置时通过唤醒回调叫醒 LVGL 任务，由 ui_plot_poll 恢复定时器。
+#ifndef UI_PLOT_H
+#define UI_PLOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UI_PLOT_CHANNELS 4
+#define UI_PLOT_COL_RING 256        // 每通道待绘制的列数（2 的幂），超出时丢弃新列
+#define UI_PLOT_PERIOD_MS 33        // LVGL 任务取列并失效的周期
+#define UI_PLOT_GAP_PX 6            // 扫描光标前方擦除的列数，用来分隔新旧数据
+#define UI_PLOT_PARK_PERIODS 30     // 连续这么多个周期没有新列后暂停取列（约 1 s）
+
+typedef struct {
+    float min;                      // 纵轴范围，超出的样本贴边显示
+    float max;
+    uint32_t samples_per_px;        // 每个像素列合并的样本数 = 采样率 × 时间窗 / 曲线宽度
+    lv_color_t color;
+} ui_plot_channel_config_t;
+
+typedef struct {
+    uint32_t samples;               // 送入的样本数
+    uint32_t columns;               // 生产者合并出的列数
+    uint32_t dropped;               // 队列满而丢弃的列数
+    uint32_t updates;               // 取到新列的周期数
+    uint32_t columns_drawn;         // 绘制的列段数（每通道每列一段）
+    uint32_t invalidated_px;        // 累计失效像素数
+} ui_plot_stats_t;
+
+// === 生产者侧：任意任务调用，每个通道只能有一个生产者 ===
+// 配置通道并清空它的曲线，在该通道的生产者任务里、第一次 push 之前调用
+void ui_plot_config_channel(int channel, const ui_plot_channel_config_t *cfg);
+// 送入一批样本；未配置的通道直接忽略。每批只发布一次队列位置，单批最多合并出 UI_PLOT_COL_RING 列
+void ui_plot_push(int channel, const float *samples, size_t n);
+
+// 取列定时器暂停后，生产者用它唤醒 LVGL 任务；在 ui_init 之前设置（ui_set_wakeup_cb 会一并设置）
+void ui_plot_set_wakeup_cb(void (*cb)(void));
+
+// === LVGL 侧：以下函数仅在 LVGL 任务中调用 ===
+// 曲线大小在创建时确定，占满父对象
+lv_obj_t *ui_plot_create(lv_obj_t *parent);
+void ui_plot_get_stats(ui_plot_stats_t *stats);
+// 生产者在定时器暂停后送入了数据时恢复取列，每次处理 UI 消息时调用
+void ui_plot_poll(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_PLOT_H
@@ -0,0 +1,327 @@
+// ui_proto.c
+// 帧在接收缓冲里就地 COBS 解码，命令参数（字符串、样本）直接从缓冲引用后调用 ui.h 接口。
+// 多字节字段为小端，与 ESP32-S3 和 x86 主机的字节序相同，按字节拷贝读取，不要求对齐。
+#include "ui_proto.h"
+#include "ui.h"
+#include <string.h>
+
+#define PROTO_CMD_HDR 3             // 操作码 + 参数长度
+#define PROTO_CRC_LEN 2
+#define PROTO_PLOT_CHUNK 64         // PLOT_PUSH 的样本按块拷到对齐的缓冲再送入曲线
+
+static ui_proto_t *g_event_proto;   // 按钮事件发往的实例
+
+static uint16_t crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint32_t rd32(const uint8_t *p) {
+    return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void wr32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static float rdf32(const uint8_t *p) {
+    float f;
+    memcpy(&f, p, sizeof(f));
+    return f;
+}
+
+// === COBS ===
+typedef struct {
+    uint8_t *out;
+    size_t code_pos;
+    size_t pos;
+    uint8_t code;
+} cobs_enc_t;
+
+static void cobs_put(cobs_enc_t *e, uint8_t b) {
+    if (b != 0) {
+        e->out[e->pos++] = b;
+        if (++e->code != 0xFF) return;
+    }
+    e->out[e->code_pos] = e->code;
+    e->code_pos = e->pos++;
+    e->code = 1;
+}
+
+size_t ui_proto_encoded_max(size_t payload_len) {
+    size_t data = payload_len + PROTO_CRC_LEN;
+    return data + data / 254 + 2;   // 每 254 字节一个块头，外加首个块头和分隔符
+}
+
+size_t ui_proto_encode(const uint8_t *payload, size_t len, uint8_t *out) {
+    cobs_enc_t e = { .out = out, .code_pos = 0, .pos = 1, .code = 1 };
+    uint16_t crc = crc16(payload, len);
+    for (size_t i = 0; i < len; i++) cobs_put(&e, payload[i]);
+    cobs_put(&e, (uint8_t)crc);
+    cobs_put(&e, (uint8_t)(crc >> 8));
+    out[e.code_pos] = e.code;
+    out[e.pos++] = 0;
+    return e.pos;
+}
+
+// 就地解码，解码结果不长于输入；编码错误返回 -1
+static int cobs_decode(uint8_t *buf, size_t len) {
+    size_t in = 0, out = 0;
+    while (in < len) {
+        uint8_t code = buf[in++];
+        size_t n = code - 1;
+        if (code == 0 || in + n > len) return -1;
+        memmove(buf + out, buf + in, n);
+        out += n;
+        in += n;
+        if (code != 0xFF && in < len) buf[out++] = 0;
+    }
+    return (int)out;
+}
+
+// === 事件（设备 -> 控制器）===
+static void send_event(ui_proto_t *p, uint8_t op, const uint8_t *args, uint16_t len) {
+    uint8_t payload[PROTO_CMD_HDR + 16];
+    uint8_t frame[PROTO_CMD_HDR + 16 + PROTO_CRC_LEN + 3];
+    if (!p || !p->write || len > sizeof(payload) - PROTO_CMD_HDR) return;
+    payload[0] = op;
+    payload[1] = (uint8_t)len;
+    payload[2] = (uint8_t)(len >> 8);
+    memcpy(payload + PROTO_CMD_HDR, args, len);
+    p->write(frame, ui_proto_encode(payload, PROTO_CMD_HDR + len, frame), p->ctx);
+}
+
+// 按钮回调没有参数，每个按钮一个跳板（在 LVGL 任务中执行）
+static void send_button(uint8_t index, bool long_press) {
+    uint8_t args[2] = { index, long_press };
+    send_event(g_event_proto, UI_PROTO_EVT_BUTTON, args, sizeof(args));
+}
+
+static void button0(void) { send_button(0, false); }
+static void button1(void) { send_button(1, false); }
+static void button2(void) { send_button(2, false); }
+static void button3(void) { send_button(3, false); }
+static void button0_long(void) { send_button(0, true); }
+static void button1_long(void) { send_button(1, true); }
+static void button2_long(void) { send_button(2, true); }
+static void button3_long(void) { send_button(3, true); }
+
+_Static_assert(UI_BUTTON_COUNT == 4, "one event trampoline per button");
+static const ui_btn_callback_t g_button_cbs[UI_BUTTON_COUNT] = { button0, button1, button2, button3 };
+static const ui_btn_callback_t g_button_long_cbs[UI_BUTTON_COUNT] = {
+    button0_long, button1_long, button2_long, button3_long,
+};
+
+// === 命令（控制器 -> 设备）===
+// 依次取出以 '\0' 结尾的字符串，越界返回 NULL
+static const char *next_str(const uint8_t **pos, const uint8_t *end) {
+    const uint8_t *s = *pos;
+    const uint8_t *nul = memchr(s, 0, end - s);
+    if (!nul) return NULL;
+    *pos = nul + 1;
+    return (const char *)s;
+}
+
+static void plot_push(int channel, const uint8_t *data, size_t count) {
+    float samples[PROTO_PLOT_CHUNK];
+    while (count > 0) {
+        size_t n = count < PROTO_PLOT_CHUNK ? count : PROTO_PLOT_CHUNK;
+        memcpy(samples, data, n * sizeof(float));
+        ui_plot_push(channel, samples, n);
+        data += n * sizeof(float);
+        count -= n;
+    }
+}
+
+static bool exec_command(ui_proto_t *p, uint8_t op, const uint8_t *args, size_t len) {
+    const uint8_t *pos = args;
+    const uint8_t *end = args + len;
+    const char *a, *b;
+    switch (op) {
+        case UI_PROTO_SET_TOP:
+            if (!(a = next_str(&pos, end)) || !(b = next_str(&pos, end))) return false;
+            ui_set_top_firmware_info(a, b);
+            return true;
+        case UI_PROTO_SET_STATUS_ITEM:
+            if (len < 4) return false;
+            pos += 4;
+            if (!(a = next_str(&pos, end)) || !(b = next_str(&pos, end))) return false;
+            ui_set_status_item(args[0], a, b, lv_color_make(args[1], args[2], args[3]));
+            return true;
+        case UI_PROTO_SET_BUTTON:
+            if (len < 1 || args[0] >= UI_BUTTON_COUNT) return false;
+            pos++;
+            if (!(a = next_str(&pos, end))) return false;
+            ui_set_button(args[0], a, g_button_cbs[args[0]]);
+            return true;
+        case UI_PROTO_ADD_LOG:
+            if (!(a = next_str(&pos, end))) return false;
+            ui_add_log(a);
+            return true;
+        case UI_PROTO_SET_BOTTOM:
+            if (len < 4) return false;
+            pos += 4;
+            if (!(a = next_str(&pos, end)) || !(b = next_str(&pos, end))) return false;
+            ui_set_bottom_info(a, rd32(args), b);
+            return true;
+        case UI_PROTO_REFRESH_STATUS:
+            ui_refresh_status();
+            return true;
+        case UI_PROTO_CLEAR_LOG:
+            ui_clear_log();
+            return true;
+        case UI_PROTO_SET_BUTTON_LONG_PRESS:
+            if (len < 1 || args[0] >= UI_BUTTON_COUNT) return false;
+            ui_set_button_long_press(args[0], g_button_long_cbs[args[0]]);
+            return true;
+        case UI_PROTO_SHOW_PLOT:
+            if (len < 1) return false;
+            ui_show_plot(args[0] != 0);
+            return true;
+        case UI_PROTO_FIND_LOG:
+            if (len < 1) return false;
+            pos++;
+            if (!(a = next_str(&pos, end))) return false;
+            ui_find_log(a, (ui_log_level_t)args[0]);
+            return true;
+        case UI_PROTO_JUMP_LOG:
+            if (len < 4) return false;
+            ui_jump_log(rd32(args));
+            return true;
+        case UI_PROTO_SET_BUTTON_ICON:
+            if (len < 1 || args[0] >= UI_BUTTON_COUNT) return false;
+            pos++;
+            if (!(a = next_str(&pos, end))) return false;
+            ui_set_button_icon(args[0], a);
+            return true;
+        case UI_PROTO_SET_STATUS_ICON:
+            if (len < 1 || args[0] >= UI_STATUS_MAX_ITEMS) return false;
+            pos++;
+            if (!(a = next_str(&pos, end))) return false;
+            ui_set_status_icon(args[0], a);
+            return true;
+        case UI_PROTO_SET_BUTTON_TEXT:
+            if (len < 1 || args[0] >= UI_BUTTON_COUNT) return false;
+            pos++;
+            if (!(a = next_str(&pos, end))) return false;
+            ui_set_button_text(args[0], a);
+            return true;
+        case UI_PROTO_PLOT_CONFIG: {
+            if (len < 16) return false;
+            ui_plot_channel_config_t cfg = {
+                .min = rdf32(args + 1),
+                .max = rdf32(args + 5),
+                .samples_per_px = rd32(args + 9),
+                .color = lv_color_make(args[13], args[14], args[15]),
+            };
+            ui_plot_config_channel(args[0], &cfg);
+            return true;
+        }
+        case UI_PROTO_PLOT_PUSH:
+            if (len < 1 || (len - 1) % sizeof(float)) return false;
+            plot_push(args[0], args + 1, (len - 1) / sizeof(float));
+            return true;
+        case UI_PROTO_PING: {
+            if (len < 4) return false;
+            uint8_t pong[16];
+            memcpy(pong, args, 4);
+            wr32(pong + 4, p->stats.frames);
+            wr32(pong + 8, p->stats.commands + 1);      // 含本条 PING
+            wr32(pong + 12, p->stats.crc_errors + p->stats.cobs_errors + p->stats.overflows + p->stats.bad_commands);
+            send_event(p, UI_PROTO_EVT_PONG, pong, sizeof(pong));
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+static void process_frame(ui_proto_t *p, uint8_t *buf, size_t len) {
+    int n = cobs_decode(buf, len);
+    if (n < PROTO_CRC_LEN) {
+        if (len > 0) p->stats.cobs_errors++;    // 连续的分隔符只是空帧
+        return;
+    }
+    size_t body = (size_t)n - PROTO_CRC_LEN;
+    if (crc16(buf, body) != (uint16_t)(buf[body] | buf[body + 1] << 8)) {
+        p->stats.crc_errors++;
+        return;
+    }
+    p->stats.frames++;
+
+    // 整帧作为一批提交，LVGL 任务不会只应用其中一部分就去渲染
+    ui_batch_begin();
+    size_t off = 0;
+    while (off < body) {
+        if (body - off < PROTO_CMD_HDR) {
+            p->stats.bad_commands++;
+            break;
+        }
+        uint8_t op = buf[off];
+        size_t arg_len = buf[off + 1] | (size_t)buf[off + 2] << 8;
+        off += PROTO_CMD_HDR;
+        if (arg_len > body - off) {
+            p->stats.bad_commands++;
+            break;
+        }
+        if (exec_command(p, op, buf + off, arg_len)) p->stats.commands++;
+        else p->stats.bad_commands++;
+        off += arg_len;
+    }
+    ui_batch_end();
+}
+
+void ui_proto_init(ui_proto_t *p, ui_proto_write_cb_t write, void *ctx) {
+    memset(p, 0, sizeof(*p));
+    p->write = write;
+    p->ctx = ctx;
+    g_event_proto = p;
+}
+
+uint8_t *ui_proto_rx_space(ui_proto_t *p, size_t *avail) {
+    if (p->len >= UI_PROTO_FRAME_MAX) {
+        // 缓冲已满仍未见分隔符：丢弃这一帧
+        p->stats.overflows++;
+        p->discard = true;
+        p->len = 0;
+    }
+    *avail = UI_PROTO_FRAME_MAX - p->len;
+    return p->buf + p->len;
+}
+
+void ui_proto_rx_commit(ui_proto_t *p, size_t n) {
+    size_t start = 0;
+    size_t end = p->len + n;
+    p->stats.bytes += n;
+    for (size_t i = p->len; i < end; i++) {
+        if (p->buf[i] != 0) continue;
+        if (!p->discard) process_frame(p, p->buf + start, i - start);
+        p->discard = false;
+        start = i + 1;
+    }
+    if (p->discard) {
+        p->len = 0;
+        return;
+    }
+    // 未完成的帧移到缓冲开头，一次读取里通常只有它的前一部分
+    p->len = end - start;
+    if (start > 0 && p->len > 0) memmove(p->buf, p->buf + start, p->len);
+}
+
+void ui_proto_reset(ui_proto_t *p) {
+    p->len = 0;
+    p->discard = true;
+}
+
+void ui_proto_get_stats(const ui_proto_t *p, ui_proto_stats_t *stats) {
+    *stats = p->stats;
+}
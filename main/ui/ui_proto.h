@@ -0,0 +1,87 @@
+// ui_proto.h
+// 串口二进制命令协议：外部控制器用它驱动 ui.h 的全部接口。与硬件无关，板上由 uart_proto.c 接 UART，
+// 主机模拟器接 pty，参考编码器见 sim/scripts/uictl.py。
+//
+// 帧 = COBS(命令... + CRC16) + 0x00
+//   命令 = 操作码(1) + 参数长度(2, 小端) + 参数
+//   CRC16/CCITT-FALSE（多项式 0x1021，初值 0xFFFF）覆盖全部命令，小端附在末尾
+// 字符串参数以 '\0' 结尾并计入参数长度，解码后直接引用接收缓冲，不再拷贝。
+// 一帧内的全部命令在同一次 LVGL 处理中生效（见 ui_batch_begin）。
+#ifndef UI_PROTO_H
+#define UI_PROTO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UI_PROTO_FRAME_MAX 1024     // 解码前单帧最大字节数（不含分隔符）
+
+// 控制器 -> 设备，0x01~0x0E 与 ui_msg_type_t 一一对应（值为类型 + 1）
+typedef enum {
+    UI_PROTO_SET_TOP = 0x01,                // name\0 version\0
+    UI_PROTO_SET_STATUS_ITEM = 0x02,        // index(1) rgb(3) key\0 value\0
+    UI_PROTO_SET_BUTTON = 0x03,             // index(1) text\0；点击时回送 UI_PROTO_EVT_BUTTON
+    UI_PROTO_ADD_LOG = 0x04,                // text\0
+    UI_PROTO_SET_BOTTOM = 0x05,             // baudrate(4) ip\0 firmware_id\0
+    UI_PROTO_REFRESH_STATUS = 0x06,
+    UI_PROTO_CLEAR_LOG = 0x07,
+    UI_PROTO_SET_BUTTON_LONG_PRESS = 0x08,  // index(1)；长按时回送 UI_PROTO_EVT_BUTTON
+    UI_PROTO_SHOW_PLOT = 0x09,              // show(1)
+    UI_PROTO_FIND_LOG = 0x0A,               // level(1) text\0
+    UI_PROTO_JUMP_LOG = 0x0B,               // tick_ms(4)，0xFFFFFFFF 回到最新日志
+    UI_PROTO_SET_BUTTON_ICON = 0x0C,        // index(1) icon\0；空串去掉图标
+    UI_PROTO_SET_STATUS_ICON = 0x0D,        // index(1) icon\0；空串去掉图标
+    UI_PROTO_SET_BUTTON_TEXT = 0x0E,        // index(1) text\0；只改文字，保留点击和长按回调
+    UI_PROTO_PLOT_CONFIG = 0x20,            // channel(1) min(f32) max(f32) samples_per_px(4) rgb(3)
+    UI_PROTO_PLOT_PUSH = 0x21,              // channel(1) samples(f32 × n)
+    UI_PROTO_PING = 0x7F,                   // token(4)；回送 UI_PROTO_EVT_PONG
+    // 设备 -> 控制器
+    UI_PROTO_EVT_BUTTON = 0x80,             // index(1) long_press(1)
+    UI_PROTO_EVT_PONG = 0x81,               // token(4) frames(4) commands(4) errors(4)
+} ui_proto_op_t;
+
+typedef struct {
+    uint32_t bytes;                 // 收到的字节数
+    uint32_t frames;                // 校验通过的帧数
+    uint32_t commands;              // 执行的命令数
+    uint32_t crc_errors;
+    uint32_t cobs_errors;           // 编码错误或帧太短
+    uint32_t overflows;             // 超过 UI_PROTO_FRAME_MAX 被丢弃的帧
+    uint32_t bad_commands;          // 未知操作码或参数不完整（同帧后续命令仍执行）
+} ui_proto_stats_t;
+
+// 向控制器发送编码好的整帧（含分隔符）
+typedef void (*ui_proto_write_cb_t)(const uint8_t *data, size_t len, void *ctx);
+
+typedef struct {
+    uint8_t buf[UI_PROTO_FRAME_MAX];
+    size_t len;                     // 当前未完成帧已收到的字节数
+    bool discard;                   // 当前帧已溢出，丢弃到下一个分隔符
+    ui_proto_write_cb_t write;
+    void *ctx;
+    ui_proto_stats_t stats;
+} ui_proto_t;
+
+// 一个进程只有一个协议实例：按钮回调没有参数，事件发给最近一次 init 的实例
+void ui_proto_init(ui_proto_t *p, ui_proto_write_cb_t write, void *ctx);
+// 接收：把数据直接读进 rx_space 返回的位置（至少 1 字节），再 commit 读到的字节数，
+// 完整的帧就地解码并执行。只允许一个任务接收。
+uint8_t *ui_proto_rx_space(ui_proto_t *p, size_t *avail);
+void ui_proto_rx_commit(ui_proto_t *p, size_t n);
+// 丢弃未完成的帧（例如底层接收溢出后）
+void ui_proto_reset(ui_proto_t *p);
+void ui_proto_get_stats(const ui_proto_t *p, ui_proto_stats_t *stats);
+
+// 编码一帧：payload 为若干条命令，out 至少 ui_proto_encoded_max(len) 字节，返回帧长（含分隔符）
+size_t ui_proto_encoded_max(size_t payload_len);
+size_t ui_proto_encode(const uint8_t *payload, size_t len, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_PROTO_H
@@ -0,0 +1,248 @@
+// ui_ring.c
+// 条目布局（8 字节对齐，保证条目在缓冲内连续）：
+//   [len:2][type|pad:1][reserved:5][payload...]
+// 每个 8 字节槽另有一个提交字，放在数据区之后，不会被负载覆盖。
+// 生产者先用 CAS 预留 head，写完条目后以 release 语义把条目起始位置写入首槽的提交字。
+// 取出或丢弃条目的一方先用 CAS 把提交字从 tail 改成 tail + 1（不是 8 的倍数，不会等于任何条目位置）
+// 认领条目，认领成功后独占该条目直到推进 tail；提交字只在条目首槽写入且消费时清除，
+// 因此非空的提交字一定对应一个尚未取出的已提交条目，与缓冲里的旧数据无关。
+// 条目放不下到缓冲末尾时，先写一个填充条目再从 0 开始。
+#include "ui_ring.h"
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#else
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#define RING_HDR_SIZE   8u
+#define RING_ALIGN(n)   (((n) + 7u) & ~7u)
+#define RING_FLAG_PAD   0x80
+#define RING_TYPE_MASK  0x7F
+
+typedef struct {
+    uint16_t len;
+    uint8_t type;   // 低 7 位为类型，最高位为填充标记
+    uint8_t reserved[5];
+} ring_hdr_t;
+
+_Static_assert(sizeof(ring_hdr_t) == RING_HDR_SIZE, "ring header must fill one slot");
+
+#ifdef ESP_PLATFORM
+static uint32_t ring_now_ms(void) {
+    return (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+static void ring_sleep(void) {
+    vTaskDelay(1);
+}
+#else
+static uint32_t ring_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static void ring_sleep(void) {
+    usleep(1000);
+}
+#endif
+
+static inline ring_hdr_t *ring_hdr(ui_ring_t *ring, uint32_t pos) {
+    return (ring_hdr_t *)(ring->buf + (pos & (ring->size - 1)));
+}
+
+static inline _Atomic uint32_t *ring_commit(ui_ring_t *ring, uint32_t pos) {
+    return &ring->commit[(pos & (ring->size - 1)) / RING_HDR_SIZE];
+}
+
+// 认领 tail 处已提交的条目，成功后由调用方读取条目并推进 tail
+static inline bool ring_claim(ui_ring_t *ring, uint32_t tail) {
+    uint32_t expected = tail;
+    return atomic_compare_exchange_strong_explicit(ring_commit(ring, tail), &expected, tail + 1,
+                                                   memory_order_acquire, memory_order_relaxed);
+}
+
+static void ring_update_high_water(ui_ring_t *ring, uint32_t used) {
+    uint32_t hw = atomic_load_explicit(&ring->high_water, memory_order_relaxed);
+    while (used > hw &&
+           !atomic_compare_exchange_weak_explicit(&ring->high_water, &hw, used,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+void ui_ring_init(ui_ring_t *ring, void *buf, uint32_t size, ui_ring_policy_t policy, uint32_t timeout_ms) {
+    ring->buf = (uint8_t *)buf;
+    ring->commit = (_Atomic uint32_t *)(ring->buf + size);
+    ring->size = size;
+    ring->policy = policy;
+    ring->timeout_ms = timeout_ms;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->pushed, 0);
+    atomic_init(&ring->popped, 0);
+    atomic_init(&ring->dropped, 0);
+    atomic_init(&ring->high_water, 0);
+    // 位置从 0 开始计数，提交字预先写入不可能匹配的值
+    for (uint32_t pos = 0; pos < size; pos += RING_HDR_SIZE) {
+        atomic_init(ring_commit(ring, pos), pos + 1);
+    }
+}
+
+void ui_ring_set_policy(ui_ring_t *ring, ui_ring_policy_t policy, uint32_t timeout_ms) {
+    ring->timeout_ms = timeout_ms;
+    ring->policy = policy;
+}
+
+// 丢弃最旧的条目。返回 true 表示 tail 已前进（由本次丢弃或其他一方），调用方重新检查空间；
+// 最旧条目尚未提交或正被消费者取出时返回 false。
+static bool ring_drop_oldest(ui_ring_t *ring, uint32_t tail) {
+    if (!ring_claim(ring, tail)) {
+        return atomic_load_explicit(&ring->tail, memory_order_acquire) != tail;
+    }
+    const ring_hdr_t *hdr = ring_hdr(ring, tail);
+    const bool pad = hdr->type & RING_FLAG_PAD;
+    atomic_store_explicit(&ring->tail, tail + RING_HDR_SIZE + RING_ALIGN(hdr->len), memory_order_release);
+    if (!pad) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+    }
+    return true;
+}
+
+static bool ring_pushv(ui_ring_t *ring, uint8_t type, const ui_ring_seg_t *segs, int seg_count, bool may_wait) {
+    uint32_t len = 0;
+    for (int i = 0; i < seg_count; i++) {
+        len += segs[i].len;
+    }
+    const uint32_t need = RING_HDR_SIZE + RING_ALIGN(len);
+    if (type > RING_TYPE_MASK || len > UINT16_MAX || need > ring->size / 2) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return false;
+    }
+
+    const uint32_t mask = ring->size - 1;
+    uint32_t wait_start = 0;
+    bool waiting = false;
+    uint32_t head, tail, total;
+    for (;;) {
+        head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        uint32_t contig = ring->size - (head & mask);
+        total = (need <= contig) ? need : contig + need;
+
+        if (head + total - tail > ring->size) {
+            if (ring->policy == UI_RING_DROP_OLDEST && ring_drop_oldest(ring, tail)) {
+                continue;
+            }
+            if (ring->policy == UI_RING_BLOCK && may_wait) {
+                uint32_t now = ring_now_ms();
+                if (!waiting) {
+                    waiting = true;
+                    wait_start = now;
+                }
+                if (now - wait_start < ring->timeout_ms) {
+                    ring_sleep();
+                    continue;
+                }
+            }
+            atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+            return false;
+        }
+        if (atomic_compare_exchange_weak_explicit(&ring->head, &head, head + total,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    uint32_t pos = head;
+    if (total != need) {
+        ring_hdr_t *pad = ring_hdr(ring, pos);
+        uint32_t contig = total - need;
+        pad->len = (uint16_t)(contig - RING_HDR_SIZE);
+        pad->type = RING_FLAG_PAD;
+        atomic_store_explicit(ring_commit(ring, pos), pos, memory_order_release);
+        pos += contig;
+    }
+
+    ring_hdr_t *hdr = ring_hdr(ring, pos);
+    hdr->len = (uint16_t)len;
+    hdr->type = type;
+    uint8_t *dst = (uint8_t *)(hdr + 1);
+    for (int i = 0; i < seg_count; i++) {
+        if (segs[i].len) {
+            memcpy(dst, segs[i].data, segs[i].len);
+            dst += segs[i].len;
+        }
+    }
+    atomic_store_explicit(ring_commit(ring, pos), pos, memory_order_release);
+
+    atomic_fetch_add_explicit(&ring->pushed, 1, memory_order_relaxed);
+    ring_update_high_water(ring, head + total - tail);
+    return true;
+}
+
+bool ui_ring_pushv(ui_ring_t *ring, uint8_t type, const ui_ring_seg_t *segs, int seg_count) {
+    return ring_pushv(ring, type, segs, seg_count, true);
+}
+
+bool ui_ring_try_pushv(ui_ring_t *ring, uint8_t type, const ui_ring_seg_t *segs, int seg_count) {
+    return ring_pushv(ring, type, segs, seg_count, false);
+}
+
+bool ui_ring_push(ui_ring_t *ring, uint8_t type, const void *data, uint32_t len) {
+    ui_ring_seg_t seg = { data, len };
+    return ui_ring_pushv(ring, type, &seg, 1);
+}
+
+int ui_ring_pop(ui_ring_t *ring, uint8_t *type, void *out, uint32_t out_size) {
+    for (;;) {
+        uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (tail == atomic_load_explicit(&ring->head, memory_order_acquire)) {
+            return -1;
+        }
+        if (!ring_claim(ring, tail)) {
+            // 尚未提交，或刚被 DROP_OLDEST 的生产者丢弃（tail 已前进）
+            if (atomic_load_explicit(&ring->tail, memory_order_acquire) == tail) {
+                return -1;
+            }
+            continue;
+        }
+        const ring_hdr_t *hdr = ring_hdr(ring, tail);
+        uint32_t len = hdr->len;
+        uint8_t entry_type = hdr->type & RING_TYPE_MASK;
+        bool pad = hdr->type & RING_FLAG_PAD;
+        uint32_t next = tail + RING_HDR_SIZE + RING_ALIGN(len);
+        bool fits = !pad && len <= out_size &&
+                    (tail & (ring->size - 1)) + RING_HDR_SIZE + len <= ring->size;
+        if (fits) {
+            memcpy(out, hdr + 1, len);
+        }
+        // 已认领，拷贝完才推进 tail，生产者不会覆盖正在读的条目
+        atomic_store_explicit(&ring->tail, next, memory_order_release);
+        if (pad) {
+            continue;
+        }
+        if (!fits) {
+            atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+            continue;
+        }
+        atomic_fetch_add_explicit(&ring->popped, 1, memory_order_relaxed);
+        if (type) *type = entry_type;
+        return (int)len;
+    }
+}
+
+void ui_ring_get_stats(ui_ring_t *ring, ui_ring_stats_t *stats) {
+    if (!stats) return;
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    stats->pushed = atomic_load_explicit(&ring->pushed, memory_order_relaxed);
+    stats->popped = atomic_load_explicit(&ring->popped, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+    stats->high_water = atomic_load_explicit(&ring->high_water, memory_order_relaxed);
+    stats->used = head - tail;
+    stats->size = ring->size;
+}
@@ -0,0 +1,72 @@
+// ui_ring.h
+// 无锁多生产者 / 单消费者字节环形队列，条目变长（长度前缀）。
+// 不依赖 FreeRTOS，可在主机上用 pthread 直接测试。
+#ifndef UI_RING_H
+#define UI_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    UI_RING_DROP_NEWEST,    // 满时丢弃新条目（默认，生产者从不等待）
+    UI_RING_DROP_OLDEST,    // 满时丢弃最旧的已提交条目
+    UI_RING_BLOCK,          // 满时等待，超时后丢弃新条目
+} ui_ring_policy_t;
+
+typedef struct {
+    const void *data;
+    uint32_t len;
+} ui_ring_seg_t;
+
+typedef struct {
+    uint32_t pushed;        // 成功写入的条目数
+    uint32_t popped;        // 成功取出的条目数
+    uint32_t dropped;       // 丢弃的条目数（满 / 过大 / 被覆盖）
+    uint32_t used;          // 当前占用字节数
+    uint32_t high_water;    // 历史最高占用字节数
+    uint32_t size;          // 总字节数
+} ui_ring_stats_t;
+
+// 缓冲字节数：size 字节数据区，后接每 8 字节一个 4 字节提交字
+#define UI_RING_MEM_SIZE(size) ((size) + (size) / 2)
+
+typedef struct {
+    uint8_t *buf;
+    _Atomic uint32_t *commit;       // 每 8 字节槽一个，位于 buf + size
+    uint32_t size;                  // 2 的幂
+    ui_ring_policy_t policy;
+    uint32_t timeout_ms;            // 仅 UI_RING_BLOCK 使用
+    _Atomic uint32_t head;          // 生产者预留位置（字节，单调递增）
+    _Atomic uint32_t tail;          // 消费位置（字节，单调递增）
+    _Atomic uint32_t pushed;
+    _Atomic uint32_t popped;
+    _Atomic uint32_t dropped;
+    _Atomic uint32_t high_water;
+} ui_ring_t;
+
+// buf 需 8 字节对齐、至少 UI_RING_MEM_SIZE(size) 字节，size 为 2 的幂
+void ui_ring_init(ui_ring_t *ring, void *buf, uint32_t size, ui_ring_policy_t policy, uint32_t timeout_ms);
+void ui_ring_set_policy(ui_ring_t *ring, ui_ring_policy_t policy, uint32_t timeout_ms);
+
+// 多个生产者可并发调用；各段按顺序拼接成一个条目的负载
+bool ui_ring_pushv(ui_ring_t *ring, uint8_t type, const ui_ring_seg_t *segs, int seg_count);
+bool ui_ring_push(ui_ring_t *ring, uint8_t type, const void *data, uint32_t len);
+// 同 ui_ring_pushv，但 UI_RING_BLOCK 策略下也不等待，满时直接丢弃（DROP_OLDEST 仍丢弃最旧条目）
+bool ui_ring_try_pushv(ui_ring_t *ring, uint8_t type, const ui_ring_seg_t *segs, int seg_count);
+
+// 仅单个消费者调用。返回负载长度，队列为空（或队首尚未提交）时返回 -1。
+// 负载超过 out_size 的条目被丢弃并计入 dropped。
+int ui_ring_pop(ui_ring_t *ring, uint8_t *type, void *out, uint32_t out_size);
+
+void ui_ring_get_stats(ui_ring_t *ring, ui_ring_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_RING_H
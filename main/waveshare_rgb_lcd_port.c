@@ -5,12 +5,30 @@
  */
 
 #include "waveshare_rgb_lcd_port.h"
+#include "boot_prof.h"
+#include "scan_mon.h"
+
+static uint8_t ch422g_out = 0x1E; // CH422G output register (EXIO1-EXIO8), only the backlight bit is changed later
 
 // VSYNC event callback function
 IRAM_ATTR static bool rgb_lcd_on_vsync_event(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *edata, void *user_ctx)
 {
+    scan_mon_vsync_isr();
+#if EXAMPLE_RGB_BOUNCE_BUFFER_SIZE > 0
+    return false; // LVGL is notified once the bounce buffer has taken the last lines of the frame
+#else
+    return lvgl_port_notify_rgb_vsync();
+#endif
+}
+
+#if EXAMPLE_RGB_BOUNCE_BUFFER_SIZE > 0
+// Bounce buffer frame finish callback function, the last refill of a frame is done
+IRAM_ATTR static bool rgb_lcd_on_bounce_frame_finish(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *edata, void *user_ctx)
+{
+    scan_mon_bounce_frame_isr();
     return lvgl_port_notify_rgb_vsync();
 }
+#endif
 
 #if CONFIG_EXAMPLE_LCD_TOUCH_CONTROLLER_GT911
 /**
@@ -51,7 +69,7 @@ void gpio_init(void)
     gpio_config(&io_conf);
 }
 
-// Reset the touch screen
+// Reset the touch screen, sleeps about 400 ms, so it runs on its own task
 void waveshare_esp32_s3_touch_reset()
 {
     uint8_t write_buf = 0x01;
@@ -60,12 +78,94 @@ void waveshare_esp32_s3_touch_reset()
     // Reset the touch screen. It is recommended to reset the touch screen before using it.
     write_buf = 0x2C;
     i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    esp_rom_delay_us(100 * 1000);
-    gpio_set_level(GPIO_INPUT_IO_4, 0);
-    esp_rom_delay_us(100 * 1000);
+    vTaskDelay(pdMS_TO_TICKS(100));
+    gpio_set_level(GPIO_INPUT_IO_4, 0); // INT low while reset is released selects the GT911 address 0x5D
+    vTaskDelay(pdMS_TO_TICKS(100));
     write_buf = 0x2E;
     i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    esp_rom_delay_us(200 * 1000);
+    ch422g_out = write_buf;
+    vTaskDelay(pdMS_TO_TICKS(200));
+}
+
+static void rgb_lcd_backlight(bool on)
+{
+    if (on) {
+        wavesahre_rgb_lcd_bl_on();
+    } else {
+        wavesahre_rgb_lcd_bl_off();
+    }
+}
+
+static TaskHandle_t touch_init_task_handle = NULL;
+
+// Bring up the touch controller while the panel and LVGL start on the calling core
+static void touch_init_task(void *arg)
+{
+    int prof = boot_prof_begin("touch reset");
+    ESP_LOGI(TAG, "Initialize I2C bus");   // Log the initialization of the I2C bus
+    i2c_master_init();                     // Initialize the I2C master
+    gpio_init();                           // Initialize GPIO pins
+    waveshare_esp32_s3_touch_reset();      // Reset the touch panel
+    boot_prof_end(prof);
+
+    prof = boot_prof_begin("GT911 probe");
+    esp_lcd_panel_io_handle_t tp_io_handle = NULL;                                          // Declare a handle for touch panel I/O
+    const esp_lcd_panel_io_i2c_config_t tp_io_config = ESP_LCD_TOUCH_IO_I2C_GT911_CONFIG(); // Configure I2C for GT911 touch controller
+
+    ESP_LOGI(TAG, "Initialize I2C panel IO");                                                                          // Log I2C panel I/O initialization
+    ESP_ERROR_CHECK(esp_lcd_new_panel_io_i2c((esp_lcd_i2c_bus_handle_t)I2C_MASTER_NUM, &tp_io_config, &tp_io_handle)); // Create new I2C panel I/O
+
+    ESP_LOGI(TAG, "Initialize touch controller GT911"); // Log touch controller initialization
+    const esp_lcd_touch_config_t tp_cfg = {
+        .x_max = EXAMPLE_LCD_H_RES,                // Set maximum X coordinate
+        .y_max = EXAMPLE_LCD_V_RES,                // Set maximum Y coordinate
+        .rst_gpio_num = EXAMPLE_PIN_NUM_TOUCH_RST, // GPIO number for reset
+        .int_gpio_num = EXAMPLE_PIN_NUM_TOUCH_INT, // GPIO number for interrupt
+        .levels = {
+            .reset = 0,     // Reset level
+            .interrupt = 0, // Interrupt level
+        },
+        .flags = {
+#if EXAMPLE_LVGL_PORT_ROTATION_90
+            .swap_xy = 1,  // Map panel coordinates back to the rotated LVGL screen
+            .mirror_x = 1,
+            .mirror_y = 0,
+#elif EXAMPLE_LVGL_PORT_ROTATION_180
+            .swap_xy = 0,
+            .mirror_x = 1,
+            .mirror_y = 1,
+#elif EXAMPLE_LVGL_PORT_ROTATION_270
+            .swap_xy = 1,
+            .mirror_x = 0,
+            .mirror_y = 1,
+#else
+            .swap_xy = 0,  // No swap of X and Y
+            .mirror_x = 0, // No mirroring of X
+            .mirror_y = 0, // No mirroring of Y
+#endif
+        },
+    };
+    esp_lcd_touch_handle_t tp_handle = NULL;                                         // Declare a handle for the touch panel
+    ESP_ERROR_CHECK(esp_lcd_touch_new_i2c_gt911(tp_io_handle, &tp_cfg, &tp_handle)); // Create new I2C GT911 touch controller
+    boot_prof_end(prof);
+
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY); // Wait for lvgl_port_init()
+    ESP_ERROR_CHECK(lvgl_port_attach_touch(tp_handle)); // Register the touch panel with LVGL
+    lvgl_port_set_backlight_cb(rgb_lcd_backlight);      // Only a touch turns the backlight back on
+    touch_init_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+static void touch_init_start(void)
+{
+    /* The other core: app_main() keeps running the panel and LVGL init on this one */
+    BaseType_t core_id = (portNUM_PROCESSORS > 1) ? !xPortGetCoreID() : tskNO_AFFINITY;
+    BaseType_t ret = xTaskCreatePinnedToCore(touch_init_task, "touch init", TOUCH_INIT_TASK_STACK_SIZE, NULL,
+                                             TOUCH_INIT_TASK_PRIORITY, &touch_init_task_handle, core_id);
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create touch init task, touch disabled");
+        touch_init_task_handle = NULL;
+    }
 }
 
 #endif
@@ -73,6 +173,11 @@ void waveshare_esp32_s3_touch_reset()
 // Initialize RGB LCD
 esp_err_t waveshare_esp32_s3_rgb_lcd_init()
 {
+#if CONFIG_EXAMPLE_LCD_TOUCH_CONTROLLER_GT911
+    touch_init_start(); // The touch reset sleeps about 400 ms, it overlaps with everything below
+#endif
+
+    int prof = boot_prof_begin("RGB panel");
     ESP_LOGI(TAG, "Install RGB LCD panel driver"); // Log the start of the RGB LCD panel driver installation
     esp_lcd_panel_handle_t panel_handle = NULL;    // Declare a handle for the LCD panel
     esp_lcd_rgb_panel_config_t panel_config = {
@@ -139,50 +244,34 @@ esp_err_t waveshare_esp32_s3_rgb_lcd_init()
 
     ESP_LOGI(TAG, "Initialize RGB LCD panel");         // Log the initialization of the RGB LCD panel
     ESP_ERROR_CHECK(esp_lcd_panel_init(panel_handle)); // Initialize the LCD panel
-
-    esp_lcd_touch_handle_t tp_handle = NULL; // Declare a handle for the touch panel
-#if CONFIG_EXAMPLE_LCD_TOUCH_CONTROLLER_GT911
-    ESP_LOGI(TAG, "Initialize I2C bus");   // Log the initialization of the I2C bus
-    i2c_master_init();                     // Initialize the I2C master
-    ESP_LOGI(TAG, "Initialize GPIO");      // Log GPIO initialization
-    gpio_init();                           // Initialize GPIO pins
-    ESP_LOGI(TAG, "Initialize Touch LCD"); // Log touch LCD initialization
-    waveshare_esp32_s3_touch_reset();      // Reset the touch panel
-
-    esp_lcd_panel_io_handle_t tp_io_handle = NULL;                                          // Declare a handle for touch panel I/O
-    const esp_lcd_panel_io_i2c_config_t tp_io_config = ESP_LCD_TOUCH_IO_I2C_GT911_CONFIG(); // Configure I2C for GT911 touch controller
-
-    ESP_LOGI(TAG, "Initialize I2C panel IO");                                                                          // Log I2C panel I/O initialization
-    ESP_ERROR_CHECK(esp_lcd_new_panel_io_i2c((esp_lcd_i2c_bus_handle_t)I2C_MASTER_NUM, &tp_io_config, &tp_io_handle)); // Create new I2C panel I/O
-
-    ESP_LOGI(TAG, "Initialize touch controller GT911"); // Log touch controller initialization
-    const esp_lcd_touch_config_t tp_cfg = {
-        .x_max = EXAMPLE_LCD_H_RES,                // Set maximum X coordinate
-        .y_max = EXAMPLE_LCD_V_RES,                // Set maximum Y coordinate
-        .rst_gpio_num = EXAMPLE_PIN_NUM_TOUCH_RST, // GPIO number for reset
-        .int_gpio_num = EXAMPLE_PIN_NUM_TOUCH_INT, // GPIO number for interrupt
-        .levels = {
-            .reset = 0,     // Reset level
-            .interrupt = 0, // Interrupt level
-        },
-        .flags = {
-            .swap_xy = 0,  // No swap of X and Y
-            .mirror_x = 0, // No mirroring of X
-            .mirror_y = 0, // No mirroring of Y
-        },
+    boot_prof_end(prof);
+
+    const scan_mon_timing_t scan_timing = {
+        .pclk_hz = panel_config.timings.pclk_hz,
+        .h_res = EXAMPLE_LCD_H_RES,
+        .v_res = EXAMPLE_LCD_V_RES,
+        .h_total = EXAMPLE_LCD_H_RES + panel_config.timings.hsync_pulse_width + panel_config.timings.hsync_back_porch +
+                   panel_config.timings.hsync_front_porch,
+        .v_total = EXAMPLE_LCD_V_RES + panel_config.timings.vsync_pulse_width + panel_config.timings.vsync_back_porch +
+                   panel_config.timings.vsync_front_porch,
+        .bounce_lines = EXAMPLE_RGB_BOUNCE_BUFFER_SIZE / EXAMPLE_LCD_H_RES,
+        .bytes_per_pixel = EXAMPLE_RGB_BIT_PER_PIXEL / 8,
     };
-    ESP_ERROR_CHECK(esp_lcd_touch_new_i2c_gt911(tp_io_handle, &tp_cfg, &tp_handle)); // Create new I2C GT911 touch controller
-#endif                                                                               // CONFIG_EXAMPLE_LCD_TOUCH_CONTROLLER_GT911
+    scan_mon_init(panel_handle, &scan_timing); // Bounce buffer refill and PSRAM bandwidth counters
 
-    ESP_ERROR_CHECK(lvgl_port_init(panel_handle, tp_handle)); // Initialize LVGL with the panel and touch handles
+    ESP_ERROR_CHECK(lvgl_port_init(panel_handle, NULL)); // Initialize LVGL with the panel, the touch panel is attached later
+#if CONFIG_EXAMPLE_LCD_TOUCH_CONTROLLER_GT911
+    if (touch_init_task_handle) {
+        xTaskNotifyGive(touch_init_task_handle); // LVGL can register the touch panel now
+    }
+#endif
 
     // Register callbacks for RGB panel events
     esp_lcd_rgb_panel_event_callbacks_t cbs = {
 #if EXAMPLE_RGB_BOUNCE_BUFFER_SIZE > 0
-        .on_bounce_frame_finish = rgb_lcd_on_vsync_event, // Callback for bounce frame finish
-#else
-        .on_vsync = rgb_lcd_on_vsync_event, // Callback for vertical sync
+        .on_bounce_frame_finish = rgb_lcd_on_bounce_frame_finish, // Callback for bounce frame finish
 #endif
+        .on_vsync = rgb_lcd_on_vsync_event, // Callback for vertical sync
     };
     ESP_ERROR_CHECK(esp_lcd_rgb_panel_register_event_callbacks(panel_handle, &cbs, NULL)); // Register event callbacks
 
@@ -196,8 +285,9 @@ esp_err_t wavesahre_rgb_lcd_bl_on()
     uint8_t write_buf = 0x01;
     i2c_master_write_to_device(I2C_MASTER_NUM, 0x24, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
 
-    // Pull the backlight pin high to light the screen backlight
-    write_buf = 0x1E;
+    // Pull the backlight pin high to light the screen backlight, keep the touch reset and other outputs
+    ch422g_out |= CH422G_EXIO_BL;
+    write_buf = ch422g_out;
     i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
     return ESP_OK;
 }
@@ -210,7 +300,8 @@ esp_err_t wavesahre_rgb_lcd_bl_off()
     i2c_master_write_to_device(I2C_MASTER_NUM, 0x24, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
 
     // Turn off the screen backlight by pulling the backlight pin low
-    write_buf = 0x1A;
+    ch422g_out &= ~CH422G_EXIO_BL;
+    write_buf = ch422g_out;
     i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
     return ESP_OK;
 }
@@ -22,6 +22,11 @@
 #define I2C_MASTER_RX_BUF_DISABLE   0                          /*!< I2C master doesn't need buffer */
 #define I2C_MASTER_TIMEOUT_MS       1000
 
+#define TOUCH_INIT_TASK_STACK_SIZE  (4 * 1024)   // Touch reset and GT911 probe, runs once at boot
+#define TOUCH_INIT_TASK_PRIORITY    (5)          // Above the LVGL task, the task mostly sleeps
+
+#define CH422G_EXIO_BL              (1 << 2)     // CH422G output driving the LCD backlight
+
 #define GPIO_INPUT_IO_4    4
 #define GPIO_INPUT_PIN_SEL  1ULL<<GPIO_INPUT_IO_4
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -68,7 +73,7 @@
 #define EXAMPLE_LCD_BK_LIGHT_OFF_LEVEL  !EXAMPLE_LCD_BK_LIGHT_ON_LEVEL
 
 #define EXAMPLE_PIN_NUM_TOUCH_RST       (-1)            // -1 if not used
-#define EXAMPLE_PIN_NUM_TOUCH_INT       (-1)            // -1 if not used
+#define EXAMPLE_PIN_NUM_TOUCH_INT       (GPIO_INPUT_IO_4) // -1 if not used, drives the touch sampler task
 
 static const char *TAG = "example";
 
@@ -0,0 +1,69 @@
+// lv_conf.h (simulator)
+// 与 sdkconfig 中的 LVGL 配置保持一致，未列出的选项使用 lv_conf_internal.h 的默认值
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#include <stdint.h>
+
+#define LV_COLOR_DEPTH 16
+#define LV_COLOR_16_SWAP 0
+#define LV_COLOR_SCREEN_TRANSP 1
+#define LV_COLOR_MIX_ROUND_OFS 128     // 与 sdkconfig 相同，lvgl_draw.c 的混合内核按此舍入
+
+// 默认与板上一样使用 main/lvgl_mem.c；-DSIM_LVGL_MEM=OFF 改用 malloc，便于 valgrind / heaptrack 跟踪
+#define LV_MEM_CUSTOM 1
+#if SIM_LVGL_MEM
+#define LV_MEM_CUSTOM_INCLUDE "lvgl_mem.h"
+#define LV_MEM_CUSTOM_ALLOC lvgl_mem_alloc
+#define LV_MEM_CUSTOM_FREE lvgl_mem_free
+#define LV_MEM_CUSTOM_REALLOC lvgl_mem_realloc
+#else
+#define LV_MEM_CUSTOM_INCLUDE <stdlib.h>
+#define LV_MEM_CUSTOM_ALLOC malloc
+#define LV_MEM_CUSTOM_FREE free
+#define LV_MEM_CUSTOM_REALLOC realloc
+#endif
+#define LV_MEMCPY_MEMSET_STD 1
+
+#define LV_DISP_DEF_REFR_PERIOD 50
+#define LV_INDEV_DEF_READ_PERIOD 30
+
+// tick 来自模拟器时钟（真实时间或固定步长）
+#define LV_TICK_CUSTOM 1
+#define LV_TICK_CUSTOM_INCLUDE "sim.h"
+#define LV_TICK_CUSTOM_SYS_TIME_EXPR (sim_tick_ms())
+
+#define LV_DRAW_COMPLEX 1
+#define LV_IMG_CACHE_DEF_SIZE 0
+
+#define LV_USE_LOG 1
+#define LV_LOG_LEVEL LV_LOG_LEVEL_WARN
+#define LV_LOG_PRINTF 1
+
+#define LV_USE_ASSERT_NULL 1
+#define LV_USE_ASSERT_MALLOC 1
+
+// 板上开启了性能监视器，模拟器关闭以保证导出的帧可复现
+#define LV_USE_PERF_MONITOR 0
+#define LV_USE_USER_DATA 1
+
+#define LV_FONT_MONTSERRAT_12 1
+#define LV_FONT_MONTSERRAT_14 0
+#define LV_FONT_MONTSERRAT_16 1
+#define LV_FONT_MONTSERRAT_20 1
+#define LV_FONT_DEFAULT &lv_font_montserrat_20
+#define LV_USE_FONT_COMPRESSED 1
+#define LV_USE_FONT_PLACEHOLDER 1
+
+#define LV_LABEL_TEXT_SELECTION 1
+#define LV_LABEL_LONG_TXT_HINT 1
+
+#define LV_USE_SNAPSHOT 1
+
+// --font-check 用 lv_font_load() 读取同一个字体文件作为参照，路径前加 "S:"
+#define LV_USE_FS_STDIO 1
+#define LV_FS_STDIO_LETTER 'S'
+#define LV_FS_STDIO_PATH ""
+#define LV_FS_STDIO_CACHE_SIZE 0
+
+#endif // LV_CONF_H
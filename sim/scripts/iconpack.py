@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+"""Pack PNG icons into the atlas read by main/ui/ui_icon.c (icon partition or the simulator's --icons).
+
+Each --page starts a new atlas page. The board decodes a whole page on the first use of one of its icons and keeps
+it in the PSRAM cache, so put the icons that are shown together (a status row, the button bar) on the same page.
+Icons are named after their file name without the extension, at most 15 bytes.
+
+    sim/scripts/iconpack.py -o icons.bin --page status/*.png --page buttons/*.png
+    sim/scripts/iconpack.py -o icons.bin --demo             # the icons used by main.c and the simulator demo
+    parttool.py write_partition --partition-name icons --input icons.bin
+    ./build-sim/unicontroller_sim --step 10 --icons icons.bin --frames 100
+
+Format (little endian): header "UICN", version u16, page count u16, icon count u16, 6 reserved bytes; page table
+(data offset u32, width u16, height u16); icon table (name char[16], page u16, x u16, y u16, width u16, height u16,
+reserved u16); then per page an RGB565 plane followed by an A8 plane.
+"""
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = b"UICN"
+VERSION = 1
+NAME_MAX = 15
+PAGE_DIM_MAX = 2048
+
+
+class Icon:
+    def __init__(self, name, w, h, rgba):
+        self.name = name
+        self.w = w
+        self.h = h
+        self.rgba = rgba        # w * h tuples (r, g, b, a)
+        self.page = 0
+        self.x = 0
+        self.y = 0
+
+
+def read_png(path):
+    """8-bit, non-interlaced gray, gray + alpha, RGB or RGBA PNG -> (w, h, [(r, g, b, a)])."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("%s: not a PNG file" % path)
+    pos = 8
+    idat = b""
+    w = h = depth = color = interlace = None
+    while pos < len(data):
+        length, kind = struct.unpack_from(">I4s", data, pos)
+        body = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b"IHDR":
+            w, h, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", body)
+        elif kind == b"IDAT":
+            idat += body
+        elif kind == b"IEND":
+            break
+    channels = {0: 1, 2: 3, 4: 2, 6: 4}.get(color)
+    if depth != 8 or channels is None or interlace:
+        raise ValueError("%s: only 8-bit non-interlaced gray / RGB / RGBA PNGs are supported" % path)
+    raw = zlib.decompress(idat)
+    stride = w * channels
+    rows = []
+    prev = bytearray(stride)
+    pos = 0
+    for _ in range(h):
+        kind = raw[pos]
+        line = bytearray(raw[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        for i in range(stride):
+            a = line[i - channels] if i >= channels else 0
+            b = prev[i]
+            c = prev[i - channels] if i >= channels else 0
+            if kind == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif kind == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif kind == 3:
+                line[i] = (line[i] + (a + b) // 2) & 0xFF
+            elif kind == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                pred = a if pa <= pb and pa <= pc else (b if pb <= pc else c)
+                line[i] = (line[i] + pred) & 0xFF
+        rows.append(line)
+        prev = line
+    px = []
+    for line in rows:
+        for x in range(w):
+            v = line[x * channels:(x + 1) * channels]
+            if channels == 1:
+                px.append((v[0], v[0], v[0], 255))
+            elif channels == 2:
+                px.append((v[0], v[0], v[0], v[1]))
+            elif channels == 3:
+                px.append((v[0], v[1], v[2], 255))
+            else:
+                px.append(tuple(v))
+    return w, h, px
+
+
+def demo_icon(name, color, inside, size=24, ss=4):
+    """Anti-aliased icon: inside(x, y) on [-1, 1] coordinates, sampled ss x ss times per pixel."""
+    r, g, b = (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF
+    px = []
+    for y in range(size):
+        for x in range(size):
+            hits = 0
+            for sy in range(ss):
+                for sx in range(ss):
+                    u = ((x + (sx + 0.5) / ss) / size) * 2 - 1
+                    v = ((y + (sy + 0.5) / ss) / size) * 2 - 1
+                    hits += 1 if inside(u, v) else 0
+            px.append((r, g, b, hits * 255 // (ss * ss)))
+    return Icon(name, size, size, px)
+
+
+def demo_icons():
+    ring = lambda u, v, r0, r1: r0 * r0 <= u * u + v * v <= r1 * r1
+    status = [
+        demo_icon("temp", 0xFF5050, lambda u, v: (u * u + (v - 0.5) ** 2 <= 0.16) or (abs(u) <= 0.18 and -0.9 <= v <= 0.5)),
+        demo_icon("pressure", 0xFFFF40, lambda u, v: ring(u, v, 0.6, 0.9) or (abs(u + v) <= 0.15 and u <= 0 and u * u + v * v <= 0.5)),
+        demo_icon("mode", 0x40FFFF, lambda u, v: abs(u) + abs(v) <= 0.9 and not abs(u) + abs(v) <= 0.45),
+        demo_icon("flow", 0x4090FF, lambda u, v: (u * u + (v - 0.25) ** 2 <= 0.36) or (v < 0.25 and abs(u) <= (v + 0.95) * 0.6)),
+        demo_icon("error", 0xFFA020, lambda u, v: v <= 0.85 and abs(u) <= (v + 0.9) * 0.55 and not (abs(u) <= 0.1 and -0.3 <= v <= 0.55)),
+        demo_icon("uptime", 0x40FF40, lambda u, v: ring(u, v, 0.7, 0.9) or (abs(u) <= 0.09 and -0.55 <= v <= 0) or (abs(v) <= 0.09 and 0 <= u <= 0.45)),
+    ]
+    buttons = [
+        demo_icon("start", 0x40FF40, lambda u, v: -0.6 <= u and abs(v) <= (0.8 - u) * 0.6),
+        demo_icon("stop", 0xFF5050, lambda u, v: abs(u) <= 0.65 and abs(v) <= 0.65),
+        demo_icon("debug", 0xFF60FF, lambda u, v: ring(u, v, 0.55, 0.85) or u * u + v * v <= 0.09),
+        demo_icon("clear", 0xFFFFFF, lambda u, v: (abs(u - v) <= 0.2 or abs(u + v) <= 0.2) and abs(u) <= 0.75 and abs(v) <= 0.75),
+    ]
+    return [status, buttons]
+
+
+def layout(icons, max_width):
+    """Shelf packing, tallest first. Returns the page size."""
+    x = y = shelf_h = page_w = 0
+    for icon in sorted(icons, key=lambda i: (-i.h, i.name)):
+        if x and x + icon.w > max_width:
+            y += shelf_h
+            x = shelf_h = 0
+        icon.x, icon.y = x, y
+        x += icon.w
+        shelf_h = max(shelf_h, icon.h)
+        page_w = max(page_w, x)
+    return page_w, y + shelf_h
+
+
+def rgb565(r, g, b):
+    return ((r * 31 + 127) // 255) << 11 | ((g * 63 + 127) // 255) << 5 | ((b * 31 + 127) // 255)
+
+
+def pack(pages, max_width):
+    icons = [icon for page in pages for icon in page]
+    names = set()
+    for icon in icons:
+        if len(icon.name.encode()) > NAME_MAX:
+            raise ValueError("icon name %r is longer than %d bytes" % (icon.name, NAME_MAX))
+        if icon.name in names:
+            raise ValueError("duplicate icon name %r" % icon.name)
+        names.add(icon.name)
+    sizes = []
+    for index, page in enumerate(pages):
+        for icon in page:
+            icon.page = index
+        w, h = layout(page, max_width)
+        if w > PAGE_DIM_MAX or h > PAGE_DIM_MAX:
+            raise ValueError("page %d is %dx%d, at most %d per side" % (index, w, h, PAGE_DIM_MAX))
+        sizes.append((w, h))
+
+    offset = 16 + 8 * len(pages) + 28 * len(icons)
+    head = MAGIC + struct.pack("<HHH6x", VERSION, len(pages), len(icons))
+    table = b""
+    planes = b""
+    for (w, h), page in zip(sizes, pages):
+        table += struct.pack("<IHH", offset + len(planes), w, h)
+        color = [0] * (w * h)
+        alpha = bytearray(w * h)
+        for icon in page:
+            for k, (r, g, b, a) in enumerate(icon.rgba):
+                i = (icon.y + k // icon.w) * w + icon.x + k % icon.w
+                color[i] = rgb565(r, g, b)
+                alpha[i] = a
+        planes += struct.pack("<%dH" % len(color), *color) + bytes(alpha)
+    for icon in icons:
+        table += struct.pack("<16sHHHHHH", icon.name.encode(), icon.page, icon.x, icon.y, icon.w, icon.h, 0)
+    return head + table + planes, sizes
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("--page", nargs="+", action="append", default=[], metavar="PNG",
+                        help="icons of one atlas page, repeat for more pages")
+    parser.add_argument("--demo", action="store_true", help="add the demo icons (two pages)")
+    parser.add_argument("--page-width", type=int, default=256, help="maximum page width in pixels (default 256)")
+    args = parser.parse_args()
+
+    pages = demo_icons() if args.demo else []
+    for paths in args.page:
+        page = []
+        for path in paths:
+            w, h, px = read_png(path)
+            page.append(Icon(os.path.splitext(os.path.basename(path))[0], w, h, px))
+        pages.append(page)
+    if not pages:
+        parser.error("nothing to pack, pass --page or --demo")
+    try:
+        data, sizes = pack(pages, args.page_width)
+    except ValueError as e:
+        sys.exit(str(e))
+    with open(args.output, "wb") as f:
+        f.write(data)
+    for index, (w, h) in enumerate(sizes):
+        print("page%d=%dx%d icons=%d decoded_bytes=%d" % (index, w, h, len(pages[index]), w * h * 3))
+    print("atlas_bytes=%d" % len(data))
+
+
+if __name__ == "__main__":
+    main()
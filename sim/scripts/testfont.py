@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""Write the small test font used by the simulator's --font-check (sim/scripts/testfont.bin).
+
+The file has the layout that `lv_font_conv --format bin --no-compress --no-kerning` writes and LVGL's
+lv_font_load() reads: head, cmap, loca and glyf tables. The glyphs are generated shapes, not letters, so the font
+needs no source font and is reproducible byte for byte. It covers the parts of the format main/ui/ui_font.c has to
+get right:
+- all four cmap subtable types (lv_font_conv itself writes FORMAT0_TINY and SPARSE_TINY);
+- glyph records that are not byte aligned (25 descriptor bits), so every bitmap starts mid-byte;
+- negative offsets, an empty glyph (space) and two 26x26 glyphs larger than the simulator's 256 byte cache slot.
+
+    sim/scripts/testfont.py -o sim/scripts/testfont.bin
+    ./build-sim/unicontroller_sim --font-check sim/scripts/testfont.bin
+
+Any font from lv_font_conv can be passed to --font-check the same way.
+"""
+import argparse
+import struct
+
+SIZE = 16
+ASCENT = 13
+DESCENT = -3
+BPP = 4
+XY_BITS = 5
+WH_BITS = 5
+ADV_BITS = 5
+
+# lv_font_fmt_txt_cmap_type_t
+FORMAT0_FULL = 0
+SPARSE_FULL = 1
+FORMAT0_TINY = 2
+SPARSE_TINY = 3
+
+CJK = "中停力压度式止流温清行误试调运错除"
+CJK_BIG = "温度"
+FULLWIDTH = [0xFF01, 0xFF08, 0xFF09, 0xFF0C, 0xFF1A, 0xFF1F]
+
+
+def mix(n):
+    n = (n * 2654435761) & 0xFFFFFFFF
+    return n ^ (n >> 15)
+
+
+def shape(cp, w, h, ss=4):
+    """Anti-aliased shape picked by the code point, as BPP-bit alpha values."""
+    kind = mix(cp) % 5
+    ring = lambda u, v, r0, r1: r0 * r0 <= u * u + v * v <= r1 * r1
+    inside = [
+        lambda u, v: ring(u, v, 0.55, 0.95),
+        lambda u, v: max(abs(u), abs(v)) <= 0.95 and not max(abs(u), abs(v)) <= 0.6,
+        lambda u, v: abs(u - v) <= 0.3 or abs(u + v) <= 0.3,
+        lambda u, v: v <= 0.9 and abs(u) <= (v + 1) * 0.5,
+        lambda u, v: abs(u) <= 0.25 or abs(v) <= 0.25,
+    ][kind]
+    top = (1 << BPP) - 1
+    px = []
+    for y in range(h):
+        for x in range(w):
+            hits = 0
+            for sy in range(ss):
+                for sx in range(ss):
+                    u = ((x + (sx + 0.5) / ss) / w) * 2 - 1
+                    v = ((y + (sy + 0.5) / ss) / h) * 2 - 1
+                    hits += 1 if inside(u, v) else 0
+            px.append(hits * top // (ss * ss))
+    return px
+
+
+def make_glyph(cp):
+    """(adv, ofs_x, ofs_y, w, h, pixels) for a code point."""
+    if cp == 0x20:
+        return 4, 0, 0, 0, 0, []
+    r = mix(cp)
+    if chr(cp) in CJK_BIG:
+        w = h = 26
+        ofs_x, ofs_y = 0, -7
+    elif cp >= 0x3000:
+        w = 13 + r % 3
+        h = 13 + (r >> 4) % 3
+        ofs_x, ofs_y = r >> 8 & 1, -2 - (r >> 9) % 2
+    else:
+        w = 3 + r % 8
+        h = 5 + (r >> 4) % 8
+        ofs_x, ofs_y = (r >> 8) % 2, -3 + (r >> 9) % 4
+    return w + ofs_x + 1, ofs_x, ofs_y, w, h, shape(cp, w, h)
+
+
+class Bits:
+    def __init__(self):
+        self.out = bytearray()
+        self.n = 0
+
+    def put(self, value, bits):
+        for k in range(bits - 1, -1, -1):
+            if self.n % 8 == 0:
+                self.out.append(0)
+            if value >> k & 1:
+                self.out[-1] |= 0x80 >> (self.n % 8)
+            self.n += 1
+
+
+def glyph_record(adv, ofs_x, ofs_y, w, h, px):
+    b = Bits()
+    b.put(adv, ADV_BITS)
+    b.put(ofs_x & ((1 << XY_BITS) - 1), XY_BITS)
+    b.put(ofs_y & ((1 << XY_BITS) - 1), XY_BITS)
+    b.put(w, WH_BITS)
+    b.put(h, WH_BITS)
+    for p in px:
+        b.put(p, BPP)
+    return bytes(b.out)
+
+
+def align4(data):
+    return data + bytes(-len(data) % 4)
+
+
+def table(label, body):
+    body = align4(body)
+    return struct.pack("<I4s", 8 + len(body), label) + body
+
+
+def build():
+    # Glyph 0 is reserved; the ids follow the cmap order below
+    glyphs = [None]
+    cmaps = []
+
+    ascii_cps = list(range(0x20, 0x7F))
+    cmaps.append((FORMAT0_TINY, 0x20, len(ascii_cps), len(glyphs), b"", 0))
+    glyphs += ascii_cps
+
+    # FORMAT0_FULL: a u8 glyph id offset per code point, deliberately not in code point order
+    full_cps = list(range(0x3000, 0x3010))
+    order = sorted(range(len(full_cps)), key=lambda k: mix(k + 7))
+    ids = bytes(order.index(k) for k in range(len(full_cps)))
+    cmaps.append((FORMAT0_FULL, 0x3000, len(full_cps), len(glyphs), ids, len(full_cps)))
+    glyphs += [full_cps[k] for k in order]
+
+    # SPARSE_TINY: sorted u16 code point offsets, consecutive glyph ids
+    cjk_cps = sorted(ord(c) for c in CJK)
+    offsets = [cp - 0x4E00 for cp in cjk_cps]
+    cmaps.append((SPARSE_TINY, 0x4E00, offsets[-1] + 1, len(glyphs),
+                  struct.pack("<%dH" % len(offsets), *offsets), len(offsets)))
+    glyphs += cjk_cps
+
+    # SPARSE_FULL: u16 code point offsets followed by u16 glyph id offsets, reversed here
+    offsets = [cp - FULLWIDTH[0] for cp in FULLWIDTH]
+    ids = list(reversed(range(len(FULLWIDTH))))
+    cmaps.append((SPARSE_FULL, FULLWIDTH[0], offsets[-1] + 1, len(glyphs),
+                  struct.pack("<%dH" % (2 * len(offsets)), *(offsets + ids)), len(offsets)))
+    glyphs += [FULLWIDTH[ids.index(k)] for k in range(len(FULLWIDTH))]
+
+    # glyf: loca offsets are relative to the start of the table, including its 8 byte header
+    records = b""
+    loca = []
+    for cp in glyphs:
+        loca.append(8 + len(records))
+        records += glyph_record(0, 0, 0, 0, 0, []) if cp is None else glyph_record(*make_glyph(cp))
+    if 8 + len(records) > 0xFFFF:
+        raise ValueError("glyf table too large for 16-bit loca offsets")
+    glyf = table(b"glyf", records)
+    loca_table = table(b"loca", struct.pack("<I%dH" % len(loca), len(loca), *loca))
+
+    subtables = b""
+    data = b""
+    data_start = 12 + 16 * len(cmaps)
+    for kind, start, length, gid, body, entries in cmaps:
+        offset = data_start + len(data) if body else 0
+        subtables += struct.pack("<IIHHHBx", offset, start, length, gid, entries, kind)
+        data += align4(body)
+    cmap = table(b"cmap", struct.pack("<I", len(cmaps)) + subtables + data)
+
+    head = table(b"head", struct.pack(
+        "<IHHHhHhHhhHHBBBBBBBBBBhH",
+        1,                      # version
+        3,                      # tables: head, cmap, loca and glyf (no kern)
+        SIZE, ASCENT, DESCENT, ASCENT, DESCENT, 0, DESCENT, ASCENT,
+        0,                      # default advance width, unused with ADV_BITS > 0
+        0,                      # kerning scale
+        0,                      # 16-bit loca offsets
+        0,                      # glyph id format
+        0,                      # integer advance widths
+        BPP, XY_BITS, WH_BITS, ADV_BITS,
+        0,                      # no compression
+        0,                      # no subpixel rendering
+        0,
+        -2, 1))                 # underline position and thickness
+    return head + cmap + loca_table + glyf, len(glyphs), len(cmaps)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-o", "--output", required=True)
+    args = parser.parse_args()
+    data, glyph_count, cmap_count = build()
+    with open(args.output, "wb") as f:
+        f.write(data)
+    print("glyphs=%d cmaps=%d font_bytes=%d" % (glyph_count, cmap_count, len(data)))
+
+
+if __name__ == "__main__":
+    main()
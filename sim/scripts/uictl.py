@@ -0,0 +1,390 @@
+#!/usr/bin/env python3
+"""Reference host-side encoder for the UI command protocol (main/ui/ui_proto.h).
+
+A frame is COBS(commands + CRC16/CCITT-FALSE, little endian) followed by 0x00.
+A command is opcode(1) + argument length(2, little endian) + arguments.
+
+Drive the simulator over a pty:
+    ./build-sim/unicontroller_sim --uart pty          # prints uart_pty=/dev/pts/N on stderr
+    sim/scripts/uictl.py /dev/pts/N demo
+    sim/scripts/uictl.py /dev/pts/N --baud 921600 bench --commands 20000 --per-frame 16
+
+Or the board, on the UART set in menuconfig ("UART protocol"):
+    sim/scripts/uictl.py /dev/ttyUSB0 --baud 921600 bench
+"""
+import argparse
+import math
+import os
+import select
+import struct
+import sys
+import termios
+import time
+import tty
+
+SET_TOP = 0x01
+SET_STATUS_ITEM = 0x02
+SET_BUTTON = 0x03
+ADD_LOG = 0x04
+SET_BOTTOM = 0x05
+REFRESH_STATUS = 0x06
+CLEAR_LOG = 0x07
+SET_BUTTON_LONG_PRESS = 0x08
+SHOW_PLOT = 0x09
+FIND_LOG = 0x0A
+JUMP_LOG = 0x0B
+SET_BUTTON_ICON = 0x0C
+SET_STATUS_ICON = 0x0D
+SET_BUTTON_TEXT = 0x0E
+PLOT_CONFIG = 0x20
+PLOT_PUSH = 0x21
+PING = 0x7F
+EVT_BUTTON = 0x80
+EVT_PONG = 0x81
+
+FRAME_MAX = 1024  # UI_PROTO_FRAME_MAX, encoded bytes without the delimiter
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray(b"\x00")
+    code_pos, code = 0, 1
+    for b in data:
+        if b:
+            out.append(b)
+            code += 1
+        if not b or code == 0xFF:
+            out[code_pos] = code
+            code_pos, code = len(out), 1
+            out.append(0)
+    out[code_pos] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError("bad COBS block")
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def frame(commands):
+    payload = b"".join(commands)
+    return cobs_encode(payload + struct.pack("<H", crc16(payload))) + b"\x00"
+
+
+def cmd(op, args=b""):
+    return struct.pack("<BH", op, len(args)) + args
+
+
+def text(s):
+    return s.encode() + b"\x00"
+
+
+def rgb(value):
+    return bytes(((value >> 16) & 0xFF, (value >> 8) & 0xFF, value & 0xFF))
+
+
+def set_top(name, version):
+    return cmd(SET_TOP, text(name) + text(version))
+
+
+def set_status(index, key, value, color=0x00FF00):
+    return cmd(SET_STATUS_ITEM, bytes((index,)) + rgb(color) + text(key) + text(value))
+
+
+def set_button(index, label):
+    return cmd(SET_BUTTON, bytes((index,)) + text(label))
+
+
+def set_button_text(index, label):
+    return cmd(SET_BUTTON_TEXT, bytes((index,)) + text(label))
+
+
+def set_button_long_press(index):
+    return cmd(SET_BUTTON_LONG_PRESS, bytes((index,)))
+
+
+def set_button_icon(index, icon):
+    return cmd(SET_BUTTON_ICON, bytes((index,)) + text(icon))
+
+
+def set_status_icon(index, icon):
+    return cmd(SET_STATUS_ICON, bytes((index,)) + text(icon))
+
+
+def add_log(msg):
+    return cmd(ADD_LOG, text(msg))
+
+
+def set_bottom(ip, baudrate, firmware_id):
+    return cmd(SET_BOTTOM, struct.pack("<I", baudrate) + text(ip) + text(firmware_id))
+
+
+def show_plot(show):
+    return cmd(SHOW_PLOT, bytes((1 if show else 0,)))
+
+
+def find_log(needle, level=5):
+    return cmd(FIND_LOG, bytes((level,)) + text(needle))
+
+
+def jump_log(tick_ms):
+    return cmd(JUMP_LOG, struct.pack("<I", tick_ms))
+
+
+def plot_config(channel, lo, hi, samples_per_px, color):
+    return cmd(PLOT_CONFIG, struct.pack("<BffI", channel, lo, hi, samples_per_px) + rgb(color))
+
+
+def plot_push(channel, samples):
+    return cmd(PLOT_PUSH, bytes((channel,)) + struct.pack("<%df" % len(samples), *samples))
+
+
+def ping(token):
+    return cmd(PING, struct.pack("<I", token))
+
+
+class Link:
+    """Serial device or pty; with `baud` set on a pty, writes are paced to that line rate."""
+
+    def __init__(self, path, baud):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        tty.setraw(self.fd)
+        self.byte_s = 10.0 / baud if baud else 0.0  # 8N1: 10 bit times per byte
+        speed = getattr(termios, "B%d" % baud, None) if baud else None
+        if speed is not None:
+            attrs = termios.tcgetattr(self.fd)
+            attrs[4] = attrs[5] = speed
+            termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+        self.rx = bytearray()
+        self.sent = 0
+        self.start = time.monotonic()
+
+    def send(self, data):
+        if self.byte_s:
+            # Do not run ahead of the wire, otherwise a pty measures the decoder, not the link
+            due = self.start + (self.sent + len(data)) * self.byte_s
+            delay = due - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+        view = memoryview(data)
+        while view:
+            n = os.write(self.fd, view)
+            view = view[n:]
+        self.sent += len(data)
+
+    def events(self, timeout):
+        """Yield (opcode, args) for each event frame received within `timeout` seconds."""
+        end = time.monotonic() + timeout
+        while True:
+            while b"\x00" in self.rx:
+                raw, _, rest = bytes(self.rx).partition(b"\x00")
+                self.rx = bytearray(rest)
+                try:
+                    body = cobs_decode(raw)
+                except ValueError:
+                    continue
+                if len(body) < 2 or crc16(body[:-2]) != struct.unpack("<H", body[-2:])[0]:
+                    continue
+                payload, off = body[:-2], 0
+                while off + 3 <= len(payload):
+                    op, n = struct.unpack_from("<BH", payload, off)
+                    yield op, payload[off + 3:off + 3 + n]
+                    off += 3 + n
+            left = end - time.monotonic()
+            if left <= 0 or not select.select([self.fd], [], [], left)[0]:
+                return
+            self.rx += os.read(self.fd, 4096)
+
+
+def pack_frames(commands, per_frame):
+    """Group commands into frames of at most `per_frame` commands that fit UI_PROTO_FRAME_MAX."""
+    frames, batch = [], []
+    for c in commands:
+        if batch and (len(batch) == per_frame or len(frame(batch + [c])) - 1 > FRAME_MAX):
+            frames.append(frame(batch))
+            batch = []
+        batch.append(c)
+    if batch:
+        frames.append(frame(batch))
+    return frames
+
+
+def wait_pong(link, token, timeout=5.0):
+    for op, args in link.events(timeout):
+        if op == EVT_PONG and struct.unpack_from("<I", args)[0] == token:
+            return struct.unpack_from("<IIII", args)
+    return None
+
+
+def cmd_demo(link, args):
+    link.send(frame([
+        set_top("UniController", "v1.0.0"),
+        set_bottom("192.168.1.100", args.baud or 921600, "FW-2025"),
+        set_status(0, "Temp", "25°C", 0x00FF00),
+        set_status(1, "Pressure", "101kPa", 0xFFFF00),
+        set_status(2, "Mode", "Auto", 0x00FFFF),
+        set_status(3, "Flow", "5L/min", 0xFF00FF),
+        set_status(4, "Error", "None", 0xFFFFFF),
+        set_status(5, "Uptime", "00:05:30", 0x00FF00),
+        set_button(0, "Start"), set_button(1, "Stop"), set_button(2, "Debug"), set_button(3, "Clear"),
+        set_button_long_press(3),
+        *[set_status_icon(i, name) for i, name in enumerate(("temp", "pressure", "mode", "flow", "error", "uptime"))],
+        *[set_button_icon(i, name) for i, name in enumerate(("start", "stop", "debug", "clear"))],
+        add_log("Driven over the UART protocol."),
+    ]))
+
+
+def cmd_log(link, args):
+    link.send(frame([add_log(m) for m in args.text]))
+
+
+def cmd_status(link, args):
+    link.send(frame([set_status(args.index, args.key, args.value, int(args.color, 16))]))
+
+
+def cmd_button(link, args):
+    link.send(frame([set_button_text(args.index, args.text)]))
+
+
+LEVELS = {"error": 1, "warn": 2, "info": 3, "debug": 4, "verbose": 5}
+
+
+def cmd_icon(link, args):
+    op = set_button_icon if args.target == "button" else set_status_icon
+    link.send(frame([op(args.index, args.name)]))
+
+
+def cmd_find(link, args):
+    link.send(frame([find_log(args.text, LEVELS[args.level])]))
+
+
+def cmd_jump(link, args):
+    """Jump to hh:mm:ss[.mmm] since boot (the log line prefix), or back to the newest line with 'latest'."""
+    if args.time == "latest":
+        tick_ms = 0xFFFFFFFF
+    else:
+        parts = [float(p) for p in args.time.split(":")]
+        tick_ms = int(round(sum(v * 60 ** (len(parts) - 1 - i) for i, v in enumerate(parts)) * 1000))
+    link.send(frame([jump_log(tick_ms)]))
+
+
+def cmd_plot(link, args):
+    """Stream a sine with a spike every 997 samples on channel 0 at --rate samples/s."""
+    link.send(frame([plot_config(0, -1.5, 1.5, max(1, args.rate // 200), 0x00FF00), show_plot(True)]))
+    batch = max(1, args.rate // 100)  # one frame every 10 ms
+    n, start = 0, time.monotonic()
+    while time.monotonic() - start < args.seconds:
+        samples = [math.sin(2 * math.pi * 3 * (n + i) / args.rate) + (0.9 if (n + i) % 997 == 0 else 0.0)
+                   for i in range(batch)]
+        link.send(b"".join(pack_frames([plot_push(0, samples[i:i + 200]) for i in range(0, batch, 200)], 1)))
+        n += batch
+        time.sleep(max(0.0, start + n / args.rate - time.monotonic()))
+
+
+def cmd_listen(link, args):
+    for op, payload in link.events(args.seconds):
+        if op == EVT_BUTTON:
+            print("button %d %s" % (payload[0], "long" if payload[1] else "click"), flush=True)
+
+
+def cmd_bench(link, args):
+    """Send status / log commands as fast as the link allows, then PING and report commands/s."""
+    keys = ("Temp", "Pressure", "Mode", "Flow", "Error", "Uptime")
+    commands = []
+    for i in range(args.commands):
+        if i % 4 == 3:
+            commands.append(add_log("bench %d" % i))
+        else:
+            commands.append(set_status(i % 6, keys[i % 6], "%d.%d" % (i % 1000, i % 6), 0x00FF00))
+    frames = pack_frames(commands, args.per_frame)
+    link.send(frame([ping(1)]))
+    before = wait_pong(link, 1)
+    if before is None:
+        sys.exit("no PONG from the device")
+    link.start, link.sent = time.monotonic(), 0
+    start = link.start
+    for f in frames:
+        link.send(f)
+    link.send(frame([ping(2)]))
+    after = wait_pong(link, 2, timeout=10.0 + args.commands / 1000.0)
+    elapsed = time.monotonic() - start
+    if after is None:
+        sys.exit("no PONG after the bench")
+    applied = after[2] - before[2] - 1
+    print("commands=%d" % args.commands)
+    print("frames=%d" % len(frames))
+    print("bytes=%d" % link.sent)
+    print("bytes_per_command=%.1f" % (link.sent / args.commands))
+    print("elapsed_s=%.3f" % elapsed)
+    print("commands_per_s=%.0f" % (applied / elapsed))
+    if args.baud:
+        print("wire_limit_commands_per_s=%.0f" % (args.baud / 10.0 * args.commands / link.sent))
+    print("device_commands=%d" % applied)
+    print("device_errors=%d" % (after[3] - before[3]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("device", help="serial device or pty (from unicontroller_sim --uart pty)")
+    parser.add_argument("--baud", type=int, default=0, help="line rate; on a pty, pace writes to it")
+    sub = parser.add_subparsers(dest="command", required=True)
+    sub.add_parser("demo", help="send the main.c sample screen in one frame").set_defaults(func=cmd_demo)
+    p = sub.add_parser("log", help="append log lines, all in one frame")
+    p.add_argument("text", nargs="+")
+    p.set_defaults(func=cmd_log)
+    p = sub.add_parser("status", help="set a status item")
+    p.add_argument("index", type=int)
+    p.add_argument("key")
+    p.add_argument("value")
+    p.add_argument("color", nargs="?", default="00FF00", help="RRGGBB")
+    p.set_defaults(func=cmd_status)
+    p = sub.add_parser("button", help="relabel a button, its click and long-press events stay as they are")
+    p.add_argument("index", type=int)
+    p.add_argument("text")
+    p.set_defaults(func=cmd_button)
+    p = sub.add_parser("icon", help="set the icon of a button or status item, an empty name removes it")
+    p.add_argument("target", choices=("button", "status"))
+    p.add_argument("index", type=int)
+    p.add_argument("name", nargs="?", default="")
+    p.set_defaults(func=cmd_icon)
+    p = sub.add_parser("find", help="scroll the log back to the previous line containing TEXT")
+    p.add_argument("text", nargs="?", default="")
+    p.add_argument("--level", choices=LEVELS, default="verbose", help="only lines at this severity or worse")
+    p.set_defaults(func=cmd_find)
+    p = sub.add_parser("jump", help="scroll the log to a time since boot")
+    p.add_argument("time", help="hh:mm:ss[.mmm], mm:ss, seconds, or 'latest'")
+    p.set_defaults(func=cmd_jump)
+    p = sub.add_parser("plot", help="stream a test signal to plot channel 0")
+    p.add_argument("--rate", type=int, default=2000, help="samples/s")
+    p.add_argument("--seconds", type=float, default=10.0)
+    p.set_defaults(func=cmd_plot)
+    p = sub.add_parser("listen", help="print button events")
+    p.add_argument("--seconds", type=float, default=60.0)
+    p.set_defaults(func=cmd_listen)
+    p = sub.add_parser("bench", help="measure commands/s")
+    p.add_argument("--commands", type=int, default=20000)
+    p.add_argument("--per-frame", type=int, default=16)
+    p.set_defaults(func=cmd_bench)
+    args = parser.parse_args()
+    args.func(Link(args.device, args.baud), args)
+
+
+if __name__ == "__main__":
+    main()
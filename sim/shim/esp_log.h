@@ -0,0 +1,21 @@
+// esp_log.h (host shim)
+// 输出到 stderr，级别由 sim_log_level 控制（默认 SIM_LOG_LEVEL，即 INFO；--log-level 修改）
+#pragma once
+
+#include <stdio.h>
+
+#ifndef SIM_LOG_LEVEL
+#define SIM_LOG_LEVEL 3
+#endif
+
+extern int sim_log_level;
+
+#define SIM_LOG(level, letter, tag, fmt, ...) do { \
+        if ((level) <= sim_log_level) fprintf(stderr, letter " (%s) " fmt "\n", tag, ##__VA_ARGS__); \
+    } while (0)
+
+#define ESP_LOGE(tag, fmt, ...) SIM_LOG(1, "E", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) SIM_LOG(2, "W", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) SIM_LOG(3, "I", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) SIM_LOG(4, "D", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) SIM_LOG(5, "V", tag, fmt, ##__VA_ARGS__)
@@ -0,0 +1,7 @@
+// esp_timer.h (host shim)
+#pragma once
+
+#include <stdint.h>
+
+// 单调时钟，单位 us，从进程启动开始计
+int64_t esp_timer_get_time(void);
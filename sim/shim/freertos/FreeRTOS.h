@@ -0,0 +1,26 @@
+// FreeRTOS.h (host shim)
+// 模拟器只用到临界区与 tick，临界区用 pthread 互斥量实现
+#pragma once
+
+#include <stdint.h>
+#include <pthread.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+
+typedef struct {
+    pthread_mutex_t mutex;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    { PTHREAD_MUTEX_INITIALIZER }
+#define portTICK_PERIOD_MS              1
+#define portMAX_DELAY                   ((TickType_t)0xFFFFFFFF)
+#define pdMS_TO_TICKS(ms)               ((TickType_t)(ms))
+#define pdTRUE                          1
+#define pdFALSE                         0
+#define pdPASS                          pdTRUE
+
+#define taskENTER_CRITICAL(mux)         pthread_mutex_lock(&(mux)->mutex)
+#define taskEXIT_CRITICAL(mux)          pthread_mutex_unlock(&(mux)->mutex)
+#define portENTER_CRITICAL(mux)         taskENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL(mux)          taskEXIT_CRITICAL(mux)
@@ -0,0 +1,14 @@
+// task.h (host shim)
+// 任务用 pthread 线程代替，tick 与模拟器的 LVGL 时钟一致（1 tick = 1 ms）
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef pthread_t TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+TickType_t xTaskGetTickCount(void);
+void vTaskDelay(TickType_t ticks);
+// 栈大小、优先级仅为保持签名一致，线程创建失败返回 pdFALSE
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_size, void *arg,
+                       int priority, TaskHandle_t *handle);
@@ -0,0 +1,120 @@
+// sim.h
+// 主机模拟器：内存帧缓冲显示、脚本化触摸输入、可选的虚拟时钟
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "perf_hist.h"
+#include "ui_proto.h"       // 不依赖 LVGL，可以经 lv_conf.h 被包含
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_HOR_RES 800
+#define SIM_VER_RES 480
+
+// === 时钟 ===
+// step_ms 为 0 时使用真实时间，否则每次 sim_time_advance() 前进 step_ms（帧序列可复现）
+void sim_time_init(uint32_t step_ms);
+bool sim_time_is_virtual(void);
+void sim_time_advance(void);
+uint32_t sim_tick_ms(void);   // LVGL tick 来源（见 lv_conf.h）
+
+// === 显示 ===
+typedef struct {
+    uint32_t frames;        // 完成的刷新次数
+    uint64_t flushed_px;    // 累计刷出的像素
+    uint32_t max_frame_px;  // 单帧最多像素
+} sim_display_stats_t;
+
+void sim_display_init(void);
+// 每次调用 lv_timer_handler() 前调用，作为帧耗时的起点
+void sim_display_begin_pass(void);
+void sim_display_get_stats(sim_display_stats_t *stats);
+// 帧缓冲按 RGB565 存储，导出为 P6 PPM；成功返回 true
+bool sim_display_dump_ppm(const char *path);
+
+// === 输入 ===
+// 脚本每行一条事件：<时间 ms> <动作> [参数]，# 开头为注释
+//   press x y / move x y / release / log 文本 / clear / dump 文件名 / quit
+//   find 文本：日志往前找下一处；jump ms：跳到该时间的日志，省略 ms 时回到最新日志
+//   touch n x0 y0 ... xn-1 yn-1：多点触摸样本（n 为 0 表示松开），板上 touch_trace on 的输出可直接回放
+//   expect 类型 begin|end [left|right|up|down]：期望在该时间前后 50 ms 内识别出的手势，
+//     类型为 tap / long_press / swipe / pinch / pan；有 expect 行时识别出的开始 / 结束事件须与之逐条一致
+bool sim_input_init(const char *script_path);
+// 执行所有到期事件，遇到 quit 返回 false
+bool sim_input_step(uint32_t now_ms);
+void sim_input_set_dump_dir(const char *dir);
+// 运行结束时调用：脚本有 expect 行时打印核对结果，多出、不符或缺少手势返回 false
+bool sim_input_check(void);
+
+// === 示例数据 ===
+// 与 main.c 相同的初始界面，之后按 log_period_ms 周期写日志（0 表示不写）
+void sim_demo_init(uint32_t log_period_ms);
+void sim_demo_step(uint32_t now_ms);
+
+// === 字体 ===
+// 从文件加载 lv_font_conv --format bin --no-compress 生成的字体（与板上字体分区的内容相同），
+// 字形按需读入 ui_font 缓存；失败返回 NULL
+// 本头文件经 lv_conf.h 被 LVGL 包含，不能反过来包含 lvgl.h，字体类型用结构体名
+struct _lv_font_t;
+const struct _lv_font_t *sim_font_load(const char *path, const struct _lv_font_t *fallback);
+bool sim_font_loaded(void);
+const perf_hist_t *sim_font_fetch_hist(void);     // 每次读取字形的耗时（us）
+
+// === 图标 ===
+// 从文件加载 sim/scripts/iconpack.py 生成的图集（与板上图标分区的内容相同），页按需解码进 ui_icon 缓存
+bool sim_icon_load(const char *path);
+bool sim_icon_loaded(void);
+const perf_hist_t *sim_icon_decode_hist(void);    // 每次解码一页的耗时（us）
+
+// === 串口命令协议 ===
+// path 为 "pty" 时新建伪终端并把从端路径以 uart_pty=... 打印到 stderr，否则打开已有的串口设备；
+// 帧由接收线程送入 ui_proto（见 ui_proto.h），按钮事件写回同一设备
+bool sim_uart_start(const char *path);
+void sim_uart_stop(void);
+bool sim_uart_get_stats(ui_proto_stats_t *stats);     // 未启用时返回 false
+
+// === 分配器基准 ===
+// 同一条类 LVGL 分配序列分别交给 malloc 和 lvgl_mem（main/lvgl_mem.c）执行 count 次操作，
+// 结果以 key=value 打印到 stdout；lvgl_mem 有分配失败时返回 1
+int sim_mem_bench(uint32_t count);
+
+// === 命令队列校验 ===
+// 每种溢出策略下多个生产者线程各向 ui_ring 写入 count 个变长条目，主线程同时取出并核对负载、
+// 每个生产者的顺序和各计数，结果以 key=value 打印到 stdout；有不一致时返回 1
+int sim_ring_check(uint32_t count);
+
+// === 软件旋转校验 ===
+// count 个随机帧尺寸、区域和角度交给 rgb565_rotate_area()（main/rgb565_rotate.c），整帧与逐像素参考映射比较，
+// 再给出整帧各角度与 memcpy 的主机 MPix/s，以 key=value 打印到 stdout；有不一致时返回 1
+int sim_rotate_check(uint32_t count);
+
+// === 日志基准 ===
+// 在 ui_init() 之后调用：同一条格式化日志分别走改动前的路径、ui_add_log、ui_logf 和 esp_log 钩子
+// （ui_log_bridge，另测被限速和被级别过滤的开销）各 count 次，打印生产者每次调用的耗时；
+// 延迟格式化的文本与 snprintf 不一致、ui_logf / 钩子有丢弃或限速计数不符时返回 1
+int sim_log_bench(uint32_t count);
+
+// === 日志视图基准 ===
+// 在 sim_display_init() 之后、ui_init() 之前调用：在填满的日志视图上每帧追加 1 行和 8 行，共 count 行，
+// 分别经改动前的 textarea 和 ui_log 行对象池，每帧立即渲染；打印每秒行数和每行刷出 / 失效的像素
+int sim_log_view_bench(uint32_t count);
+
+// === 混合内核校验 ===
+// 在 sim_display_init() 之后调用：count 次随机混合分别交给 LVGL 的 lv_draw_sw_blend_basic 和 lvgl_draw.c，
+// 逐像素比较，再给出每种内核两边的 MPix/s，以 key=value 打印到 stdout；结果有不一致时返回 1
+int sim_blend_bench(uint32_t count);
+
+// === 字体校验 ===
+// 在 lv_init() 之后调用：同一个字体文件分别经 ui_font（很小的两级缓存）和 LVGL 的 lv_font_load() 打开，
+// 逐个码点比较字形描述和位图，再按随机顺序多轮查询，结果以 key=value 打印到 stdout；有不一致时返回 1
+int sim_font_check(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_H
@@ -0,0 +1,186 @@
+// sim_blend_bench.c
+// 混合内核校验与基准：随机的填充、不透明复制、固定透明度混合和 A8 遮罩填充，分别交给 LVGL 自带的
+// lv_draw_sw_blend_basic 和 lvgl_draw.c 的绘制上下文（rgb565_blend.c 的可移植 C 内核），逐像素比较结果；
+// 之后每种内核在整块缓冲上各计时一次，给出两者的 MPix/s。主机上没有 PIE，板上的向量内核用 `blend bench` 测
+#include "sim.h"
+#include "lvgl.h"
+#include "lvgl_draw.h"
+#include "src/draw/sw/lv_draw_sw.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BLEND_BENCH_W       SIM_HOR_RES
+#define BLEND_BENCH_H       64
+#define BLEND_BENCH_SEED    0x9E3779B9u
+#define BLEND_BENCH_PASSES  200     // 每种内核的计时遍数
+
+typedef enum {
+    BLEND_FILL,
+    BLEND_FILL_OPA,
+    BLEND_FILL_MASK,
+    BLEND_FILL_MASK_OPA,
+    BLEND_COPY,
+    BLEND_COPY_OPA,
+    BLEND_KIND_COUNT,
+} blend_kind_t;
+
+static const char *const g_kind_names[BLEND_KIND_COUNT] = {
+    "fill", "fill_opa", "fill_mask", "fill_mask_opa", "copy", "copy_opa",
+};
+
+static lv_color_t g_ref_buf[BLEND_BENCH_W * BLEND_BENCH_H];
+static lv_color_t g_our_buf[BLEND_BENCH_W * BLEND_BENCH_H];
+static lv_color_t g_src[BLEND_BENCH_W * BLEND_BENCH_H];
+static lv_opa_t g_mask[BLEND_BENCH_W * BLEND_BENCH_H];
+
+static uint32_t xorshift32(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// 绘制缓冲覆盖整块 BLEND_BENCH_W x BLEND_BENCH_H，裁剪区由调用方设置
+static void ctx_setup(lv_draw_sw_ctx_t *ctx, lv_color_t *buf, lv_area_t *buf_area, lv_area_t *clip) {
+    ctx->base_draw.buf = buf;
+    ctx->base_draw.buf_area = buf_area;
+    ctx->base_draw.clip_area = clip;
+}
+
+// 遮罩里大半是 0 和 255（字形和圆角外的空白与内部），其余是边缘的过渡值
+static lv_opa_t pick_mask(uint32_t *rng) {
+    uint32_t r = xorshift32(rng) % 8;
+    if (r < 3) return LV_OPA_TRANSP;
+    if (r < 6) return LV_OPA_COVER;
+    return (lv_opa_t)xorshift32(rng);
+}
+
+static lv_opa_t pick_opa(uint32_t *rng, bool opaque) {
+    if (opaque) return (xorshift32(rng) % 4) ? LV_OPA_COVER : LV_OPA_MAX;   // LVGL 把 LV_OPA_MAX 以上当作不透明
+    return (lv_opa_t)(LV_OPA_MIN + 1 + xorshift32(rng) % (LV_OPA_MAX - LV_OPA_MIN - 1));
+}
+
+static void fill_dsc(lv_draw_sw_blend_dsc_t *dsc, blend_kind_t kind, const lv_area_t *area, lv_opa_t opa,
+                     lv_color_t color) {
+    memset(dsc, 0, sizeof(*dsc));
+    dsc->blend_area = area;
+    dsc->color = color;
+    dsc->opa = opa;
+    dsc->blend_mode = LV_BLEND_MODE_NORMAL;
+    dsc->mask_res = LV_DRAW_MASK_RES_FULL_COVER;
+    if (kind == BLEND_FILL_MASK || kind == BLEND_FILL_MASK_OPA) {
+        dsc->mask_buf = g_mask;
+        dsc->mask_area = area;
+        dsc->mask_res = LV_DRAW_MASK_RES_CHANGED;
+    }
+    if (kind == BLEND_COPY || kind == BLEND_COPY_OPA) dsc->src_buf = g_src;
+}
+
+static bool kind_opaque(blend_kind_t kind) {
+    return kind == BLEND_FILL || kind == BLEND_FILL_MASK || kind == BLEND_COPY;
+}
+
+// 随机一次混合：区域可以伸出裁剪区，目标内容有一半是纯色背景（LVGL 和 C 内核都缓存上一个结果）
+static bool check_case(lv_draw_sw_ctx_t *ref, lv_draw_sw_ctx_t *our, uint32_t *rng, blend_kind_t kind) {
+    lv_area_t area;
+    area.x1 = (lv_coord_t)(xorshift32(rng) % (BLEND_BENCH_W + 16)) - 8;
+    area.y1 = (lv_coord_t)(xorshift32(rng) % (BLEND_BENCH_H + 8)) - 4;
+    area.x2 = area.x1 + (lv_coord_t)(xorshift32(rng) % BLEND_BENCH_W);
+    area.y2 = area.y1 + (lv_coord_t)(xorshift32(rng) % 16);
+    const int32_t area_px = lv_area_get_size(&area);
+    const bool flat = xorshift32(rng) & 1;
+    const lv_color_t bg = { .full = (uint16_t)xorshift32(rng) };
+    for (int i = 0; i < BLEND_BENCH_W * BLEND_BENCH_H; i++) {
+        g_ref_buf[i].full = flat ? bg.full : (uint16_t)xorshift32(rng);
+    }
+    memcpy(g_our_buf, g_ref_buf, sizeof(g_our_buf));
+    for (int32_t i = 0; i < area_px; i++) {     // 区域最多 16 行，源和遮罩放得下
+        g_src[i].full = (uint16_t)xorshift32(rng);
+        g_mask[i] = pick_mask(rng);
+    }
+
+    lv_draw_sw_blend_dsc_t dsc;
+    fill_dsc(&dsc, kind, &area, pick_opa(rng, kind_opaque(kind)), (lv_color_t){ .full = (uint16_t)xorshift32(rng) });
+    // lv_draw_sw_blend() 在调用 blend 之前滤掉了 LV_OPA_MIN 以下和不在裁剪区内的混合
+    lv_area_t clipped;
+    if (!_lv_area_intersect(&clipped, &area, ref->base_draw.clip_area)) return true;
+    lv_draw_sw_blend_basic(&ref->base_draw, &dsc);
+    our->blend(&our->base_draw, &dsc);
+    if (!memcmp(g_ref_buf, g_our_buf, sizeof(g_ref_buf))) return true;
+    for (int i = 0; i < BLEND_BENCH_W * BLEND_BENCH_H; i++) {
+        if (g_ref_buf[i].full != g_our_buf[i].full) {
+            printf("blend_mismatch=%s opa=%u area=%d,%d,%d,%d px=%d,%d lvgl=0x%04x ours=0x%04x\n",
+                   g_kind_names[kind], dsc.opa, area.x1, area.y1, area.x2, area.y2, i % BLEND_BENCH_W,
+                   i / BLEND_BENCH_W, g_ref_buf[i].full, g_our_buf[i].full);
+            break;
+        }
+    }
+    return false;
+}
+
+// 整块缓冲重复混合 BLEND_BENCH_PASSES 遍，返回 MPix/s
+static double time_kind(lv_draw_sw_ctx_t *ctx, blend_kind_t kind, uint32_t *rng) {
+    lv_area_t area = { 0, 0, BLEND_BENCH_W - 1, BLEND_BENCH_H - 1 };
+    for (int i = 0; i < BLEND_BENCH_W * BLEND_BENCH_H; i++) {
+        g_src[i].full = (uint16_t)xorshift32(rng);
+        g_mask[i] = pick_mask(rng);
+    }
+    lv_draw_sw_blend_dsc_t dsc;
+    fill_dsc(&dsc, kind, &area, kind_opaque(kind) ? LV_OPA_COVER : LV_OPA_50, lv_color_make(0x20, 0x80, 0xE0));
+    const int64_t start = now_ns();
+    for (int i = 0; i < BLEND_BENCH_PASSES; i++) {
+        dsc.color.full ^= 0x0821;   // 每遍换颜色，背景不会一直是同一个值
+        ctx->blend(&ctx->base_draw, &dsc);
+    }
+    const int64_t elapsed = now_ns() - start;
+    return (double)BLEND_BENCH_W * BLEND_BENCH_H * BLEND_BENCH_PASSES * 1000.0 / (double)elapsed;
+}
+
+int sim_blend_bench(uint32_t count) {
+    if (count == 0) count = 100000;
+    lv_disp_t *disp = lv_disp_get_default();
+    lv_disp_t *refreshing = _lv_refr_get_disp_refreshing();
+    _lv_refr_set_disp_refreshing(disp);    // 两边都从正在刷新的显示器取驱动参数
+
+    static lv_draw_sw_ctx_t ref_ctx, our_ctx;
+    lv_draw_sw_init_ctx(disp->driver, &ref_ctx.base_draw);
+    lvgl_draw_ctx_init(disp->driver, &our_ctx.base_draw);
+    ref_ctx.blend = lv_draw_sw_blend_basic;
+    lv_area_t ref_buf_area = { 0, 0, BLEND_BENCH_W - 1, BLEND_BENCH_H - 1 };
+    lv_area_t our_buf_area = ref_buf_area;
+    lv_area_t clip = { 3, 2, BLEND_BENCH_W - 4, BLEND_BENCH_H - 3 };   // 伸出裁剪区的混合要被裁掉
+    ctx_setup(&ref_ctx, g_ref_buf, &ref_buf_area, &clip);
+    ctx_setup(&our_ctx, g_our_buf, &our_buf_area, &clip);
+
+    uint32_t rng = BLEND_BENCH_SEED;
+    uint32_t mismatches[BLEND_KIND_COUNT] = { 0 };
+    uint32_t total_mismatches = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const blend_kind_t kind = (blend_kind_t)(i % BLEND_KIND_COUNT);
+        if (!check_case(&ref_ctx, &our_ctx, &rng, kind)) {
+            mismatches[kind]++;
+            total_mismatches++;
+        }
+    }
+
+    printf("blend_cases=%u\n", (unsigned)count);
+    lv_area_t full = ref_buf_area;
+    ref_ctx.base_draw.clip_area = &full;
+    our_ctx.base_draw.clip_area = &full;
+    for (int k = 0; k < BLEND_KIND_COUNT; k++) {
+        printf("%s_mismatches=%u\n", g_kind_names[k], (unsigned)mismatches[k]);
+        printf("%s_lvgl_mpix_s=%.1f\n", g_kind_names[k], time_kind(&ref_ctx, (blend_kind_t)k, &rng));
+        printf("%s_ours_mpix_s=%.1f\n", g_kind_names[k], time_kind(&our_ctx, (blend_kind_t)k, &rng));
+    }
+    _lv_refr_set_disp_refreshing(refreshing);
+    return total_mismatches ? 1 : 0;
+}
@@ -0,0 +1,75 @@
+// sim_demo.c
+// 与 main.c 相同的示例界面，供模拟器在没有脚本时也有内容可渲染
+#include "sim.h"
+#include "ui.h"
+#include <stdio.h>
+
+static uint32_t g_log_period_ms;
+static uint32_t g_next_log_ms;
+static uint32_t g_next_uptime_ms;
+static uint32_t g_log_count;
+static bool g_started;
+
+static void key1_pressed(void) {
+    ui_add_log("pressed");
+}
+
+static void key4_pressed(void) {
+    ui_clear_log();
+}
+
+void sim_demo_init(uint32_t log_period_ms) {
+    g_log_period_ms = log_period_ms;
+    g_started = false;
+}
+
+void sim_demo_step(uint32_t now_ms) {
+    if (!g_started) {
+        g_started = true;
+        ui_set_top_firmware_info("UniController", "v1.0.0");
+        ui_set_bottom_info("192.168.1.100", 115200, "FW-2025");
+
+        ui_set_status_item(0, "Temp", "25°C", lv_color_hex(0x00FF00));
+        ui_set_status_item(1, "Pressure", "101kPa", lv_color_hex(0xFFFF00));
+        ui_set_status_item(2, "Mode", "Auto", lv_color_hex(0x00FFFF));
+        ui_set_status_item(3, "Flow", "5L/min", lv_color_hex(0xFF00FF));
+        ui_set_status_item(4, "Error", "None", lv_color_hex(0xFFFFFF));
+        ui_set_status_item(5, "Uptime", "00:00:00", lv_color_hex(0x00FF00));
+
+        ui_set_button(0, "Start", key1_pressed);
+        ui_set_button(1, "Stop", key1_pressed);
+        ui_set_button(2, "Debug", key1_pressed);
+        ui_set_button(3, "Clear", key4_pressed);
+
+        // 图标：状态项一页、按钮一页（sim/scripts/iconpack.py --demo），没有 --icons 时不显示
+        ui_set_status_icon(0, "temp");
+        ui_set_status_icon(1, "pressure");
+        ui_set_status_icon(2, "mode");
+        ui_set_status_icon(3, "flow");
+        ui_set_status_icon(4, "error");
+        ui_set_status_icon(5, "uptime");
+        ui_set_button_icon(0, "start");
+        ui_set_button_icon(1, "stop");
+        ui_set_button_icon(2, "debug");
+        ui_set_button_icon(3, "clear");
+
+        ui_add_log("System booting...");
+        ui_add_log("LVGL initialized.");
+        ui_add_log("Network connected.");
+        ui_add_log("Device ready.");
+        g_next_log_ms = now_ms + g_log_period_ms;
+        g_next_uptime_ms = now_ms + 1000;
+        return;
+    }
+    if (g_log_period_ms && (int32_t)(now_ms - g_next_log_ms) >= 0) {
+        ui_logf("tick %u.", (unsigned)++g_log_count);
+        g_next_log_ms += g_log_period_ms;
+    }
+    if ((int32_t)(now_ms - g_next_uptime_ms) >= 0) {
+        uint32_t s = now_ms / 1000;
+        char value[16];
+        snprintf(value, sizeof(value), "%02u:%02u:%02u", (unsigned)(s / 3600), (unsigned)(s / 60 % 60), (unsigned)(s % 60));
+        ui_set_status_item(5, "Uptime", value, lv_color_hex(0x00FF00));
+        g_next_uptime_ms += 1000;
+    }
+}
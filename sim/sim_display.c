@@ -0,0 +1,97 @@
+// sim_display.c
+// 与板上默认配置（防撕裂模式 3）一致：LVGL direct mode 直接渲染进整屏帧缓冲
+#include "sim.h"
+#include "ui_bench.h"
+#include "lvgl_draw.h"
+#include "lvgl.h"
+#include "esp_timer.h"
+#include <malloc.h>
+#include <stdio.h>
+#include <string.h>
+
+static lv_color_t g_fb[SIM_HOR_RES * SIM_VER_RES];
+static lv_disp_draw_buf_t g_draw_buf;
+static lv_disp_drv_t g_disp_drv;
+static sim_display_stats_t g_stats;
+static uint32_t g_frame_px;
+static int64_t g_pass_start_us;
+static uint32_t g_flush_us;
+
+static uint32_t heap_used(void) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return (uint32_t)mallinfo2().uordblks;
+#else
+    return (uint32_t)mallinfo().uordblks;
+#endif
+}
+
+static void flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map) {
+    (void)color_map;    // direct mode 下 color_map 就是 g_fb
+    int64_t start_us = esp_timer_get_time();
+    g_frame_px += lv_area_get_size(area);
+    if (lv_disp_flush_is_last(drv)) {
+        g_stats.frames++;
+        g_stats.flushed_px += g_frame_px;
+        if (g_frame_px > g_stats.max_frame_px) g_stats.max_frame_px = g_frame_px;
+        g_frame_px = 0;
+    }
+    g_flush_us += (uint32_t)(esp_timer_get_time() - start_us);
+    lv_disp_flush_ready(drv);
+}
+
+// 每次刷新结束后调用一次，与板上 lvgl_port.c 的 monitor_callback 相同
+static void monitor_cb(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px) {
+    (void)time_ms;
+    if (ui_bench_running()) {
+        ui_bench_frame_t frame = {
+            .frame_us = (uint32_t)(esp_timer_get_time() - g_pass_start_us),
+            .flush_us = g_flush_us,
+            .inv_px = px,
+            .heap_used = heap_used(),
+        };
+        ui_bench_frame_done(&frame);
+    }
+    g_flush_us = 0;
+}
+
+void sim_display_begin_pass(void) {
+    g_pass_start_us = esp_timer_get_time();
+    g_flush_us = 0;
+}
+
+void sim_display_init(void) {
+    lv_disp_draw_buf_init(&g_draw_buf, g_fb, NULL, SIM_HOR_RES * SIM_VER_RES);
+    lv_disp_drv_init(&g_disp_drv);
+    g_disp_drv.hor_res = SIM_HOR_RES;
+    g_disp_drv.ver_res = SIM_VER_RES;
+    g_disp_drv.flush_cb = flush_cb;
+    g_disp_drv.monitor_cb = monitor_cb;
+    g_disp_drv.draw_buf = &g_draw_buf;
+    g_disp_drv.direct_mode = 1;
+    g_disp_drv.draw_ctx_init = lvgl_draw_ctx_init;     // 与板上相同的混合内核（可移植 C 版本）
+    lv_disp_drv_register(&g_disp_drv);
+}
+
+void sim_display_get_stats(sim_display_stats_t *stats) {
+    *stats = g_stats;
+}
+
+bool sim_display_dump_ppm(const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", SIM_HOR_RES, SIM_VER_RES);
+    uint8_t line[SIM_HOR_RES * 3];
+    for (int y = 0; y < SIM_VER_RES; y++) {
+        const lv_color_t *src = &g_fb[y * SIM_HOR_RES];
+        for (int x = 0; x < SIM_HOR_RES; x++) {
+            uint16_t c = src[x].full;
+            // 高位复制到低位，0x1F / 0x3F 映射为 255
+            uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+            line[x * 3 + 0] = (uint8_t)((r << 3) | (r >> 2));
+            line[x * 3 + 1] = (uint8_t)((g << 2) | (g >> 4));
+            line[x * 3 + 2] = (uint8_t)((b << 3) | (b >> 2));
+        }
+        fwrite(line, 1, sizeof(line), f);
+    }
+    return fclose(f) == 0;
+}
@@ -0,0 +1,56 @@
+// sim_font.c
+// 从磁盘文件加载字体，代替板上的字体分区（main/font_partition.c）；缓存大小与 Kconfig 默认值一致
+#include "sim.h"
+#include "ui_font.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char *TAG = "sim_font";
+
+#define SIM_FONT_CACHE_HOT_BYTES    (16 * 1024)
+#define SIM_FONT_CACHE_LRU_BYTES    (256 * 1024)
+#define SIM_FONT_CACHE_SLOT_BYTES   256
+
+static FILE *g_file;
+static ui_font_t g_font;
+static perf_hist_t g_fetch_hist;
+static bool g_loaded;
+
+static bool file_read(void *ctx, uint32_t offset, void *buf, uint32_t len) {
+    (void)ctx;
+    return fseek(g_file, (long)offset, SEEK_SET) == 0 && fread(buf, 1, len, g_file) == len;
+}
+
+const lv_font_t *sim_font_load(const char *path, const lv_font_t *fallback) {
+    g_file = fopen(path, "rb");
+    if (!g_file) {
+        ESP_LOGE(TAG, "cannot open %s", path);
+        return NULL;
+    }
+    static uint8_t hot[SIM_FONT_CACHE_HOT_BYTES];
+    const ui_font_cache_config_t cfg = {
+        .hot_mem = hot,
+        .hot_size = sizeof(hot),
+        .lru_mem = malloc(SIM_FONT_CACHE_LRU_BYTES),
+        .lru_size = SIM_FONT_CACHE_LRU_BYTES,
+        .slot_bytes = SIM_FONT_CACHE_SLOT_BYTES,
+        .fetch_hist = &g_fetch_hist,
+    };
+    perf_hist_reset(&g_fetch_hist);
+    const ui_font_src_t src = { .read = file_read };
+    if (!ui_font_cache_init(&cfg) || !ui_font_open(&g_font, &src, fallback)) {
+        fclose(g_file);
+        return NULL;
+    }
+    g_loaded = true;
+    return &g_font.font;
+}
+
+bool sim_font_loaded(void) {
+    return g_loaded;
+}
+
+const perf_hist_t *sim_font_fetch_hist(void) {
+    return &g_fetch_hist;
+}
@@ -0,0 +1,188 @@
+// sim_font_check.c
+// ui_font 与 LVGL 自带加载器的对照：同一个字体文件分别经 ui_font_open()（字形按需读入两级缓存）和
+// lv_font_load()（整个字体读入内存）打开，对每个子表范围内的每个码点比较两边是否都能查到，
+// 查到的再比较字形描述（步进宽度、包围盒、偏移、bpp）和位图。
+// 缓存取得很小，热点层和 LRU 层都只有几个槽，查到的码点按随机顺序查询多轮，
+// 让提升、两层交换、挤出和不缓存的大字形都发生，比较的是经过缓存之后交给 LVGL 的结果。
+#include "sim.h"
+#include "ui_font.h"
+#include "lvgl.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FONT_CHECK_HOT_BYTES    2048
+#define FONT_CHECK_LRU_BYTES    8192
+#define FONT_CHECK_SLOT_BYTES   256     // 与 sim_font.c 相同
+#define FONT_CHECK_PASSES       4
+#define FONT_CHECK_COMMON       8       // 常用字形数，每轮反复穿插查询，进入热点层
+#define FONT_CHECK_SEED         0x2545F491u
+
+static uint32_t g_mismatches;
+
+static uint32_t xorshift32(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static bool file_read(void *ctx, uint32_t offset, void *buf, uint32_t len) {
+    FILE *f = ctx;
+    return fseek(f, (long)offset, SEEK_SET) == 0 && fread(buf, 1, len, f) == len;
+}
+
+static void mismatch(uint32_t letter, const char *what) {
+    if (!g_mismatches) printf("font_check_first_fail=U+%04X %s\n", (unsigned)letter, what);
+    g_mismatches++;
+}
+
+// 查一个码点，两边结果一致时返回 true；found 返回 LVGL 是否查到
+static bool compare_glyph(const lv_font_t *font, const lv_font_t *ref, uint32_t letter, bool *found) {
+    lv_font_glyph_dsc_t a, b;
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0, sizeof(b));
+    const bool has_a = font->get_glyph_dsc(font, &a, letter, 0);
+    const bool has_b = ref->get_glyph_dsc(ref, &b, letter, 0);
+    if (found) *found = has_b;
+    if (has_a != has_b) {
+        mismatch(letter, has_b ? "missing in ui_font" : "missing in lv_font_load");
+        return false;
+    }
+    if (!has_b) return true;
+    if (a.adv_w != b.adv_w || a.box_w != b.box_w || a.box_h != b.box_h || a.ofs_x != b.ofs_x ||
+        a.ofs_y != b.ofs_y || a.bpp != b.bpp) {
+        char what[160];
+        snprintf(what, sizeof(what), "dsc adv %u/%u box %ux%u/%ux%u ofs %d,%d/%d,%d bpp %u/%u", a.adv_w, b.adv_w,
+                 a.box_w, a.box_h, b.box_w, b.box_h, a.ofs_x, a.ofs_y, b.ofs_x, b.ofs_y, a.bpp, b.bpp);
+        mismatch(letter, what);
+        return false;
+    }
+    // 制表符的 box_w 是空格的两倍，位图仍是空格的，空格本身另外比较
+    const uint32_t size = ((uint32_t)b.box_w * b.box_h * b.bpp + 7) / 8;
+    if (letter == '\t' || size == 0) return true;
+    // 与绘制时相同，取位图紧跟在取描述之后（不缓存的大字形只在这一次调用内有效）
+    const uint8_t *bitmap_a = font->get_glyph_bitmap(font, letter);
+    const uint8_t *bitmap_b = ref->get_glyph_bitmap(ref, letter);
+    if (!bitmap_a || !bitmap_b || memcmp(bitmap_a, bitmap_b, size)) {
+        mismatch(letter, "bitmap");
+        return false;
+    }
+    return true;
+}
+
+int sim_font_check(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        printf("font_check_error=cannot open %s\n", path);
+        return 1;
+    }
+    static uint8_t hot[FONT_CHECK_HOT_BYTES];
+    static uint8_t lru[FONT_CHECK_LRU_BYTES];
+    const ui_font_cache_config_t cfg = {
+        .hot_mem = hot,
+        .hot_size = sizeof(hot),
+        .lru_mem = lru,
+        .lru_size = sizeof(lru),
+        .slot_bytes = FONT_CHECK_SLOT_BYTES,
+    };
+    static ui_font_t font;
+    const ui_font_src_t src = { .read = file_read, .ctx = file };
+    if (!ui_font_cache_init(&cfg) || !ui_font_open(&font, &src, NULL)) {
+        printf("font_check_error=ui_font cannot open %s\n", path);
+        fclose(file);
+        return 1;
+    }
+    // LVGL 的文件系统经 LV_USE_FS_STDIO 映射到盘符 S
+    char ref_path[512];
+    snprintf(ref_path, sizeof(ref_path), "S:%s", path);
+    lv_font_t *ref = lv_font_load(ref_path);
+    if (!ref) {
+        printf("font_check_error=lv_font_load cannot open %s\n", path);
+        ui_font_close(&font);
+        fclose(file);
+        return 1;
+    }
+
+    const lv_font_t *lf = &font.font;
+    if (lf->line_height != ref->line_height || lf->base_line != ref->base_line ||
+        lf->underline_position != ref->underline_position || lf->underline_thickness != ref->underline_thickness ||
+        lf->subpx != ref->subpx) {
+        printf("font_check_error=header line_height %d/%d base_line %d/%d underline %d,%d/%d,%d\n",
+               lf->line_height, ref->line_height, lf->base_line, ref->base_line, lf->underline_position,
+               lf->underline_thickness, ref->underline_position, ref->underline_thickness);
+        g_mismatches++;
+    }
+
+    // 第一遍按码点顺序扫过每个子表的整个范围，记下查到的码点
+    uint32_t range_total = 0;
+    for (uint32_t k = 0; k < font.cmap_count; k++) range_total += font.cmaps[k].range_length;
+    uint32_t *letters = malloc((range_total + 1) * sizeof(uint32_t));
+    uint32_t glyphs = 0;
+    bool has_space = false;
+    for (uint32_t k = 0; letters && k < font.cmap_count; k++) {
+        const ui_font_cmap_t *c = &font.cmaps[k];
+        for (uint32_t rcp = 0; rcp < c->range_length; rcp++) {
+            bool found;
+            compare_glyph(lf, ref, c->range_start + rcp, &found);
+            if (found) letters[glyphs++] = c->range_start + rcp;
+            if (found && c->range_start + rcp == ' ') has_space = true;
+        }
+    }
+    if (has_space) letters[glyphs++] = '\t';
+    // 字体之外的码点两边都应查不到
+    static const uint32_t absent[] = { 0x01, 0x7F, 0xFFFF, 0x10FFFF };
+    for (size_t k = 0; k < sizeof(absent) / sizeof(absent[0]); k++) compare_glyph(lf, ref, absent[k], NULL);
+
+    // 按码点顺序的前几个字形当作常用字形
+    uint32_t common[FONT_CHECK_COMMON];
+    const uint32_t common_count = glyphs < FONT_CHECK_COMMON ? glyphs : FONT_CHECK_COMMON;
+    if (letters) memcpy(common, letters, common_count * sizeof(uint32_t));
+    uint32_t rng = FONT_CHECK_SEED;
+    for (int pass = 0; letters && pass < FONT_CHECK_PASSES; pass++) {
+        for (uint32_t i = glyphs; i > 1; i--) {
+            const uint32_t j = xorshift32(&rng) % i;
+            const uint32_t t = letters[i - 1];
+            letters[i - 1] = letters[j];
+            letters[j] = t;
+        }
+        // 随机顺序里夹带紧邻的重复查询和常用字形，让字形在 LRU 层达到提升次数、热点层满后互相交换
+        for (uint32_t i = 0; i < glyphs; i++) {
+            const int repeat = (xorshift32(&rng) & 3) == 0 ? UI_FONT_PROMOTE_HITS + 1 : 1;
+            for (int r = 0; r < repeat; r++) compare_glyph(lf, ref, letters[i], NULL);
+            if (common_count && (xorshift32(&rng) & 1)) {
+                compare_glyph(lf, ref, common[xorshift32(&rng) % common_count], NULL);
+            }
+        }
+    }
+
+    ui_font_cache_stats_t st;
+    ui_font_cache_get_stats(&st);
+    printf("font_check_letters=%u\n", (unsigned)glyphs);
+    printf("font_check_cmaps=%u\n", (unsigned)font.cmap_count);
+    printf("font_check_hot_slots=%u\n", (unsigned)st.hot_slots);
+    printf("font_check_lru_slots=%u\n", (unsigned)st.lru_slots);
+    printf("font_check_lookups=%u\n", (unsigned)st.lookups);
+    printf("font_check_hot_hits=%u\n", (unsigned)st.hot_hits);
+    printf("font_check_lru_hits=%u\n", (unsigned)st.lru_hits);
+    printf("font_check_misses=%u\n", (unsigned)st.misses);
+    printf("font_check_promotions=%u\n", (unsigned)st.promotions);
+    printf("font_check_evictions=%u\n", (unsigned)st.evictions);
+    printf("font_check_uncached=%u\n", (unsigned)st.uncached);
+    if (!letters) {
+        printf("font_check_error=out of memory\n");
+        g_mismatches++;
+    }
+    if (st.read_errors || st.lookups != st.hot_hits + st.lru_hits + st.misses) {
+        printf("font_check_error=cache counters read_errors=%u\n", (unsigned)st.read_errors);
+        g_mismatches++;
+    }
+    printf("font_check_mismatches=%u\n", (unsigned)g_mismatches);
+
+    free(letters);
+    lv_font_free(ref);
+    ui_font_close(&font);
+    fclose(file);
+    return g_mismatches ? 1 : 0;
+}
@@ -0,0 +1,50 @@
+// sim_icon.c
+// 从磁盘文件加载图标图集，代替板上的图标分区（main/icon_partition.c）；解码预算与 Kconfig 默认值一致
+#include "sim.h"
+#include "ui_icon.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char *TAG = "sim_icon";
+
+#define SIM_ICON_CACHE_BYTES    (512 * 1024)
+
+static FILE *g_file;
+static perf_hist_t g_decode_hist;
+static bool g_loaded;
+
+static bool file_read(void *ctx, uint32_t offset, void *buf, uint32_t len) {
+    (void)ctx;
+    return fseek(g_file, (long)offset, SEEK_SET) == 0 && fread(buf, 1, len, g_file) == len;
+}
+
+bool sim_icon_load(const char *path) {
+    g_file = fopen(path, "rb");
+    if (!g_file) {
+        ESP_LOGE(TAG, "cannot open %s", path);
+        return false;
+    }
+    const ui_icon_cache_config_t cfg = {
+        .alloc = malloc,
+        .free = free,
+        .budget = SIM_ICON_CACHE_BYTES,
+        .decode_hist = &g_decode_hist,
+    };
+    perf_hist_reset(&g_decode_hist);
+    const ui_icon_src_t src = { .read = file_read };
+    if (!ui_icon_open(&src, &cfg)) {
+        fclose(g_file);
+        return false;
+    }
+    g_loaded = true;
+    return true;
+}
+
+bool sim_icon_loaded(void) {
+    return g_loaded;
+}
+
+const perf_hist_t *sim_icon_decode_hist(void) {
+    return &g_decode_hist;
+}
@@ -0,0 +1,313 @@
+// sim_input.c
+// 脚本化的触摸输入设备，事件按时间顺序执行。
+// 触摸样本与板上的 touchpad_read 一样先入队，read_cb 逐个取出送给手势引擎和 LVGL（缓冲模式）。
+// 脚本里的 expect 行不是事件，而是期望识别出的手势，回放时按顺序核对。
+#include "sim.h"
+#include "ui.h"
+#include "lvgl.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "sim_input";
+
+typedef enum {
+    EV_PRESS,
+    EV_MOVE,
+    EV_RELEASE,
+    EV_TOUCH,
+    EV_LOG,
+    EV_CLEAR,
+    EV_FIND,
+    EV_JUMP,
+    EV_DUMP,
+    EV_QUIT,
+    EV_EXPECT,
+} ev_type_t;
+
+typedef struct {
+    ui_gesture_type_t type;
+    ui_gesture_phase_t phase;
+    ui_gesture_dir_t dir;
+} sim_expect_t;
+
+typedef struct {
+    uint32_t time_ms;
+    ev_type_t type;
+    ui_gesture_input_t touch;   // press / move / release / touch 的触点
+    char *text;     // log 正文、find 的文本或 dump 文件名
+    uint32_t jump_ms;
+    sim_expect_t expect;
+} sim_event_t;
+
+static sim_event_t *g_events;
+static int g_event_count;
+static int g_event_next;
+static const char *g_dump_dir = ".";
+
+// 长按由没有新样本时的 tick 触发，时间取决于 LVGL 读输入的周期（30 ms）和 --step
+#define SIM_EXPECT_SLACK_MS 50
+
+static sim_event_t *g_expects;  // 只用 time_ms 和 expect
+static int g_expect_count;
+static int g_expect_next;
+static bool g_expect_failed;
+
+static const char *const g_phase_names[] = { "begin", "update", "end" };
+static const char *const g_dir_names[] = { "-", "left", "right", "up", "down" };
+
+#define SIM_TOUCH_QUEUE 32     // 与 TOUCH_SAMPLER_RING_SIZE 相同
+
+static lv_indev_drv_t g_indev_drv;
+static ui_gesture_input_t g_touch_queue[SIM_TOUCH_QUEUE];
+static uint32_t g_touch_head, g_touch_tail;
+static ui_gesture_input_t g_touch_last;
+
+static void touch_push(const ui_gesture_input_t *in) {
+    if (g_touch_head - g_touch_tail >= SIM_TOUCH_QUEUE) {
+        ESP_LOGW(TAG, "touch queue full, sample at %u ms dropped", (unsigned)in->time_ms);
+        return;
+    }
+    g_touch_queue[g_touch_head++ % SIM_TOUCH_QUEUE] = *in;
+}
+
+static void read_cb(lv_indev_drv_t *drv, lv_indev_data_t *data) {
+    (void)drv;
+    if (g_touch_tail != g_touch_head) {
+        ui_gesture_input_t in = g_touch_queue[g_touch_tail++ % SIM_TOUCH_QUEUE];
+        if (in.count == 0) {
+            // 松开时 LVGL 停在最后的位置
+            memcpy(in.points, g_touch_last.points, sizeof(in.points));
+        }
+        g_touch_last = in;
+        ui_touch_feed(&in);
+    } else {
+        ui_touch_tick(sim_tick_ms());
+    }
+    data->point.x = g_touch_last.points[0].x;
+    data->point.y = g_touch_last.points[0].y;
+    data->state = g_touch_last.count ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    data->continue_reading = g_touch_tail != g_touch_head;
+}
+
+static int name_index(const char *name, const char *const *names, int count) {
+    for (int i = 0; i < count; i++) {
+        if (!strcmp(name, names[i])) return i;
+    }
+    return -1;
+}
+
+// expect 类型 阶段 [方向]，例如 expect swipe end right
+static bool parse_expect(const char *rest, int line_no, sim_expect_t *x) {
+    char type[16], phase[16], dir[16] = "-";
+    if (sscanf(rest, "%15s %15s %15s", type, phase, dir) < 2) {
+        ESP_LOGW(TAG, "line %d: expect needs a type and a phase", line_no);
+        return false;
+    }
+    int t = -1;
+    for (int i = UI_GESTURE_TAP; i <= UI_GESTURE_PAN; i++) {
+        if (!strcmp(type, ui_gesture_type_name((ui_gesture_type_t)i))) t = i;
+    }
+    const int p = name_index(phase, g_phase_names, 3);
+    const int d = name_index(dir, g_dir_names, 5);
+    // UPDATE 的个数取决于采样点，不核对
+    if (t < 0 || p < 0 || p == UI_GESTURE_UPDATE || d < 0) {
+        ESP_LOGW(TAG, "line %d: expect '%s %s %s' is not a gesture begin / end", line_no, type, phase, dir);
+        return false;
+    }
+    x->type = (ui_gesture_type_t)t;
+    x->phase = (ui_gesture_phase_t)p;
+    x->dir = (ui_gesture_dir_t)d;
+    return true;
+}
+
+static void expect_fail(const sim_event_t *want, const ui_gesture_event_t *got) {
+    char want_text[64] = "nothing";
+    char got_text[64] = "nothing";
+    if (want) {
+        snprintf(want_text, sizeof(want_text), "%s %s %s at %u ms", ui_gesture_type_name(want->expect.type),
+                 g_phase_names[want->expect.phase], g_dir_names[want->expect.dir], (unsigned)want->time_ms);
+    }
+    if (got) {
+        snprintf(got_text, sizeof(got_text), "%s %s %s at %u ms", ui_gesture_type_name(got->type),
+                 g_phase_names[got->phase], g_dir_names[got->dir], (unsigned)got->time_ms);
+    }
+    ESP_LOGE(TAG, "gesture %d: expected %s, got %s", g_expect_next + 1, want_text, got_text);
+    g_expect_failed = true;
+}
+
+// 每个识别出的开始 / 结束事件必须与下一条 expect 一致，时间相差不超过 SIM_EXPECT_SLACK_MS
+static void gesture_observer(const ui_gesture_event_t *ev, void *user_data) {
+    (void)user_data;
+    if (ev->phase == UI_GESTURE_UPDATE || g_expect_failed) return;
+    const sim_event_t *want = g_expect_next < g_expect_count ? &g_expects[g_expect_next] : NULL;
+    const int32_t late_ms = want ? (int32_t)(ev->time_ms - want->time_ms) : 0;
+    if (!want || ev->type != want->expect.type || ev->phase != want->expect.phase || ev->dir != want->expect.dir ||
+        late_ms > SIM_EXPECT_SLACK_MS || late_ms < -SIM_EXPECT_SLACK_MS) {
+        expect_fail(want, ev);
+        return;
+    }
+    g_expect_next++;
+}
+
+static bool parse_line(char *line, int line_no, sim_event_t *ev) {
+    char *p = line + strspn(line, " \t");
+    if (*p == '#' || *p == '\n' || *p == '\0') return false;
+    char action[16];
+    int consumed = 0;
+    unsigned long t;
+    if (sscanf(p, "%lu %15s %n", &t, action, &consumed) < 2) {
+        ESP_LOGW(TAG, "line %d: expected <time_ms> <action>", line_no);
+        return false;
+    }
+    char *rest = p + consumed;
+    rest[strcspn(rest, "\r\n")] = '\0';
+    memset(ev, 0, sizeof(*ev));
+    ev->time_ms = (uint32_t)t;
+    int x = 0, y = 0;
+    if (!strcmp(action, "press") || !strcmp(action, "move")) {
+        if (sscanf(rest, "%d %d", &x, &y) != 2) {
+            ESP_LOGW(TAG, "line %d: %s needs x y", line_no, action);
+            return false;
+        }
+        ev->type = action[0] == 'p' ? EV_PRESS : EV_MOVE;
+        ev->touch.count = 1;
+        ev->touch.points[0].x = (int16_t)x;
+        ev->touch.points[0].y = (int16_t)y;
+    } else if (!strcmp(action, "release")) {
+        ev->type = EV_RELEASE;
+    } else if (!strcmp(action, "touch")) {
+        // touch n x0 y0 ... 与板上 touch_trace 的输出格式相同，n 为 0 表示松开
+        int n = 0, used = 0;
+        if (sscanf(rest, "%d %n", &n, &used) < 1 || n < 0 || n > UI_GESTURE_MAX_POINTS) {
+            ESP_LOGW(TAG, "line %d: touch needs a count of 0..%d", line_no, UI_GESTURE_MAX_POINTS);
+            return false;
+        }
+        char *q = rest + used;
+        for (int i = 0; i < n; i++) {
+            if (sscanf(q, "%d %d %n", &x, &y, &used) < 2) {
+                ESP_LOGW(TAG, "line %d: touch needs %d x y pairs", line_no, n);
+                return false;
+            }
+            ev->touch.points[i].x = (int16_t)x;
+            ev->touch.points[i].y = (int16_t)y;
+            q += used;
+        }
+        ev->type = EV_TOUCH;
+        ev->touch.count = (uint8_t)n;
+    } else if (!strcmp(action, "log")) {
+        ev->type = EV_LOG;
+        ev->text = strdup(rest);
+    } else if (!strcmp(action, "clear")) {
+        ev->type = EV_CLEAR;
+    } else if (!strcmp(action, "find")) {
+        ev->type = EV_FIND;
+        ev->text = strdup(rest);
+    } else if (!strcmp(action, "jump")) {
+        ev->type = EV_JUMP;
+        ev->jump_ms = *rest ? (uint32_t)strtoul(rest, NULL, 0) : UINT32_MAX;
+    } else if (!strcmp(action, "dump")) {
+        ev->type = EV_DUMP;
+        ev->text = strdup(*rest ? rest : "frame.ppm");
+    } else if (!strcmp(action, "quit")) {
+        ev->type = EV_QUIT;
+    } else if (!strcmp(action, "expect")) {
+        if (!parse_expect(rest, line_no, &ev->expect)) return false;
+        ev->type = EV_EXPECT;
+    } else {
+        ESP_LOGW(TAG, "line %d: unknown action '%s'", line_no, action);
+        return false;
+    }
+    return true;
+}
+
+bool sim_input_init(const char *script_path) {
+    lv_indev_drv_init(&g_indev_drv);
+    g_indev_drv.type = LV_INDEV_TYPE_POINTER;
+    g_indev_drv.read_cb = read_cb;
+    lv_indev_drv_register(&g_indev_drv);
+
+    if (!script_path) return true;
+    FILE *f = fopen(script_path, "r");
+    if (!f) {
+        ESP_LOGE(TAG, "cannot open %s", script_path);
+        return false;
+    }
+    char line[256];
+    int line_no = 0, cap = 0, expect_cap = 0;
+    sim_event_t ev;
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        if (!parse_line(line, line_no, &ev)) continue;
+        if (ev.type == EV_EXPECT) {
+            if (g_expect_count == expect_cap) {
+                expect_cap = expect_cap ? expect_cap * 2 : 16;
+                g_expects = realloc(g_expects, expect_cap * sizeof(*g_expects));
+            }
+            g_expects[g_expect_count++] = ev;
+            continue;
+        }
+        if (g_event_count == cap) {
+            cap = cap ? cap * 2 : 64;
+            g_events = realloc(g_events, cap * sizeof(*g_events));
+        }
+        g_events[g_event_count++] = ev;
+    }
+    fclose(f);
+    ESP_LOGI(TAG, "%d events, %d expected gestures loaded from %s", g_event_count, g_expect_count, script_path);
+    if (g_expect_count) ui_set_gesture_observer(gesture_observer, NULL);
+    return true;
+}
+
+bool sim_input_check(void) {
+    if (!g_expect_count) return true;
+    if (!g_expect_failed && g_expect_next < g_expect_count) expect_fail(&g_expects[g_expect_next], NULL);
+    printf("gesture_expected=%d\n", g_expect_count);
+    printf("gesture_matched=%d\n", g_expect_next);
+    return !g_expect_failed;
+}
+
+void sim_input_set_dump_dir(const char *dir) {
+    g_dump_dir = dir;
+}
+
+bool sim_input_step(uint32_t now_ms) {
+    while (g_event_next < g_event_count && g_events[g_event_next].time_ms <= now_ms) {
+        const sim_event_t *ev = &g_events[g_event_next++];
+        switch (ev->type) {
+        case EV_PRESS:
+        case EV_MOVE:
+        case EV_RELEASE:
+        case EV_TOUCH: {
+            ui_gesture_input_t in = ev->touch;
+            in.time_ms = ev->time_ms;
+            touch_push(&in);
+            break;
+        }
+        case EV_LOG:
+            ui_add_log(ev->text);
+            break;
+        case EV_CLEAR:
+            ui_clear_log();
+            break;
+        case EV_FIND:
+            ui_find_log(ev->text, UI_LOG_VERBOSE);
+            break;
+        case EV_JUMP:
+            ui_jump_log(ev->jump_ms);
+            break;
+        case EV_DUMP: {
+            char path[512];
+            snprintf(path, sizeof(path), "%s/%s", g_dump_dir, ev->text);
+            if (!sim_display_dump_ppm(path)) ESP_LOGE(TAG, "cannot write %s", path);
+            break;
+        }
+        case EV_QUIT:
+            return false;
+        case EV_EXPECT:
+            break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,211 @@
+// sim_log_bench.c
+// 日志生产者基准：同一条格式化日志分别走三条路径，只计生产者一侧每次调用的耗时
+//   legacy：改动前的做法，调用方 snprintf 正文，ui_add_log 再 snprintf 时间前缀，两段拷入队列
+//   text  ：调用方 snprintf 正文，ui_add_log 只记录时间和原文
+//   logf  ：ui_logf 只记录时间、格式串指针和打包的参数
+// 每批调用后由 ui_process_messages 取走并上屏（单独计时），队列不会溢出
+// esplog 系列是同一条日志以 esp_log 的行格式经 ui_log_bridge 写入：
+//   esplog           ：通过限速（每批之前重置令牌桶）写入界面日志
+//   esplog_suppressed：单个标签刷屏，几乎全部被令牌桶丢掉
+//   esplog_filtered  ：DEBUG 级别，被级别过滤
+// 最后在填满的历史存储区上计时一次找不到的搜索（遍历全部存储行）和一次时间跳转
+#include "sim.h"
+#include "ui.h"
+#include "ui_log.h"
+#include "ui_log_bridge.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+
+#define LOG_BENCH_BATCH 32      // 每批调用数，32 条典型日志约占命令队列的一半
+#define LOG_BENCH_FMT   "ch%d %s=%ld.%03ld mV raw=0x%04x"
+
+static const char *const g_names[] = { "vin", "vbat", "i_motor", "temp" };
+
+#define LOG_BENCH_ARGS(i) (int)((i) % 4), g_names[(i) % 4], (long)((i) * 7919 % 50000 / 1000), \
+                          (long)((i) * 7919 % 1000), (unsigned)((i) & 0xFFFF)
+
+// 与 esp_log.h 的 LOG_FORMAT 相同（未启用颜色）
+#define ESP_LOG_FORMAT(letter, format) #letter " (%" PRIu32 ") %s: " format "\n"
+
+typedef void (*log_producer_t)(uint32_t i);
+
+typedef struct {
+    int64_t produce_ns;
+    int64_t consume_ns;
+    uint32_t rows_set;      // 格式化并排版的行数
+    uint32_t dropped;
+} log_bench_result_t;
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void produce_legacy(uint32_t i) {
+    char msg[128];
+    snprintf(msg, sizeof(msg), LOG_BENCH_FMT, LOG_BENCH_ARGS(i));
+    // 原 ui_add_log 的前缀格式化；前缀与现在的记录头同为 16 字节，入队拷贝量相同
+    uint32_t tick_ms = lv_tick_get();
+    uint32_t total_sec = tick_ms / 1000;
+    char prefix[24];
+    snprintf(prefix, sizeof(prefix), "[%02d:%02d:%02d.%03d] ", (int)(total_sec / 3600),
+             (int)(total_sec % 3600 / 60), (int)(total_sec % 60), (int)(tick_ms % 1000));
+    ui_add_log(msg);
+}
+
+static void produce_text(uint32_t i) {
+    char msg[128];
+    snprintf(msg, sizeof(msg), LOG_BENCH_FMT, LOG_BENCH_ARGS(i));
+    ui_add_log(msg);
+}
+
+static void produce_logf(uint32_t i) {
+    ui_logf(LOG_BENCH_FMT, LOG_BENCH_ARGS(i));
+}
+
+// esp_log_write 把这两个参数交给 vprintf 钩子
+static void esp_log_write_sim(const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    ui_log_bridge_write(fmt, ap);
+    va_end(ap);
+}
+
+static void produce_esp_log(uint32_t i) {
+    esp_log_write_sim(ESP_LOG_FORMAT(I, LOG_BENCH_FMT), (uint32_t)i, "sensor", LOG_BENCH_ARGS(i));
+}
+
+static void produce_esp_logd(uint32_t i) {
+    esp_log_write_sim(ESP_LOG_FORMAT(D, LOG_BENCH_FMT), (uint32_t)i, "sensor", LOG_BENCH_ARGS(i));
+}
+
+static void bridge_init(uint16_t rate_per_s, uint8_t burst) {
+    const ui_log_bridge_config_t cfg = { .level = UI_LOG_INFO, .rate_per_s = rate_per_s, .burst = burst };
+    ui_log_bridge_init(&cfg);
+}
+
+// 令牌桶容量大于一批，每批之前装满，让每次调用都走写入路径
+static void bridge_refill(void) {
+    bridge_init(1000, UI_LOG_BRIDGE_BURST_MAX);
+}
+
+// before_batch 不计时，NULL 表示不需要
+static void run(log_producer_t produce, void (*before_batch)(void), uint32_t count, log_bench_result_t *res) {
+    ui_log_stats_t log_before, log_after;
+    ui_ring_stats_t queue_before, queue_after;
+    ui_log_get_stats(&log_before);
+    ui_get_queue_stats(&queue_before);
+    memset(res, 0, sizeof(*res));
+    for (uint32_t i = 0; i < count;) {
+        if (before_batch) before_batch();
+        const int64_t t0 = now_ns();
+        for (uint32_t k = 0; k < LOG_BENCH_BATCH && i < count; k++, i++) {
+            produce(i);
+        }
+        const int64_t t1 = now_ns();
+        ui_process_messages();
+        res->produce_ns += t1 - t0;
+        res->consume_ns += now_ns() - t1;
+    }
+    ui_log_get_stats(&log_after);
+    ui_get_queue_stats(&queue_after);
+    res->rows_set = log_after.rows_set - log_before.rows_set;
+    res->dropped = queue_after.dropped - queue_before.dropped;
+}
+
+static size_t pack(uint8_t *out, size_t cap, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    size_t len = ui_log_pack_args(out, cap, fmt, ap);
+    va_end(ap);
+    return len;
+}
+
+// 延迟格式化的文本必须与直接 snprintf 逐字相同
+static uint32_t check_format(uint32_t count) {
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        char expect[UI_LOG_LINE_MAX], got[UI_LOG_LINE_MAX];
+        uint8_t args[UI_LOG_ARGS_MAX];
+        snprintf(expect, sizeof(expect), LOG_BENCH_FMT, LOG_BENCH_ARGS(i));
+        size_t len = pack(args, sizeof(args), LOG_BENCH_FMT, LOG_BENCH_ARGS(i));
+        ui_log_format(got, sizeof(got), LOG_BENCH_FMT, args, len);
+        if (strcmp(expect, got) != 0) mismatches++;
+    }
+    return mismatches;
+}
+
+static void print_result(const char *name, uint32_t count, const log_bench_result_t *res) {
+    printf("%s_ns_per_call=%.1f\n", name, (double)res->produce_ns / count);
+    printf("%s_consume_ns_per_call=%.1f\n", name, (double)res->consume_ns / count);
+    printf("%s_rows_formatted=%u\n", name, (unsigned)res->rows_set);
+    printf("%s_dropped=%u\n", name, (unsigned)res->dropped);
+}
+
+int sim_log_bench(uint32_t count) {
+    if (count == 0) count = 1000000;
+    static const struct {
+        const char *name;
+        log_producer_t produce;
+        void (*before_batch)(void);
+    } paths[] = {
+        { "legacy", produce_legacy, NULL },
+        { "text", produce_text, NULL },
+        { "logf", produce_logf, NULL },
+        { "esplog", produce_esp_log, bridge_refill },
+    };
+    log_bench_result_t results[sizeof(paths) / sizeof(paths[0])];
+
+    // 预热一遍，让日志行全部填满，之后每批都走滚动路径
+    for (size_t p = 0; p < sizeof(paths) / sizeof(paths[0]); p++) {
+        run(paths[p].produce, paths[p].before_batch, count / 10 + UI_LOG_MAX_LINES, &results[p]);
+    }
+    for (size_t p = 0; p < sizeof(paths) / sizeof(paths[0]); p++) {
+        run(paths[p].produce, paths[p].before_batch, count, &results[p]);
+    }
+    const uint32_t mismatches = check_format(count < 100000 ? count : 100000);
+
+    // 刷屏：每秒 10 行、容量 20 行的令牌桶，结束后汇总被丢的行数
+    log_bench_result_t flood, filtered;
+    ui_log_bridge_stats_t bridge;
+    bridge_init(10, 20);
+    run(produce_esp_log, NULL, count, &flood);
+    ui_log_bridge_flush();
+    ui_process_messages();
+    ui_log_bridge_get_stats(&bridge);
+    run(produce_esp_logd, NULL, count, &filtered);
+
+    ui_log_stats_t log;
+    int64_t t0 = now_ns();
+    const bool found = ui_log_find("no such line", UI_LOG_VERBOSE);
+    const int64_t find_ns = now_ns() - t0;
+    t0 = now_ns();
+    ui_log_jump(0);
+    const int64_t jump_ns = now_ns() - t0;
+    ui_log_jump(UINT32_MAX);
+    ui_log_get_stats(&log);
+
+    printf("log_bench_calls=%u\n", (unsigned)count);
+    printf("log_bench_batch=%u\n", (unsigned)LOG_BENCH_BATCH);
+    for (size_t p = 0; p < sizeof(paths) / sizeof(paths[0]); p++) {
+        print_result(paths[p].name, count, &results[p]);
+    }
+    printf("logf_speedup=%.2f\n", (double)results[0].produce_ns / (results[2].produce_ns ? results[2].produce_ns : 1));
+    printf("esplog_suppressed_ns_per_call=%.1f\n", (double)flood.produce_ns / count);
+    printf("esplog_filtered_ns_per_call=%.1f\n", (double)filtered.produce_ns / count);
+    printf("esplog_flood_shown=%u\n", (unsigned)bridge.shown);
+    printf("esplog_flood_suppressed=%u\n", (unsigned)bridge.suppressed);
+    printf("esplog_flood_summaries=%u\n", (unsigned)bridge.summaries);
+    printf("logf_format_mismatches=%u\n", (unsigned)mismatches);
+    printf("log_stored=%u\n", (unsigned)log.stored);
+    printf("log_store_used=%u\n", (unsigned)log.store_used);
+    printf("log_evicted=%u\n", (unsigned)log.evicted);
+    printf("log_find_miss_us=%.1f\n", find_ns / 1000.0);
+    printf("log_jump_us=%.1f\n", jump_ns / 1000.0);
+    return mismatches || found || results[2].dropped || results[3].dropped ||
+           bridge.shown + bridge.suppressed != count || !bridge.summaries ? 1 : 0;
+}
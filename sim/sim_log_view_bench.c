@@ -0,0 +1,154 @@
+// sim_log_view_bench.c
+// 日志视图基准：视图填满之后每帧追加若干行，比较两种视图的上屏开销
+//   textarea：改动前 ui.c 的做法，保留最近 UI_LOG_MAX_LINES 行，每行到达都拼接全部文本重设 lv_textarea
+//   rows    ：ui_log 的行对象池，每帧 ui_log_commit 一次
+// 每帧之后 lv_refr_now 立即渲染，计时包括追加、排版和渲染；flushed_px 取自模拟显示实际刷出的像素，
+// rows 另给出 ui_log 自己统计的失效像素。两种视图放在同样大小（宽 100%、高 240）的容器里。
+// 视图填满后每追加一行，所有行都上移一行，整个日志区都要重绘：行对象池省掉的是整段文本的拼接和重新排版，
+// 重绘的像素与 textarea 同量级，flushed_px_per_line 会直接反映这一点。
+#include "sim.h"
+#include "ui.h"
+#include "ui_log.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define LOG_VIEW_HEIGHT     240
+#define LOG_VIEW_LINE_MAX   128
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void make_line(char *out, size_t cap, uint32_t i) {
+    snprintf(out, cap, "[00:%02u:%02u.%03u] ch%u vin=%u.%03u mV raw=0x%04x", (unsigned)(i / 60000 % 60),
+             (unsigned)(i / 1000 % 60), (unsigned)(i % 1000), (unsigned)(i % 4), (unsigned)(i * 7919 % 50000 / 1000),
+             (unsigned)(i * 7919 % 1000), (unsigned)(i & 0xFFFF));
+}
+
+// === 改动前的 textarea 视图 ===
+static lv_obj_t *g_textarea;
+static char g_lines[UI_LOG_MAX_LINES][LOG_VIEW_LINE_MAX];
+static char g_text[UI_LOG_MAX_LINES * LOG_VIEW_LINE_MAX];
+static uint32_t g_line_index;
+static uint32_t g_line_count;
+
+static void textarea_add(const char *line) {
+    strncpy(g_lines[g_line_index], line, LOG_VIEW_LINE_MAX - 1);
+    g_lines[g_line_index][LOG_VIEW_LINE_MAX - 1] = '\0';
+    g_line_index = (g_line_index + 1) % UI_LOG_MAX_LINES;
+    if (g_line_count < UI_LOG_MAX_LINES) g_line_count++;
+    size_t pos = 0;
+    for (uint32_t i = 0; i < g_line_count; i++) {
+        const char *src = g_lines[(g_line_index + UI_LOG_MAX_LINES - g_line_count + i) % UI_LOG_MAX_LINES];
+        const size_t len = strlen(src);
+        memcpy(g_text + pos, src, len);
+        pos += len;
+        g_text[pos++] = '\n';
+    }
+    g_text[pos] = '\0';
+    lv_textarea_set_text(g_textarea, g_text);
+    lv_textarea_set_cursor_pos(g_textarea, LV_TEXTAREA_CURSOR_LAST);
+}
+
+static void textarea_create(lv_obj_t *parent) {
+    g_textarea = lv_textarea_create(parent);
+    lv_obj_set_size(g_textarea, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_bg_color(g_textarea, lv_color_black(), 0);
+    lv_obj_set_style_text_color(g_textarea, lv_color_hex(0x00FF00), 0);
+    lv_obj_set_scrollbar_mode(g_textarea, LV_SCROLLBAR_MODE_AUTO);
+    lv_textarea_set_one_line(g_textarea, false);
+    lv_textarea_set_text(g_textarea, "");
+    g_line_index = 0;
+    g_line_count = 0;
+}
+
+// === 行对象池 ===
+static void rows_add(const char *line) {
+    const ui_log_rec_hdr_t hdr = { .tick_ms = 0, .level = UI_LOG_INFO };
+    ui_log_append(&hdr, line, strlen(line));
+}
+
+// === 计时 ===
+typedef struct {
+    int64_t ns;
+    uint64_t flushed_px;
+    uint32_t frames;
+    uint32_t invalidated_px;    // 仅 rows
+} view_result_t;
+
+static void run(bool rows, uint32_t count, uint32_t per_frame, view_result_t *res) {
+    lv_obj_t *scr = lv_obj_create(NULL);
+    lv_scr_load(scr);
+    lv_obj_t *box = lv_obj_create(scr);
+    lv_obj_set_size(box, LV_PCT(100), LOG_VIEW_HEIGHT);
+    lv_obj_set_style_border_width(box, 0, 0);
+    lv_obj_set_style_bg_color(box, lv_color_hex(0x0d0d0d), 0);
+    if (rows) {
+        ui_log_create(box);
+        ui_log_clear();
+    } else {
+        textarea_create(box);
+    }
+
+    // 先填满视图，之后每行都走滚动路径
+    char line[LOG_VIEW_LINE_MAX];
+    for (uint32_t i = 0; i < UI_LOG_MAX_LINES; i++) {
+        make_line(line, sizeof(line), i);
+        if (rows) rows_add(line);
+        else textarea_add(line);
+    }
+    if (rows) ui_log_commit();
+    lv_refr_now(NULL);
+
+    sim_display_stats_t disp_before, disp_after;
+    ui_log_stats_t log_before, log_after;
+    sim_display_get_stats(&disp_before);
+    ui_log_get_stats(&log_before);
+    const int64_t start = now_ns();
+    for (uint32_t i = 0; i < count;) {
+        for (uint32_t k = 0; k < per_frame && i < count; k++, i++) {
+            make_line(line, sizeof(line), UI_LOG_MAX_LINES + i);
+            if (rows) rows_add(line);
+            else textarea_add(line);
+        }
+        if (rows) ui_log_commit();
+        lv_refr_now(NULL);
+    }
+    res->ns = now_ns() - start;
+    sim_display_get_stats(&disp_after);
+    ui_log_get_stats(&log_after);
+    res->flushed_px = disp_after.flushed_px - disp_before.flushed_px;
+    res->frames = disp_after.frames - disp_before.frames;
+    res->invalidated_px = log_after.invalidated_px - log_before.invalidated_px;
+
+    lv_scr_load(lv_obj_create(NULL));
+    lv_obj_del(scr);
+}
+
+static void print_result(const char *name, uint32_t per_frame, uint32_t count, const view_result_t *res, bool rows) {
+    printf("%s_%u_lines_per_s=%.0f\n", name, (unsigned)per_frame, (double)count * 1e9 / (double)(res->ns ? res->ns : 1));
+    printf("%s_%u_frames=%u\n", name, (unsigned)per_frame, (unsigned)res->frames);
+    printf("%s_%u_flushed_px_per_line=%.0f\n", name, (unsigned)per_frame, (double)res->flushed_px / count);
+    if (rows) {
+        printf("%s_%u_invalidated_px_per_line=%.0f\n", name, (unsigned)per_frame, (double)res->invalidated_px / count);
+    }
+}
+
+int sim_log_view_bench(uint32_t count) {
+    static const uint32_t per_frame[] = { 1, 8 };
+    if (count == 0) count = 2000;
+    ui_log_store_init(NULL, 0);
+    printf("log_view_lines=%u\n", (unsigned)count);
+    printf("log_view_area_px=%u\n", (unsigned)(SIM_HOR_RES * LOG_VIEW_HEIGHT));
+    for (size_t p = 0; p < sizeof(per_frame) / sizeof(per_frame[0]); p++) {
+        view_result_t textarea, rows;
+        run(false, count, per_frame[p], &textarea);
+        run(true, count, per_frame[p], &rows);
+        print_result("textarea", per_frame[p], count, &textarea, false);
+        print_result("rows", per_frame[p], count, &rows, true);
+    }
+    return 0;
+}
@@ -0,0 +1,427 @@
+// sim_main.c
+// 主机模拟器入口：主线程扮演 lvgl_port_task，流程与板上一致
+//   ui_process_messages() -> lv_timer_handler() -> 等待唤醒或下一个定时器
+#include "sim.h"
+#include "ui.h"
+#include "ui_log.h"
+#include "ui_bench.h"
+#include "lvgl.h"
+#include "lvgl_mem.h"
+#include "ui_font.h"
+#include "ui_icon.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+static const char *TAG = "sim";
+
+#define SIM_TASK_MAX_DELAY_MS 500   // 与 CONFIG_EXAMPLE_LVGL_PORT_TASK_MAX/MIN_DELAY_MS 一致
+#define SIM_TASK_MIN_DELAY_MS 10
+#define SIM_LOG_STORE_BYTES (1024 * 1024)  // 与 CONFIG_EXAMPLE_LOG_STORE_KB 默认值一致
+
+typedef struct {
+    uint32_t frames;        // 达到该帧数后退出，0 不限
+    uint32_t duration_ms;   // 达到该时长后退出，0 不限
+    uint32_t step_ms;       // 虚拟时钟步长，0 使用真实时间
+    uint32_t log_period_ms;
+    uint32_t dump_every;    // 每 N 帧导出一张 PPM，0 不导出
+    const char *script;
+    const char *dump_dir;
+    bool threaded;          // 示例数据由独立线程产生（仅真实时间）
+    ui_ring_policy_t policy;
+    bool bench;             // 运行基准负载，结束后输出结果并退出
+    ui_bench_config_t bench_config;
+    ui_bench_format_t bench_format;
+    const char *bench_out;  // 结果文件，默认 stdout
+    uint32_t mem_bench_ops; // 只运行分配器基准，0 不运行
+    uint32_t ring_check_entries; // 只运行命令队列多生产者校验，0 不运行
+    uint32_t rotate_cases;  // 只运行软件旋转校验，0 不运行
+    uint32_t log_bench_calls; // 只运行日志生产者基准，0 不运行
+    uint32_t log_view_lines; // 只运行日志视图基准，0 不运行
+    uint32_t blend_cases;   // 只运行混合内核校验，0 不运行
+    const char *font_check; // 只运行字体校验，NULL 不运行
+    const char *font;       // 字体文件，代替板上的字体分区
+    const char *icons;      // 图标图集文件，代替板上的图标分区
+    const char *uart;       // 串口命令协议的设备，"pty" 新建伪终端
+} sim_options_t;
+
+static pthread_mutex_t g_wake_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_wake_cond;
+static bool g_wake_pending;
+static volatile bool g_running = true;
+
+static void sim_wake(void) {
+    pthread_mutex_lock(&g_wake_lock);
+    g_wake_pending = true;
+    pthread_cond_signal(&g_wake_cond);
+    pthread_mutex_unlock(&g_wake_lock);
+}
+
+static void sim_wait(uint32_t timeout_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+    pthread_mutex_lock(&g_wake_lock);
+    while (!g_wake_pending) {
+        if (pthread_cond_timedwait(&g_wake_cond, &g_wake_lock, &deadline) != 0) break;
+    }
+    g_wake_pending = false;
+    pthread_mutex_unlock(&g_wake_lock);
+}
+
+static void demo_task(void *arg) {
+    (void)arg;
+    while (g_running) {
+        sim_demo_step(sim_tick_ms());
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+}
+
+#define SIM_BENCH_DRAIN_MS 200
+
+static void bench_write(const char *text, void *ctx) {
+    fputs(text, (FILE *)ctx);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --frames N        stop after N frames\n"
+            "  --duration MS     stop after MS milliseconds of UI time\n"
+            "  --step MS         virtual clock, advance MS per loop (reproducible frames)\n"
+            "  --script FILE     scripted input, see sim.h\n"
+            "  --dump-dir DIR    directory for PPM dumps (default .)\n"
+            "  --dump-every N    dump every Nth frame as frame_NNNNN.ppm\n"
+            "  --log-period MS   demo log period, 0 disables (default 10000)\n"
+            "  --threaded        produce demo data from a separate thread\n"
+            "  --policy P        queue overflow policy: newest | oldest | block\n"
+            "  --bench W         run a benchmark workload: log_flood | status_rate | button_relabel\n"
+            "                    | mixed | plot_stream\n"
+            "                    (--duration sets its length, default 5000)\n"
+            "  --bench-rate HZ   workload rate, 0 uses the workload default\n"
+            "  --bench-format F  csv | json (default csv)\n"
+            "  --bench-out FILE  write the benchmark result to FILE instead of stdout\n"
+            "  --log-level N     1 error .. 5 verbose (default 3), 4 also prints recognized gestures\n"
+            "  --mem-bench N     compare lvgl_mem with malloc over N LVGL-like allocations and exit\n"
+            "  --ring-check N    push N entries per producer thread through ui_ring under every overflow policy,\n"
+            "                    check payloads and counters and exit\n"
+            "  --rotate-check N  compare rgb565_rotate_area with a per-pixel reference over N random areas and exit\n"
+            "  --log-bench N     compare ui_logf with snprintf + ui_add_log over N log calls and exit\n"
+            "  --log-view-bench N\n"
+            "                    append N lines to a full log view, former textarea against the row pool, and exit\n"
+            "  --blend-check N   compare the blend kernels with LVGL over N random blends, time both and exit\n"
+            "  --font-check FILE compare ui_font with lv_font_load() glyph by glyph on FILE and exit\n"
+            "  --font FILE       screen font from FILE (lv_font_conv --format bin --no-compress), as the font partition\n"
+            "  --icons FILE      button and status icons from FILE (sim/scripts/iconpack.py), as the icon partition\n"
+            "  --uart DEV        accept ui_proto command frames on DEV, or on a new pty with DEV=pty\n"
+            "                    (its path is printed to stderr as uart_pty=...), see sim/scripts/uictl.py\n",
+            prog);
+}
+
+static bool parse_args(int argc, char **argv, sim_options_t *opt) {
+    static const struct option longopts[] = {
+        { "frames", required_argument, NULL, 'f' },
+        { "duration", required_argument, NULL, 'd' },
+        { "step", required_argument, NULL, 's' },
+        { "script", required_argument, NULL, 'i' },
+        { "dump-dir", required_argument, NULL, 'o' },
+        { "dump-every", required_argument, NULL, 'e' },
+        { "log-period", required_argument, NULL, 'l' },
+        { "threaded", no_argument, NULL, 't' },
+        { "policy", required_argument, NULL, 'p' },
+        { "bench", required_argument, NULL, 'b' },
+        { "bench-rate", required_argument, NULL, 'r' },
+        { "bench-format", required_argument, NULL, 'F' },
+        { "bench-out", required_argument, NULL, 'O' },
+        { "log-level", required_argument, NULL, 'L' },
+        { "mem-bench", required_argument, NULL, 'M' },
+        { "ring-check", required_argument, NULL, 'R' },
+        { "rotate-check", required_argument, NULL, 'A' },
+        { "log-bench", required_argument, NULL, 'G' },
+        { "log-view-bench", required_argument, NULL, 'V' },
+        { "blend-check", required_argument, NULL, 'X' },
+        { "font-check", required_argument, NULL, 'C' },
+        { "font", required_argument, NULL, 'T' },
+        { "icons", required_argument, NULL, 'I' },
+        { "uart", required_argument, NULL, 'U' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    *opt = (sim_options_t) {
+        .log_period_ms = 10000,
+        .dump_dir = ".",
+        .policy = UI_RING_DROP_NEWEST,
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "", longopts, NULL)) != -1) {
+        switch (c) {
+        case 'f': opt->frames = strtoul(optarg, NULL, 0); break;
+        case 'd': opt->duration_ms = strtoul(optarg, NULL, 0); break;
+        case 's': opt->step_ms = strtoul(optarg, NULL, 0); break;
+        case 'i': opt->script = optarg; break;
+        case 'o': opt->dump_dir = optarg; break;
+        case 'e': opt->dump_every = strtoul(optarg, NULL, 0); break;
+        case 'l': opt->log_period_ms = strtoul(optarg, NULL, 0); break;
+        case 't': opt->threaded = true; break;
+        case 'p':
+            if (!strcmp(optarg, "newest")) opt->policy = UI_RING_DROP_NEWEST;
+            else if (!strcmp(optarg, "oldest")) opt->policy = UI_RING_DROP_OLDEST;
+            else if (!strcmp(optarg, "block")) opt->policy = UI_RING_BLOCK;
+            else return false;
+            break;
+        case 'b':
+            if (!ui_bench_workload_from_name(optarg, &opt->bench_config.workload)) return false;
+            opt->bench = true;
+            break;
+        case 'r': opt->bench_config.rate_hz = strtoul(optarg, NULL, 0); break;
+        case 'F':
+            if (!strcmp(optarg, "csv")) opt->bench_format = UI_BENCH_CSV;
+            else if (!strcmp(optarg, "json")) opt->bench_format = UI_BENCH_JSON;
+            else return false;
+            break;
+        case 'O': opt->bench_out = optarg; break;
+        case 'L': sim_log_level = atoi(optarg); break;
+        case 'M': opt->mem_bench_ops = strtoul(optarg, NULL, 0); break;
+        case 'R': opt->ring_check_entries = strtoul(optarg, NULL, 0); break;
+        case 'A': opt->rotate_cases = strtoul(optarg, NULL, 0); break;
+        case 'G': opt->log_bench_calls = strtoul(optarg, NULL, 0); break;
+        case 'V': opt->log_view_lines = strtoul(optarg, NULL, 0); break;
+        case 'X': opt->blend_cases = strtoul(optarg, NULL, 0); break;
+        case 'C': opt->font_check = optarg; break;
+        case 'T': opt->font = optarg; break;
+        case 'I': opt->icons = optarg; break;
+        case 'U': opt->uart = optarg; break;
+        default: return false;
+        }
+    }
+    if (opt->bench) {
+        // 基准的时长由负载决定，主循环在负载结束后再多跑一小段让最后的命令上屏
+        opt->bench_config.duration_ms = opt->duration_ms ? opt->duration_ms : 5000;
+        opt->duration_ms = 0;
+        opt->log_period_ms = 0;
+    }
+    if (opt->threaded && opt->step_ms) {
+        fprintf(stderr, "--threaded needs the real clock, ignoring --step\n");
+        opt->step_ms = 0;
+    }
+    return optind == argc;
+}
+
+int main(int argc, char **argv) {
+    sim_options_t opt;
+    if (!parse_args(argc, argv, &opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (opt.mem_bench_ops) return sim_mem_bench(opt.mem_bench_ops);
+    if (opt.ring_check_entries) return sim_ring_check(opt.ring_check_entries);
+    if (opt.rotate_cases) return sim_rotate_check(opt.rotate_cases);
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&g_wake_cond, &attr);
+
+    sim_time_init(opt.step_ms);
+    lv_init();
+    if (opt.font_check) return sim_font_check(opt.font_check);
+    sim_display_init();
+    if (opt.blend_cases) return sim_blend_bench(opt.blend_cases);
+    if (opt.log_view_lines) return sim_log_view_bench(opt.log_view_lines);
+    if (!sim_input_init(opt.script)) return 1;
+    sim_input_set_dump_dir(opt.dump_dir);
+
+    ui_set_wakeup_cb(sim_wake);
+    if (opt.font) {
+        // 与 lvgl_port_task 相同：在 ui_init() 之前设置，所有控件继承该字体
+        const lv_font_t *font = sim_font_load(opt.font, LV_FONT_DEFAULT);
+        if (!font) return 1;
+        lv_obj_set_style_text_font(lv_scr_act(), font, 0);
+    }
+    if (opt.icons && !sim_icon_load(opt.icons)) return 1;
+    ui_log_store_init(malloc(SIM_LOG_STORE_BYTES), SIM_LOG_STORE_BYTES);
+    ui_init();
+    ui_set_queue_policy(opt.policy, 100);
+    if (opt.log_bench_calls) return sim_log_bench(opt.log_bench_calls);
+    sim_demo_init(opt.log_period_ms);
+    if (opt.uart && !sim_uart_start(opt.uart)) return 1;
+    if (opt.threaded && xTaskCreate(demo_task, "demo", 4096, NULL, 5, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "cannot start demo task");
+        return 1;
+    }
+
+    if (opt.bench) {
+        // 先让示例界面完成首帧，基准只测量负载本身
+        sim_demo_step(sim_tick_ms());
+        ui_process_messages();
+        lv_timer_handler();
+        if (!ui_bench_start(&opt.bench_config)) return 1;
+    }
+    uint32_t bench_end_ms = 0;
+
+    int64_t process_us = 0, render_us = 0;
+    const int64_t wall_start_us = esp_timer_get_time();
+    uint32_t dumped_frame = 0;
+    sim_display_stats_t disp;
+    while (1) {
+        const uint32_t now_ms = sim_tick_ms();
+        if (!sim_input_step(now_ms)) break;
+        if (!opt.threaded) sim_demo_step(now_ms);
+        if (opt.bench && !bench_end_ms && !ui_bench_step()) bench_end_ms = now_ms + SIM_BENCH_DRAIN_MS;
+
+        int64_t t0 = esp_timer_get_time();
+        if (ui_process_messages()) {
+            lv_disp_t *d = lv_disp_get_default();
+            if (d && d->refr_timer) lv_timer_ready(d->refr_timer);
+        }
+        int64_t t1 = esp_timer_get_time();
+        sim_display_begin_pass();
+        uint32_t delay_ms = lv_timer_handler();
+        int64_t t2 = esp_timer_get_time();
+        process_us += t1 - t0;
+        render_us += t2 - t1;
+
+        sim_display_get_stats(&disp);
+        if (opt.dump_every && disp.frames != dumped_frame && disp.frames % opt.dump_every == 0) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s/frame_%05u.ppm", opt.dump_dir, (unsigned)disp.frames);
+            if (!sim_display_dump_ppm(path)) ESP_LOGE(TAG, "cannot write %s", path);
+            dumped_frame = disp.frames;
+        }
+        if (opt.frames && disp.frames >= opt.frames) break;
+        if (opt.duration_ms && sim_tick_ms() >= opt.duration_ms) break;
+        if (bench_end_ms && (int32_t)(sim_tick_ms() - bench_end_ms) >= 0) break;
+
+        if (sim_time_is_virtual()) {
+            sim_time_advance();
+        } else {
+            if (delay_ms > SIM_TASK_MAX_DELAY_MS) delay_ms = SIM_TASK_MAX_DELAY_MS;
+            else if (delay_ms < SIM_TASK_MIN_DELAY_MS) delay_ms = SIM_TASK_MIN_DELAY_MS;
+            sim_wait(delay_ms);
+        }
+    }
+    g_running = false;
+    sim_uart_stop();
+
+    if (opt.bench) {
+        ui_bench_stop();
+        FILE *out = opt.bench_out ? fopen(opt.bench_out, "w") : stdout;
+        if (!out) {
+            ESP_LOGE(TAG, "cannot write %s", opt.bench_out);
+            return 1;
+        }
+        ui_bench_report(opt.bench_format, bench_write, out);
+        if (out != stdout) fclose(out);
+        else return 0;  // 结果占用 stdout，不再输出运行汇总
+    }
+
+    ui_ring_stats_t queue;
+    ui_log_stats_t log;
+    ui_status_stats_t status;
+    ui_gesture_stats_t gesture;
+    ui_plot_stats_t plot;
+    struct rusage usage;
+    ui_get_queue_stats(&queue);
+    ui_get_status_stats(&status);
+    ui_get_gesture_stats(&gesture);
+    ui_log_get_stats(&log);
+    ui_plot_get_stats(&plot);
+    getrusage(RUSAGE_SELF, &usage);
+    sim_display_get_stats(&disp);
+    const uint32_t frames = disp.frames ? disp.frames : 1;
+    printf("ui_time_ms=%u\n", (unsigned)sim_tick_ms());
+    printf("wall_us=%lld\n", (long long)(esp_timer_get_time() - wall_start_us));
+    printf("frames=%u\n", (unsigned)disp.frames);
+    printf("flushed_px=%llu\n", (unsigned long long)disp.flushed_px);
+    printf("px_per_frame_avg=%llu\n", (unsigned long long)(disp.flushed_px / frames));
+    printf("px_per_frame_max=%u\n", (unsigned)disp.max_frame_px);
+    printf("render_us=%lld\n", (long long)render_us);
+    printf("render_us_per_frame=%lld\n", (long long)(render_us / frames));
+    printf("process_us=%lld\n", (long long)process_us);
+    printf("queue_pushed=%u\n", (unsigned)queue.pushed);
+    printf("queue_popped=%u\n", (unsigned)queue.popped);
+    printf("queue_dropped=%u\n", (unsigned)queue.dropped);
+    printf("queue_high_water=%u\n", (unsigned)queue.high_water);
+    printf("log_commits=%u\n", (unsigned)log.commits);
+    printf("log_stored=%u\n", (unsigned)log.stored);
+    printf("log_evicted=%u\n", (unsigned)log.evicted);
+    printf("log_store_used=%u\n", (unsigned)log.store_used);
+    printf("log_finds=%u\n", (unsigned)log.finds);
+    printf("log_find_us_max=%u\n", (unsigned)log.find_us_max);
+    printf("status_applied=%u\n", (unsigned)status.applied);
+    printf("status_skipped=%u\n", (unsigned)status.skipped);
+    printf("status_labels_set=%u\n", (unsigned)status.labels_set);
+    printf("gesture_samples=%u\n", (unsigned)gesture.samples);
+    printf("gesture_events=%u\n", (unsigned)gesture.events);
+    const bool gestures_ok = sim_input_check();
+    printf("plot_samples=%u\n", (unsigned)plot.samples);
+    printf("plot_columns=%u\n", (unsigned)plot.columns);
+    printf("plot_dropped=%u\n", (unsigned)plot.dropped);
+    printf("plot_columns_drawn=%u\n", (unsigned)plot.columns_drawn);
+    printf("plot_invalidated_px=%u\n", (unsigned)plot.invalidated_px);
+    ui_proto_stats_t uart;
+    if (sim_uart_get_stats(&uart)) {
+        printf("uart_bytes=%u\n", (unsigned)uart.bytes);
+        printf("uart_frames=%u\n", (unsigned)uart.frames);
+        printf("uart_commands=%u\n", (unsigned)uart.commands);
+        printf("uart_crc_errors=%u\n", (unsigned)uart.crc_errors);
+        printf("uart_cobs_errors=%u\n", (unsigned)uart.cobs_errors);
+        printf("uart_overflows=%u\n", (unsigned)uart.overflows);
+        printf("uart_bad_commands=%u\n", (unsigned)uart.bad_commands);
+    }
+    if (sim_font_loaded()) {
+        ui_font_cache_stats_t font;
+        ui_font_cache_get_stats(&font);
+        const perf_hist_t *fetch = sim_font_fetch_hist();
+        printf("font_lookups=%u\n", (unsigned)font.lookups);
+        printf("font_hot_hits=%u\n", (unsigned)font.hot_hits);
+        printf("font_lru_hits=%u\n", (unsigned)font.lru_hits);
+        printf("font_misses=%u\n", (unsigned)font.misses);
+        printf("font_hit_pct=%u\n",
+               (unsigned)(font.lookups ? (font.hot_hits + font.lru_hits) * 100ULL / font.lookups : 0));
+        printf("font_promotions=%u\n", (unsigned)font.promotions);
+        printf("font_evictions=%u\n", (unsigned)font.evictions);
+        printf("font_fetch_us_p50=%u\n", (unsigned)perf_hist_percentile(fetch, 50));
+        printf("font_fetch_us_p99=%u\n", (unsigned)perf_hist_percentile(fetch, 99));
+        printf("font_fetch_us_max=%u\n", (unsigned)font.fetch_us_max);
+    }
+    if (sim_icon_loaded()) {
+        ui_icon_cache_stats_t icon;
+        ui_icon_get_stats(&icon);
+        const perf_hist_t *decode = sim_icon_decode_hist();
+        printf("icon_lookups=%u\n", (unsigned)icon.lookups);
+        printf("icon_hits=%u\n", (unsigned)icon.hits);
+        printf("icon_misses=%u\n", (unsigned)icon.misses);
+        printf("icon_evictions=%u\n", (unsigned)icon.evictions);
+        printf("icon_failures=%u\n", (unsigned)icon.failures);
+        printf("icon_pages_decoded=%u\n", (unsigned)icon.pages_decoded);
+        printf("icon_bytes_used=%u\n", (unsigned)icon.bytes_used);
+        printf("icon_decode_us_p50=%u\n", (unsigned)perf_hist_percentile(decode, 50));
+        printf("icon_decode_us_p99=%u\n", (unsigned)perf_hist_percentile(decode, 99));
+        printf("icon_decode_us_max=%u\n", (unsigned)icon.decode_us_max);
+    }
+#if SIM_LVGL_MEM
+    lvgl_mem_stats_t mem;
+    lvgl_mem_get_stats(&mem);
+    printf("lvgl_mem_pool_pages_used=%u\n", (unsigned)mem.pool_pages_used);
+    printf("lvgl_mem_tlsf_used=%zu\n", mem.tlsf_used);
+    printf("lvgl_mem_tlsf_peak=%zu\n", mem.tlsf_peak);
+    printf("lvgl_mem_tlsf_frag_pct=%u\n", (unsigned)mem.tlsf_frag_pct);
+    printf("lvgl_mem_spill_peak=%zu\n", mem.spill_peak);
+#endif
+    printf("max_rss_kb=%ld\n", usage.ru_maxrss);
+    return gestures_ok ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+// sim_mem_bench.c
+// LVGL 分配器基准：同一条分配序列分别交给 malloc 和 main/lvgl_mem.c，比较每次操作耗时和碎片
+// 序列模拟 LVGL 的分配特点：大量 16~256 字节的对象 / 样式 / 事件描述，少量文本和数组，
+// 偶尔有超过溢出阈值的大块；标签改文字时原地 realloc 到相近大小
+#include "sim.h"
+#include "lvgl_mem.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MEM_BENCH_SLOTS 256     // 同时存活的块不超过该数，稳定后约 60% 被占用
+#define MEM_BENCH_SEED  0x2545F491u
+
+typedef struct {
+    void *(*alloc)(size_t size);
+    void (*free)(void *ptr);
+    void *(*realloc)(void *ptr, size_t size);
+} mem_ops_t;
+
+typedef struct {
+    void *ptr;
+    uint32_t size;
+} mem_slot_t;
+
+static uint32_t xorshift32(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// 块大小分布：45% 16~64，30% 64~256，18% 256~1K，6% 1K~4K，1% 4K~16K
+static uint32_t pick_size(uint32_t *rng) {
+    uint32_t r = xorshift32(rng) % 100;
+    uint32_t v = xorshift32(rng);
+    if (r < 45) return 16 + v % 49;
+    if (r < 75) return 64 + v % 193;
+    if (r < 93) return 256 + v % 769;
+    if (r < 99) return 1024 + v % 3073;
+    return 4096 + v % 12289;
+}
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// 返回总耗时（ns）；live 非 NULL 时在释放全部块之前取一次 lvgl_mem 统计（稳定状态下的占用和碎片）
+static int64_t run(const mem_ops_t *ops, uint32_t count, uint32_t *failed, lvgl_mem_stats_t *live) {
+    static mem_slot_t slots[MEM_BENCH_SLOTS];
+    memset(slots, 0, sizeof(slots));
+    uint32_t rng = MEM_BENCH_SEED;
+    *failed = 0;
+    const int64_t start = now_ns();
+    for (uint32_t i = 0; i < count; i++) {
+        mem_slot_t *slot = &slots[xorshift32(&rng) % MEM_BENCH_SLOTS];
+        uint32_t r = xorshift32(&rng) % 10;
+        if (!slot->ptr) {
+            slot->size = pick_size(&rng);
+            slot->ptr = ops->alloc(slot->size);
+            if (!slot->ptr) {
+                (*failed)++;
+                continue;
+            }
+            memset(slot->ptr, (int)i, slot->size < 16 ? slot->size : 16);  // 和 LVGL 一样马上写入对象头
+        } else if (r < 7) {
+            ops->free(slot->ptr);
+            slot->ptr = NULL;
+        } else {
+            // 改文字：在原大小附近伸缩 ±25%
+            int32_t delta = (int32_t)(xorshift32(&rng) % (slot->size / 2 + 1)) - (int32_t)(slot->size / 4);
+            uint32_t size = (uint32_t)((int32_t)slot->size + delta);
+            if (size == 0) size = 1;
+            void *ptr = ops->realloc(slot->ptr, size);
+            if (!ptr) {
+                (*failed)++;
+                continue;
+            }
+            slot->ptr = ptr;
+            slot->size = size;
+        }
+    }
+    const int64_t elapsed = now_ns() - start;
+    if (live) lvgl_mem_get_stats(live);
+    for (int i = 0; i < MEM_BENCH_SLOTS; i++) {
+        ops->free(slots[i].ptr);
+    }
+    return elapsed;
+}
+
+int sim_mem_bench(uint32_t count) {
+    static const mem_ops_t libc_ops = { malloc, free, realloc };
+    static const mem_ops_t lvgl_ops = { lvgl_mem_alloc, lvgl_mem_free, lvgl_mem_realloc };
+    if (count == 0) count = 1000000;
+
+    // 先各跑一遍预热，让 malloc 的 arena 和 lvgl_mem 的区域都已就绪
+    uint32_t failed;
+    run(&libc_ops, count / 10, &failed, NULL);
+    run(&lvgl_ops, count / 10, &failed, NULL);
+
+    lvgl_mem_stats_t before;
+    lvgl_mem_get_stats(&before);
+    uint32_t libc_failed, lvgl_failed;
+    lvgl_mem_stats_t mem, after;
+    const int64_t libc_ns = run(&libc_ops, count, &libc_failed, NULL);
+    const int64_t lvgl_ns = run(&lvgl_ops, count, &lvgl_failed, &mem);
+    lvgl_mem_get_stats(&after);
+
+    printf("mem_bench_ops=%u\n", (unsigned)count);
+    printf("malloc_ns_per_op=%.1f\n", (double)libc_ns / count);
+    printf("malloc_failed=%u\n", (unsigned)libc_failed);
+    printf("lvgl_mem_ns_per_op=%.1f\n", (double)lvgl_ns / count);
+    printf("lvgl_mem_failed=%u\n", (unsigned)lvgl_failed);
+    for (int i = 0; i < LVGL_MEM_CLASS_COUNT; i++) {
+        const lvgl_mem_class_stats_t *cls = &mem.classes[i];
+        printf("lvgl_mem_class_%u_in_use=%u\n", cls->size, (unsigned)cls->in_use);
+        printf("lvgl_mem_class_%u_peak=%u\n", cls->size, (unsigned)cls->peak);
+        printf("lvgl_mem_class_%u_fallbacks=%u\n", cls->size,
+               (unsigned)(cls->fallbacks - before.classes[i].fallbacks));
+    }
+    printf("lvgl_mem_pool_pages=%u\n", (unsigned)mem.pool_pages);
+    printf("lvgl_mem_pool_pages_used=%u\n", (unsigned)mem.pool_pages_used);
+    printf("lvgl_mem_tlsf_size=%zu\n", mem.tlsf_size);
+    printf("lvgl_mem_tlsf_used=%zu\n", mem.tlsf_used);
+    printf("lvgl_mem_tlsf_peak=%zu\n", mem.tlsf_peak);
+    printf("lvgl_mem_tlsf_largest_free=%zu\n", mem.tlsf_largest_free);
+    printf("lvgl_mem_tlsf_frag_pct=%u\n", (unsigned)mem.tlsf_frag_pct);
+    printf("lvgl_mem_spill_used=%zu\n", mem.spill_used);
+    printf("lvgl_mem_spill_peak=%zu\n", mem.spill_peak);
+    printf("lvgl_mem_leaked=%zu\n", after.tlsf_used + after.spill_used);
+    return lvgl_failed ? 1 : 0;
+}
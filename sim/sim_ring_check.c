@@ -0,0 +1,177 @@
+// sim_ring_check.c
+// ui_ring 多生产者校验：每种溢出策略下 RING_CHECK_PRODUCERS 个线程并发写入变长条目，主线程同时取出。
+// 条目负载带生产者编号、序号和由二者生成的填充字节，取出时逐字节核对；同一生产者的序号必须严格递增
+// （队列不会重排，也不会重复交付）。结束后核对计数：
+//   pushed 等于生产者看到的成功次数，popped 等于取出的条目数，
+//   dropped 等于生产者看到的失败次数加上被 DROP_OLDEST 覆盖的条目数（pushed - popped）。
+// 缓冲取得很小，让回绕、填充条目和溢出都频繁发生。
+#include "sim.h"
+#include "ui_ring.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define RING_CHECK_SIZE         1024
+#define RING_CHECK_PRODUCERS    4
+#define RING_CHECK_MAX_LEN      120
+#define RING_CHECK_HEAD_LEN     5       // 生产者编号 1 字节 + 序号 4 字节
+
+typedef struct {
+    ui_ring_t *ring;
+    int id;
+    uint32_t count;
+    bool try_push;                      // 奇数编号的生产者用 ui_ring_try_pushv，BLOCK 下不等待
+    uint32_t ok;
+    uint32_t failed;
+} ring_producer_t;
+
+static uint8_t g_ring_buf[UI_RING_MEM_SIZE(RING_CHECK_SIZE)] __attribute__((aligned(8)));
+static atomic_int g_producers_done;
+
+static uint8_t pattern(int id, uint32_t seq, uint32_t k) {
+    return (uint8_t)(seq * 31u + k * 7u + (uint32_t)id * 101u);
+}
+
+static uint32_t entry_len(int id, uint32_t seq) {
+    return RING_CHECK_HEAD_LEN + (seq * 2654435761u + (uint32_t)id * 40503u) % (RING_CHECK_MAX_LEN - RING_CHECK_HEAD_LEN + 1);
+}
+
+static void *producer_main(void *arg) {
+    ring_producer_t *p = arg;
+    uint8_t body[RING_CHECK_MAX_LEN];
+    for (uint32_t seq = 0; seq < p->count; seq++) {
+        const uint32_t len = entry_len(p->id, seq);
+        body[0] = (uint8_t)p->id;
+        memcpy(body + 1, &seq, sizeof(seq));
+        for (uint32_t k = RING_CHECK_HEAD_LEN; k < len; k++) {
+            body[k] = pattern(p->id, seq, k);
+        }
+        // 头和填充分两段写入，同时覆盖 pushv 的拼接
+        const ui_ring_seg_t segs[2] = {
+            { body, RING_CHECK_HEAD_LEN },
+            { body + RING_CHECK_HEAD_LEN, len - RING_CHECK_HEAD_LEN },
+        };
+        const bool ok = p->try_push ? ui_ring_try_pushv(p->ring, (uint8_t)(p->id + 1), segs, 2)
+                                    : ui_ring_pushv(p->ring, (uint8_t)(p->id + 1), segs, 2);
+        if (ok) p->ok++;
+        else p->failed++;
+    }
+    atomic_fetch_add(&g_producers_done, 1);
+    return NULL;
+}
+
+// 核对一个取出的条目，出错时打印原因并返回 false
+static bool check_entry(const char *name, uint8_t type, const uint8_t *body, int len, int64_t *last_seq) {
+    if (len < RING_CHECK_HEAD_LEN || len > RING_CHECK_MAX_LEN) {
+        printf("ring_check_%s_error=bad length %d\n", name, len);
+        return false;
+    }
+    const int id = body[0];
+    uint32_t seq;
+    memcpy(&seq, body + 1, sizeof(seq));
+    if (id >= RING_CHECK_PRODUCERS || type != id + 1 || (uint32_t)len != entry_len(id, seq)) {
+        printf("ring_check_%s_error=bad header id=%d type=%u seq=%u len=%d\n", name, id, type, (unsigned)seq, len);
+        return false;
+    }
+    if ((int64_t)seq <= last_seq[id]) {
+        printf("ring_check_%s_error=producer %d seq %u after %lld\n", name, id, (unsigned)seq, (long long)last_seq[id]);
+        return false;
+    }
+    last_seq[id] = seq;
+    for (int k = RING_CHECK_HEAD_LEN; k < len; k++) {
+        if (body[k] != pattern(id, seq, (uint32_t)k)) {
+            printf("ring_check_%s_error=payload producer %d seq %u byte %d\n", name, id, (unsigned)seq, k);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool run_policy(const char *name, ui_ring_policy_t policy, uint32_t count) {
+    ui_ring_t ring;
+    ui_ring_init(&ring, g_ring_buf, RING_CHECK_SIZE, policy, 1000);
+    atomic_store(&g_producers_done, 0);
+
+    ring_producer_t producers[RING_CHECK_PRODUCERS];
+    pthread_t threads[RING_CHECK_PRODUCERS];
+    for (int i = 0; i < RING_CHECK_PRODUCERS; i++) {
+        producers[i] = (ring_producer_t){
+            .ring = &ring,
+            .id = i,
+            .count = count,
+            .try_push = policy == UI_RING_BLOCK && (i & 1),
+        };
+        pthread_create(&threads[i], NULL, producer_main, &producers[i]);
+    }
+
+    int64_t last_seq[RING_CHECK_PRODUCERS];
+    for (int i = 0; i < RING_CHECK_PRODUCERS; i++) last_seq[i] = -1;
+    uint8_t body[RING_CHECK_MAX_LEN];
+    uint32_t received = 0;
+    bool ok = true;
+    const struct timespec pause = { 0, 20000 };
+    for (;;) {
+        // 先看生产者是否都已结束，再取空队列，保证最后写入的条目也被取出
+        const bool done = atomic_load(&g_producers_done) == RING_CHECK_PRODUCERS;
+        uint8_t type;
+        int len;
+        while ((len = ui_ring_pop(&ring, &type, body, sizeof(body))) >= 0) {
+            ok = check_entry(name, type, body, len, last_seq) && ok;
+            received++;
+        }
+        if (done) break;
+        // 消费者偶尔停顿，让队列填满
+        if ((received & 255) == 0) nanosleep(&pause, NULL);
+    }
+    for (int i = 0; i < RING_CHECK_PRODUCERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    uint32_t push_ok = 0, push_failed = 0;
+    for (int i = 0; i < RING_CHECK_PRODUCERS; i++) {
+        push_ok += producers[i].ok;
+        push_failed += producers[i].failed;
+    }
+    ui_ring_stats_t st;
+    ui_ring_get_stats(&ring, &st);
+    const uint32_t overwritten = st.pushed - st.popped;
+    printf("ring_check_%s_pushed=%u\n", name, (unsigned)st.pushed);
+    printf("ring_check_%s_popped=%u\n", name, (unsigned)st.popped);
+    printf("ring_check_%s_dropped=%u\n", name, (unsigned)st.dropped);
+    printf("ring_check_%s_push_failed=%u\n", name, (unsigned)push_failed);
+    printf("ring_check_%s_overwritten=%u\n", name, (unsigned)overwritten);
+    printf("ring_check_%s_high_water=%u\n", name, (unsigned)st.high_water);
+
+    if (st.used != 0 || st.pushed != push_ok || st.popped != received || st.dropped != push_failed + overwritten ||
+        push_ok + push_failed != count * RING_CHECK_PRODUCERS) {
+        printf("ring_check_%s_error=counters do not add up (used=%u received=%u push_ok=%u)\n", name,
+               (unsigned)st.used, (unsigned)received, (unsigned)push_ok);
+        ok = false;
+    }
+    if (policy != UI_RING_DROP_OLDEST && overwritten != 0) {
+        printf("ring_check_%s_error=entries lost without DROP_OLDEST\n", name);
+        ok = false;
+    }
+    // 超时 1 s 远大于消费者的停顿，等待的生产者不应丢弃
+    if (policy == UI_RING_BLOCK) {
+        for (int i = 0; i < RING_CHECK_PRODUCERS; i += 2) {
+            if (producers[i].failed) {
+                printf("ring_check_%s_error=blocking producer %d dropped %u\n", name, i, (unsigned)producers[i].failed);
+                ok = false;
+            }
+        }
+    }
+    printf("ring_check_%s=%s\n", name, ok ? "ok" : "fail");
+    return ok;
+}
+
+int sim_ring_check(uint32_t count) {
+    if (count == 0) count = 20000;
+    printf("ring_check_entries=%u\n", (unsigned)count);
+    printf("ring_check_producers=%d\n", RING_CHECK_PRODUCERS);
+    bool ok = run_policy("newest", UI_RING_DROP_NEWEST, count);
+    ok = run_policy("oldest", UI_RING_DROP_OLDEST, count) && ok;
+    ok = run_policy("block", UI_RING_BLOCK, count) && ok;
+    return ok ? 0 : 1;
+}
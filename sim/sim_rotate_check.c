@@ -0,0 +1,133 @@
+// sim_rotate_check.c
+// rgb565_rotate_area() 校验：随机帧尺寸、随机区域和随机角度（90 / 180 / 270），目标缓冲起点随机错开 0 或 1 个像素
+// 以覆盖成对写入的对齐分支。结果与按 rgb565_rotate.h 中的坐标映射逐像素写出的参考帧比较，
+// 整个目标帧都参与比较，区域外被写到也会被发现。最后对整帧 800x480 计时，与同样大小的 memcpy 对照。
+#include "sim.h"
+#include "rgb565_rotate.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ROTATE_CHECK_MAX_DIM    200
+#define ROTATE_CHECK_SEED       0x9E3779B9u
+#define ROTATE_CHECK_FILL       0xA5A5
+#define ROTATE_BENCH_W          800
+#define ROTATE_BENCH_H          480
+#define ROTATE_BENCH_PASSES     20
+
+static uint32_t xorshift32(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// 参考实现：按头文件中的映射逐像素写出
+static void rotate_ref(uint16_t *dst, const uint16_t *src, int src_w, int src_h,
+                       int x1, int y1, int x2, int y2, int degree) {
+    for (int y = y1; y <= y2; y++) {
+        for (int x = x1; x <= x2; x++) {
+            const uint16_t px = src[y * src_w + x];
+            switch (degree) {
+            case 90: dst[x * src_h + (src_h - 1 - y)] = px; break;
+            case 180: dst[(src_h - 1 - y) * src_w + (src_w - 1 - x)] = px; break;
+            default: dst[(src_w - 1 - x) * src_h + y] = px; break;
+            }
+        }
+    }
+}
+
+static double bench_mpix(uint16_t *dst, const uint16_t *src, int degree) {
+    const int src_w = (degree == 90 || degree == 270) ? ROTATE_BENCH_H : ROTATE_BENCH_W;
+    const int src_h = (degree == 90 || degree == 270) ? ROTATE_BENCH_W : ROTATE_BENCH_H;
+    const int64_t start = now_ns();
+    for (int i = 0; i < ROTATE_BENCH_PASSES; i++) {
+        if (degree) {
+            rgb565_rotate_area(dst, src, src_w, src_h, 0, 0, src_w - 1, src_h - 1, degree);
+        } else {
+            memcpy(dst, src, (size_t)src_w * src_h * sizeof(uint16_t));
+        }
+    }
+    const int64_t elapsed = now_ns() - start;
+    return (double)src_w * src_h * ROTATE_BENCH_PASSES * 1000.0 / (double)(elapsed ? elapsed : 1);
+}
+
+int sim_rotate_check(uint32_t count) {
+    static const int degrees[] = { 90, 180, 270 };
+    const size_t max_px = (size_t)ROTATE_CHECK_MAX_DIM * ROTATE_CHECK_MAX_DIM;
+    uint16_t *src = malloc(max_px * sizeof(uint16_t));
+    uint16_t *dst = malloc((max_px + 1) * sizeof(uint16_t));
+    uint16_t *ref = malloc((max_px + 1) * sizeof(uint16_t));
+    if (!src || !dst || !ref) {
+        free(src);
+        free(dst);
+        free(ref);
+        return 1;
+    }
+
+    uint32_t rng = ROTATE_CHECK_SEED;
+    uint32_t failed[3] = { 0 };
+    uint32_t cases[3] = { 0 };
+    for (uint32_t i = 0; i < count; i++) {
+        const int k = (int)(xorshift32(&rng) % 3);
+        const int degree = degrees[k];
+        const int src_w = 1 + (int)(xorshift32(&rng) % ROTATE_CHECK_MAX_DIM);
+        const int src_h = 1 + (int)(xorshift32(&rng) % ROTATE_CHECK_MAX_DIM);
+        int x1 = (int)(xorshift32(&rng) % src_w), x2 = (int)(xorshift32(&rng) % src_w);
+        int y1 = (int)(xorshift32(&rng) % src_h), y2 = (int)(xorshift32(&rng) % src_h);
+        if (x1 > x2) { const int t = x1; x1 = x2; x2 = t; }
+        if (y1 > y2) { const int t = y1; y1 = y2; y2 = t; }
+        // 每 8 次取一次整帧，覆盖区域贴边的情况
+        if ((i & 7) == 0) {
+            x1 = y1 = 0;
+            x2 = src_w - 1;
+            y2 = src_h - 1;
+        }
+        const size_t px = (size_t)src_w * src_h;
+        const int ofs = (int)(xorshift32(&rng) & 1);
+        for (size_t p = 0; p < px; p++) src[p] = (uint16_t)xorshift32(&rng);
+        for (size_t p = 0; p < px + 1; p++) dst[p] = ref[p] = ROTATE_CHECK_FILL;
+
+        rgb565_rotate_area(dst + ofs, src, src_w, src_h, x1, y1, x2, y2, degree);
+        rotate_ref(ref + ofs, src, src_w, src_h, x1, y1, x2, y2, degree);
+        cases[k]++;
+        if (memcmp(dst, ref, (px + 1) * sizeof(uint16_t))) {
+            if (!failed[k]) {
+                printf("rotate_check_%d_first_fail=%dx%d area %d,%d-%d,%d dst_ofs %d\n", degree, src_w, src_h,
+                       x1, y1, x2, y2, ofs);
+            }
+            failed[k]++;
+        }
+    }
+    printf("rotate_check_cases=%u\n", (unsigned)count);
+    for (int k = 0; k < 3; k++) {
+        printf("rotate_check_%d_cases=%u\n", degrees[k], (unsigned)cases[k]);
+        printf("rotate_check_%d_failed=%u\n", degrees[k], (unsigned)failed[k]);
+    }
+    free(src);
+    free(dst);
+    free(ref);
+
+    // 主机上的整帧速度，只用于比较各角度与 memcpy 的相对差距，板上的数字见启动日志的 Rotate 行
+    const size_t frame_px = (size_t)ROTATE_BENCH_W * ROTATE_BENCH_H;
+    uint16_t *fsrc = malloc(frame_px * sizeof(uint16_t));
+    uint16_t *fdst = malloc(frame_px * sizeof(uint16_t));
+    if (fsrc && fdst) {
+        for (size_t p = 0; p < frame_px; p++) fsrc[p] = (uint16_t)xorshift32(&rng);
+        printf("rotate_bench_copy_mpix_s=%.1f\n", bench_mpix(fdst, fsrc, 0));
+        for (int k = 0; k < 3; k++) {
+            printf("rotate_bench_%d_mpix_s=%.1f\n", degrees[k], bench_mpix(fdst, fsrc, degrees[k]));
+        }
+    }
+    free(fsrc);
+    free(fdst);
+    return (failed[0] || failed[1] || failed[2]) ? 1 : 0;
+}
@@ -0,0 +1,85 @@
+// sim_shim.c
+// FreeRTOS / esp_timer 的主机实现与模拟器时钟
+#include "sim.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+int sim_log_level = SIM_LOG_LEVEL;
+
+static struct timespec g_start;
+static uint32_t g_step_ms;
+static _Atomic uint32_t g_virtual_ms;
+
+static int64_t monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)(ts.tv_sec - g_start.tv_sec) * 1000000 + (ts.tv_nsec - g_start.tv_nsec) / 1000;
+}
+
+void sim_time_init(uint32_t step_ms) {
+    clock_gettime(CLOCK_MONOTONIC, &g_start);
+    g_step_ms = step_ms;
+    atomic_store(&g_virtual_ms, 0);
+}
+
+bool sim_time_is_virtual(void) {
+    return g_step_ms != 0;
+}
+
+void sim_time_advance(void) {
+    atomic_fetch_add(&g_virtual_ms, g_step_ms);
+}
+
+uint32_t sim_tick_ms(void) {
+    if (g_step_ms) return atomic_load(&g_virtual_ms);
+    return (uint32_t)(monotonic_us() / 1000);
+}
+
+int64_t esp_timer_get_time(void) {
+    return monotonic_us();
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return sim_tick_ms();
+}
+
+void vTaskDelay(TickType_t ticks) {
+    usleep((useconds_t)ticks * 1000);
+}
+
+typedef struct {
+    TaskFunction_t fn;
+    void *arg;
+} task_start_t;
+
+static void *task_entry(void *p) {
+    task_start_t start = *(task_start_t *)p;
+    free(p);
+    start.fn(start.arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_size, void *arg,
+                       int priority, TaskHandle_t *handle) {
+    (void)name;
+    (void)stack_size;
+    (void)priority;
+    task_start_t *start = malloc(sizeof(*start));
+    if (!start) return pdFALSE;
+    start->fn = fn;
+    start->arg = arg;
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, task_entry, start) != 0) {
+        free(start);
+        return pdFALSE;
+    }
+    pthread_detach(thread);
+    if (handle) *handle = thread;
+    return pdPASS;
+}
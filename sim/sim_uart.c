@@ -0,0 +1,96 @@
+// sim_uart.c
+// 串口命令协议的主机端：打开 pty（或已有的串口设备），由接收线程送入 ui_proto，与板上的 uart_proto.c 相同
+#define _XOPEN_SOURCE 600           // posix_openpt / grantpt / unlockpt / ptsname
+#define _DEFAULT_SOURCE             // cfmakeraw / usleep
+#include "sim.h"
+#include "ui_proto.h"
+#include "esp_log.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+static const char *TAG = "sim_uart";
+
+#define SIM_UART_POLL_MS 100        // 接收线程检查退出标志的周期
+
+static int g_fd = -1;
+static ui_proto_t g_proto;
+static pthread_t g_thread;
+static volatile bool g_running;
+
+static void uart_write(const uint8_t *data, size_t len, void *ctx) {
+    while (len > 0) {
+        ssize_t n = write(g_fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+static void *rx_thread(void *arg) {
+    struct pollfd pfd = { .fd = g_fd, .events = POLLIN };
+    while (g_running) {
+        if (poll(&pfd, 1, SIM_UART_POLL_MS) <= 0) continue;
+        if (pfd.revents & POLLHUP) {
+            // 对端还没打开或已关闭 pty，稍后再试
+            usleep(SIM_UART_POLL_MS * 1000);
+            continue;
+        }
+        size_t avail;
+        uint8_t *dst = ui_proto_rx_space(&g_proto, &avail);
+        ssize_t n = read(g_fd, dst, avail);
+        if (n > 0) ui_proto_rx_commit(&g_proto, (size_t)n);
+    }
+    return NULL;
+}
+
+bool sim_uart_start(const char *path) {
+    if (!strcmp(path, "pty")) {
+        g_fd = posix_openpt(O_RDWR | O_NOCTTY);
+        if (g_fd < 0 || grantpt(g_fd) || unlockpt(g_fd)) {
+            ESP_LOGE(TAG, "cannot create a pty: %s", strerror(errno));
+            return false;
+        }
+        // 路径写到 stderr，stdout 留给运行汇总
+        fprintf(stderr, "uart_pty=%s\n", ptsname(g_fd));
+    } else {
+        g_fd = open(path, O_RDWR | O_NOCTTY);
+        if (g_fd < 0) {
+            ESP_LOGE(TAG, "cannot open %s: %s", path, strerror(errno));
+            return false;
+        }
+    }
+    struct termios tio;
+    if (tcgetattr(g_fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(g_fd, TCSANOW, &tio);
+    }
+    ui_proto_init(&g_proto, uart_write, NULL);
+    g_running = true;
+    if (pthread_create(&g_thread, NULL, rx_thread, NULL) != 0) {
+        g_running = false;
+        return false;
+    }
+    return true;
+}
+
+void sim_uart_stop(void) {
+    if (!g_running) return;
+    g_running = false;
+    pthread_join(g_thread, NULL);
+}
+
+bool sim_uart_get_stats(ui_proto_stats_t *stats) {
+    if (g_fd < 0) return false;
+    ui_proto_get_stats(&g_proto, stats);
+    return true;
+}